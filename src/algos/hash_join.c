@@ -0,0 +1,534 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash_join.h"
+#include "../utils/log.h"
+#include "../utils/parallel.h"
+
+bool hash_join_init(
+    hash_join* join,
+    const hash_join_type type,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(join, 0, sizeof(hash_join));
+
+    if (type != HASH_JOIN_INNER && type != HASH_JOIN_SEMI && type != HASH_JOIN_ANTI) {
+        log_error("invalid hash join type: %d", type);
+        return false;
+    }
+
+    join->type = type;
+    join->key_cmp = key_cmp == NULL ? value_cmp_string : key_cmp;
+    join->key_hash = key_hash == NULL ? hash_table_key_hash_string : key_hash;
+
+    return true;
+}
+
+void hash_join_set_emit_func(hash_join* join, const hash_join_emit_func emit_func, void* emit_user_arg) {
+    join->emit_func = emit_func;
+    join->emit_user_arg = emit_user_arg;
+}
+
+/**
+ * Partitioned row
+ */
+struct hash_join_record {
+    size_t row;
+
+    /**
+     * Full hash of the row's key
+     */
+    uint32_t hash;
+};
+
+/**
+ * One side of the join, as it's partitioned
+ */
+struct hash_join_side {
+    void* const* keys;
+    size_t n;
+
+    /**
+     * Full hashes of the keys
+     */
+    uint32_t* hashes;
+
+    /**
+     * Number of rows in each partition from each thread's slice of the input (threads x partitions), which then become
+     * the offsets in records that each thread writes each partition's rows to
+     */
+    size_t* offsets;
+
+    /**
+     * Offset of each partition in records (partitions + 1)
+     */
+    size_t* partition_starts;
+
+    /**
+     * Rows, grouped by partition (in input order within each)
+     */
+    struct hash_join_record* records;
+};
+
+/**
+ * Join state, shared by all threads
+ */
+struct hash_join_state {
+    hash_join* join;
+
+    size_t threads;
+    size_t partitions;
+
+    /**
+     * Right shift that turns a multiplied hash into a partition
+     */
+    size_t partition_shift;
+
+    struct hash_join_side build;
+    struct hash_join_side probe;
+
+    /**
+     * Next build record with the same key as each build record (as its position + 1, or 0 for the last one), so a
+     * partition's hash table only needs to hold the first record of each key (inner joins only)
+     */
+    size_t* next;
+
+    /**
+     * Number of matches each thread emitted
+     */
+    size_t* matches;
+
+    /**
+     * Next partition for a thread to claim
+     */
+    size_t next_partition;
+
+    /**
+     * Set if a thread failed to join a partition
+     */
+    bool failed;
+};
+
+/**
+ * Thread's buffer of matches that haven't been emitted yet
+ */
+struct hash_join_batch {
+    hash_join_match matches[HASH_JOIN_BATCH_SIZE];
+    size_t n;
+};
+
+/**
+ * Get the partition that a key hash belongs to
+ *
+ * The hash is multiplied first (Fibonacci hashing), so weak custom hash functions (like ones that return small
+ * integers) still spread over every partition. Partition hash tables pick buckets from their own mix of the hash, so
+ * keys in the same partition don't end up in the same buckets either.
+ *
+ * @param[in] state Join state
+ * @param[in] hash Full hash of the key
+ * @return Partition
+ */
+static inline size_t partition_of(const struct hash_join_state* state, const uint32_t hash) {
+    return (uint64_t)(uint32_t)(hash * 0x9e3779b9u) >> state->partition_shift;
+}
+
+/**
+ * Get a thread's slice of one side of the join
+ *
+ * @param[in] state Join state
+ * @param[in] side Side of the join
+ * @param[in] thread Thread number
+ * @param[out] start First row in the slice
+ * @param[out] end End of the slice (exclusive)
+ */
+static inline void side_slice(
+    const struct hash_join_state* state,
+    const struct hash_join_side* side,
+    const size_t thread,
+    size_t* start,
+    size_t* end
+) {
+    *start = side->n * thread / state->threads;
+    *end = side->n * (thread + 1) / state->threads;
+}
+
+/**
+ * Hash a thread's slice of one side of the join, and count how many rows go to each partition
+ *
+ * @param[in] state Join state
+ * @param[in,out] side Side of the join
+ * @param[in] thread Thread number
+ */
+static void hash_side(const struct hash_join_state* state, struct hash_join_side* side, const size_t thread) {
+    const hash_table_key_hash_func key_hash = state->join->key_hash;
+    size_t* p_counts = side->offsets + thread * state->partitions;
+    size_t start, end;
+    side_slice(state, side, thread, &start, &end);
+
+    for (size_t i = start; i < end; ++i) {
+        const uint32_t hash = key_hash(side->keys[i], SIZE_MAX);
+        side->hashes[i] = hash;
+        ++p_counts[partition_of(state, hash)];
+    }
+}
+
+/**
+ * Phase 1: Hash a slice of each side, and count how many rows go to each partition
+ * {@see parallel_func}
+ */
+static void hash_phase(void* arg, const size_t thread) {
+    struct hash_join_state* state = arg;
+    hash_side(state, &state->build, thread);
+    hash_side(state, &state->probe, thread);
+}
+
+/**
+ * Turn each thread's partition counts into the offsets it writes each partition's rows to
+ *
+ * @param[in] state Join state
+ * @param[in,out] side Side of the join
+ */
+static void assign_offsets(const struct hash_join_state* state, struct hash_join_side* side) {
+    size_t offset = 0;
+    for (size_t partition = 0; partition < state->partitions; ++partition) {
+        side->partition_starts[partition] = offset;
+
+        for (size_t t = 0; t < state->threads; ++t) {
+            size_t* p_count = &side->offsets[t * state->partitions + partition];
+            const size_t count = *p_count;
+            *p_count = offset;
+            offset += count;
+        }
+    }
+
+    side->partition_starts[state->partitions] = offset;
+}
+
+/**
+ * Write a record for each row in a thread's slice of one side of the join, grouped by partition
+ * Slices are written in order, so each partition's records keep their input order.
+ *
+ * @param[in] state Join state
+ * @param[in,out] side Side of the join
+ * @param[in] thread Thread number
+ */
+static void scatter_side(const struct hash_join_state* state, struct hash_join_side* side, const size_t thread) {
+    size_t* p_offsets = side->offsets + thread * state->partitions;
+    size_t start, end;
+    side_slice(state, side, thread, &start, &end);
+
+    for (size_t i = start; i < end; ++i) {
+        const uint32_t hash = side->hashes[i];
+        struct hash_join_record* p_record = &side->records[p_offsets[partition_of(state, hash)]++];
+        p_record->row = i;
+        p_record->hash = hash;
+    }
+}
+
+/**
+ * Phase 2: Partition a slice of each side
+ * {@see parallel_func}
+ */
+static void scatter_phase(void* arg, const size_t thread) {
+    struct hash_join_state* state = arg;
+    scatter_side(state, &state->build, thread);
+    scatter_side(state, &state->probe, thread);
+}
+
+/**
+ * Add a match to a thread's batch, emitting the batch if it's full
+ *
+ * @param[in] state Join state
+ * @param[in,out] batch Thread's batch
+ * @param[in] thread Thread number
+ * @param[in] build_row Build row
+ * @param[in] probe_row Probe row
+ */
+static inline void add_match(
+    const struct hash_join_state* state,
+    struct hash_join_batch* batch,
+    const size_t thread,
+    const size_t build_row,
+    const size_t probe_row
+) {
+    hash_join_match* p_match = &batch->matches[batch->n++];
+    p_match->build_row = build_row;
+    p_match->probe_row = probe_row;
+
+    if (batch->n == HASH_JOIN_BATCH_SIZE) {
+        const hash_join* join = state->join;
+        if (join->emit_func != NULL) {
+            join->emit_func(batch->matches, batch->n, thread, join->emit_user_arg);
+        }
+
+        state->matches[thread] += batch->n;
+        batch->n = 0;
+    }
+}
+
+/**
+ * Build a hash table over a partition's build records, and probe it with the partition's probe records
+ *
+ * @param[in,out] state Join state
+ * @param[in,out] batch Thread's batch
+ * @param[in] thread Thread number
+ * @param[in] partition Partition to join
+ * @return true on success, false on failure
+ */
+static bool join_partition(
+    struct hash_join_state* state,
+    struct hash_join_batch* batch,
+    const size_t thread,
+    const size_t partition
+) {
+    const hash_join* join = state->join;
+    const size_t build_start = state->build.partition_starts[partition];
+    const size_t build_end = state->build.partition_starts[partition + 1];
+    const size_t probe_start = state->probe.partition_starts[partition];
+    const size_t probe_end = state->probe.partition_starts[partition + 1];
+
+    if (build_start == build_end) {
+        // Nothing to match, so only anti joins emit anything
+        if (join->type == HASH_JOIN_ANTI) {
+            for (size_t i = probe_start; i < probe_end; ++i) {
+                add_match(state, batch, thread, SIZE_MAX, state->probe.records[i].row);
+            }
+        }
+
+        return true;
+    }
+
+    // Sized for every key to be distinct, so the table never grows while it's built
+    const size_t size = build_end - build_start < UINT32_MAX ? build_end - build_start : UINT32_MAX;
+    hash_table ht;
+    if (!hash_table_init(&ht, (uint32_t)size, join->key_cmp, join->key_hash)) {
+        return false;
+    }
+
+    // Values are the position + 1 of the first record with each key. Records are inserted in reverse, so each key's
+    // first record ends up in the table, and its chain of duplicates is in build row order.
+    for (size_t i = build_end; i > build_start; --i) {
+        const struct hash_join_record* p_record = &state->build.records[i - 1];
+
+        bool inserted;
+        void** p_slot = hash_table_get_or_insert_with_hash(
+            &ht,
+            state->build.keys[p_record->row],
+            p_record->hash,
+            &inserted
+        );
+
+        if (p_slot == NULL) {
+            hash_table_destroy(&ht);
+            return false;
+        }
+
+        if (state->next != NULL) {
+            state->next[i - 1] = (uintptr_t)*p_slot; // NULL (0) for a new key
+        }
+
+        *p_slot = (void *)(uintptr_t)i;
+    }
+
+    for (size_t i = probe_start; i < probe_end; ++i) {
+        const struct hash_join_record* p_record = &state->probe.records[i];
+        const size_t first = (uintptr_t)hash_table_get_with_hash(
+            &ht,
+            state->probe.keys[p_record->row],
+            p_record->hash
+        );
+
+        switch (join->type) {
+            case HASH_JOIN_INNER:
+                for (size_t position = first; position != 0; position = state->next[position - 1]) {
+                    add_match(state, batch, thread, state->build.records[position - 1].row, p_record->row);
+                }
+                break;
+
+            case HASH_JOIN_SEMI:
+                if (first != 0) {
+                    add_match(state, batch, thread, state->build.records[first - 1].row, p_record->row);
+                }
+                break;
+
+            case HASH_JOIN_ANTI:
+                if (first == 0) {
+                    add_match(state, batch, thread, SIZE_MAX, p_record->row);
+                }
+                break;
+        }
+    }
+
+    return hash_table_destroy(&ht);
+}
+
+/**
+ * Phase 3: Claim partitions and join them, until there are none left (or a thread fails)
+ * {@see parallel_func}
+ */
+static void join_phase(void* arg, const size_t thread) {
+    struct hash_join_state* state = arg;
+    struct hash_join_batch batch;
+    batch.n = 0;
+
+    while (!__atomic_load_n(&state->failed, __ATOMIC_RELAXED)) {
+        const size_t partition = __atomic_fetch_add(&state->next_partition, 1, __ATOMIC_RELAXED);
+        if (partition >= state->partitions) {
+            break;
+        }
+
+        if (!join_partition(state, &batch, thread, partition)) {
+            log_error("failed to join hash join partition %zu", partition);
+            __atomic_store_n(&state->failed, true, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Emit what's left
+    if (batch.n > 0) {
+        const hash_join* join = state->join;
+        if (join->emit_func != NULL) {
+            join->emit_func(batch.matches, batch.n, thread, join->emit_user_arg);
+        }
+
+        state->matches[thread] += batch.n;
+    }
+}
+
+/**
+ * Allocate one side of the join's partitioning buffers
+ *
+ * @param[in] state Join state
+ * @param[out] side Side of the join
+ * @param[in] keys Keys of the side
+ * @param[in] n Number of keys
+ * @return true on success, false on failure
+ */
+static bool alloc_side(
+    const struct hash_join_state* state,
+    struct hash_join_side* side,
+    void* const* keys,
+    const size_t n
+) {
+    side->keys = keys;
+    side->n = n;
+    side->hashes = malloc((n == 0 ? 1 : n) * sizeof(uint32_t));
+    side->offsets = calloc(state->threads * state->partitions, sizeof(size_t));
+    side->partition_starts = malloc((state->partitions + 1) * sizeof(size_t));
+    side->records = malloc((n == 0 ? 1 : n) * sizeof(struct hash_join_record));
+
+    return side->hashes != NULL && side->offsets != NULL && side->partition_starts != NULL && side->records != NULL;
+}
+
+/**
+ * Free one side of the join's partitioning buffers
+ *
+ * @param[in,out] side Side of the join
+ */
+static void free_side(struct hash_join_side* side) {
+    free(side->hashes);
+    free(side->offsets);
+    free(side->partition_starts);
+    free(side->records);
+}
+
+/**
+ * Free the join state
+ *
+ * @param[in,out] state Join state
+ */
+static void free_state(struct hash_join_state* state) {
+    free_side(&state->build);
+    free_side(&state->probe);
+    free(state->next);
+    free(state->matches);
+}
+
+bool hash_join_run(
+    hash_join* join,
+    void* const* build_keys,
+    const size_t build_n,
+    void* const* probe_keys,
+    const size_t probe_n,
+    size_t threads
+) {
+    if (join->key_hash == NULL) {
+        log_error("hash join not initialized");
+        return false;
+    }
+
+    join->matches = 0;
+
+    // Small joins aren't worth starting threads for
+    threads = parallel_threads(threads);
+    const size_t rows = build_n + probe_n;
+    if (rows / HASH_JOIN_PARTITION_SIZE < threads) {
+        threads = rows / HASH_JOIN_PARTITION_SIZE > 0 ? rows / HASH_JOIN_PARTITION_SIZE : 1;
+    }
+
+    // Enough partitions for each to fit in cache, and for threads to balance out their partitions
+    size_t target = (build_n + HASH_JOIN_PARTITION_SIZE - 1) / HASH_JOIN_PARTITION_SIZE;
+    if (threads > 1 && target < threads * 4) {
+        target = threads * 4;
+    }
+
+    size_t partition_bits = 0;
+    while (((size_t)1 << partition_bits) < target && ((size_t)1 << partition_bits) < HASH_JOIN_MAX_PARTITIONS) {
+        ++partition_bits;
+    }
+
+    struct hash_join_state state = {
+        .join = join,
+        .threads = threads,
+        .partitions = (size_t)1 << partition_bits,
+        .partition_shift = 32 - partition_bits,
+    };
+
+    bool success = alloc_side(&state, &state.build, build_keys, build_n);
+    success = alloc_side(&state, &state.probe, probe_keys, probe_n) && success;
+
+    if (join->type == HASH_JOIN_INNER) {
+        state.next = malloc((build_n == 0 ? 1 : build_n) * sizeof(size_t));
+        success = state.next != NULL && success;
+    }
+
+    state.matches = calloc(threads, sizeof(size_t));
+    success = state.matches != NULL && success;
+
+    if (!success) {
+        log_perror("hash join allocation failed");
+        free_state(&state);
+        return false;
+    }
+
+    parallel_run(threads, hash_phase, &state);
+
+    assign_offsets(&state, &state.build);
+    assign_offsets(&state, &state.probe);
+
+    parallel_run(threads, scatter_phase, &state);
+
+    // The records have their own copy of the hashes
+    free(state.build.hashes);
+    free(state.probe.hashes);
+    state.build.hashes = nullptr;
+    state.probe.hashes = nullptr;
+
+    parallel_run(threads, join_phase, &state);
+
+    for (size_t t = 0; t < threads; ++t) {
+        join->matches += state.matches[t];
+    }
+
+    success = !state.failed;
+    free_state(&state);
+
+    return success;
+}
+
+bool hash_join_destroy(hash_join* join) {
+    memset(join, 0, sizeof(hash_join));
+    return true;
+}
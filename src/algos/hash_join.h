@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "../structs/hash_table.h"
+#include "../utils/value.h"
+
+/**
+ * Target number of build keys in each partition (small enough for a partition's hash table to fit in cache)
+ */
+#define HASH_JOIN_PARTITION_SIZE 4096
+
+/**
+ * Max number of partitions
+ */
+#define HASH_JOIN_MAX_PARTITIONS 4096
+
+/**
+ * Number of matches each thread buffers before passing them to the emit callback
+ */
+#define HASH_JOIN_BATCH_SIZE 1024
+
+/**
+ * Join type
+ */
+typedef enum hash_join_type {
+    /**
+     * Every (build row, probe row) pair with equal keys
+     */
+    HASH_JOIN_INNER,
+
+    /**
+     * Every probe row with at least one matching build row (once, with the first matching build row)
+     */
+    HASH_JOIN_SEMI,
+
+    /**
+     * Every probe row with no matching build row (build_row is SIZE_MAX)
+     */
+    HASH_JOIN_ANTI,
+} hash_join_type;
+
+/**
+ * Joined row pair
+ */
+typedef struct hash_join_match {
+    /**
+     * Index of the row in the build keys (or SIZE_MAX for anti joins)
+     */
+    size_t build_row;
+
+    /**
+     * Index of the row in the probe keys
+     */
+    size_t probe_row;
+} hash_join_match;
+
+/**
+ * Emit callback function, called with each batch of matches
+ *
+ * @param[in] matches Batch of matches (only valid during the call)
+ * @param[in] n Number of matches in the batch
+ * @param[in] thread Number of the thread that found the matches (0 to threads - 1)
+ * @param user_arg Optional user arg
+ */
+typedef void (*hash_join_emit_func)(const hash_join_match* matches, size_t n, size_t thread, void* user_arg);
+
+/**
+ * A hash join finds the rows of two key arrays (the build side and the probe side) whose keys are equal, like a SQL
+ * `SELECT ... FROM build JOIN probe ON build.key = probe.key`.
+ *
+ * Both sides are radix partitioned in parallel by key hash, into partitions of about HASH_JOIN_PARTITION_SIZE build
+ * keys, so each partition's hash_table stays in cache while it's built and probed. Threads then claim partitions one at
+ * a time, build a hash_table over the partition's build keys, and probe it with the partition's probe keys. Each key is
+ * hashed once (when it's partitioned), and the hash is reused for the hash table.
+ *
+ * Matches are buffered per thread and passed to the emit callback in batches of up to HASH_JOIN_BATCH_SIZE. Within a
+ * partition, probe rows are emitted in order, and an inner join emits each probe row's matches in build row order, but
+ * there's no order between partitions.
+ *
+ * Build keys may have duplicates. Keys aren't copied, and must stay valid until the join finishes.
+ *
+ * **Example**
+ * ```c
+ * void emit(const hash_join_match* matches, size_t n, size_t thread, void* user_arg) {
+ *     for (size_t i = 0; i < n; ++i) {
+ *         printf("%zu = %zu\n", matches[i].build_row, matches[i].probe_row);
+ *     }
+ * }
+ *
+ * hash_join join;
+ * hash_join_init(&join, HASH_JOIN_INNER, NULL, NULL); // String keys
+ * hash_join_set_emit_func(&join, emit, NULL);
+ *
+ * char* customers[] = {"alice", "bob"};
+ * char* orders[] = {"bob", "carol", "alice", "bob"};
+ * hash_join_run(&join, (void**)customers, 2, (void**)orders, 4, 0); // 1 = 0, 0 = 2, 1 = 3 (in some order)
+ * ```
+ */
+typedef struct hash_join {
+    hash_join_type type;
+
+    value_cmp_func key_cmp;
+    hash_table_key_hash_func key_hash;
+
+    /**
+     * Emit callback
+     */
+    hash_join_emit_func emit_func;
+    void* emit_user_arg;
+
+    /**
+     * Number of matches emitted by the last run
+     */
+    size_t matches;
+} hash_join;
+
+/**
+ * Initialize the hash join
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_join
+ * @param[out] join Hash join
+ * @param[in] type Join type
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool hash_join_init(hash_join* join, hash_join_type type, value_cmp_func key_cmp, hash_table_key_hash_func key_hash);
+
+/**
+ * Set the emit callback
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_join
+ * @param[in,out] join Hash join
+ * @param[in] emit_func Called with each batch of matches (or NULL to only count them)
+ * @param emit_user_arg Optional argument to pass to the emit callback
+ */
+void hash_join_set_emit_func(hash_join* join, hash_join_emit_func emit_func, void* emit_user_arg);
+
+/**
+ * Join the build keys with the probe keys
+ *
+ * The emit callback, key_hash and key_cmp are called from several threads at once, so they must be thread safe (the
+ * default key functions are). The emit callback gets the thread number, so it can write to per-thread output without
+ * locking.
+ *
+ * Time complexity: O((m + n) / threads + matches)
+ *
+ * @relates hash_join
+ * @param[in,out] join Hash join
+ * @param[in] build_keys Build side keys
+ * @param[in] build_n Number of build keys
+ * @param[in] probe_keys Probe side keys
+ * @param[in] probe_n Number of probe keys
+ * @param[in] threads Number of threads to use, including the calling thread (or 0 for one per online CPU, see
+ *   parallel_threads())
+ * @return true on success, false on failure (some matches may have been emitted)
+ */
+bool hash_join_run(
+    hash_join* join,
+    void* const* build_keys,
+    size_t build_n,
+    void* const* probe_keys,
+    size_t probe_n,
+    size_t threads
+);
+
+/**
+ * Destroy the hash join
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_join
+ * @param[in,out] join Hash join
+ * @return true on success, false on failure
+ */
+bool hash_join_destroy(hash_join* join);
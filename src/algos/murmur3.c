@@ -41,3 +41,76 @@ uint32_t murmur3(const uint8_t* key, const size_t len, const uint32_t seed) {
 
     return h;
 }
+
+static inline uint64_t murmur3_rotl64(const uint64_t x, const int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+void murmur3_128(const uint8_t* key, const size_t len, const uint32_t seed, uint64_t hash_out[2]) {
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    uint64_t k1, k2;
+
+    // Read in groups of 16
+    for (size_t i = len >> 4; i; --i) {
+        memcpy(&k1, key, sizeof(uint64_t));
+        memcpy(&k2, key + sizeof(uint64_t), sizeof(uint64_t));
+        key += 2 * sizeof(uint64_t);
+
+        k1 *= c1;
+        k1 = murmur3_rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = murmur3_rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = murmur3_rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = murmur3_rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    // Read the rest
+    const size_t tail = len & 15;
+    k1 = 0;
+    k2 = 0;
+    for (size_t i = tail; i > 8; --i) {
+        k2 = (k2 << 8) | key[i - 1];
+    }
+    for (size_t i = tail < 8 ? tail : 8; i; --i) {
+        k1 = (k1 << 8) | key[i - 1];
+    }
+
+    if (tail > 8) {
+        k2 *= c2;
+        k2 = murmur3_rotl64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+
+    if (tail > 0) {
+        k1 *= c1;
+        k1 = murmur3_rotl64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    // Finalize
+    h1 ^= len;
+    h2 ^= len;
+    h1 += h2;
+    h2 += h1;
+    h1 = murmur3_fmix64(h1);
+    h2 = murmur3_fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    hash_out[0] = h1;
+    hash_out[1] = h2;
+}
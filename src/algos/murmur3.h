@@ -14,3 +14,38 @@
  * @return Hash value
  */
 uint32_t murmur3(const uint8_t* key, size_t len, uint32_t seed);
+
+/**
+ * MurmurHash 3 (x64 128-bit variant)
+ *
+ * This is faster than murmur3() on long keys (it reads 16 bytes at a time), and gives two independent 64-bit hash
+ * halves, which is enough for structures that need more than 32 bits of hash.
+ *
+ * Time complexity: O(n)
+ *
+ * @param[in] key Key to hash
+ * @param[in] len Length of the key
+ * @param[in] seed Hash seed
+ * @param[out] hash_out Hash value (low 64 bits, then high 64 bits)
+ */
+void murmur3_128(const uint8_t* key, size_t len, uint32_t seed, uint64_t hash_out[2]);
+
+/**
+ * MurmurHash 3 64-bit finalizer
+ *
+ * Mixes every bit of a 64-bit value into every bit of the result (and maps distinct values to distinct results). This
+ * is a cheap way to rehash an existing 64-bit hash, e.g. with a different seed added to it.
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] k Value to mix
+ * @return Mixed value
+ */
+static inline uint64_t murmur3_fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "library.h"
+#include "benchmarks/benchmark.h"
+#include "benchmarks/algos/hash_join_benchmark.h"
+#include "benchmarks/structs/cache_benchmark.h"
+#include "benchmarks/structs/concurrent_hash_table_benchmark.h"
+#include "benchmarks/structs/filter_benchmark.h"
+#include "benchmarks/structs/flat_hash_table_benchmark.h"
+#include "benchmarks/structs/hash_aggregate_benchmark.h"
+#include "benchmarks/structs/hash_table_benchmark.h"
+#include "benchmarks/structs/string_pool_benchmark.h"
+
+/**
+ * Registered benchmark
+ */
+typedef struct benchmark_info {
+    const char* name;
+    benchmark_func func;
+} benchmark_info;
+
+static void usage(const char* program, const benchmark_info* benchmarks) {
+    fprintf(stderr, "Usage: %s <benchmark|all> [args...]\n\nBenchmarks:\n", program);
+    for (const benchmark_info* p_bench = benchmarks; p_bench->name != NULL; ++p_bench) {
+        fprintf(stderr, "  %s\n", p_bench->name);
+    }
+}
+
+int main(int argc, char** argv) {
+    const benchmark_info benchmarks[] = {
+        {"cache", run_cache_benchmark},
+        {"concurrent_hash_table", run_concurrent_hash_table_benchmark},
+        {"filter", run_filter_benchmark},
+        {"flat_hash_table", run_flat_hash_table_benchmark},
+        {"hash_aggregate", run_hash_aggregate_benchmark},
+        {"hash_join", run_hash_join_benchmark},
+        {"hash_table", run_hash_table_benchmark},
+        {"string_pool", run_string_pool_benchmark},
+        {NULL, NULL},
+    };
+
+    if (argc < 2) {
+        usage(argv[0], benchmarks);
+        return 1;
+    }
+
+    if (!lupra_init()) {
+        return 1;
+    }
+
+    const bool run_all = strcmp(argv[1], "all") == 0;
+    bool found = false;
+    int result = 0;
+
+    for (const benchmark_info* p_bench = benchmarks; p_bench->name != NULL; ++p_bench) {
+        if (run_all || strcmp(argv[1], p_bench->name) == 0) {
+            found = true;
+            printf("%s\n", p_bench->name);
+            result |= p_bench->func(argc - 2, argv + 2);
+        }
+    }
+
+    if (!found) {
+        usage(argv[0], benchmarks);
+        result = 1;
+    }
+
+    lupra_destroy();
+
+    return result;
+}
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hash_join_benchmark.h"
+#include "../benchmark.h"
+#include "../../algos/hash_join.h"
+#include "../../structs/hash_map.h"
+
+/**
+ * Probe rows per build row
+ */
+#define PROBE_RATIO 4
+
+/**
+ * Benchmark dataset
+ */
+struct hash_join_benchmark_rows {
+    size_t build_n;
+    size_t probe_n;
+
+    /**
+     * Key storage
+     */
+    uint64_t* build_values;
+    uint64_t* probe_values;
+
+    void** build_keys;
+    void** probe_keys;
+
+    /**
+     * Expected number of inner join matches
+     */
+    size_t matches;
+};
+
+static int key_cmp_u64(const void* a, const void* b) {
+    const uint64_t a_key = *(const uint64_t *)a;
+    const uint64_t b_key = *(const uint64_t *)b;
+    return (a_key > b_key) - (a_key < b_key);
+}
+
+static uint32_t key_hash_u64(const void* key, size_t _ht_size) {
+    return (uint32_t)hash_map_hash_u64(*(const uint64_t *)key);
+}
+
+/**
+ * Get the key with a number (distinct numbers have distinct keys, scattered over the key space)
+ */
+static inline uint64_t key_of(const size_t number) {
+    return (uint64_t)number * 0x9e3779b97f4a7c15ULL;
+}
+
+static bool init_rows(struct hash_join_benchmark_rows* rows, const size_t build_n) {
+    rows->build_n = build_n;
+    rows->probe_n = build_n * PROBE_RATIO;
+    rows->build_values = malloc(rows->build_n * sizeof(uint64_t));
+    rows->probe_values = malloc(rows->probe_n * sizeof(uint64_t));
+    rows->build_keys = malloc(rows->build_n * sizeof(void*));
+    rows->probe_keys = malloc(rows->probe_n * sizeof(void*));
+    rows->matches = 0;
+    if (
+        rows->build_values == NULL || rows->probe_values == NULL || rows->build_keys == NULL || rows->probe_keys == NULL
+    ) {
+        fprintf(stderr, "failed to allocate %zu benchmark rows\n", rows->build_n + rows->probe_n);
+        return false;
+    }
+
+    for (size_t i = 0; i < rows->build_n; ++i) {
+        rows->build_values[i] = key_of(i);
+        rows->build_keys[i] = &rows->build_values[i];
+    }
+
+    // Numbers below build_n are build keys, so about half of the probe keys match
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < rows->probe_n; ++i) {
+        const size_t number = benchmark_rand(&rng) % (rows->build_n * 2);
+        rows->probe_values[i] = key_of(number);
+        rows->probe_keys[i] = &rows->probe_values[i];
+        rows->matches += number < rows->build_n;
+    }
+
+    return true;
+}
+
+static void destroy_rows(struct hash_join_benchmark_rows* rows) {
+    free(rows->build_values);
+    free(rows->probe_values);
+    free(rows->build_keys);
+    free(rows->probe_keys);
+}
+
+/**
+ * Check that a join found every match
+ *
+ * @param[in] rows Benchmark dataset
+ * @param[in] matches Number of matches found
+ * @return true if the number of matches is right, false otherwise
+ */
+static bool check_matches(const struct hash_join_benchmark_rows* rows, const size_t matches) {
+    if (matches != rows->matches) {
+        fprintf(stderr, "found %zu matches, expected %zu\n", matches, rows->matches);
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_set_get(const struct hash_join_benchmark_rows* rows) {
+    hash_table ht;
+    if (!hash_table_init(&ht, 1024, key_cmp_u64, key_hash_u64)) {
+        return false;
+    }
+
+    bool ok = true;
+    size_t matches = 0;
+    const uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < rows->build_n && ok; ++i) {
+        ok = hash_table_set(&ht, rows->build_keys[i], (void *)(uintptr_t)(i + 1));
+    }
+    for (size_t i = 0; i < rows->probe_n && ok; ++i) {
+        matches += hash_table_get(&ht, rows->probe_keys[i]) != NULL;
+    }
+    benchmark_report("hash_table_set + hash_table_get", rows->build_n + rows->probe_n, benchmark_now_ns() - start);
+
+    hash_table_destroy(&ht);
+
+    return ok && check_matches(rows, matches);
+}
+
+static bool bench_join(const struct hash_join_benchmark_rows* rows, const size_t threads, const char* name) {
+    hash_join join;
+    if (!hash_join_init(&join, HASH_JOIN_INNER, key_cmp_u64, key_hash_u64)) {
+        return false;
+    }
+
+    // Matches are only counted, like the hash_table baseline
+    const uint64_t start = benchmark_now_ns();
+    const bool ok = hash_join_run(&join, rows->build_keys, rows->build_n, rows->probe_keys, rows->probe_n, threads);
+    benchmark_report(name, rows->build_n + rows->probe_n, benchmark_now_ns() - start);
+
+    const size_t matches = join.matches;
+    hash_join_destroy(&join);
+
+    return ok && check_matches(rows, matches);
+}
+
+int run_hash_join_benchmark(const int argc, char** argv) {
+    const size_t default_sizes[] = {10000000};
+    size_t sizes[argc > 1 ? argc : 1];
+    const size_t size_count = benchmark_sizes(argc, argv, default_sizes, 1, sizes);
+
+    for (size_t i = 0; i < size_count; ++i) {
+        struct hash_join_benchmark_rows rows;
+        printf(" %zu build rows, %zu probe rows\n", sizes[i], sizes[i] * PROBE_RATIO);
+
+        if (!init_rows(&rows, sizes[i])) {
+            destroy_rows(&rows);
+            return 1;
+        }
+
+        const bool ok = bench_set_get(&rows) &&
+                        bench_join(&rows, 1, "hash_join_run (1 thread)") &&
+                        bench_join(&rows, 0, "hash_join_run (all CPUs)");
+        destroy_rows(&rows);
+
+        if (!ok) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+/**
+ * Compare an inner join of two synthetic key arrays with a hash_table_set() loop over the build side followed by a
+ * hash_table_get() loop over the probe side, and hash_join_run() on one thread and on every CPU
+ *
+ * Build keys are distinct 64-bit integers, and there are 4 probe keys for each build key, half of which match one.
+ *
+ * Arguments: [build rows...] (default: 10000000)
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_hash_join_benchmark(int argc, char** argv);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Benchmark entry point
+ *
+ * @param[in] argc Number of benchmark arguments
+ * @param[in] argv Benchmark arguments (excluding the benchmark name)
+ * @return 0 on success, non-zero on failure
+ */
+typedef int (*benchmark_func)(int argc, char** argv);
+
+/**
+ * Get a monotonic timestamp
+ *
+ * @return Time in nanoseconds
+ */
+static inline uint64_t benchmark_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Print a benchmark result line
+ *
+ * @param[in] name Name of the measured operation
+ * @param[in] ops Number of operations performed
+ * @param[in] elapsed_ns Time taken to perform all operations
+ */
+static inline void benchmark_report(const char* name, const size_t ops, const uint64_t elapsed_ns) {
+    const double ns_per_op = ops == 0 ? 0 : (double)elapsed_ns / (double)ops;
+    const double mops = elapsed_ns == 0 ? 0 : (double)ops * 1000.0 / (double)elapsed_ns;
+    printf("  %-36s %12zu ops %10.1f ns/op %10.2f Mops/s\n", name, ops, ns_per_op, mops);
+}
+
+/**
+ * qsort() comparator for latencies
+ */
+static inline int benchmark_latency_cmp(const void* a, const void* b) {
+    const uint64_t x = *(const uint64_t*)a;
+    const uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Print latency percentiles of a set of individually timed operations
+ *
+ * @param[in] name Name of the measured operation
+ * @param[in,out] latencies_ns Latency of each timed operation (sorted in place)
+ * @param[in] count Number of timed operations
+ */
+static inline void benchmark_report_latency(const char* name, uint64_t* latencies_ns, const size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    qsort(latencies_ns, count, sizeof(uint64_t), benchmark_latency_cmp);
+
+    printf(
+        "  %-36s %12zu ops p50 %6lu ns  p99 %6lu ns  p99.9 %6lu ns  max %8lu ns\n",
+        name,
+        count,
+        (unsigned long)latencies_ns[count / 2],
+        (unsigned long)latencies_ns[count * 99 / 100],
+        (unsigned long)latencies_ns[count * 999 / 1000],
+        (unsigned long)latencies_ns[count - 1]
+    );
+}
+
+/**
+ * Fast pseudo-random number generator (xorshift64*) for generating benchmark inputs
+ *
+ * @param[in,out] state Non-zero generator state
+ * @return Random number
+ */
+static inline uint64_t benchmark_rand(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545f4914f6cdd1dULL;
+}
+
+/**
+ * Parse benchmark sizes from arguments, or fall back to defaults
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments (each one is a size)
+ * @param[in] defaults Default sizes
+ * @param[in] default_count Number of default sizes
+ * @param[out] sizes_out Parsed sizes (must fit max(argc, default_count) items)
+ * @return Number of sizes
+ */
+static inline size_t benchmark_sizes(
+    const int argc,
+    char** argv,
+    const size_t* defaults,
+    const size_t default_count,
+    size_t* sizes_out
+) {
+    if (argc == 0) {
+        for (size_t i = 0; i < default_count; ++i) {
+            sizes_out[i] = defaults[i];
+        }
+        return default_count;
+    }
+
+    for (int i = 0; i < argc; ++i) {
+        sizes_out[i] = strtoull(argv[i], NULL, 10);
+    }
+
+    return argc;
+}
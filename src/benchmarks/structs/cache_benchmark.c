@@ -0,0 +1,260 @@
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cache_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/hash_map.h"
+#include "../../structs/lru_cache.h"
+#include "../../structs/tinylfu_cache.h"
+
+/**
+ * Number of distinct keys in the synthetic trace's Zipf distribution
+ */
+#define ZIPF_KEY_COUNT 1000000
+
+/**
+ * Zipf distribution exponent (close to what web and storage traces show)
+ */
+#define ZIPF_EXPONENT 0.9
+
+/**
+ * Number of accesses in the synthetic trace
+ */
+#define TRACE_LENGTH 5000000
+
+/**
+ * Number of Zipf accesses between scans in the synthetic trace
+ */
+#define SCAN_INTERVAL 1000000
+
+/**
+ * Number of keys in each scan of the synthetic trace
+ */
+#define SCAN_LENGTH 200000
+
+/**
+ * Access trace
+ */
+struct cache_benchmark_trace {
+    /**
+     * Keys, stored directly in the key pointers (plus 1, since caches can't have NULL keys)
+     */
+    void** keys;
+
+    size_t length;
+};
+
+static int trace_key_cmp(const void* a, const void* b) {
+    return a != b;
+}
+
+static uint32_t trace_key_hash(const void* key, const size_t ht_size) {
+    return (uint32_t)hash_map_hash_u64((uintptr_t)key) % (ht_size - 1);
+}
+
+/**
+ * Generate a Zipf distributed trace, with a scan of new keys after every SCAN_INTERVAL accesses
+ *
+ * @param[out] trace Trace
+ * @return true on success, false on failure
+ */
+static bool init_synthetic_trace(struct cache_benchmark_trace* trace) {
+    trace->length = TRACE_LENGTH;
+    trace->keys = malloc(TRACE_LENGTH * sizeof(void*));
+    double* cdf = malloc(ZIPF_KEY_COUNT * sizeof(double));
+    if (trace->keys == NULL || cdf == NULL) {
+        fprintf(stderr, "failed to allocate synthetic trace\n");
+        free(cdf);
+        return false;
+    }
+
+    double total = 0;
+    for (size_t i = 0; i < ZIPF_KEY_COUNT; ++i) {
+        total += 1.0 / pow((double)(i + 1), ZIPF_EXPONENT);
+        cdf[i] = total;
+    }
+
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    uintptr_t next_scan_key = ZIPF_KEY_COUNT;
+    size_t i = 0;
+
+    while (i < TRACE_LENGTH) {
+        for (size_t j = 0; j < SCAN_INTERVAL && i < TRACE_LENGTH; ++j, ++i) {
+            // Binary search the CDF for a uniform random point
+            const double target = (double)(benchmark_rand(&rng) >> 11) / (double)(1ULL << 53) * total;
+            size_t lo = 0;
+            size_t hi = ZIPF_KEY_COUNT - 1;
+            while (lo < hi) {
+                const size_t mid = lo + (hi - lo) / 2;
+                if (cdf[mid] < target) {
+                    lo = mid + 1;
+                }
+                else {
+                    hi = mid;
+                }
+            }
+
+            // Scatter ranks across the key space, so popular keys aren't numerically adjacent
+            trace->keys[i] = (void *)(uintptr_t)(hash_map_hash_u64(lo) % ZIPF_KEY_COUNT + 1);
+        }
+
+        for (size_t j = 0; j < SCAN_LENGTH && i < TRACE_LENGTH; ++j, ++i) {
+            trace->keys[i] = (void *)(++next_scan_key);
+        }
+    }
+
+    free(cdf);
+
+    return true;
+}
+
+/**
+ * Read a trace file (one unsigned integer key per line)
+ *
+ * @param[out] trace Trace
+ * @param[in] path Trace file path
+ * @return true on success, false on failure
+ */
+static bool init_file_trace(struct cache_benchmark_trace* trace, const char* path) {
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL) {
+        perror("fopen() failed");
+        return false;
+    }
+
+    size_t capacity = 1 << 20;
+    trace->length = 0;
+    trace->keys = malloc(capacity * sizeof(void*));
+
+    unsigned long long key;
+    while (trace->keys != NULL && fscanf(fp, "%llu", &key) == 1) {
+        if (trace->length == capacity) {
+            capacity *= 2;
+            void** keys = realloc(trace->keys, capacity * sizeof(void*));
+            if (keys == NULL) {
+                free(trace->keys);
+                trace->keys = nullptr;
+                break;
+            }
+            trace->keys = keys;
+        }
+
+        trace->keys[trace->length++] = (void *)(uintptr_t)(key + 1);
+    }
+
+    fclose(fp);
+
+    if (trace->keys == NULL) {
+        fprintf(stderr, "failed to allocate trace\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Print a hit ratio result line
+ *
+ * @param[in] name Name of the cache
+ * @param[in] hits Number of hits
+ * @param[in] accesses Number of accesses
+ */
+static void report_hit_ratio(const char* name, const size_t hits, const size_t accesses) {
+    printf("  %-36s %11.2f%% hit ratio\n", name, accesses == 0 ? 0 : 100.0 * (double)hits / (double)accesses);
+}
+
+static bool bench_lru_cache(
+    const struct cache_benchmark_trace* trace,
+    const size_t capacity,
+    const lru_cache_policy policy,
+    const char* name
+) {
+    lru_cache cache;
+    if (!lru_cache_init(&cache, capacity, 0, policy, trace_key_cmp, trace_key_hash)) {
+        return false;
+    }
+
+    size_t hits = 0;
+    const uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < trace->length; ++i) {
+        if (lru_cache_get(&cache, trace->keys[i]) != NULL) {
+            ++hits;
+        }
+        else {
+            lru_cache_put(&cache, trace->keys[i], trace->keys[i], 0);
+        }
+    }
+    benchmark_report(name, trace->length, benchmark_now_ns() - start);
+    report_hit_ratio(name, hits, trace->length);
+
+    lru_cache_destroy(&cache);
+
+    return true;
+}
+
+static bool bench_tinylfu_cache(const struct cache_benchmark_trace* trace, const size_t capacity) {
+    tinylfu_cache cache;
+    if (!tinylfu_cache_init(&cache, capacity, trace_key_cmp, trace_key_hash)) {
+        return false;
+    }
+
+    size_t hits = 0;
+    const uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < trace->length; ++i) {
+        if (tinylfu_cache_get(&cache, trace->keys[i]) != NULL) {
+            ++hits;
+        }
+        else {
+            tinylfu_cache_put(&cache, trace->keys[i], trace->keys[i]);
+        }
+    }
+    benchmark_report("tinylfu_cache", trace->length, benchmark_now_ns() - start);
+    report_hit_ratio("tinylfu_cache", hits, trace->length);
+
+    tinylfu_cache_destroy(&cache);
+
+    return true;
+}
+
+int run_cache_benchmark(int argc, char** argv) {
+    struct cache_benchmark_trace trace;
+    bool trace_ok;
+
+    if (argc > 0 && !isdigit((unsigned char)argv[0][0])) {
+        printf(" trace: %s\n", argv[0]);
+        trace_ok = init_file_trace(&trace, argv[0]);
+        --argc;
+        ++argv;
+    }
+    else {
+        printf(" trace: synthetic (zipf %.2f over %d keys, %d key scan every %d accesses)\n",
+            ZIPF_EXPONENT, ZIPF_KEY_COUNT, SCAN_LENGTH, SCAN_INTERVAL);
+        trace_ok = init_synthetic_trace(&trace);
+    }
+
+    if (!trace_ok) {
+        return 1;
+    }
+
+    const size_t default_capacities[] = {1000, 10000, 100000};
+    size_t capacities[argc > 3 ? argc : 3];
+    const size_t capacity_count = benchmark_sizes(argc, argv, default_capacities, 3, capacities);
+
+    int result = 0;
+    for (size_t i = 0; i < capacity_count && result == 0; ++i) {
+        printf(" %zu entries, %zu accesses\n", capacities[i], trace.length);
+
+        if (capacities[i] == 0 ||
+            !bench_lru_cache(&trace, capacities[i], LRU_CACHE_POLICY_LRU, "lru_cache (LRU)") ||
+            !bench_lru_cache(&trace, capacities[i], LRU_CACHE_POLICY_CLOCK, "lru_cache (CLOCK)") ||
+            !bench_tinylfu_cache(&trace, capacities[i])) {
+            result = 1;
+        }
+    }
+
+    free(trace.keys);
+
+    return result;
+}
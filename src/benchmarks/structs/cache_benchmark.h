@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * Replay an access trace against lru_cache (LRU and CLOCK) and tinylfu_cache, and compare hit ratios and throughput
+ *
+ * Each access looks the key up, and puts it on a miss (like a read-through cache would).
+ *
+ * Arguments: [trace_file] [capacities...] (default: synthetic trace, capacities 1000 10000 100000)
+ * A trace file has one unsigned integer key per line. The synthetic trace is Zipf distributed over a fixed key set,
+ * interrupted by periodic full scans over keys that are never looked up again.
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_cache_benchmark(int argc, char** argv);
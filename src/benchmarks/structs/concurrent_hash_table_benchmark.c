@@ -0,0 +1,192 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "concurrent_hash_table_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/concurrent_hash_table.h"
+#include "../../structs/hash_table.h"
+
+#define KEY_SIZE 32
+
+/**
+ * Number of keys in the table
+ */
+#define KEY_COUNT 1000000
+
+/**
+ * Total number of operations per run (split between threads)
+ */
+#define TOTAL_OPS 8000000
+
+/**
+ * Percentage of operations that are sets
+ */
+#define SET_PERCENT 10
+
+/**
+ * Table under test, shared by all worker threads
+ */
+struct concurrent_hash_table_benchmark_shared {
+    char (*keys)[KEY_SIZE];
+
+    concurrent_hash_table cht;
+
+    hash_table ht;
+    pthread_mutex_t ht_lock;
+
+    /**
+     * Set when workers should use the mutex-wrapped hash_table instead of the concurrent_hash_table
+     */
+    bool use_mutex;
+};
+
+/**
+ * Worker thread state
+ */
+struct concurrent_hash_table_benchmark_worker {
+    struct concurrent_hash_table_benchmark_shared* shared;
+    pthread_t thread;
+    size_t ops;
+    uint64_t seed;
+    size_t found;
+};
+
+static void* worker_thread(void* arg) {
+    struct concurrent_hash_table_benchmark_worker* worker = arg;
+    struct concurrent_hash_table_benchmark_shared* shared = worker->shared;
+    uint64_t rng = worker->seed;
+
+    for (size_t i = 0; i < worker->ops; ++i) {
+        const uint64_t r = benchmark_rand(&rng);
+        char* key = shared->keys[r % KEY_COUNT];
+        const bool is_set = (r >> 32) % 100 < SET_PERCENT;
+
+        if (shared->use_mutex) {
+            pthread_mutex_lock(&shared->ht_lock);
+            if (is_set) {
+                hash_table_set(&shared->ht, key, key);
+            }
+            else {
+                worker->found += hash_table_get(&shared->ht, key) != NULL;
+            }
+            pthread_mutex_unlock(&shared->ht_lock);
+        }
+        else if (is_set) {
+            concurrent_hash_table_set(&shared->cht, key, key);
+        }
+        else {
+            worker->found += concurrent_hash_table_get(&shared->cht, key) != NULL;
+        }
+    }
+
+    if (!shared->use_mutex) {
+        concurrent_hash_table_thread_detach(&shared->cht);
+    }
+
+    return NULL;
+}
+
+/**
+ * Run the workload with a number of threads
+ *
+ * @param[in,out] shared Shared state
+ * @param[in] name Result name
+ * @param[in] thread_count Number of threads
+ * @return true on success, false on failure
+ */
+static bool run_threads(
+    struct concurrent_hash_table_benchmark_shared* shared,
+    const char* name,
+    const size_t thread_count
+) {
+    struct concurrent_hash_table_benchmark_worker* workers = calloc(
+        thread_count,
+        sizeof(struct concurrent_hash_table_benchmark_worker)
+    );
+    if (workers == NULL) {
+        fprintf(stderr, "failed to allocate %zu workers\n", thread_count);
+        return false;
+    }
+
+    const uint64_t start = benchmark_now_ns();
+    size_t started = 0;
+    for (; started < thread_count; ++started) {
+        workers[started].shared = shared;
+        workers[started].ops = TOTAL_OPS / thread_count;
+        workers[started].seed = 0x9e3779b97f4a7c15ULL * (started + 1);
+        if (pthread_create(&workers[started].thread, NULL, worker_thread, &workers[started]) != 0) {
+            fprintf(stderr, "failed to start thread %zu\n", started);
+            break;
+        }
+    }
+
+    size_t ops = 0;
+    for (size_t t = 0; t < started; ++t) {
+        pthread_join(workers[t].thread, NULL);
+        ops += workers[t].ops;
+    }
+
+    char result_name[64];
+    snprintf(result_name, sizeof(result_name), "%s (%zu threads)", name, thread_count);
+    benchmark_report(result_name, ops, benchmark_now_ns() - start);
+
+    free(workers);
+
+    return started == thread_count;
+}
+
+int run_concurrent_hash_table_benchmark(const int argc, char** argv) {
+    const size_t default_threads[] = {1, 2, 4, 8, 16, 32, 64};
+    size_t thread_counts[argc > 7 ? argc : 7];
+    const size_t thread_count_count = benchmark_sizes(argc, argv, default_threads, 7, thread_counts);
+
+    struct concurrent_hash_table_benchmark_shared shared;
+    shared.keys = malloc(KEY_COUNT * KEY_SIZE);
+    if (shared.keys == NULL) {
+        fprintf(stderr, "failed to allocate benchmark keys\n");
+        return 1;
+    }
+
+    if (!concurrent_hash_table_init(&shared.cht, KEY_COUNT, 0, NULL, NULL)) {
+        free(shared.keys);
+        return 1;
+    }
+
+    if (!hash_table_init(&shared.ht, KEY_COUNT, NULL, NULL)) {
+        concurrent_hash_table_destroy(&shared.cht);
+        free(shared.keys);
+        return 1;
+    }
+
+    pthread_mutex_init(&shared.ht_lock, NULL);
+
+    for (size_t i = 0; i < KEY_COUNT; ++i) {
+        snprintf(shared.keys[i], KEY_SIZE, "key:%zu", i);
+        concurrent_hash_table_set(&shared.cht, shared.keys[i], shared.keys[i]);
+        hash_table_set(&shared.ht, shared.keys[i], shared.keys[i]);
+    }
+
+    printf(" %d keys, %d%% sets\n", KEY_COUNT, SET_PERCENT);
+
+    bool ok = true;
+    for (size_t i = 0; i < thread_count_count && ok; ++i) {
+        if (thread_counts[i] == 0) {
+            ok = false;
+            break;
+        }
+
+        shared.use_mutex = false;
+        ok = run_threads(&shared, "concurrent_hash_table", thread_counts[i]);
+
+        shared.use_mutex = true;
+        ok = ok && run_threads(&shared, "hash_table + mutex", thread_counts[i]);
+    }
+
+    pthread_mutex_destroy(&shared.ht_lock);
+    hash_table_destroy(&shared.ht);
+    concurrent_hash_table_destroy(&shared.cht);
+    free(shared.keys);
+
+    return ok ? 0 : 1;
+}
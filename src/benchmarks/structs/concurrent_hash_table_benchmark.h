@@ -0,0 +1,13 @@
+#pragma once
+
+/**
+ * Measure get/set throughput of concurrent_hash_table against a hash_table behind one global mutex, as the number of
+ * threads grows (90% gets, 10% sets of random existing keys)
+ *
+ * Arguments: [thread counts...] (default: 1 2 4 8 16 32 64)
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_concurrent_hash_table_benchmark(int argc, char** argv);
@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "filter_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/binary_fuse_filter.h"
+#include "../../structs/blocked_bloom_filter.h"
+#include "../../structs/bloom_filter.h"
+#include "../../structs/counting_bloom_filter.h"
+#include "../../structs/cuckoo_filter.h"
+#include "../../structs/scalable_bloom_filter.h"
+
+/**
+ * Target false positive rates every filter is sized for
+ */
+static const double target_fprs[] = {0.01, 0.001};
+
+/**
+ * Number of keys the scalable filter's first sub-filter is sized for, relative to the number of keys added
+ */
+#define SCALABLE_INITIAL_RATIO 1000
+
+/**
+ * Benchmark inputs
+ */
+struct filter_benchmark_keys {
+    size_t count;
+
+    /**
+     * Keys to add, and the same number of keys that are never added (in random order)
+     */
+    uint64_t* keys;
+    uint64_t* other_keys;
+};
+
+static bool init_keys(struct filter_benchmark_keys* keys, const size_t count) {
+    keys->count = count;
+    keys->keys = malloc(count * sizeof(uint64_t));
+    keys->other_keys = malloc(count * sizeof(uint64_t));
+    if (keys->keys == NULL || keys->other_keys == NULL) {
+        fprintf(stderr, "failed to allocate %zu benchmark keys\n", count * 2);
+        return false;
+    }
+
+    // Even numbers are added and odd numbers aren't, so the two sets never overlap
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < count; ++i) {
+        keys->keys[i] = benchmark_rand(&rng) & ~1ULL;
+        keys->other_keys[i] = benchmark_rand(&rng) | 1ULL;
+    }
+
+    return true;
+}
+
+static void destroy_keys(struct filter_benchmark_keys* keys) {
+    free(keys->keys);
+    free(keys->other_keys);
+}
+
+/**
+ * Print the measured false positive rate and memory use of a filter
+ *
+ * @param[in] keys Benchmark inputs
+ * @param[in] false_positives Number of other keys the filter matched
+ * @param[in] bytes Size of the filter
+ */
+static void report_accuracy(
+    const struct filter_benchmark_keys* keys,
+    const size_t false_positives,
+    const size_t bytes
+) {
+    printf(
+        "  %-36s %11.3f%% fpr %10.2f bits/key\n",
+        "accuracy",
+        100.0 * (double)false_positives / (double)keys->count,
+        8.0 * (double)bytes / (double)keys->count
+    );
+}
+
+/**
+ * Check that a filter found every key that was added
+ *
+ * @param[in] found Number of added keys the filter matched
+ * @param[in] count Number of added keys
+ * @return true if there were no false negatives, false otherwise
+ */
+static bool check_found(const size_t found, const size_t count) {
+    if (found != count) {
+        fprintf(stderr, "found %zu keys, expected %zu\n", found, count);
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_bloom_filter(const struct filter_benchmark_keys* keys, const double fpr) {
+    bloom_filter bf;
+    if (!bloom_filter_init_with_fpr(&bf, keys->count, fpr)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        bloom_filter_add(&bf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("bloom_filter_add", keys->count, benchmark_now_ns() - start);
+
+    size_t found = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        found += bloom_filter_check(&bf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("bloom_filter_check (hit)", keys->count, benchmark_now_ns() - start);
+
+    size_t false_positives = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        false_positives += bloom_filter_check(&bf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("bloom_filter_check (miss)", keys->count, benchmark_now_ns() - start);
+    report_accuracy(keys, false_positives, bf.bit_array->size_bits / 8);
+
+    bloom_filter_destroy(&bf);
+
+    return check_found(found, keys->count);
+}
+
+static bool bench_blocked_bloom_filter(const struct filter_benchmark_keys* keys, const double fpr) {
+    blocked_bloom_filter bf;
+    if (!blocked_bloom_filter_init_with_fpr(&bf, keys->count, fpr)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        blocked_bloom_filter_add(&bf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("blocked_bloom_filter_add", keys->count, benchmark_now_ns() - start);
+
+    size_t found = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        found += blocked_bloom_filter_check(&bf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("blocked_bloom_filter_check (hit)", keys->count, benchmark_now_ns() - start);
+
+    size_t false_positives = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        false_positives += blocked_bloom_filter_check(&bf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("blocked_bloom_filter_check (miss)", keys->count, benchmark_now_ns() - start);
+    report_accuracy(keys, false_positives, blocked_bloom_filter_bytes(&bf));
+
+    blocked_bloom_filter_destroy(&bf);
+
+    return check_found(found, keys->count);
+}
+
+static bool bench_counting_bloom_filter(const struct filter_benchmark_keys* keys, const double fpr) {
+    counting_bloom_filter cbf;
+    if (!counting_bloom_filter_init_with_fpr(&cbf, keys->count, fpr)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        counting_bloom_filter_add(&cbf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("counting_bloom_filter_add", keys->count, benchmark_now_ns() - start);
+
+    size_t found = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        found += counting_bloom_filter_check(&cbf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("counting_bloom_filter_check (hit)", keys->count, benchmark_now_ns() - start);
+
+    size_t false_positives = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        false_positives += counting_bloom_filter_check(&cbf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("counting_bloom_filter_check (miss)", keys->count, benchmark_now_ns() - start);
+    report_accuracy(keys, false_positives, cbf.size / 2);
+
+    // Compacting replaces rebuilding a bloom_filter from every key (reported per counter)
+    bloom_filter bf;
+    start = benchmark_now_ns();
+    const bool ok = counting_bloom_filter_compact(&cbf, &bf);
+    benchmark_report("counting_bloom_filter_compact", cbf.size, benchmark_now_ns() - start);
+    if (ok) {
+        bloom_filter_destroy(&bf);
+    }
+
+    // Churn: remove a key and add one that wasn't there
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        counting_bloom_filter_remove(&cbf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+        counting_bloom_filter_add(&cbf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("counting_bloom_filter_remove + add", keys->count, benchmark_now_ns() - start);
+
+    const size_t saturated = counting_bloom_filter_saturated(&cbf);
+    if (saturated > 0) {
+        printf("  %zu saturated counters\n", saturated);
+    }
+
+    counting_bloom_filter_destroy(&cbf);
+
+    return ok && check_found(found, keys->count);
+}
+
+static bool bench_scalable_bloom_filter(const struct filter_benchmark_keys* keys, const double fpr) {
+    scalable_bloom_filter sbf;
+    const size_t initial_capacity = keys->count / SCALABLE_INITIAL_RATIO > 0 ? keys->count / SCALABLE_INITIAL_RATIO : 1;
+    if (!scalable_bloom_filter_init(&sbf, initial_capacity, fpr)) {
+        return false;
+    }
+
+    bool ok = true;
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count && ok; ++i) {
+        ok = scalable_bloom_filter_add(&sbf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("scalable_bloom_filter_add", keys->count, benchmark_now_ns() - start);
+
+    size_t found = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        found += scalable_bloom_filter_check(&sbf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("scalable_bloom_filter_check (hit)", keys->count, benchmark_now_ns() - start);
+
+    size_t false_positives = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        false_positives += scalable_bloom_filter_check(&sbf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("scalable_bloom_filter_check (miss)", keys->count, benchmark_now_ns() - start);
+    report_accuracy(keys, false_positives, scalable_bloom_filter_bytes(&sbf));
+    printf(
+        "  %zu sub-filters from %zu keys, %.3f%% estimated fpr\n",
+        sbf.filter_count,
+        initial_capacity,
+        100 * scalable_bloom_filter_fpr(&sbf)
+    );
+
+    scalable_bloom_filter_destroy(&sbf);
+
+    return ok && check_found(found, keys->count);
+}
+
+static bool bench_cuckoo_filter(const struct filter_benchmark_keys* keys, const double fpr) {
+    cuckoo_filter cf;
+    if (!cuckoo_filter_init_with_fpr(&cf, keys->count, fpr)) {
+        return false;
+    }
+
+    bool ok = true;
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count && ok; ++i) {
+        ok = cuckoo_filter_add(&cf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("cuckoo_filter_add", keys->count, benchmark_now_ns() - start);
+    if (!ok) {
+        fprintf(stderr, "cuckoo filter is full after %zu keys\n", cuckoo_filter_size(&cf));
+    }
+
+    size_t found = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        found += cuckoo_filter_check(&cf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("cuckoo_filter_check (hit)", keys->count, benchmark_now_ns() - start);
+
+    size_t false_positives = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        false_positives += cuckoo_filter_check(&cf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("cuckoo_filter_check (miss)", keys->count, benchmark_now_ns() - start);
+    report_accuracy(keys, false_positives, cuckoo_filter_bytes(&cf));
+
+    // Churn: remove a key and add one that wasn't there
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count && ok; ++i) {
+        cuckoo_filter_remove(&cf, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+        ok = cuckoo_filter_add(&cf, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("cuckoo_filter_remove + add", keys->count, benchmark_now_ns() - start);
+
+    cuckoo_filter_destroy(&cf);
+
+    return ok && check_found(found, keys->count);
+}
+
+static bool bench_binary_fuse_filter(const struct filter_benchmark_keys* keys) {
+    uint64_t* hashes = malloc(keys->count * sizeof(uint64_t));
+    if (hashes == NULL) {
+        fprintf(stderr, "failed to allocate %zu key hashes\n", keys->count);
+        return false;
+    }
+
+    // Built from every key at once (hashing is included in the build time)
+    binary_fuse_filter bff;
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        hashes[i] = binary_fuse_filter_hash((const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    const bool ok = binary_fuse_filter_build_hashes(&bff, hashes, keys->count);
+    benchmark_report("binary_fuse_filter_build", keys->count, benchmark_now_ns() - start);
+
+    free(hashes);
+    if (!ok) {
+        return false;
+    }
+
+    size_t found = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        found += binary_fuse_filter_check(&bff, (const uint8_t *)&keys->keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("binary_fuse_filter_check (hit)", keys->count, benchmark_now_ns() - start);
+
+    size_t false_positives = 0;
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->count; ++i) {
+        false_positives += binary_fuse_filter_check(&bff, (const uint8_t *)&keys->other_keys[i], sizeof(uint64_t));
+    }
+    benchmark_report("binary_fuse_filter_check (miss)", keys->count, benchmark_now_ns() - start);
+    report_accuracy(keys, false_positives, binary_fuse_filter_bytes(&bff));
+
+    binary_fuse_filter_destroy(&bff);
+
+    return check_found(found, keys->count);
+}
+
+int run_filter_benchmark(const int argc, char** argv) {
+    const size_t default_sizes[] = {10000000};
+    size_t sizes[argc > 1 ? argc : 1];
+    const size_t size_count = benchmark_sizes(argc, argv, default_sizes, 1, sizes);
+
+    for (size_t i = 0; i < size_count; ++i) {
+        struct filter_benchmark_keys keys;
+        if (!init_keys(&keys, sizes[i])) {
+            destroy_keys(&keys);
+            return 1;
+        }
+
+        bool ok = true;
+        for (size_t j = 0; j < sizeof(target_fprs) / sizeof(double) && ok; ++j) {
+            printf(" %zu keys, %.1f%% target false positive rate\n", sizes[i], 100 * target_fprs[j]);
+            ok = bench_bloom_filter(&keys, target_fprs[j]) &&
+                 bench_blocked_bloom_filter(&keys, target_fprs[j]) &&
+                 bench_counting_bloom_filter(&keys, target_fprs[j]) &&
+                 bench_scalable_bloom_filter(&keys, target_fprs[j]) &&
+                 bench_cuckoo_filter(&keys, target_fprs[j]);
+        }
+
+        // The binary fuse filter's rate is fixed by its 8-bit fingerprints
+        if (ok) {
+            printf(" %zu keys, 0.4%% false positive rate\n", sizes[i]);
+            ok = bench_binary_fuse_filter(&keys);
+        }
+        destroy_keys(&keys);
+
+        if (!ok) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * Compare memory, false positive rate and throughput of the approximate membership filters: bloom_filter,
+ * blocked_bloom_filter, counting_bloom_filter, scalable_bloom_filter and cuckoo_filter, sized for the same number of
+ * keys at target false positive rates of 1% and 0.1%, and binary_fuse_filter (which has a fixed rate of about 0.4%).
+ * The scalable filter starts out sized for 1/1000th of the keys, and grows.
+ *
+ * Reports add (or build) throughput, check throughput for keys that were added and for keys that weren't, and the
+ * measured false positive rate and memory (bits per key) of each filter. The filters that support removing keys also
+ * report churn (removing an added key and adding a new one), and the counting filter reports compaction.
+ *
+ * Arguments: [keys...] (default: 10000000)
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_filter_benchmark(int argc, char** argv);
@@ -0,0 +1,350 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "flat_hash_table_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/cuckoo_hash_table.h"
+#include "../../structs/flat_hash_table.h"
+#include "../../structs/hash_table.h"
+
+#define KEY_SIZE 32
+
+/**
+ * Max number of operations timed individually for latency percentiles (evenly spread over the keys)
+ */
+#define LATENCY_SAMPLES (1 << 20)
+
+/**
+ * Benchmark inputs shared by both tables
+ */
+struct flat_hash_table_benchmark_keys {
+    size_t count;
+
+    /**
+     * Keys that get inserted
+     */
+    char (*keys)[KEY_SIZE];
+
+    /**
+     * Keys that are never inserted
+     */
+    char (*missing_keys)[KEY_SIZE];
+
+    /**
+     * Random permutation of [0, count) used as the lookup order
+     */
+    size_t* order;
+};
+
+static bool init_keys(struct flat_hash_table_benchmark_keys* keys, const size_t count) {
+    keys->count = count;
+    keys->keys = malloc(count * KEY_SIZE);
+    keys->missing_keys = malloc(count * KEY_SIZE);
+    keys->order = malloc(count * sizeof(size_t));
+    if (keys->keys == NULL || keys->missing_keys == NULL || keys->order == NULL) {
+        fprintf(stderr, "failed to allocate benchmark keys for %zu entries\n", count);
+        return false;
+    }
+
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(keys->keys[i], KEY_SIZE, "key:%zu", i);
+        snprintf(keys->missing_keys[i], KEY_SIZE, "missing:%zu", i);
+        keys->order[i] = i;
+    }
+
+    // Fisher-Yates shuffle so lookups don't follow insertion order
+    for (size_t i = count - 1; i > 0; --i) {
+        const size_t j = benchmark_rand(&rng) % (i + 1);
+        const size_t tmp = keys->order[i];
+        keys->order[i] = keys->order[j];
+        keys->order[j] = tmp;
+    }
+
+    return true;
+}
+
+static void destroy_keys(struct flat_hash_table_benchmark_keys* keys) {
+    free(keys->keys);
+    free(keys->missing_keys);
+    free(keys->order);
+}
+
+static bool bench_hash_table(const struct flat_hash_table_benchmark_keys* keys) {
+    const size_t count = keys->count;
+    size_t found = 0;
+    hash_table ht;
+
+    if (!hash_table_init(&ht, count, NULL, NULL)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        hash_table_set(&ht, keys->keys[i], keys->keys[i]);
+    }
+    benchmark_report("hash_table insert", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        found += hash_table_get(&ht, keys->keys[keys->order[i]]) != NULL;
+    }
+    benchmark_report("hash_table get (hit)", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        found += hash_table_get(&ht, keys->missing_keys[i]) != NULL;
+    }
+    benchmark_report("hash_table get (miss)", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        hash_table_del(&ht, keys->keys[keys->order[i]]);
+    }
+    benchmark_report("hash_table del", count, benchmark_now_ns() - start);
+
+    hash_table_destroy(&ht);
+
+    if (found != count) {
+        fprintf(stderr, "hash_table found %zu of %zu keys\n", found, count);
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_flat_hash_table(const struct flat_hash_table_benchmark_keys* keys) {
+    const size_t count = keys->count;
+    size_t found = 0;
+    flat_hash_table ft;
+
+    if (!flat_hash_table_init(&ft, count, NULL, NULL)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        flat_hash_table_set(&ft, keys->keys[i], keys->keys[i]);
+    }
+    benchmark_report("flat_hash_table insert", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        found += flat_hash_table_get(&ft, keys->keys[keys->order[i]]) != NULL;
+    }
+    benchmark_report("flat_hash_table get (hit)", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        found += flat_hash_table_get(&ft, keys->missing_keys[i]) != NULL;
+    }
+    benchmark_report("flat_hash_table get (miss)", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        flat_hash_table_del(&ft, keys->keys[keys->order[i]]);
+    }
+    benchmark_report("flat_hash_table del", count, benchmark_now_ns() - start);
+
+    flat_hash_table_destroy(&ft);
+
+    if (found != count) {
+        fprintf(stderr, "flat_hash_table found %zu of %zu keys\n", found, count);
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_cuckoo_hash_table(const struct flat_hash_table_benchmark_keys* keys) {
+    const size_t count = keys->count;
+    size_t found = 0;
+    cuckoo_hash_table ct;
+
+    if (!cuckoo_hash_table_init(&ct, count, NULL, NULL)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        cuckoo_hash_table_set(&ct, keys->keys[i], keys->keys[i]);
+    }
+    benchmark_report("cuckoo_hash_table insert", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        found += cuckoo_hash_table_get(&ct, keys->keys[keys->order[i]]) != NULL;
+    }
+    benchmark_report("cuckoo_hash_table get (hit)", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        found += cuckoo_hash_table_get(&ct, keys->missing_keys[i]) != NULL;
+    }
+    benchmark_report("cuckoo_hash_table get (miss)", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        cuckoo_hash_table_del(&ct, keys->keys[keys->order[i]]);
+    }
+    benchmark_report("cuckoo_hash_table del", count, benchmark_now_ns() - start);
+
+    cuckoo_hash_table_destroy(&ct);
+
+    if (found != count) {
+        fprintf(stderr, "cuckoo_hash_table found %zu of %zu keys\n", found, count);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Table operations used by the latency benchmark
+ */
+struct flat_hash_table_benchmark_table {
+    const char* insert_name;
+    const char* get_name;
+    bool (*init)(void* table, size_t count);
+    bool (*set)(void* table, void* key, void* value);
+    void* (*get)(const void* table, const void* key);
+    bool (*destroy)(void* table);
+};
+
+/**
+ * Define the latency benchmark operations of a table type, which has the same surface as hash_table
+ *
+ * @param type Table type (and function prefix)
+ */
+#define LATENCY_TABLE_OPS(type) \
+    static bool type##_latency_init(void* table, const size_t count) { \
+        return type##_init(table, count, NULL, NULL); \
+    } \
+    static bool type##_latency_set(void* table, void* key, void* value) { \
+        return type##_set(table, key, value); \
+    } \
+    static void* type##_latency_get(const void* table, const void* key) { \
+        return type##_get(table, key); \
+    } \
+    static bool type##_latency_destroy(void* table) { \
+        return type##_destroy(table); \
+    }
+
+#define LATENCY_TABLE(type) { \
+    #type " insert latency", \
+    #type " get (hit) latency", \
+    type##_latency_init, \
+    type##_latency_set, \
+    type##_latency_get, \
+    type##_latency_destroy, \
+}
+
+LATENCY_TABLE_OPS(hash_table)
+LATENCY_TABLE_OPS(flat_hash_table)
+LATENCY_TABLE_OPS(cuckoo_hash_table)
+
+static const struct flat_hash_table_benchmark_table latency_tables[] = {
+    LATENCY_TABLE(hash_table),
+    LATENCY_TABLE(flat_hash_table),
+    LATENCY_TABLE(cuckoo_hash_table),
+};
+
+/**
+ * Time individual inserts and hit lookups, and report their latency percentiles
+ * Tail latency is what cuckoo_hash_table bounds, and it doesn't show in the mean of a bulk run.
+ *
+ * @param[in] keys Benchmark keys
+ * @param[in] ops Table operations
+ * @param[out] latencies Buffer for at least LATENCY_SAMPLES latencies
+ * @return true on success, false on failure
+ */
+static bool bench_latency(
+    const struct flat_hash_table_benchmark_keys* keys,
+    const struct flat_hash_table_benchmark_table* ops,
+    uint64_t* latencies
+) {
+    const size_t count = keys->count;
+    const size_t stride = (count + LATENCY_SAMPLES - 1) / LATENCY_SAMPLES;
+    size_t found = 0;
+    size_t samples = 0;
+
+    union {
+        hash_table ht;
+        flat_hash_table ft;
+        cuckoo_hash_table ct;
+    } table;
+
+    if (!ops->init(&table, count)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (i % stride != 0) {
+            ops->set(&table, keys->keys[i], keys->keys[i]);
+            continue;
+        }
+
+        const uint64_t start = benchmark_now_ns();
+        ops->set(&table, keys->keys[i], keys->keys[i]);
+        latencies[samples++] = benchmark_now_ns() - start;
+    }
+    benchmark_report_latency(ops->insert_name, latencies, samples);
+
+    samples = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % stride != 0) {
+            found += ops->get(&table, keys->keys[keys->order[i]]) != NULL;
+            continue;
+        }
+
+        const uint64_t start = benchmark_now_ns();
+        found += ops->get(&table, keys->keys[keys->order[i]]) != NULL;
+        latencies[samples++] = benchmark_now_ns() - start;
+    }
+    benchmark_report_latency(ops->get_name, latencies, samples);
+
+    ops->destroy(&table);
+
+    if (found != count) {
+        fprintf(stderr, "%s found %zu of %zu keys\n", ops->get_name, found, count);
+        return false;
+    }
+
+    return true;
+}
+
+int run_flat_hash_table_benchmark(const int argc, char** argv) {
+    const size_t default_sizes[] = {1000, 1000000, 50000000};
+    size_t sizes[argc > 3 ? argc : 3];
+    const size_t size_count = benchmark_sizes(argc, argv, default_sizes, 3, sizes);
+
+    for (size_t i = 0; i < size_count; ++i) {
+        struct flat_hash_table_benchmark_keys keys;
+        printf(" %zu keys\n", sizes[i]);
+
+        if (sizes[i] == 0 || !init_keys(&keys, sizes[i])) {
+            return 1;
+        }
+
+        bool ok = bench_hash_table(&keys) && bench_flat_hash_table(&keys) && bench_cuckoo_hash_table(&keys);
+
+        uint64_t* latencies = malloc(LATENCY_SAMPLES * sizeof(uint64_t));
+        if (latencies == NULL) {
+            fprintf(stderr, "failed to allocate benchmark latencies\n");
+            ok = false;
+        }
+
+        for (size_t t = 0; t < sizeof(latency_tables) / sizeof(latency_tables[0]) && ok; ++t) {
+            ok = bench_latency(&keys, &latency_tables[t], latencies);
+        }
+
+        free(latencies);
+        destroy_keys(&keys);
+
+        if (!ok) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
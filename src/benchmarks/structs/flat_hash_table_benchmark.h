@@ -0,0 +1,12 @@
+#pragma once
+
+/**
+ * Compare flat_hash_table and cuckoo_hash_table against hash_table for insert, hit, miss and delete workloads
+ *
+ * Arguments: [sizes...] (default: 1000 1000000 50000000)
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_flat_hash_table_benchmark(int argc, char** argv);
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hash_aggregate_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/hash_aggregate.h"
+
+#define KEY_SIZE 32
+
+/**
+ * Benchmark dataset
+ */
+struct hash_aggregate_benchmark_rows {
+    size_t count;
+    size_t groups;
+
+    /**
+     * Group key storage
+     */
+    char (*group_keys)[KEY_SIZE];
+
+    /**
+     * Group key of each row
+     */
+    void** keys;
+
+    /**
+     * Value of each row
+     */
+    int64_t* values;
+
+    /**
+     * Expected sum of all values
+     */
+    int64_t sum;
+};
+
+static bool init_rows(struct hash_aggregate_benchmark_rows* rows, const size_t count, const size_t groups) {
+    rows->count = count;
+    rows->groups = groups;
+    rows->group_keys = malloc(groups * KEY_SIZE);
+    rows->keys = malloc(count * sizeof(void*));
+    rows->values = malloc(count * sizeof(int64_t));
+    rows->sum = 0;
+    if (rows->group_keys == NULL || rows->keys == NULL || rows->values == NULL) {
+        fprintf(stderr, "failed to allocate %zu benchmark rows\n", count);
+        return false;
+    }
+
+    for (size_t i = 0; i < groups; ++i) {
+        snprintf(rows->group_keys[i], KEY_SIZE, "group:%zu", i);
+    }
+
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < count; ++i) {
+        // The first rows cover every group, so the number of groups is exact
+        rows->keys[i] = rows->group_keys[i < groups ? i : benchmark_rand(&rng) % groups];
+        rows->values[i] = (int64_t)(benchmark_rand(&rng) % 1000);
+        rows->sum += rows->values[i];
+    }
+
+    return true;
+}
+
+static void destroy_rows(struct hash_aggregate_benchmark_rows* rows) {
+    free(rows->group_keys);
+    free(rows->keys);
+    free(rows->values);
+}
+
+/**
+ * Group state for the hash_table baseline
+ */
+struct hash_aggregate_benchmark_state {
+    uint64_t count;
+    int64_t sum;
+    int64_t min;
+    int64_t max;
+};
+
+static bool bench_get_set(const struct hash_aggregate_benchmark_rows* rows) {
+    hash_table ht;
+    if (!hash_table_init(&ht, 1024, NULL, NULL)) {
+        return false;
+    }
+
+    bool ok = true;
+    const uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < rows->count && ok; ++i) {
+        struct hash_aggregate_benchmark_state* p_state = hash_table_get(&ht, rows->keys[i]);
+        if (p_state == NULL) {
+            p_state = malloc(sizeof(struct hash_aggregate_benchmark_state));
+            ok = p_state != NULL && hash_table_set(&ht, rows->keys[i], p_state);
+            if (!ok) {
+                free(p_state);
+                break;
+            }
+
+            p_state->count = 0;
+            p_state->sum = 0;
+            p_state->min = INT64_MAX;
+            p_state->max = INT64_MIN;
+        }
+
+        const int64_t value = rows->values[i];
+        ++p_state->count;
+        p_state->sum += value;
+        p_state->min = value < p_state->min ? value : p_state->min;
+        p_state->max = value > p_state->max ? value : p_state->max;
+    }
+    benchmark_report("hash_table_get + hash_table_set", rows->count, benchmark_now_ns() - start);
+
+    void** states = malloc(hash_table_size(&ht) * sizeof(void*));
+    if (states != NULL) {
+        const size_t count = hash_table_values(&ht, states);
+        for (size_t i = 0; i < count; ++i) {
+            free(states[i]);
+        }
+    }
+    free(states);
+
+    ok = ok && hash_table_size(&ht) == rows->groups;
+    hash_table_destroy(&ht);
+
+    return ok;
+}
+
+static void total_iter_func(const void* _key, const hash_aggregate_state* state, void* totals) {
+    ((int64_t *)totals)[0] += (int64_t)state->count;
+    ((int64_t *)totals)[1] += state->sum;
+}
+
+/**
+ * Check that an aggregate counted every row
+ *
+ * @param[in] rows Benchmark dataset
+ * @param[in] agg Aggregate of the dataset
+ * @return true if the totals match, false otherwise
+ */
+static bool check_totals(const struct hash_aggregate_benchmark_rows* rows, const hash_aggregate* agg) {
+    int64_t totals[2] = {0, 0};
+    hash_aggregate_iter(agg, total_iter_func, totals);
+
+    if (hash_aggregate_size(agg) != rows->groups || totals[0] != (int64_t)rows->count || totals[1] != rows->sum) {
+        fprintf(stderr, "aggregated %zu groups, %ld rows\n", hash_aggregate_size(agg), (long)totals[0]);
+        return false;
+    }
+
+    return true;
+}
+
+static bool bench_aggregate(const struct hash_aggregate_benchmark_rows* rows) {
+    hash_aggregate agg;
+    if (!hash_aggregate_init(&agg, 1024, NULL, NULL)) {
+        return false;
+    }
+
+    bool ok = true;
+    const uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < rows->count && ok; ++i) {
+        ok = hash_aggregate_add(&agg, rows->keys[i], rows->values[i]);
+    }
+    benchmark_report("hash_aggregate_add", rows->count, benchmark_now_ns() - start);
+
+    ok = ok && check_totals(rows, &agg);
+    hash_aggregate_destroy(&agg);
+
+    return ok;
+}
+
+static bool bench_aggregate_parallel(const struct hash_aggregate_benchmark_rows* rows) {
+    hash_aggregate agg;
+    if (!hash_aggregate_init(&agg, 1024, NULL, NULL)) {
+        return false;
+    }
+
+    const uint64_t start = benchmark_now_ns();
+    bool ok = hash_aggregate_add_parallel(&agg, rows->keys, rows->values, rows->count, 0);
+    benchmark_report("hash_aggregate_add_parallel", rows->count, benchmark_now_ns() - start);
+
+    ok = ok && check_totals(rows, &agg);
+    hash_aggregate_destroy(&agg);
+
+    return ok;
+}
+
+int run_hash_aggregate_benchmark(const int argc, char** argv) {
+    const size_t default_sizes[] = {100000000};
+    const size_t group_counts[] = {1000, 1000000};
+    size_t sizes[argc > 1 ? argc : 1];
+    const size_t size_count = benchmark_sizes(argc, argv, default_sizes, 1, sizes);
+
+    for (size_t i = 0; i < size_count; ++i) {
+        for (size_t g = 0; g < sizeof(group_counts) / sizeof(group_counts[0]); ++g) {
+            struct hash_aggregate_benchmark_rows rows;
+            printf(" %zu rows, %zu groups\n", sizes[i], group_counts[g]);
+
+            if (sizes[i] < group_counts[g]) {
+                continue; // Not every group would have rows
+            }
+
+            if (!init_rows(&rows, sizes[i], group_counts[g])) {
+                destroy_rows(&rows);
+                return 1;
+            }
+
+            const bool ok = bench_get_set(&rows) && bench_aggregate(&rows) && bench_aggregate_parallel(&rows);
+            destroy_rows(&rows);
+
+            if (!ok) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
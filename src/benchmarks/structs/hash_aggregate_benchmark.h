@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * Compare GROUP BY aggregation of a synthetic dataset with hash_table_get() + hash_table_set() (allocating each group's
+ * state), hash_aggregate_add(), and hash_aggregate_add_parallel() on every CPU
+ *
+ * Each row has a group key (uniformly picked from a fixed set of groups) and a value. Runs are repeated for 1000 and
+ * 1000000 groups.
+ *
+ * Arguments: [rows...] (default: 100000000)
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_hash_aggregate_benchmark(int argc, char** argv);
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hash_table_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/hash_table.h"
+
+#define KEY_SIZE 32
+
+/**
+ * Number of keys passed to each batch call
+ */
+#define BATCH_SIZE 256
+
+/**
+ * Benchmark inputs
+ */
+struct hash_table_benchmark_keys {
+    size_t count;
+
+    /**
+     * Key storage
+     */
+    char (*keys)[KEY_SIZE];
+
+    /**
+     * Key pointers in random order (half of them are never inserted)
+     */
+    void** lookup_keys;
+
+    /**
+     * Value pointers from lookups
+     */
+    void** values;
+};
+
+static bool init_keys(struct hash_table_benchmark_keys* keys, const size_t count) {
+    keys->count = count;
+    keys->keys = malloc(count * 2 * KEY_SIZE);
+    keys->lookup_keys = malloc(count * 2 * sizeof(void*));
+    keys->values = malloc(count * 2 * sizeof(void*));
+    if (keys->keys == NULL || keys->lookup_keys == NULL || keys->values == NULL) {
+        fprintf(stderr, "failed to allocate benchmark keys for %zu entries\n", count);
+        return false;
+    }
+
+    for (size_t i = 0; i < count * 2; ++i) {
+        snprintf(keys->keys[i], KEY_SIZE, "key:%zu", i);
+        keys->lookup_keys[i] = keys->keys[i];
+    }
+
+    // Fisher-Yates shuffle so inserts and lookups jump around the table
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = count * 2 - 1; i > 0; --i) {
+        const size_t j = benchmark_rand(&rng) % (i + 1);
+        void* tmp = keys->lookup_keys[i];
+        keys->lookup_keys[i] = keys->lookup_keys[j];
+        keys->lookup_keys[j] = tmp;
+    }
+
+    return true;
+}
+
+static void destroy_keys(struct hash_table_benchmark_keys* keys) {
+    free(keys->keys);
+    free(keys->lookup_keys);
+    free(keys->values);
+}
+
+static bool bench_single(const struct hash_table_benchmark_keys* keys, size_t* found) {
+    const size_t count = keys->count;
+    hash_table ht;
+
+    if (!hash_table_init(&ht, count, NULL, NULL)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < count; ++i) {
+        hash_table_set(&ht, keys->lookup_keys[i], keys->lookup_keys[i]);
+    }
+    benchmark_report("hash_table_set", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count * 2; ++i) {
+        keys->values[i] = hash_table_get(&ht, keys->lookup_keys[i]);
+        *found += keys->values[i] != NULL;
+    }
+    benchmark_report("hash_table_get", count * 2, benchmark_now_ns() - start);
+
+    hash_table_destroy(&ht);
+
+    return true;
+}
+
+static bool bench_batch(const struct hash_table_benchmark_keys* keys, size_t* found) {
+    const size_t count = keys->count;
+    hash_table ht;
+
+    if (!hash_table_init(&ht, count, NULL, NULL)) {
+        return false;
+    }
+
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < count; i += BATCH_SIZE) {
+        const size_t n = count - i < BATCH_SIZE ? count - i : BATCH_SIZE;
+        hash_table_set_many(&ht, keys->lookup_keys + i, keys->lookup_keys + i, n);
+    }
+    benchmark_report("hash_table_set_many", count, benchmark_now_ns() - start);
+
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < count * 2; i += BATCH_SIZE) {
+        const size_t n = count * 2 - i < BATCH_SIZE ? count * 2 - i : BATCH_SIZE;
+        *found += hash_table_get_many(&ht, keys->lookup_keys + i, n, keys->values + i);
+    }
+    benchmark_report("hash_table_get_many", count * 2, benchmark_now_ns() - start);
+
+    hash_table_destroy(&ht);
+
+    return true;
+}
+
+static bool bench_bulk_load(const struct hash_table_benchmark_keys* keys, const size_t threads, size_t* found) {
+    const size_t count = keys->count;
+    hash_table ht;
+
+    if (!hash_table_init(&ht, count, NULL, NULL)) {
+        return false;
+    }
+
+    char name[64];
+    if (threads == 0) {
+        snprintf(name, sizeof(name), "hash_table_bulk_load (all CPUs)");
+    }
+    else {
+        snprintf(name, sizeof(name), "hash_table_bulk_load (%zu threads)", threads);
+    }
+
+    const uint64_t start = benchmark_now_ns();
+    if (!hash_table_bulk_load(&ht, keys->lookup_keys, keys->lookup_keys, count, threads)) {
+        hash_table_destroy(&ht);
+        return false;
+    }
+    benchmark_report(name, count, benchmark_now_ns() - start);
+
+    *found = hash_table_size(&ht);
+    hash_table_destroy(&ht);
+
+    return true;
+}
+
+int run_hash_table_benchmark(const int argc, char** argv) {
+    const size_t default_sizes[] = {10000, 10000000};
+    size_t sizes[argc > 2 ? argc : 2];
+    const size_t size_count = benchmark_sizes(argc, argv, default_sizes, 2, sizes);
+
+    for (size_t i = 0; i < size_count; ++i) {
+        struct hash_table_benchmark_keys keys;
+        printf(" %zu keys (50%% hit rate)\n", sizes[i]);
+
+        if (sizes[i] == 0 || !init_keys(&keys, sizes[i])) {
+            return 1;
+        }
+
+        size_t single_found = 0;
+        size_t batch_found = 0;
+        size_t serial_loaded = 0;
+        size_t parallel_loaded = 0;
+        const bool ok = bench_single(&keys, &single_found) && bench_batch(&keys, &batch_found) &&
+                        bench_bulk_load(&keys, 1, &serial_loaded) && bench_bulk_load(&keys, 0, &parallel_loaded);
+        destroy_keys(&keys);
+
+        if (!ok) {
+            return 1;
+        }
+
+        if (serial_loaded != sizes[i] || parallel_loaded != sizes[i]) {
+            fprintf(
+                stderr,
+                "bulk loaded %zu (1 thread) and %zu (all CPUs) of %zu keys\n",
+                serial_loaded,
+                parallel_loaded,
+                sizes[i]
+            );
+            return 1;
+        }
+
+        if (single_found != sizes[i] || batch_found != sizes[i]) {
+            fprintf(stderr, "found %zu (single) and %zu (batch) of %zu keys\n", single_found, batch_found, sizes[i]);
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+/**
+ * Compare batched hash_table lookups and inserts (hash_table_get_many(), hash_table_set_many()) against one key at a
+ * time, for random keys
+ *
+ * Arguments: [sizes...] (default: 10000 10000000)
+ * The default large size makes the table much bigger than a typical last level cache, which is where batching helps.
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_hash_table_benchmark(int argc, char** argv);
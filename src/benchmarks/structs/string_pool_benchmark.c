@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "string_pool_benchmark.h"
+#include "../benchmark.h"
+#include "../../structs/string_pool.h"
+
+#define KEY_SIZE 48
+
+/**
+ * Total number of lookups per run
+ */
+#define LOOKUPS 10000000
+
+/**
+ * Benchmark inputs
+ */
+struct string_pool_benchmark_keys {
+    size_t count;
+    size_t lookups;
+
+    /**
+     * Inserted strings, and separate copies of them to look up
+     */
+    char (*keys)[KEY_SIZE];
+    char (*copies)[KEY_SIZE];
+
+    /**
+     * Copy to look up for each lookup (in random order)
+     */
+    const char** lookup_keys;
+
+    /**
+     * Handle of each lookup key
+     */
+    const char** lookup_handles;
+};
+
+static bool init_keys(struct string_pool_benchmark_keys* keys, const size_t count) {
+    keys->count = count;
+    keys->lookups = count > LOOKUPS ? count : LOOKUPS;
+    keys->keys = malloc(count * KEY_SIZE);
+    keys->copies = malloc(count * KEY_SIZE);
+    keys->lookup_keys = malloc(keys->lookups * sizeof(char*));
+    keys->lookup_handles = malloc(keys->lookups * sizeof(char*));
+    if (keys->keys == NULL || keys->copies == NULL || keys->lookup_keys == NULL || keys->lookup_handles == NULL) {
+        fprintf(stderr, "failed to allocate benchmark keys for %zu strings\n", count);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(keys->keys[i], KEY_SIZE, "/api/v1/resource/%zu/attribute", i);
+        snprintf(keys->copies[i], KEY_SIZE, "/api/v1/resource/%zu/attribute", i);
+    }
+
+    uint64_t rng = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < keys->lookups; ++i) {
+        keys->lookup_keys[i] = keys->copies[benchmark_rand(&rng) % count];
+    }
+
+    return true;
+}
+
+static void destroy_keys(struct string_pool_benchmark_keys* keys) {
+    free(keys->keys);
+    free(keys->copies);
+    free(keys->lookup_keys);
+    free(keys->lookup_handles);
+}
+
+static bool bench_string_keys(const struct string_pool_benchmark_keys* keys) {
+    hash_table ht;
+    if (!hash_table_init(&ht, keys->count, NULL, NULL)) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < keys->count && ok; ++i) {
+        ok = hash_table_set(&ht, keys->keys[i], keys->keys[i]);
+    }
+
+    size_t found = 0;
+    const uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->lookups; ++i) {
+        found += hash_table_get(&ht, keys->lookup_keys[i]) != NULL;
+    }
+    benchmark_report("hash_table_get (string keys)", keys->lookups, benchmark_now_ns() - start);
+
+    hash_table_destroy(&ht);
+
+    return ok && found == keys->lookups;
+}
+
+static bool bench_handle_keys(const struct string_pool_benchmark_keys* keys) {
+    string_pool pool;
+    if (!string_pool_init(&pool, keys->count)) {
+        return false;
+    }
+
+    hash_table ht;
+    if (!hash_table_init(&ht, keys->count, string_pool_key_cmp, string_pool_key_hash)) {
+        string_pool_destroy(&pool);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < keys->count && ok; ++i) {
+        const char* handle = string_pool_intern(&pool, keys->keys[i]);
+        ok = handle != NULL && hash_table_set(&ht, (void *)handle, keys->keys[i]);
+    }
+
+    // Each lookup key is interned as it's looked up
+    size_t found = 0;
+    uint64_t start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->lookups && ok; ++i) {
+        const char* handle = string_pool_intern(&pool, keys->lookup_keys[i]);
+        keys->lookup_handles[i] = handle;
+        found += hash_table_get(&ht, handle) != NULL;
+    }
+    benchmark_report("string_pool_intern + hash_table_get", keys->lookups, benchmark_now_ns() - start);
+
+    // Handles that are already known (e.g. interned once when a request was parsed)
+    start = benchmark_now_ns();
+    for (size_t i = 0; i < keys->lookups; ++i) {
+        found += hash_table_get(&ht, keys->lookup_handles[i]) != NULL;
+    }
+    benchmark_report("hash_table_get (handle keys)", keys->lookups, benchmark_now_ns() - start);
+
+    ok = ok && found == keys->lookups * 2 && string_pool_size(&pool) == keys->count;
+    hash_table_destroy(&ht);
+    string_pool_destroy(&pool);
+
+    return ok;
+}
+
+int run_string_pool_benchmark(const int argc, char** argv) {
+    const size_t default_sizes[] = {300000};
+    size_t sizes[argc > 1 ? argc : 1];
+    const size_t size_count = benchmark_sizes(argc, argv, default_sizes, 1, sizes);
+
+    for (size_t i = 0; i < size_count; ++i) {
+        struct string_pool_benchmark_keys keys;
+        printf(" %zu strings\n", sizes[i]);
+
+        if (!init_keys(&keys, sizes[i])) {
+            destroy_keys(&keys);
+            return 1;
+        }
+
+        const bool ok = bench_string_keys(&keys) && bench_handle_keys(&keys);
+        destroy_keys(&keys);
+
+        if (!ok) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * Compare hash_table lookups with string keys (default strlen + murmur3 hash and strcmp) to lookups with string_pool
+ * handles (stored hash and pointer compare), both when the handles are already known, and when each lookup key is
+ * interned first
+ *
+ * Lookup keys are separate copies of the inserted strings, so string keys can't match by pointer. Each distinct string
+ * is looked up 10000000 / strings times (at least once).
+ *
+ * Arguments: [distinct strings...] (default: 300000)
+ *
+ * @param[in] argc Number of arguments
+ * @param[in] argv Arguments
+ * @return 0 on success, non-zero on failure
+ */
+int run_string_pool_benchmark(int argc, char** argv);
@@ -0,0 +1,439 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_fuse_filter.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+/**
+ * Number of positions (and segments) each key maps to
+ */
+#define ARITY 3
+
+/**
+ * Max segment length (larger segments don't make the filter any smaller)
+ */
+#define MAX_SEGMENT_LENGTH 262144
+
+/**
+ * Number of seeds a build tries before giving up
+ */
+#define MAX_BUILD_ATTEMPTS 100
+
+uint64_t binary_fuse_filter_hash(const uint8_t* key, const size_t key_len) {
+    uint64_t hash[2];
+    murmur3_128(key, key_len, 0x5f3759df, hash); // Seed: Fast inverse sqrt const
+    return hash[0];
+}
+
+/**
+ * Size the filter's segments and fingerprint array for a number of keys
+ *
+ * @param[in,out] bff Binary fuse filter
+ * @param[in] n Number of keys
+ * @return true on success, false on failure
+ */
+static bool init_filter(binary_fuse_filter* bff, const uint32_t n) {
+    memset(bff, 0, sizeof(binary_fuse_filter));
+
+    // Segments get longer, and the array gets relatively smaller, as the number of keys grows (from the paper)
+    bff->segment_length = n == 0 ? 4 : 1U << (int)floor(log((double)n) / log(3.33) + 2.25);
+    if (bff->segment_length > MAX_SEGMENT_LENGTH) {
+        bff->segment_length = MAX_SEGMENT_LENGTH;
+    }
+    bff->segment_length_mask = bff->segment_length - 1;
+
+    const double size_factor = n <= 1 ? 0 : fmax(1.125, 0.875 + 0.25 * log(1000000.0) / log((double)n));
+    const uint64_t capacity = (uint64_t)round((double)n * size_factor);
+
+    // A key's first position can be in any segment but the last ARITY - 1
+    const uint64_t segments = (capacity + bff->segment_length - 1) / bff->segment_length;
+    bff->segment_count = segments <= ARITY - 1 ? 1 : (uint32_t)(segments - (ARITY - 1));
+    bff->segment_count_length = bff->segment_count * bff->segment_length;
+    bff->array_length = (bff->segment_count + ARITY - 1) * bff->segment_length;
+
+    bff->fingerprints = calloc(bff->array_length, sizeof(uint8_t));
+    if (bff->fingerprints == NULL) {
+        log_perror("calloc() failed");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Get a key's fingerprint
+ *
+ * @param[in] hash Seeded key hash
+ * @return Fingerprint
+ */
+static inline uint8_t fingerprint(const uint64_t hash) {
+    return (uint8_t)(hash ^ (hash >> 32));
+}
+
+/**
+ * Get one of a key's positions
+ * The first is in one of the first segment_count segments, and the others are in the next 2 segments after it.
+ *
+ * @param[in] bff Binary fuse filter
+ * @param[in] index Position number (0, 1 or 2)
+ * @param[in] hash Seeded key hash
+ * @return Position in the fingerprint array
+ */
+static inline uint32_t position(const binary_fuse_filter* bff, const uint64_t index, const uint64_t hash) {
+    uint64_t h = (uint64_t)(((unsigned __int128)hash * bff->segment_count_length) >> 64);
+    h += index * bff->segment_length;
+
+    // Different bits of the hash pick the offset in each segment
+    const uint64_t hh = hash & ((1ULL << 36) - 1);
+    h ^= (hh >> (36 - 18 * index)) & bff->segment_length_mask;
+
+    return (uint32_t)h;
+}
+
+/**
+ * Generate the next seed to try (splitmix64)
+ *
+ * @param[in,out] state Generator state
+ * @return Seed
+ */
+static inline uint64_t next_seed(uint64_t* state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static int hash_cmp(const void* a, const void* b) {
+    const uint64_t a_hash = *(const uint64_t *)a;
+    const uint64_t b_hash = *(const uint64_t *)b;
+    return (a_hash > b_hash) - (a_hash < b_hash);
+}
+
+/**
+ * Sort hashes and remove duplicates
+ *
+ * @param[in,out] hashes Hashes
+ * @param[in] n Number of hashes
+ * @return Number of distinct hashes (at the start of hashes)
+ */
+static uint32_t remove_duplicates(uint64_t* hashes, const uint32_t n) {
+    qsort(hashes, n, sizeof(uint64_t), hash_cmp);
+
+    uint32_t distinct = n == 0 ? 0 : 1;
+    for (uint32_t i = 1; i < n; ++i) {
+        if (hashes[i] != hashes[distinct - 1]) {
+            hashes[distinct++] = hashes[i];
+        }
+    }
+
+    return distinct;
+}
+
+/**
+ * Scratch space for building a filter
+ */
+struct build_state {
+    /**
+     * Seeded key hashes, sorted roughly by first position (then the order keys were peeled in), and the position
+     * number each peeled key was found alone at
+     */
+    uint64_t* order;
+    uint8_t* order_index;
+
+    /**
+     * For each position: 4 times the number of keys there, plus the xor of those keys' position numbers
+     */
+    uint8_t* counts;
+
+    /**
+     * For each position: xor of the keys' seeded hashes there (the one key's hash, once it's alone)
+     */
+    uint64_t* hashes;
+
+    /**
+     * Queue of positions with one key
+     */
+    uint32_t* alone;
+
+    /**
+     * Next free spot in order for each block of first positions
+     */
+    uint32_t* start;
+};
+
+static void destroy_build_state(struct build_state* state) {
+    free(state->order);
+    free(state->order_index);
+    free(state->counts);
+    free(state->hashes);
+    free(state->alone);
+    free(state->start);
+}
+
+/**
+ * Map every key to its positions, and peel them off one at a time from positions that only one key maps to
+ *
+ * @param[in] bff Binary fuse filter (with a seed picked)
+ * @param[in,out] state Build scratch space (cleared)
+ * @param[in] keys Key hashes
+ * @param[in] n Number of keys
+ * @param[in] block_bits Number of bits in a block number
+ * @param[out] duplicates_out Number of keys that were skipped, since they were exactly the same as another key
+ * @return Number of keys peeled (all of them but the duplicates on success), or 0 if positions overflowed
+ */
+static uint32_t peel(
+    const binary_fuse_filter* bff,
+    struct build_state* state,
+    const uint64_t* keys,
+    const uint32_t n,
+    const uint32_t block_bits,
+    uint32_t* duplicates_out
+) {
+    // Bucket the seeded hashes by their top bits (roughly by first position), so the passes below are cache friendly
+    const uint32_t blocks = 1U << block_bits;
+    for (uint32_t i = 0; i < blocks; ++i) {
+        state->start[i] = (uint32_t)(((uint64_t)i * n) >> block_bits);
+    }
+
+    state->order[n] = 1; // Sentinel, so a full last block spills into the next one
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint64_t hash = murmur3_fmix64(keys[i] + bff->seed);
+        uint64_t block = hash >> (64 - block_bits);
+        while (state->order[state->start[block]] != 0) {
+            block = (block + 1) & (blocks - 1);
+        }
+        state->order[state->start[block]++] = hash;
+    }
+
+    bool overflow = false;
+    uint32_t duplicates = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint64_t hash = state->order[i];
+        const uint32_t h0 = position(bff, 0, hash);
+        const uint32_t h1 = position(bff, 1, hash);
+        const uint32_t h2 = position(bff, 2, hash);
+
+        state->counts[h0] += 4;
+        state->hashes[h0] ^= hash;
+        state->counts[h1] += 4;
+        state->counts[h1] ^= 1;
+        state->hashes[h1] ^= hash;
+        state->counts[h2] += 4;
+        state->counts[h2] ^= 2;
+        state->hashes[h2] ^= hash;
+
+        // A pair of identical keys cancels out of all 3 hashes, leaving a count of 2 (with no hash) at some position
+        if ((state->hashes[h0] & state->hashes[h1] & state->hashes[h2]) == 0) {
+            if (
+                (state->hashes[h0] == 0 && state->counts[h0] == 8) ||
+                (state->hashes[h1] == 0 && state->counts[h1] == 8) ||
+                (state->hashes[h2] == 0 && state->counts[h2] == 8)
+            ) {
+                ++duplicates;
+                state->counts[h0] -= 4;
+                state->hashes[h0] ^= hash;
+                state->counts[h1] -= 4;
+                state->counts[h1] ^= 1;
+                state->hashes[h1] ^= hash;
+                state->counts[h2] -= 4;
+                state->counts[h2] ^= 2;
+                state->hashes[h2] ^= hash;
+            }
+        }
+
+        // More than 63 keys at one position wraps the count around
+        overflow |= state->counts[h0] < 4 || state->counts[h1] < 4 || state->counts[h2] < 4;
+    }
+
+    if (overflow) {
+        return 0;
+    }
+
+    uint32_t queue_size = 0;
+    for (uint32_t i = 0; i < bff->array_length; ++i) {
+        state->alone[queue_size] = i;
+        queue_size += (state->counts[i] >> 2) == 1;
+    }
+
+    uint32_t peeled = 0;
+    while (queue_size > 0) {
+        const uint32_t index = state->alone[--queue_size];
+        if ((state->counts[index] >> 2) != 1) {
+            continue; // Another key was peeled off this position since it was queued
+        }
+
+        // The one key at this position, and which of its positions this is
+        const uint64_t hash = state->hashes[index];
+        const uint8_t found = state->counts[index] & 3;
+        const uint32_t h[ARITY] = {position(bff, 0, hash), position(bff, 1, hash), position(bff, 2, hash)};
+
+        state->order_index[peeled] = found;
+        state->order[peeled] = hash;
+        ++peeled;
+
+        // Remove the key from its other 2 positions, which queues them if they only have one key left
+        for (uint8_t j = 1; j < ARITY; ++j) {
+            const uint8_t other = (found + j) % ARITY;
+            const uint32_t other_index = h[other];
+
+            state->alone[queue_size] = other_index;
+            queue_size += (state->counts[other_index] >> 2) == 2;
+
+            state->counts[other_index] -= 4;
+            state->counts[other_index] ^= other;
+            state->hashes[other_index] ^= hash;
+        }
+    }
+
+    *duplicates_out = duplicates;
+
+    return peeled;
+}
+
+bool binary_fuse_filter_build_hashes(binary_fuse_filter* bff, const uint64_t* hashes, const size_t n) {
+    if (n > UINT32_MAX) {
+        log_error("too many keys for a binary fuse filter: %zu", n);
+        return false;
+    }
+
+    uint32_t size = (uint32_t)n;
+    if (!init_filter(bff, size)) {
+        return false;
+    }
+
+    uint32_t block_bits = 1;
+    while ((1U << block_bits) < bff->segment_count) {
+        ++block_bits;
+    }
+
+    // Keys are copied, so duplicates can be removed from them
+    uint64_t* keys = malloc((n == 0 ? 1 : n) * sizeof(uint64_t));
+    struct build_state state = {
+        .order = calloc(n + 1, sizeof(uint64_t)),
+        .order_index = malloc(n == 0 ? 1 : n),
+        .counts = calloc(bff->array_length, sizeof(uint8_t)),
+        .hashes = calloc(bff->array_length, sizeof(uint64_t)),
+        .alone = malloc(bff->array_length * sizeof(uint32_t)),
+        .start = malloc((1U << block_bits) * sizeof(uint32_t)),
+    };
+    if (
+        keys == NULL || state.order == NULL || state.order_index == NULL || state.counts == NULL ||
+        state.hashes == NULL || state.alone == NULL || state.start == NULL
+    ) {
+        log_perror("binary fuse filter build allocation failed for %zu keys", n);
+        free(keys);
+        destroy_build_state(&state);
+        binary_fuse_filter_destroy(bff);
+        return false;
+    }
+
+    memcpy(keys, hashes, n * sizeof(uint64_t));
+
+    uint64_t seed_state = 0x726b2b9d438b9d4dULL;
+    bool built = false;
+    for (uint32_t attempt = 0; attempt < MAX_BUILD_ATTEMPTS; ++attempt) {
+        bff->seed = next_seed(&seed_state);
+
+        uint32_t duplicates = 0;
+        const uint32_t peeled = peel(bff, &state, keys, size, block_bits, &duplicates);
+        if (peeled + duplicates == size) {
+            size = peeled;
+            built = true;
+            break;
+        }
+
+        // Duplicates can keep peeling from finishing, so remove them for good before the next seed
+        if (duplicates > 0) {
+            size = remove_duplicates(keys, size);
+        }
+
+        memset(state.order, 0, (size + 1) * sizeof(uint64_t));
+        memset(state.counts, 0, bff->array_length * sizeof(uint8_t));
+        memset(state.hashes, 0, bff->array_length * sizeof(uint64_t));
+    }
+
+    if (built) {
+        // Assign fingerprints in reverse peel order: each key's position is the last of its 3 to be set, so it can make
+        // all 3 xor to the key's fingerprint
+        for (uint32_t i = size; i > 0; --i) {
+            const uint64_t hash = state.order[i - 1];
+            const uint8_t found = state.order_index[i - 1];
+            const uint32_t h[ARITY] = {position(bff, 0, hash), position(bff, 1, hash), position(bff, 2, hash)};
+
+            bff->fingerprints[h[found]] = fingerprint(hash) ^
+                                          bff->fingerprints[h[(found + 1) % ARITY]] ^
+                                          bff->fingerprints[h[(found + 2) % ARITY]];
+        }
+
+        bff->size = size;
+    }
+    else {
+        log_error("binary fuse filter build failed for %zu keys after %d attempts", n, MAX_BUILD_ATTEMPTS);
+        binary_fuse_filter_destroy(bff);
+    }
+
+    free(keys);
+    destroy_build_state(&state);
+
+    return built;
+}
+
+bool binary_fuse_filter_build(
+    binary_fuse_filter* bff,
+    const uint8_t* const* keys,
+    const size_t* key_lens,
+    const size_t n
+) {
+    uint64_t* hashes = malloc((n == 0 ? 1 : n) * sizeof(uint64_t));
+    if (hashes == NULL) {
+        log_perror("malloc() failed");
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        hashes[i] = binary_fuse_filter_hash(keys[i], key_lens[i]);
+    }
+
+    const bool built = binary_fuse_filter_build_hashes(bff, hashes, n);
+    free(hashes);
+
+    return built;
+}
+
+bool binary_fuse_filter_check_hash(const binary_fuse_filter* bff, const uint64_t hash) {
+    const uint64_t seeded = murmur3_fmix64(hash + bff->seed);
+
+    return (
+        fingerprint(seeded) ^
+        bff->fingerprints[position(bff, 0, seeded)] ^
+        bff->fingerprints[position(bff, 1, seeded)] ^
+        bff->fingerprints[position(bff, 2, seeded)]
+    ) == 0;
+}
+
+bool binary_fuse_filter_check(const binary_fuse_filter* bff, const uint8_t* key, const size_t key_len) {
+    return binary_fuse_filter_check_hash(bff, binary_fuse_filter_hash(key, key_len));
+}
+
+size_t binary_fuse_filter_size(const binary_fuse_filter* bff) {
+    return bff->size;
+}
+
+size_t binary_fuse_filter_bytes(const binary_fuse_filter* bff) {
+    return bff->array_length;
+}
+
+bool binary_fuse_filter_destroy(binary_fuse_filter* bff) {
+    if (bff->fingerprints != NULL) {
+        free(bff->fingerprints);
+        bff->fingerprints = nullptr;
+    }
+
+    bff->array_length = 0;
+    bff->size = 0;
+
+    return true;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * A binary fuse filter is a static approximate membership set, built once from all of its keys, that takes less memory
+ * than a bloom_filter or cuckoo_filter for the same false positive rate.
+ * https://arxiv.org/abs/2201.01174
+ *
+ * Each key hashes to 3 positions in an array of 8-bit fingerprints, and the filter is built so that the fingerprints at
+ * a key's 3 positions xor to the key's own fingerprint. A check reads those 3 bytes (three memory accesses, one per
+ * position), and a key that was never added matches with probability 2^-8, about 0.4%. The array is about 1.13 times
+ * the number of keys (less for large sets), which works out to about 9 bits per key.
+ *
+ * The 3 positions are in 3 consecutive segments of the array (instead of anywhere in it, like an xor filter), which
+ * makes building it fast and cache friendly. Building "peels" keys off positions that only one key maps to, and if that
+ * gets stuck it retries with another seed, which is rare for more than a few keys.
+ *
+ * Keys are hashed with murmur3_128(). Keys can't be added or removed after the filter is built.
+ *
+ * **Example**
+ * ```c
+ * const uint8_t* keys[] = {(uint8_t *)"foo", (uint8_t *)"bar"};
+ * const size_t key_lens[] = {3, 3};
+ *
+ * binary_fuse_filter bff;
+ * binary_fuse_filter_build(&bff, keys, key_lens, 2);
+ *
+ * assert(binary_fuse_filter_check(&bff, (uint8_t *)"foo", 3));
+ *
+ * binary_fuse_filter_destroy(&bff);
+ * ```
+ */
+typedef struct binary_fuse_filter {
+    /**
+     * Seed that the build succeeded with (mixed into every key hash)
+     */
+    uint64_t seed;
+
+    /**
+     * Number of fingerprints in a segment (a power of 2)
+     */
+    uint32_t segment_length;
+    uint32_t segment_length_mask;
+
+    /**
+     * Number of segments a key's first position can be in, and the number of fingerprints in them
+     */
+    uint32_t segment_count;
+    uint32_t segment_count_length;
+
+    /**
+     * Fingerprints (segment_count + 2 segments)
+     */
+    uint8_t* fingerprints;
+    uint32_t array_length;
+
+    /**
+     * Number of distinct keys the filter was built from
+     */
+    size_t size;
+} binary_fuse_filter;
+
+/**
+ * Hash a key for binary_fuse_filter_build_hashes() and binary_fuse_filter_check_hash()
+ *
+ * Time complexity: O(len)
+ *
+ * @param[in] key Key to hash
+ * @param[in] key_len Length of the key
+ * @return 64-bit hash
+ */
+uint64_t binary_fuse_filter_hash(const uint8_t* key, size_t key_len);
+
+/**
+ * Build the binary fuse filter from a set of keys
+ * Duplicate keys are allowed (and only counted once).
+ *
+ * Time complexity: O(n)
+ *
+ * @relates binary_fuse_filter
+ * @param[out] bff Binary fuse filter
+ * @param[in] keys Keys
+ * @param[in] key_lens Length of each key
+ * @param[in] n Number of keys (up to UINT32_MAX)
+ * @return true on success, false on failure
+ */
+bool binary_fuse_filter_build(binary_fuse_filter* bff, const uint8_t* const* keys, const size_t* key_lens, size_t n);
+
+/**
+ * Build the binary fuse filter from keys that have already been hashed
+ * {@see binary_fuse_filter_build}
+ *
+ * Time complexity: O(n)
+ *
+ * @relates binary_fuse_filter
+ * @param[out] bff Binary fuse filter
+ * @param[in] hashes binary_fuse_filter_hash() of each key
+ * @param[in] n Number of keys (up to UINT32_MAX)
+ * @return true on success, false on failure
+ */
+bool binary_fuse_filter_build_hashes(binary_fuse_filter* bff, const uint64_t* hashes, size_t n);
+
+/**
+ * Check if a key is in the binary fuse filter
+ *
+ * False positives are possible (meaning this can indicate that a key is a member when it's not)
+ * False negatives are impossible (meaning this can't indicate that a key is not a member when it is)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates binary_fuse_filter
+ * @param[in] bff Binary fuse filter
+ * @param[in] key Key to check
+ * @param[in] key_len Length of the key
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool binary_fuse_filter_check(const binary_fuse_filter* bff, const uint8_t* key, size_t key_len);
+
+/**
+ * Check if a key that's already been hashed is in the binary fuse filter
+ * {@see binary_fuse_filter_check}
+ *
+ * Time complexity: O(1)
+ *
+ * @relates binary_fuse_filter
+ * @param[in] bff Binary fuse filter
+ * @param[in] hash binary_fuse_filter_hash() of the key
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool binary_fuse_filter_check_hash(const binary_fuse_filter* bff, uint64_t hash);
+
+/**
+ * Get the number of distinct keys in the binary fuse filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates binary_fuse_filter
+ * @param[in] bff Binary fuse filter
+ * @return Number of keys
+ */
+size_t binary_fuse_filter_size(const binary_fuse_filter* bff);
+
+/**
+ * Get the size of the binary fuse filter's fingerprints
+ *
+ * Time complexity: O(1)
+ *
+ * @relates binary_fuse_filter
+ * @param[in] bff Binary fuse filter
+ * @return Size in bytes
+ */
+size_t binary_fuse_filter_bytes(const binary_fuse_filter* bff);
+
+/**
+ * Destroy the binary fuse filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates binary_fuse_filter
+ * @param[in,out] bff Binary fuse filter
+ * @return true on success, false on failure
+ */
+bool binary_fuse_filter_destroy(binary_fuse_filter* bff);
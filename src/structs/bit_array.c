@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "bit_array.h"
 #include "../utils/log.h"
@@ -28,16 +29,52 @@ bool bit_array_init(bit_array *ba, const size_t size) {
     return true;
 }
 
-void bit_array_set(bit_array *ba, const uint32_t k) {
-    ba->bit_array[k / ba->size_bits] |= 1U << (k % ba->size_bits);
+/**
+ * Get the array element that holds a bit
+ *
+ * @param[in] k Bit (already wrapped to size_bits)
+ * @return Index into the bit_array array
+ */
+static inline size_t elem_index(const uint64_t k) {
+    return k / 32;
 }
 
-void bit_array_clear(bit_array *ba, const uint32_t k) {
-    ba->bit_array[k / ba->size_bits] &= ~(1U << (k % ba->size_bits));
+/**
+ * Get the mask for a bit within its array element
+ *
+ * @param[in] k Bit (already wrapped to size_bits)
+ * @return Bit mask
+ */
+static inline uint32_t elem_mask(const uint64_t k) {
+    return 1U << (k % 32);
 }
 
-bool bit_array_test(const bit_array *ba, const uint32_t k) {
-    return (ba->bit_array[k / ba->size_bits] & (1U << (k % ba->size_bits))) != 0;
+void bit_array_set(bit_array *ba, uint64_t k) {
+    k %= ba->size_bits;
+    ba->bit_array[elem_index(k)] |= elem_mask(k);
+}
+
+void bit_array_clear(bit_array *ba, uint64_t k) {
+    k %= ba->size_bits;
+    ba->bit_array[elem_index(k)] &= ~elem_mask(k);
+}
+
+bool bit_array_test(const bit_array *ba, uint64_t k) {
+    k %= ba->size_bits;
+    return (ba->bit_array[elem_index(k)] & elem_mask(k)) != 0;
+}
+
+void bit_array_clear_all(bit_array *ba) {
+    memset(ba->bit_array, 0, ba->size_bits / 8);
+}
+
+size_t bit_array_count(const bit_array *ba) {
+    size_t count = 0;
+    for (size_t i = 0; i < ba->size_bits / 32; ++i) {
+        count += __builtin_popcount(ba->bit_array[i]);
+    }
+
+    return count;
 }
 
 bool bit_array_destroy(bit_array *ba) {
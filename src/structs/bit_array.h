@@ -54,7 +54,7 @@ bool bit_array_init(bit_array *ba, size_t size);
  * @param[in,out] ba Bit array
  * @param[in] k Bit to set (will wrap w/ modulo size_bits)
  */
-void bit_array_set(bit_array *ba, uint32_t k);
+void bit_array_set(bit_array *ba, uint64_t k);
 
 /**
  * Set a bit to 0 in the bit array
@@ -65,7 +65,7 @@ void bit_array_set(bit_array *ba, uint32_t k);
  * @param[in,out] ba Bit array
  * @param k Bit to clear (will wrap w/ modulo size_bits)
  */
-void bit_array_clear(bit_array *ba, uint32_t k);
+void bit_array_clear(bit_array *ba, uint64_t k);
 
 /**
  * Test if a bit is set to 1 in the bit array
@@ -77,7 +77,28 @@ void bit_array_clear(bit_array *ba, uint32_t k);
  * @param[in] k Bit to test (will wrap w/ modulo size_bits)
  * @return true if bit is set, false otherwise
  */
-bool bit_array_test(const bit_array *ba, uint32_t k);
+bool bit_array_test(const bit_array *ba, uint64_t k);
+
+/**
+ * Set all bits to 0 in the bit array
+ *
+ * Time complexity: O(n)
+ *
+ * @relates bit_array
+ * @param[in,out] ba Bit array
+ */
+void bit_array_clear_all(bit_array *ba);
+
+/**
+ * Count the bits that are set to 1 in the bit array
+ *
+ * Time complexity: O(n)
+ *
+ * @relates bit_array
+ * @param[in] ba Bit array
+ * @return Number of bits set
+ */
+size_t bit_array_count(const bit_array *ba);
 
 /**
  * Destroy the bit array
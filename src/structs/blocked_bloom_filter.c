@@ -0,0 +1,272 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blocked_bloom_filter.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Odd constants that the in-block half of the hash is multiplied by, to pick the bit in each word
+ * (the same ones as the Parquet split block bloom filter)
+ */
+#define SALTS 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+
+/**
+ * Right shift that turns a salted hash into a bit within a 64-bit word
+ */
+#define WORD_BIT_SHIFT 26
+
+/**
+ * Max number of blocks blocked_bloom_filter_init_with_fpr() will size a filter to (2^58 bytes)
+ */
+#define MAX_BLOCKS ((size_t)1 << 52)
+
+bool blocked_bloom_filter_init(blocked_bloom_filter* bf, const size_t size) {
+    memset(bf, 0, sizeof(blocked_bloom_filter));
+
+    const size_t block_count = size == 0 ? 1 : (size + BLOCKED_BLOOM_FILTER_BLOCK_BITS - 1) / BLOCKED_BLOOM_FILTER_BLOCK_BITS;
+
+    bf->blocks = aligned_alloc(alignof(blocked_bloom_filter_block), block_count * sizeof(blocked_bloom_filter_block));
+    if (bf->blocks == NULL) {
+        log_perror("aligned_alloc() failed for %zu blocked bloom filter blocks", block_count);
+        return false;
+    }
+
+    memset(bf->blocks, 0, block_count * sizeof(blocked_bloom_filter_block));
+    bf->block_count = block_count;
+
+    return true;
+}
+
+double blocked_bloom_filter_expected_fpr(const size_t n, const size_t block_count) {
+    // The number of keys in a block is Poisson distributed, and a key that was never added is a false positive if the
+    // bit it picks in each of the block's words is set
+    const double keys_per_block = (double)n / (double)block_count;
+    if (keys_per_block == 0) {
+        return 0;
+    }
+
+    const double spread = 12 * sqrt(keys_per_block) + 12;
+    const double first = keys_per_block > spread ? floor(keys_per_block - spread) : 0;
+    const double last = ceil(keys_per_block + spread);
+
+    double fpr = 0;
+    for (double keys = first; keys <= last; ++keys) {
+        const double p_keys = exp(keys * log(keys_per_block) - keys_per_block - lgamma(keys + 1));
+        const double p_bit_set = 1 - pow(1 - 1.0 / 64, keys);
+        fpr += p_keys * pow(p_bit_set, BLOCKED_BLOOM_FILTER_BLOCK_WORDS);
+    }
+
+    return fpr;
+}
+
+bool blocked_bloom_filter_init_with_fpr(blocked_bloom_filter* bf, const size_t n, const double fpr) {
+    if (n == 0 || !(fpr > 0 && fpr < 1)) {
+        log_error("invalid blocked bloom filter size: %zu keys with a false positive rate of %f", n, fpr);
+        return false;
+    }
+
+    // Double until the rate is low enough, then binary search for the fewest blocks that still are
+    size_t high = 1;
+    while (blocked_bloom_filter_expected_fpr(n, high) > fpr) {
+        if (high >= MAX_BLOCKS) {
+            log_error("blocked bloom filter for %zu keys with a false positive rate of %f is too big", n, fpr);
+            return false;
+        }
+
+        high *= 2;
+    }
+
+    size_t low = high / 2 + 1;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (blocked_bloom_filter_expected_fpr(n, mid) > fpr) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    return blocked_bloom_filter_init(bf, high * BLOCKED_BLOOM_FILTER_BLOCK_BITS);
+}
+
+/**
+ * Pick the block for a key hash (from the high half of the hash)
+ *
+ * @param[in] bf Blocked bloom filter
+ * @param[in] hash 64-bit hash of the key
+ * @return Block
+ */
+static inline blocked_bloom_filter_block* block_of(const blocked_bloom_filter* bf, const uint64_t hash) {
+    // Multiply and shift instead of modulo (Lemire's fast range reduction)
+    return &bf->blocks[(size_t)(((unsigned __int128)hash * bf->block_count) >> 64)];
+}
+
+#if defined(__AVX2__)
+
+/**
+ * Build the mask of bits to set in each word of a block (words 0-3 and 4-7)
+ *
+ * @param[in] hash Low half of the key hash
+ * @param[out] lo Mask for words 0-3
+ * @param[out] hi Mask for words 4-7
+ */
+static inline void block_mask(const uint32_t hash, __m256i* lo, __m256i* hi) {
+    const __m256i salted = _mm256_mullo_epi32(_mm256_set1_epi32((int)hash), _mm256_setr_epi32(SALTS));
+    const __m256i bits = _mm256_srli_epi32(salted, WORD_BIT_SHIFT);
+    const __m256i one = _mm256_set1_epi64x(1);
+
+    *lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+    *hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+}
+
+static inline void block_set(blocked_bloom_filter_block* block, const uint32_t hash) {
+    __m256i lo, hi;
+    block_mask(hash, &lo, &hi);
+
+    __m256i* words = (__m256i*)block->words;
+    _mm256_store_si256(&words[0], _mm256_or_si256(_mm256_load_si256(&words[0]), lo));
+    _mm256_store_si256(&words[1], _mm256_or_si256(_mm256_load_si256(&words[1]), hi));
+}
+
+static inline bool block_test(const blocked_bloom_filter_block* block, const uint32_t hash) {
+    __m256i lo, hi;
+    block_mask(hash, &lo, &hi);
+
+    // testc is set if every bit of the mask is set in the block
+    const __m256i* words = (const __m256i*)block->words;
+    return _mm256_testc_si256(_mm256_load_si256(&words[0]), lo) & _mm256_testc_si256(_mm256_load_si256(&words[1]), hi);
+}
+
+#elif defined(__ARM_NEON)
+
+/**
+ * Build the mask of bits to set in each word of a block (two words per vector)
+ *
+ * @param[in] hash Low half of the key hash
+ * @param[out] masks Masks for words 0-1, 2-3, 4-5 and 6-7
+ */
+static inline void block_mask(const uint32_t hash, uint64x2_t masks[4]) {
+    static const uint32_t salts[BLOCKED_BLOOM_FILTER_BLOCK_WORDS] = {SALTS};
+    const uint32x4_t hashes = vdupq_n_u32(hash);
+    const uint32x4_t bits_lo = vshrq_n_u32(vmulq_u32(hashes, vld1q_u32(salts)), WORD_BIT_SHIFT);
+    const uint32x4_t bits_hi = vshrq_n_u32(vmulq_u32(hashes, vld1q_u32(salts + 4)), WORD_BIT_SHIFT);
+    const uint64x2_t one = vdupq_n_u64(1);
+
+    masks[0] = vshlq_u64(one, vreinterpretq_s64_u64(vmovl_u32(vget_low_u32(bits_lo))));
+    masks[1] = vshlq_u64(one, vreinterpretq_s64_u64(vmovl_u32(vget_high_u32(bits_lo))));
+    masks[2] = vshlq_u64(one, vreinterpretq_s64_u64(vmovl_u32(vget_low_u32(bits_hi))));
+    masks[3] = vshlq_u64(one, vreinterpretq_s64_u64(vmovl_u32(vget_high_u32(bits_hi))));
+}
+
+static inline void block_set(blocked_bloom_filter_block* block, const uint32_t hash) {
+    uint64x2_t masks[4];
+    block_mask(hash, masks);
+
+    for (size_t i = 0; i < 4; ++i) {
+        vst1q_u64(&block->words[i * 2], vorrq_u64(vld1q_u64(&block->words[i * 2]), masks[i]));
+    }
+}
+
+static inline bool block_test(const blocked_bloom_filter_block* block, const uint32_t hash) {
+    uint64x2_t masks[4];
+    block_mask(hash, masks);
+
+    // Bits of the mask that aren't set in the block
+    uint64x2_t missing = vdupq_n_u64(0);
+    for (size_t i = 0; i < 4; ++i) {
+        missing = vorrq_u64(missing, vbicq_u64(masks[i], vld1q_u64(&block->words[i * 2])));
+    }
+
+    return (vgetq_lane_u64(missing, 0) | vgetq_lane_u64(missing, 1)) == 0;
+}
+
+#else
+
+/**
+ * Get the mask of the bit to set in one word of a block
+ *
+ * @param[in] hash Low half of the key hash
+ * @param[in] salt Word's salt
+ * @return Word mask
+ */
+static inline uint64_t word_mask(const uint32_t hash, const uint32_t salt) {
+    return (uint64_t)1 << ((hash * salt) >> WORD_BIT_SHIFT);
+}
+
+static inline void block_set(blocked_bloom_filter_block* block, const uint32_t hash) {
+    static const uint32_t salts[BLOCKED_BLOOM_FILTER_BLOCK_WORDS] = {SALTS};
+
+    for (size_t i = 0; i < BLOCKED_BLOOM_FILTER_BLOCK_WORDS; ++i) {
+        block->words[i] |= word_mask(hash, salts[i]);
+    }
+}
+
+static inline bool block_test(const blocked_bloom_filter_block* block, const uint32_t hash) {
+    static const uint32_t salts[BLOCKED_BLOOM_FILTER_BLOCK_WORDS] = {SALTS};
+
+    // Bits of the mask that aren't set in the block
+    uint64_t missing = 0;
+    for (size_t i = 0; i < BLOCKED_BLOOM_FILTER_BLOCK_WORDS; ++i) {
+        missing |= word_mask(hash, salts[i]) & ~block->words[i];
+    }
+
+    return missing == 0;
+}
+
+#endif
+
+/**
+ * Hash a key
+ *
+ * @param[in] key Key to hash
+ * @param[in] key_len Size of the key
+ * @return 64-bit hash
+ */
+static inline uint64_t key_hash(const uint8_t* key, const size_t key_len) {
+    uint64_t hash[2];
+    murmur3_128(key, key_len, 0x5f3759df, hash); // Seed: Fast inverse sqrt const
+    return hash[0];
+}
+
+void blocked_bloom_filter_add_hash(const blocked_bloom_filter* bf, const uint64_t hash) {
+    block_set(block_of(bf, hash), (uint32_t)hash);
+}
+
+bool blocked_bloom_filter_add(const blocked_bloom_filter* bf, const uint8_t* key, const size_t key_len) {
+    blocked_bloom_filter_add_hash(bf, key_hash(key, key_len));
+    return true;
+}
+
+bool blocked_bloom_filter_check_hash(const blocked_bloom_filter* bf, const uint64_t hash) {
+    return block_test(block_of(bf, hash), (uint32_t)hash);
+}
+
+bool blocked_bloom_filter_check(const blocked_bloom_filter* bf, const uint8_t* key, const size_t key_len) {
+    return blocked_bloom_filter_check_hash(bf, key_hash(key, key_len));
+}
+
+size_t blocked_bloom_filter_bytes(const blocked_bloom_filter* bf) {
+    return bf->block_count * sizeof(blocked_bloom_filter_block);
+}
+
+void blocked_bloom_filter_clear(const blocked_bloom_filter* bf) {
+    memset(bf->blocks, 0, bf->block_count * sizeof(blocked_bloom_filter_block));
+}
+
+bool blocked_bloom_filter_destroy(blocked_bloom_filter* bf) {
+    free(bf->blocks);
+    bf->blocks = nullptr;
+    bf->block_count = 0;
+
+    return true;
+}
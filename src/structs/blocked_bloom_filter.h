@@ -0,0 +1,185 @@
+#pragma once
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Number of 64-bit words in a block (one cache line)
+ */
+#define BLOCKED_BLOOM_FILTER_BLOCK_WORDS 8
+
+/**
+ * Number of bits in a block
+ */
+#define BLOCKED_BLOOM_FILTER_BLOCK_BITS (BLOCKED_BLOOM_FILTER_BLOCK_WORDS * 64)
+
+/**
+ * Block of a blocked bloom filter
+ */
+typedef struct blocked_bloom_filter_block {
+    alignas(64) uint64_t words[BLOCKED_BLOOM_FILTER_BLOCK_WORDS];
+} blocked_bloom_filter_block;
+
+/**
+ * A blocked bloom filter is a bloom filter (see bloom_filter) where all the bits for a key are in the same cache line
+ * sized block, so adding or checking a key costs one cache miss instead of one for each hash function.
+ *
+ * This is a split block bloom filter: one half of a 64-bit key hash picks the block, and the other half is multiplied
+ * by 8 different odd constants to pick one bit in each of the block's 8 words. The 8 bits are built into a mask and set
+ * or tested at once, using AVX2 or NEON when the library is compiled for them (e.g. with -mavx2 or -march=native), and
+ * a scalar loop otherwise.
+ *
+ * Keeping every bit in one block makes the false positive rate a little higher than a standard bloom filter with the
+ * same number of bits (blocks don't fill evenly), so it needs a little more memory for the same rate (about 5% more at
+ * 1%, and more for lower rates). In exchange, adds and lookups are much faster on filters that don't fit in cache.
+ *
+ * Items can't be deleted from a blocked bloom filter.
+ *
+ * **Example**
+ * ```c
+ * blocked_bloom_filter bf;
+ * blocked_bloom_filter_init_with_fpr(&bf, 1000000, 0.01); // 1% false positives with up to 1M keys
+ *
+ * blocked_bloom_filter_add(&bf, (uint8_t *)"foo", 3);
+ * assert(blocked_bloom_filter_check(&bf, (uint8_t *)"foo", 3));
+ *
+ * blocked_bloom_filter_destroy(&bf);
+ * ```
+ */
+typedef struct blocked_bloom_filter {
+    /**
+     * Blocks (cache line aligned)
+     */
+    blocked_bloom_filter_block* blocks;
+
+    /**
+     * Number of blocks
+     */
+    size_t block_count;
+} blocked_bloom_filter;
+
+/**
+ * Initialize the blocked bloom filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates blocked_bloom_filter
+ * @param[out] bf Blocked bloom filter
+ * @param[in] size Size of the filter in bits (rounded up to a multiple of BLOCKED_BLOOM_FILTER_BLOCK_BITS)
+ * @return true on success, false on failure
+ */
+bool blocked_bloom_filter_init(blocked_bloom_filter* bf, size_t size);
+
+/**
+ * Initialize the blocked bloom filter, sized for a target false positive rate
+ *
+ * The number of blocks is the smallest that gives the target rate with n keys, accounting for the uneven number of
+ * keys in each block.
+ *
+ * Time complexity: O(m)
+ *
+ * @relates blocked_bloom_filter
+ * @param[out] bf Blocked bloom filter
+ * @param[in] n Expected number of keys
+ * @param[in] fpr Target false positive rate (between 0 and 1, exclusive)
+ * @return true on success, false on failure
+ */
+bool blocked_bloom_filter_init_with_fpr(blocked_bloom_filter* bf, size_t n, double fpr);
+
+/**
+ * Get the expected false positive rate of a blocked bloom filter
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] n Number of keys in the filter
+ * @param[in] block_count Number of blocks in the filter
+ * @return Probability that checking a key that was never added returns true
+ */
+double blocked_bloom_filter_expected_fpr(size_t n, size_t block_count);
+
+/**
+ * Add a key to the blocked bloom filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in,out] bf Blocked bloom filter
+ * @param[in] key Key to add
+ * @param[in] key_len Length of the key
+ * @return true on success, false on failure
+ */
+bool blocked_bloom_filter_add(const blocked_bloom_filter* bf, const uint8_t* key, size_t key_len);
+
+/**
+ * Add a key that's already been hashed to the blocked bloom filter
+ * The hash must have well mixed bits in both halves (like either half of a murmur3_128() hash).
+ *
+ * Time complexity: O(1)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in,out] bf Blocked bloom filter
+ * @param[in] hash 64-bit hash of the key
+ */
+void blocked_bloom_filter_add_hash(const blocked_bloom_filter* bf, uint64_t hash);
+
+/**
+ * Check if a key is in the blocked bloom filter
+ *
+ * False positives are possible (meaning this can indicate that a key is a member when it's not)
+ * False negatives are impossible (meaning this can't indicate that a key is not a member when it is)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in] bf Blocked bloom filter
+ * @param[in] key Key to check
+ * @param[in] key_len Length of the key
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool blocked_bloom_filter_check(const blocked_bloom_filter* bf, const uint8_t* key, size_t key_len);
+
+/**
+ * Check if a key that's already been hashed is in the blocked bloom filter
+ * {@see blocked_bloom_filter_check}
+ *
+ * Time complexity: O(1)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in] bf Blocked bloom filter
+ * @param[in] hash 64-bit hash of the key (the same hash that was passed to blocked_bloom_filter_add_hash())
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool blocked_bloom_filter_check_hash(const blocked_bloom_filter* bf, uint64_t hash);
+
+/**
+ * Get the size of the blocked bloom filter's bit storage
+ *
+ * Time complexity: O(1)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in] bf Blocked bloom filter
+ * @return Size in bytes
+ */
+size_t blocked_bloom_filter_bytes(const blocked_bloom_filter* bf);
+
+/**
+ * Remove all keys from the blocked bloom filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in,out] bf Blocked bloom filter
+ */
+void blocked_bloom_filter_clear(const blocked_bloom_filter* bf);
+
+/**
+ * Destroy the blocked bloom filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates blocked_bloom_filter
+ * @param[in,out] bf Blocked bloom filter
+ * @return true on success, false on failure
+ */
+bool blocked_bloom_filter_destroy(blocked_bloom_filter* bf);
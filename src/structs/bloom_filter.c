@@ -1,7 +1,7 @@
+#include <math.h>
 #include <stdio.h>
 
 #include "bloom_filter.h"
-#include "../algos/murmur3.h"
 #include "../utils/log.h"
 
 bool bloom_filter_init(bloom_filter* bf, const size_t size) {
@@ -21,50 +21,40 @@ bool bloom_filter_init(bloom_filter* bf, const size_t size) {
     return true;
 }
 
-/**
- * Hash function that uses the Kirsch & Mitzenmacher technique
- * https://www.eecs.harvard.edu/~michaelm/postscripts/rsa2008.pdf
- *
- * Simulates k hash functions by combining murmur3 hashes
- *
- * @param[in] key Key to hash
- * @param[in] key_len Size of the key
- * @param[in] k Total number of hashes to generate
- * @param[in] m Modulo (total number of bits in bloom filter)
- * @param[out] hashes_out Generated hashes
- */
-static void bloom_hashes(
-    const uint8_t* key,
-    const size_t key_len,
-    const uint32_t k,
-    const uint32_t m,
-    uint32_t* hashes_out
-) {
-    const uint32_t hash1 = murmur3(key, key_len, 0x5f3759df); // Seed: Fast inverse sqrt const
-    const uint32_t hash2 = murmur3(key, key_len, 0x9e3779b9); // Seed: Golden ratio prime
-
-    for (uint32_t i = 0; i < k; ++i) {
-        hashes_out[i] = (hash1 + i * hash2) % m;
+bool bloom_filter_init_with_fpr(bloom_filter* bf, const size_t n, const double fpr) {
+    if (n == 0 || !(fpr > 0 && fpr < 1)) {
+        log_error("invalid bloom filter size: %zu keys with a false positive rate of %f", n, fpr);
+        return false;
     }
-}
-
-bool bloom_filter_add(const bloom_filter* bf, const uint8_t* key, const size_t key_len) {
-    uint32_t hashes[bf->hash_count];
-    bloom_hashes(key, key_len, bf->hash_count, bf->bit_array->size_bits, hashes);
 
-    for (uint32_t i = 0; i < bf->hash_count; ++i) {
-        bit_array_set(bf->bit_array, hashes[i]);
+    const double bits = ceil(-(double)n * log(fpr) / (M_LN2 * M_LN2));
+    if (!bloom_filter_init(bf, (size_t)bits)) {
+        return false;
     }
 
+    const double hash_count = round(bits / (double)n * M_LN2);
+    bf->hash_count = hash_count < 1 ? 1 : (size_t)hash_count;
+
     return true;
 }
 
-bool bloom_filter_check(const bloom_filter* bf, const uint8_t* key, const size_t key_len) {
-    uint32_t hashes[bf->hash_count];
-    bloom_hashes(key, key_len, bf->hash_count, bf->bit_array->size_bits, hashes);
+void bloom_filter_add_hashes(const bloom_filter* bf, const uint64_t hashes[2]) {
+    for (size_t i = 0; i < bf->hash_count; ++i) {
+        bit_array_set(bf->bit_array, bloom_filter_bit(hashes, i, bf->bit_array->size_bits));
+    }
+}
+
+bool bloom_filter_add(const bloom_filter* bf, const uint8_t* key, const size_t key_len) {
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+    bloom_filter_add_hashes(bf, hashes);
 
-    for (uint32_t i = 0; i < bf->hash_count; ++i) {
-        if (!bit_array_test(bf->bit_array, hashes[i])) {
+    return true;
+}
+
+bool bloom_filter_check_hashes(const bloom_filter* bf, const uint64_t hashes[2]) {
+    for (size_t i = 0; i < bf->hash_count; ++i) {
+        if (!bit_array_test(bf->bit_array, bloom_filter_bit(hashes, i, bf->bit_array->size_bits))) {
             return false;
         }
     }
@@ -72,6 +62,23 @@ bool bloom_filter_check(const bloom_filter* bf, const uint8_t* key, const size_t
     return true;
 }
 
+bool bloom_filter_check(const bloom_filter* bf, const uint8_t* key, const size_t key_len) {
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+
+    return bloom_filter_check_hashes(bf, hashes);
+}
+
+double bloom_filter_estimated_fpr(const bloom_filter* bf) {
+    // A key that was never added is a false positive if all k of its bits happen to be set
+    const double fill_ratio = (double)bit_array_count(bf->bit_array) / (double)bf->bit_array->size_bits;
+    return pow(fill_ratio, (double)bf->hash_count);
+}
+
+void bloom_filter_clear(const bloom_filter* bf) {
+    bit_array_clear_all(bf->bit_array);
+}
+
 bool bloom_filter_destroy(bloom_filter* bf) {
     if (bf->bit_array != NULL) {
         if (!bit_array_destroy(bf->bit_array)) {
@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "bit_array.h"
+#include "../algos/murmur3.h"
 
 /**
  * A bloom filter is a probabilistic set that can make the following guarantees:
@@ -15,12 +16,15 @@
  * Values stored in the bloom filter are very memory efficient because they use a fixed-size bit array to store hashes
  * of values, rather than the values themselves.
  *
- * Items can't be deleted from a bloom filter.
+ * Items can't be deleted from a bloom filter (see counting_bloom_filter for a filter that supports it).
+ *
+ * Filters are best sized with bloom_filter_init_with_fpr(), which picks the optimal number of bits and hash functions
+ * for an expected number of keys and a target false positive rate.
  *
  * **Example**
  * ```c
  * bloom_filter bf;
- * bloom_filter_init(&bf, 100); // Max 100 values before false positive rate increases
+ * bloom_filter_init_with_fpr(&bf, 100, 0.01); // 1% false positives with up to 100 keys
  *
  * assert(!bloom_filter_check(&bf, "foo"));
  *
@@ -34,7 +38,8 @@ typedef struct bloom_filter {
     /**
      * Number of hash functions to use
      * This should ideally be a minimum of 2
-     * Hash functions use murmur3 but are simulated using the Kirsch & Mitzenmacher technique
+     * Hash functions are simulated from the two 64-bit halves of a murmur3_128() hash, using the Kirsch & Mitzenmacher
+     * technique
      */
     size_t hash_count;
 
@@ -44,6 +49,33 @@ typedef struct bloom_filter {
     bit_array *bit_array;
 } bloom_filter;
 
+/**
+ * Hash a key for the Kirsch & Mitzenmacher technique
+ * https://www.eecs.harvard.edu/~michaelm/postscripts/rsa2008.pdf
+ *
+ * Simulates k hash functions by combining two hashes: g_i(x) = h1(x) + i h2(x) (mod m). The hashes are the 64-bit
+ * halves of a single murmur3_128() hash, so bit positions don't repeat in filters with more than 2^32 bits.
+ *
+ * @param[in] key Key to hash
+ * @param[in] key_len Size of the key
+ * @param[out] hashes_out h1 and h2
+ */
+static inline void bloom_filter_hashes(const uint8_t* key, const size_t key_len, uint64_t hashes_out[2]) {
+    murmur3_128(key, key_len, 0x5f3759df, hashes_out); // Seed: Fast inverse sqrt const
+}
+
+/**
+ * Get the bit for one of the simulated hash functions
+ *
+ * @param[in] hashes h1 and h2 from bloom_filter_hashes()
+ * @param[in] i Hash function number
+ * @param[in] m Total number of bits in the bloom filter
+ * @return Bit position
+ */
+static inline uint64_t bloom_filter_bit(const uint64_t hashes[2], const size_t i, const uint64_t m) {
+    return (hashes[0] + i * hashes[1]) % m;
+}
+
 /**
  * Initialize the bloom filter
  *
@@ -56,6 +88,22 @@ typedef struct bloom_filter {
  */
 bool bloom_filter_init(bloom_filter* bf, size_t size);
 
+/**
+ * Initialize the bloom filter, sized for a target false positive rate
+ *
+ * The filter gets the optimal number of bits, m = -n ln(p) / ln(2)^2, and hash functions, k = (m / n) ln(2), for n
+ * keys. The false positive rate stays at about p until n keys have been added, and rises after that.
+ *
+ * Time complexity: O(m)
+ *
+ * @relates bloom_filter
+ * @param[out] bf Bloom filter
+ * @param[in] n Expected number of keys
+ * @param[in] fpr Target false positive rate (between 0 and 1, exclusive)
+ * @return true on success, false on failure
+ */
+bool bloom_filter_init_with_fpr(bloom_filter* bf, size_t n, double fpr);
+
 /**
  * Add a key to the bloom filter
  *
@@ -69,6 +117,18 @@ bool bloom_filter_init(bloom_filter* bf, size_t size);
  */
 bool bloom_filter_add(const bloom_filter* bf, const uint8_t* key, size_t key_len);
 
+/**
+ * Add a key that's already been hashed to the bloom filter
+ * Lets filters that share hashes (like the sub-filters of a scalable_bloom_filter) hash each key once.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates bloom_filter
+ * @param[in,out] bf Bloom filter
+ * @param[in] hashes h1 and h2 from bloom_filter_hashes()
+ */
+void bloom_filter_add_hashes(const bloom_filter* bf, const uint64_t hashes[2]);
+
 /**
  * Check if a key is in the bloom filter
  *
@@ -85,6 +145,40 @@ bool bloom_filter_add(const bloom_filter* bf, const uint8_t* key, size_t key_len
  */
 bool bloom_filter_check(const bloom_filter* bf, const uint8_t* key, size_t key_len);
 
+/**
+ * Check if a key that's already been hashed is in the bloom filter
+ * {@see bloom_filter_check}
+ *
+ * Time complexity: O(1)
+ *
+ * @relates bloom_filter
+ * @param[in] bf Bloom filter
+ * @param[in] hashes h1 and h2 from bloom_filter_hashes()
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool bloom_filter_check_hashes(const bloom_filter* bf, const uint64_t hashes[2]);
+
+/**
+ * Estimate the bloom filter's current false positive rate, from the fraction of its bits that are set
+ *
+ * Time complexity: O(m)
+ *
+ * @relates bloom_filter
+ * @param[in] bf Bloom filter
+ * @return Estimated probability that checking a key that was never added returns true
+ */
+double bloom_filter_estimated_fpr(const bloom_filter* bf);
+
+/**
+ * Remove all keys from the bloom filter
+ *
+ * Time complexity: O(n)
+ *
+ * @relates bloom_filter
+ * @param[in,out] bf Bloom filter
+ */
+void bloom_filter_clear(const bloom_filter* bf);
+
 /**
  * Destroy the bloom filter
  *
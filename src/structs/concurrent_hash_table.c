@@ -0,0 +1,562 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "concurrent_hash_table.h"
+#include "../utils/log.h"
+
+/**
+ * Remix a key hash so weak custom hash functions still spread across stripes and buckets (murmur3 fmix32 finalizer)
+ *
+ * @param[in] hash Key hash
+ * @return Mixed hash
+ */
+static inline uint32_t mix_hash(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static inline uint32_t hash_key(const concurrent_hash_table* cht, const void* key) {
+    return mix_hash((*cht->key_hash)(key, SIZE_MAX));
+}
+
+static inline concurrent_hash_table_stripe* stripe_for(const concurrent_hash_table* cht, const uint32_t hash) {
+    return &cht->stripes[hash & (cht->stripe_count - 1)];
+}
+
+/**
+ * Round up to a power of 2
+ *
+ * @param[in] n Number
+ * @return Smallest power of 2 that's >= n
+ */
+static size_t round_up_pow2(const size_t n) {
+    size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+static void free_node(epoch_entry* entry) {
+    free(entry);
+}
+
+/**
+ * Free a retired index, along with the nodes that are only reachable from it
+ *
+ * @param[in] entry Retired index
+ */
+static void free_index(epoch_entry* entry) {
+    concurrent_hash_table_index* p_index = (concurrent_hash_table_index*)entry;
+
+    for (size_t i = 0; i < p_index->size; ++i) {
+        concurrent_hash_table_node* p_node = atomic_load_explicit(&p_index->buckets[i], memory_order_relaxed);
+        while (p_node != NULL) {
+            concurrent_hash_table_node* p_next = atomic_load_explicit(&p_node->next, memory_order_relaxed);
+            free(p_node);
+            p_node = p_next;
+        }
+    }
+
+    free(p_index);
+}
+
+/**
+ * Allocate an empty index
+ *
+ * @param[in] size Number of buckets
+ * @return Index or NULL on failure
+ */
+static concurrent_hash_table_index* alloc_index(const size_t size) {
+    concurrent_hash_table_index* p_index = calloc(
+        1,
+        sizeof(concurrent_hash_table_index) + size * sizeof(_Atomic(concurrent_hash_table_node*))
+    );
+    if (p_index == NULL) {
+        log_perror("calloc() failed for concurrent hash table index");
+        return nullptr;
+    }
+
+    p_index->size = size;
+    p_index->retire.free_func = free_index;
+
+    for (size_t i = 0; i < size; ++i) {
+        atomic_init(&p_index->buckets[i], nullptr);
+    }
+
+    return p_index;
+}
+
+static inline _Atomic(concurrent_hash_table_node*)* bucket_for(
+    concurrent_hash_table_index* index,
+    const uint32_t hash
+) {
+    return &index->buckets[hash & (index->size - 1)];
+}
+
+bool concurrent_hash_table_init(
+    concurrent_hash_table* cht,
+    const uint32_t size,
+    const uint32_t stripe_count,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(cht, 0, sizeof(concurrent_hash_table));
+
+    cht->stripe_count = round_up_pow2(stripe_count == 0 ? CONCURRENT_HASH_TABLE_DEFAULT_STRIPES : stripe_count);
+    cht->stripes = aligned_alloc(
+        alignof(concurrent_hash_table_stripe),
+        cht->stripe_count * sizeof(concurrent_hash_table_stripe)
+    );
+    if (cht->stripes == NULL) {
+        log_perror("aligned_alloc() failed for concurrent hash table stripes");
+        return false;
+    }
+
+    // Every stripe needs at least one bucket, so a bucket's stripe is the same in every index size
+    const size_t index_size = round_up_pow2(size < cht->stripe_count ? cht->stripe_count : size);
+    concurrent_hash_table_index* p_index = alloc_index(index_size);
+    if (p_index == NULL) {
+        free(cht->stripes);
+        cht->stripes = nullptr;
+        return false;
+    }
+
+    for (size_t i = 0; i < cht->stripe_count; ++i) {
+        pthread_mutex_init(&cht->stripes[i].lock, NULL);
+        atomic_init(&cht->stripes[i].entry_size, 0);
+        atomic_init(&cht->stripes[i].index, p_index);
+    }
+
+    atomic_init(&cht->index, p_index);
+    cht->prev_index = nullptr;
+    pthread_mutex_init(&cht->resize_lock, NULL);
+    epoch_domain_init(&cht->epoch);
+
+    cht->max_load_factor = CONCURRENT_HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR;
+    cht->key_cmp = key_cmp == NULL ? value_cmp_string : key_cmp;
+    cht->key_hash = key_hash == NULL ? hash_table_key_hash_string : key_hash;
+
+    return true;
+}
+
+/**
+ * Free the nodes in a stripe's buckets of an index, and empty the buckets
+ *
+ * @param[in] cht Concurrent hash table
+ * @param[in] offset Stripe offset
+ * @param[in,out] index Index
+ */
+static void free_stripe_nodes(
+    const concurrent_hash_table* cht,
+    const size_t offset,
+    concurrent_hash_table_index* index
+) {
+    for (size_t i = offset; i < index->size; i += cht->stripe_count) {
+        concurrent_hash_table_node* p_node = atomic_load_explicit(&index->buckets[i], memory_order_relaxed);
+        while (p_node != NULL) {
+            concurrent_hash_table_node* p_next = atomic_load_explicit(&p_node->next, memory_order_relaxed);
+            free(p_node);
+            p_node = p_next;
+        }
+
+        atomic_store_explicit(&index->buckets[i], nullptr, memory_order_relaxed);
+    }
+}
+
+/**
+ * Move a stripe's entries into another index, by copying its nodes (without modifying the source index, which readers
+ * may still be using)
+ *
+ * The stripe's lock must be held. A stripe's buckets are the same in every index, so no other stripe's buckets are
+ * touched.
+ *
+ * @param[in,out] cht Concurrent hash table
+ * @param[in,out] stripe Stripe to migrate
+ * @param[in,out] dst Destination index
+ * @return true on success, false on failure (the stripe stays in its current index)
+ */
+static bool migrate_stripe(
+    concurrent_hash_table* cht,
+    concurrent_hash_table_stripe* stripe,
+    concurrent_hash_table_index* dst
+) {
+    concurrent_hash_table_index* p_src = atomic_load_explicit(&stripe->index, memory_order_relaxed);
+    if (p_src == dst) {
+        return true;
+    }
+
+    const size_t offset = (size_t)(stripe - cht->stripes);
+
+    for (size_t i = offset; i < p_src->size; i += cht->stripe_count) {
+        const concurrent_hash_table_node* p_node = atomic_load_explicit(&p_src->buckets[i], memory_order_relaxed);
+        while (p_node != NULL) {
+            concurrent_hash_table_node* p_copy = malloc(sizeof(concurrent_hash_table_node));
+            if (p_copy == NULL) {
+                log_perror("malloc() failed for concurrent hash table node");
+                free_stripe_nodes(cht, offset, dst);
+                return false;
+            }
+
+            p_copy->retire.free_func = free_node;
+            p_copy->key = p_node->key;
+            p_copy->hash = p_node->hash;
+            atomic_init(&p_copy->value, atomic_load_explicit(&p_node->value, memory_order_relaxed));
+
+            _Atomic(concurrent_hash_table_node*)* p_bucket = bucket_for(dst, p_node->hash);
+            atomic_init(&p_copy->next, atomic_load_explicit(p_bucket, memory_order_relaxed));
+            atomic_store_explicit(p_bucket, p_copy, memory_order_relaxed);
+
+            p_node = atomic_load_explicit(&p_node->next, memory_order_relaxed);
+        }
+    }
+
+    // Readers that see the new index also see the copies in it
+    atomic_store_explicit(&stripe->index, dst, memory_order_release);
+
+    return true;
+}
+
+/**
+ * Get the index that a writer should use for a stripe, migrating the stripe into the newest index first if a resize
+ * hasn't gotten to it yet
+ *
+ * The stripe's lock must be held.
+ *
+ * @param[in,out] cht Concurrent hash table
+ * @param[in,out] stripe Locked stripe
+ * @return Index
+ */
+static concurrent_hash_table_index* writer_index(concurrent_hash_table* cht, concurrent_hash_table_stripe* stripe) {
+    concurrent_hash_table_index* p_newest = atomic_load_explicit(&cht->index, memory_order_acquire);
+    if (!migrate_stripe(cht, stripe, p_newest)) {
+        // Still correct, since readers look in the stripe's index too. The resize retries the migration.
+        return atomic_load_explicit(&stripe->index, memory_order_relaxed);
+    }
+
+    return p_newest;
+}
+
+/**
+ * Migrate every stripe into the newest index, then retire the index they were migrated out of
+ * resize_lock must be held.
+ *
+ * @param[in,out] cht Concurrent hash table
+ * @param[in,out] record Calling thread's epoch record
+ * @return true on success, false on failure (the migration is finished by the next resize)
+ */
+static bool finish_migration(concurrent_hash_table* cht, epoch_record* record) {
+    if (cht->prev_index == NULL) {
+        return true;
+    }
+
+    concurrent_hash_table_index* p_newest = atomic_load_explicit(&cht->index, memory_order_relaxed);
+
+    // One stripe at a time, so writers of the other stripes carry on
+    for (size_t i = 0; i < cht->stripe_count; ++i) {
+        pthread_mutex_lock(&cht->stripes[i].lock);
+        const bool migrated = migrate_stripe(cht, &cht->stripes[i], p_newest);
+        pthread_mutex_unlock(&cht->stripes[i].lock);
+
+        if (!migrated) {
+            return false;
+        }
+    }
+
+    // The old index and its nodes are freed once no reader can still be traversing them
+    epoch_retire(&cht->epoch, record, &cht->prev_index->retire);
+    cht->prev_index = nullptr;
+
+    // An index retired in epoch e can be freed once the epoch reaches e + 2, so try to get there now instead of
+    // waiting for enough other retires (which a table that's only growing may never do)
+    epoch_collect(&cht->epoch, record);
+    epoch_collect(&cht->epoch, record);
+
+    return true;
+}
+
+/**
+ * Replace the index with one of a different size
+ * resize_lock must be held.
+ *
+ * @param[in,out] cht Concurrent hash table
+ * @param[in] new_size New index size (power of 2, at least the stripe count)
+ * @param[in] only_if_larger Skip the resize if the index is already at least new_size (another thread grew it)
+ * @return true on success, false on failure
+ */
+static bool resize(concurrent_hash_table* cht, const size_t new_size, const bool only_if_larger) {
+    epoch_record* p_record = epoch_thread_record(&cht->epoch);
+    if (p_record == NULL) {
+        return false;
+    }
+
+    // Finish a migration that failed part way before starting another one
+    if (!finish_migration(cht, p_record)) {
+        return false;
+    }
+
+    concurrent_hash_table_index* p_old = atomic_load_explicit(&cht->index, memory_order_relaxed);
+    if ((only_if_larger && p_old->size >= new_size) || p_old->size == new_size) {
+        return true;
+    }
+
+    concurrent_hash_table_index* p_new = alloc_index(new_size);
+    if (p_new == NULL) {
+        return false;
+    }
+
+    // Writers migrate their stripe as soon as they see the new index, readers keep using the stripe's index until then
+    cht->prev_index = p_old;
+    atomic_store_explicit(&cht->index, p_new, memory_order_release);
+
+    return finish_migration(cht, p_record);
+}
+
+bool concurrent_hash_table_rehash(concurrent_hash_table* cht, const uint32_t new_size) {
+    if (cht->stripes == NULL) {
+        log_error("concurrent hash table not initialized");
+        return false;
+    }
+
+    const size_t size = round_up_pow2(new_size < cht->stripe_count ? cht->stripe_count : new_size);
+
+    // Wait for any automatic resize to finish
+    pthread_mutex_lock(&cht->resize_lock);
+    const bool resized = resize(cht, size, false);
+    pthread_mutex_unlock(&cht->resize_lock);
+
+    return resized;
+}
+
+/**
+ * Grow the index if the load factor is above its max
+ *
+ * Entries are spread evenly over stripes, so the load factor is estimated from a single stripe's entry count instead of
+ * summing every stripe's.
+ *
+ * @param[in,out] cht Concurrent hash table
+ * @param[in] stripe Stripe that was just inserted into
+ * @param[in] index_size Size of the index that was inserted into
+ * @return true on success, false on failure
+ */
+static bool check_load_factor(
+    concurrent_hash_table* cht,
+    concurrent_hash_table_stripe* stripe,
+    const size_t index_size
+) {
+    if (cht->max_load_factor <= 0) {
+        return true;
+    }
+
+    const size_t stripe_size = atomic_load_explicit(&stripe->entry_size, memory_order_relaxed);
+    if ((double)stripe_size * (double)cht->stripe_count <= (double)index_size * cht->max_load_factor) {
+        return true;
+    }
+
+    // Only one thread grows the index, the rest keep going
+    if (pthread_mutex_trylock(&cht->resize_lock) != 0) {
+        return true;
+    }
+
+    const bool resized = resize(cht, index_size * 2, true);
+    pthread_mutex_unlock(&cht->resize_lock);
+
+    return resized;
+}
+
+/**
+ * Find a node in a bucket chain
+ *
+ * @param[in] cht Concurrent hash table
+ * @param[in] head First node in the chain
+ * @param[in] key Key to find
+ * @param[in] hash Full (mixed) hash of the key
+ * @return Node or NULL if not found
+ */
+static concurrent_hash_table_node* find_node(
+    const concurrent_hash_table* cht,
+    concurrent_hash_table_node* head,
+    const void* key,
+    const uint32_t hash
+) {
+    for (concurrent_hash_table_node* p_node = head; p_node != NULL; ) {
+        if (p_node->hash == hash && (*cht->key_cmp)(p_node->key, key) == 0) {
+            return p_node;
+        }
+
+        p_node = atomic_load_explicit(&p_node->next, memory_order_acquire);
+    }
+
+    return nullptr;
+}
+
+bool concurrent_hash_table_set(concurrent_hash_table* cht, void* key, void* value) {
+    if (cht->stripes == NULL) {
+        log_error("concurrent hash table not initialized");
+        return false;
+    }
+
+    const uint32_t hash = hash_key(cht, key);
+    concurrent_hash_table_stripe* p_stripe = stripe_for(cht, hash);
+
+    pthread_mutex_lock(&p_stripe->lock);
+
+    // The stripe can't be migrated to another index while its lock is held
+    concurrent_hash_table_index* p_index = writer_index(cht, p_stripe);
+    _Atomic(concurrent_hash_table_node*)* p_bucket = bucket_for(p_index, hash);
+    concurrent_hash_table_node* p_head = atomic_load_explicit(p_bucket, memory_order_acquire);
+
+    concurrent_hash_table_node* p_node = find_node(cht, p_head, key, hash);
+    if (p_node != NULL) {
+        // Update existing entry
+        atomic_store_explicit(&p_node->value, value, memory_order_release);
+        pthread_mutex_unlock(&p_stripe->lock);
+        return true;
+    }
+
+    p_node = malloc(sizeof(concurrent_hash_table_node));
+    if (p_node == NULL) {
+        log_perror("malloc() failed for concurrent hash table node");
+        pthread_mutex_unlock(&p_stripe->lock);
+        return false;
+    }
+
+    p_node->retire.free_func = free_node;
+    p_node->key = key;
+    p_node->hash = hash;
+    atomic_init(&p_node->value, value);
+    atomic_init(&p_node->next, p_head);
+
+    // Publish the fully initialized node to readers
+    atomic_store_explicit(p_bucket, p_node, memory_order_release);
+    atomic_fetch_add_explicit(&p_stripe->entry_size, 1, memory_order_relaxed);
+
+    const size_t index_size = p_index->size;
+    pthread_mutex_unlock(&p_stripe->lock);
+
+    return check_load_factor(cht, p_stripe, index_size);
+}
+
+void* concurrent_hash_table_get(concurrent_hash_table* cht, const void* key) {
+    if (cht->stripes == NULL) {
+        log_error("concurrent hash table not initialized");
+        return nullptr;
+    }
+
+    epoch_record* p_record = epoch_thread_record(&cht->epoch);
+    if (p_record == NULL) {
+        return nullptr;
+    }
+
+    const uint32_t hash = hash_key(cht, key);
+    void* value = nullptr;
+
+    epoch_enter(&cht->epoch, p_record);
+
+    // The stripe's index, which is the old one during a resize until the stripe has been migrated
+    concurrent_hash_table_index* p_index = atomic_load_explicit(&stripe_for(cht, hash)->index, memory_order_acquire);
+    concurrent_hash_table_node* p_head = atomic_load_explicit(bucket_for(p_index, hash), memory_order_acquire);
+
+    concurrent_hash_table_node* p_node = find_node(cht, p_head, key, hash);
+    if (p_node != NULL) {
+        value = atomic_load_explicit(&p_node->value, memory_order_acquire);
+    }
+
+    epoch_exit(p_record);
+
+    return value;
+}
+
+bool concurrent_hash_table_del(concurrent_hash_table* cht, const void* key) {
+    if (cht->stripes == NULL) {
+        log_error("concurrent hash table not initialized");
+        return false;
+    }
+
+    epoch_record* p_record = epoch_thread_record(&cht->epoch);
+    if (p_record == NULL) {
+        return false;
+    }
+
+    const uint32_t hash = hash_key(cht, key);
+    concurrent_hash_table_stripe* p_stripe = stripe_for(cht, hash);
+
+    pthread_mutex_lock(&p_stripe->lock);
+
+    concurrent_hash_table_index* p_index = writer_index(cht, p_stripe);
+    _Atomic(concurrent_hash_table_node*)* p_link = bucket_for(p_index, hash);
+
+    for (
+        concurrent_hash_table_node* p_node = atomic_load_explicit(p_link, memory_order_acquire);
+        p_node != NULL;
+        p_node = atomic_load_explicit(p_link, memory_order_acquire)
+    ) {
+        if (p_node->hash == hash && (*cht->key_cmp)(p_node->key, key) == 0) {
+            // Unlink, but leave the node's next pointer alone so readers that are on it can keep going
+            atomic_store_explicit(
+                p_link,
+                atomic_load_explicit(&p_node->next, memory_order_relaxed),
+                memory_order_release
+            );
+            atomic_fetch_sub_explicit(&p_stripe->entry_size, 1, memory_order_relaxed);
+            pthread_mutex_unlock(&p_stripe->lock);
+
+            epoch_retire(&cht->epoch, p_record, &p_node->retire);
+            return true;
+        }
+
+        p_link = &p_node->next;
+    }
+
+    pthread_mutex_unlock(&p_stripe->lock);
+    log_debug("concurrent hash table has no entry for key");
+
+    return false;
+}
+
+size_t concurrent_hash_table_size(concurrent_hash_table* cht) {
+    size_t size = 0;
+    for (size_t i = 0; i < cht->stripe_count; ++i) {
+        size += atomic_load_explicit(&cht->stripes[i].entry_size, memory_order_relaxed);
+    }
+
+    return size;
+}
+
+void concurrent_hash_table_thread_detach(concurrent_hash_table* cht) {
+    epoch_thread_detach(&cht->epoch);
+}
+
+bool concurrent_hash_table_destroy(concurrent_hash_table* cht) {
+    if (cht->stripes == NULL) {
+        return false;
+    }
+
+    free_index(&atomic_load(&cht->index)->retire);
+    atomic_store(&cht->index, nullptr);
+
+    // Only left if a resize failed part way (migrated stripes' nodes in it are copies, so nothing is freed twice)
+    if (cht->prev_index != NULL) {
+        free_index(&cht->prev_index->retire);
+        cht->prev_index = nullptr;
+    }
+
+    epoch_domain_destroy(&cht->epoch);
+
+    for (size_t i = 0; i < cht->stripe_count; ++i) {
+        pthread_mutex_destroy(&cht->stripes[i].lock);
+    }
+
+    pthread_mutex_destroy(&cht->resize_lock);
+
+    free(cht->stripes);
+    cht->stripes = nullptr;
+    cht->stripe_count = 0;
+
+    return true;
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "hash_table.h"
+#include "../utils/epoch.h"
+#include "../utils/value.h"
+
+/**
+ * Default number of lock stripes
+ */
+#define CONCURRENT_HASH_TABLE_DEFAULT_STRIPES 64
+
+/**
+ * Default max load factor (entries per bucket) before the index grows
+ */
+#define CONCURRENT_HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR 1.0f
+
+/**
+ * Concurrent hash table entry
+ */
+typedef struct concurrent_hash_table_node {
+    /**
+     * Used to retire the node after it's deleted (must be first)
+     */
+    epoch_entry retire;
+
+    void* key;
+    _Atomic(void*) value;
+
+    /**
+     * Full hash of the key
+     */
+    uint32_t hash;
+
+    _Atomic(struct concurrent_hash_table_node*) next;
+} concurrent_hash_table_node;
+
+/**
+ * Concurrent hash table index (bucket array)
+ */
+typedef struct concurrent_hash_table_index {
+    /**
+     * Used to retire the index (and its nodes) after it's replaced by a resize (must be first)
+     */
+    epoch_entry retire;
+
+    /**
+     * Number of buckets (power of 2, and a multiple of the stripe count)
+     */
+    size_t size;
+
+    /**
+     * Bucket chain heads
+     */
+    _Atomic(concurrent_hash_table_node*) buckets[];
+} concurrent_hash_table_index;
+
+/**
+ * Writer lock for the buckets whose offset is congruent to the stripe's offset (mod the stripe count)
+ * Padded to its own cache line so stripes don't contend with each other
+ */
+typedef struct concurrent_hash_table_stripe {
+    alignas(64) pthread_mutex_t lock;
+
+    /**
+     * Number of entries in this stripe's buckets
+     */
+    _Atomic size_t entry_size;
+
+    /**
+     * Index that holds this stripe's entries (behind the table's index until a resize migrates the stripe)
+     */
+    _Atomic(concurrent_hash_table_index*) index;
+} concurrent_hash_table_stripe;
+
+/**
+ * A hash table that can be used by many threads at once.
+ *
+ * Writers (set and delete) lock one of a fixed number of stripes, chosen from the key's hash, so writers of unrelated
+ * keys rarely contend. Readers never lock: bucket heads and chain links are atomic, and deleted entries are only freed
+ * once no reader can still be looking at them (using epoch-based reclamation, see epoch_domain).
+ *
+ * The index grows automatically (doubles) when the load factor goes above max_load_factor. A resize publishes a new index,
+ * then migrates one stripe at a time, copying its entries into the new index under just that stripe's lock. Readers
+ * look a key up in whichever index its stripe is in, so they keep going throughout, and a writer only waits while its
+ * own stripe is copied (or copies it itself if it gets there first).
+ *
+ * Keys and values aren't copied or freed by the table. A value returned by concurrent_hash_table_get() may be replaced
+ * or deleted by another thread right after it's returned, so values that are freed by their owner need their own
+ * reclamation scheme.
+ *
+ * Each thread that uses the table gets an epoch record the first time it does. Threads that exit should call
+ * concurrent_hash_table_thread_detach() first so their record can be reused.
+ *
+ * **Example**
+ * ```c
+ * concurrent_hash_table cht;
+ * concurrent_hash_table_init(&cht, 1024, 0, NULL, NULL); // Default stripes, string keys
+ *
+ * // From any thread
+ * concurrent_hash_table_set(&cht, "foo", "one");
+ * char* foo = concurrent_hash_table_get(&cht, "foo");
+ * concurrent_hash_table_del(&cht, "foo");
+ *
+ * concurrent_hash_table_destroy(&cht); // Once all threads are done
+ * ```
+ */
+typedef struct concurrent_hash_table {
+    /**
+     * Newest index (stripes are migrated into it by the resize that published it)
+     */
+    _Atomic(concurrent_hash_table_index*) index;
+
+    /**
+     * Index that stripes are being migrated out of, or NULL once every stripe is in the newest index
+     * Only used with resize_lock held
+     */
+    concurrent_hash_table_index* prev_index;
+
+    /**
+     * Writer lock stripes
+     */
+    concurrent_hash_table_stripe* stripes;
+
+    /**
+     * Number of stripes (power of 2)
+     */
+    size_t stripe_count;
+
+    /**
+     * Load factor (entries per bucket) above which the index automatically grows, or 0 to never grow
+     * Default: CONCURRENT_HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR
+     */
+    float max_load_factor;
+
+    /**
+     * Held while a thread is resizing the index
+     */
+    pthread_mutex_t resize_lock;
+
+    /**
+     * Key comparator function
+     * Default: String comparator
+     */
+    value_cmp_func key_cmp;
+
+    /**
+     * Key hash function (called with ht_size set to SIZE_MAX)
+     * Default: String hash function
+     */
+    hash_table_key_hash_func key_hash;
+
+    /**
+     * Reclaims deleted nodes and replaced indexes
+     */
+    epoch_domain epoch;
+} concurrent_hash_table;
+
+/**
+ * Initialize the concurrent hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates concurrent_hash_table
+ * @param[out] cht Concurrent hash table
+ * @param[in] size Initial index size (rounded up to a power of 2, and at least the stripe count)
+ * @param[in] stripe_count Number of writer lock stripes (rounded up to a power of 2), or 0 to use the default
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool concurrent_hash_table_init(
+    concurrent_hash_table* cht,
+    uint32_t size,
+    uint32_t stripe_count,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash
+);
+
+/**
+ * Resize the concurrent hash table's index
+ *
+ * This can be called while other threads are using the table, and waits for any automatic resize to finish first.
+ *
+ * Time complexity: O(n)
+ *
+ * @relates concurrent_hash_table
+ * @param[in,out] cht Concurrent hash table
+ * @param[in] new_size New index size (rounded up to a power of 2, and at least the stripe count)
+ * @return true on success, false on failure
+ */
+bool concurrent_hash_table_rehash(concurrent_hash_table* cht, uint32_t new_size);
+
+/**
+ * Set a value in the concurrent hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates concurrent_hash_table
+ * @param[in,out] cht Concurrent hash table
+ * @param[in] key Pointer to key
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+bool concurrent_hash_table_set(concurrent_hash_table* cht, void* key, void* value);
+
+/**
+ * Get value from the concurrent hash table (without locking)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates concurrent_hash_table
+ * @param[in] cht Concurrent hash table
+ * @param[in] key Entry key to get value for
+ * @return Value pointer, or NULL if not found
+ */
+void* concurrent_hash_table_get(concurrent_hash_table* cht, const void* key);
+
+/**
+ * Delete entry from the concurrent hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates concurrent_hash_table
+ * @param[in,out] cht Concurrent hash table
+ * @param[in] key Entry key to delete
+ * @return true on success, false on failure
+ */
+bool concurrent_hash_table_del(concurrent_hash_table* cht, const void* key);
+
+/**
+ * Get the number of entries in the concurrent hash table
+ * Only exact when no other thread is modifying the table
+ *
+ * Time complexity: O(stripes)
+ *
+ * @relates concurrent_hash_table
+ * @param[in] cht Concurrent hash table
+ * @return Number of entries
+ */
+size_t concurrent_hash_table_size(concurrent_hash_table* cht);
+
+/**
+ * Release the calling thread's epoch record for the table, so another thread can reuse it
+ *
+ * Time complexity: O(1)
+ *
+ * @relates concurrent_hash_table
+ * @param[in,out] cht Concurrent hash table
+ */
+void concurrent_hash_table_thread_detach(concurrent_hash_table* cht);
+
+/**
+ * Destroy the concurrent hash table
+ *
+ * No other thread may be using the table.
+ *
+ * Time complexity: O(n)
+ *
+ * @relates concurrent_hash_table
+ * @param[in,out] cht Concurrent hash table
+ * @return true on success, false on failure
+ */
+bool concurrent_hash_table_destroy(concurrent_hash_table* cht);
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "count_min_sketch.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+/**
+ * Number of 4-bit counters in each table word
+ */
+#define COUNTERS_PER_WORD 16
+
+bool count_min_sketch_init(count_min_sketch* cms, const size_t width) {
+    memset(cms, 0, sizeof(count_min_sketch));
+
+    cms->width = COUNTERS_PER_WORD;
+    while (cms->width < width) {
+        cms->width <<= 1;
+    }
+    cms->row_words = cms->width / COUNTERS_PER_WORD;
+
+    cms->table = calloc(COUNT_MIN_SKETCH_DEPTH * cms->row_words, sizeof(uint64_t));
+    if (cms->table == NULL) {
+        log_perror("calloc() failed");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Get the counter index of a key in each row
+ * Row hashes are simulated from two murmur3 hashes (Kirsch & Mitzenmacher), like bloom_filter does
+ *
+ * @param[in] cms Count-min sketch
+ * @param[in] key Key to hash
+ * @param[in] key_len Length of the key
+ * @param[out] indexes_out Counter index in each row
+ */
+static void row_indexes(
+    const count_min_sketch* cms,
+    const uint8_t* key,
+    const size_t key_len,
+    size_t indexes_out[COUNT_MIN_SKETCH_DEPTH]
+) {
+    const uint32_t hash1 = murmur3(key, key_len, 0x5f3759df); // Seed: Fast inverse sqrt const
+    const uint32_t hash2 = murmur3(key, key_len, 0x9e3779b9); // Seed: Golden ratio prime
+
+    for (uint32_t i = 0; i < COUNT_MIN_SKETCH_DEPTH; ++i) {
+        indexes_out[i] = (hash1 + i * hash2) & (cms->width - 1);
+    }
+}
+
+/**
+ * Get a pointer to the word holding a counter
+ *
+ * @param[in] cms Count-min sketch
+ * @param[in] row Row
+ * @param[in] index Counter index in the row
+ * @return Table word
+ */
+static inline uint64_t* counter_word(const count_min_sketch* cms, const uint32_t row, const size_t index) {
+    return &cms->table[row * cms->row_words + index / COUNTERS_PER_WORD];
+}
+
+/**
+ * Get the bit offset of a counter within its word
+ *
+ * @param[in] index Counter index in the row
+ * @return Bit offset
+ */
+static inline uint32_t counter_shift(const size_t index) {
+    return (index % COUNTERS_PER_WORD) * 4;
+}
+
+void count_min_sketch_increment(count_min_sketch* cms, const uint8_t* key, const size_t key_len) {
+    size_t indexes[COUNT_MIN_SKETCH_DEPTH];
+    row_indexes(cms, key, key_len, indexes);
+
+    for (uint32_t i = 0; i < COUNT_MIN_SKETCH_DEPTH; ++i) {
+        uint64_t* p_word = counter_word(cms, i, indexes[i]);
+        const uint32_t shift = counter_shift(indexes[i]);
+
+        if (((*p_word >> shift) & 0xf) < COUNT_MIN_SKETCH_MAX_COUNT) {
+            *p_word += 1ULL << shift;
+        }
+    }
+}
+
+uint8_t count_min_sketch_estimate(const count_min_sketch* cms, const uint8_t* key, const size_t key_len) {
+    size_t indexes[COUNT_MIN_SKETCH_DEPTH];
+    row_indexes(cms, key, key_len, indexes);
+
+    uint8_t estimate = COUNT_MIN_SKETCH_MAX_COUNT;
+    for (uint32_t i = 0; i < COUNT_MIN_SKETCH_DEPTH; ++i) {
+        const uint8_t count = (*counter_word(cms, i, indexes[i]) >> counter_shift(indexes[i])) & 0xf;
+        if (count < estimate) {
+            estimate = count;
+        }
+    }
+
+    return estimate;
+}
+
+void count_min_sketch_halve(count_min_sketch* cms) {
+    // Shift every counter right by one at once, masking off the bit that each counter shifts into its neighbor
+    for (size_t i = 0; i < COUNT_MIN_SKETCH_DEPTH * cms->row_words; ++i) {
+        cms->table[i] = (cms->table[i] >> 1) & 0x7777777777777777ULL;
+    }
+}
+
+void count_min_sketch_clear(count_min_sketch* cms) {
+    memset(cms->table, 0, COUNT_MIN_SKETCH_DEPTH * cms->row_words * sizeof(uint64_t));
+}
+
+bool count_min_sketch_destroy(count_min_sketch* cms) {
+    if (cms->table != NULL) {
+        free(cms->table);
+        cms->table = nullptr;
+    }
+
+    cms->width = 0;
+    cms->row_words = 0;
+
+    return true;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Number of rows (hash functions) in a count-min sketch
+ */
+#define COUNT_MIN_SKETCH_DEPTH 4
+
+/**
+ * Max value of a counter (counters are 4 bits wide, and saturate)
+ */
+#define COUNT_MIN_SKETCH_MAX_COUNT 15
+
+/**
+ * A count-min sketch estimates how many times each key was added, in a fixed amount of memory.
+ *
+ * Each key maps to one counter in each of COUNT_MIN_SKETCH_DEPTH rows, and its estimate is the smallest of those
+ * counters. Collisions can only make a counter larger, so estimates can be too high but never too low.
+ *
+ * Counters are 4 bits (16 to a 64-bit word) and stop at COUNT_MIN_SKETCH_MAX_COUNT. This is meant for telling popular
+ * keys apart from unpopular ones (e.g. cache admission), rather than for exact counts. count_min_sketch_halve() ages
+ * all counts, so keys that used to be popular fade out.
+ *
+ * Row hashes are simulated from two murmur3 hashes, the same way bloom_filter does.
+ *
+ * **Example**
+ * ```c
+ * count_min_sketch cms;
+ * count_min_sketch_init(&cms, 1000); // About 1000 distinct keys
+ *
+ * count_min_sketch_increment(&cms, (uint8_t *)"foo", 3);
+ * count_min_sketch_increment(&cms, (uint8_t *)"foo", 3);
+ * assert(count_min_sketch_estimate(&cms, (uint8_t *)"foo", 3) >= 2);
+ *
+ * count_min_sketch_destroy(&cms);
+ * ```
+ */
+typedef struct count_min_sketch {
+    /**
+     * Counters, COUNT_MIN_SKETCH_DEPTH rows of row_words words each
+     */
+    uint64_t* table;
+
+    /**
+     * Number of counters per row (always a power of 2, and at least 16)
+     */
+    size_t width;
+
+    /**
+     * Number of words per row
+     */
+    size_t row_words;
+} count_min_sketch;
+
+/**
+ * Initialize the count-min sketch
+ *
+ * Time complexity: O(n)
+ *
+ * @relates count_min_sketch
+ * @param[out] cms Count-min sketch
+ * @param[in] width Number of counters per row (rounded up to a power of 2). This should be about the number of distinct
+ *   keys that are being counted, since more collisions make estimates less accurate.
+ * @return true on success, false on failure
+ */
+bool count_min_sketch_init(count_min_sketch* cms, size_t width);
+
+/**
+ * Increment a key's count in the count-min sketch
+ *
+ * Time complexity: O(1)
+ *
+ * @relates count_min_sketch
+ * @param[in,out] cms Count-min sketch
+ * @param[in] key Key to count
+ * @param[in] key_len Length of the key
+ */
+void count_min_sketch_increment(count_min_sketch* cms, const uint8_t* key, size_t key_len);
+
+/**
+ * Estimate how many times a key was counted
+ *
+ * Time complexity: O(1)
+ *
+ * @relates count_min_sketch
+ * @param[in] cms Count-min sketch
+ * @param[in] key Key to estimate
+ * @param[in] key_len Length of the key
+ * @return Estimated count (never less than the real count, up to COUNT_MIN_SKETCH_MAX_COUNT)
+ */
+uint8_t count_min_sketch_estimate(const count_min_sketch* cms, const uint8_t* key, size_t key_len);
+
+/**
+ * Halve all counts in the count-min sketch (rounding down)
+ *
+ * Time complexity: O(n)
+ *
+ * @relates count_min_sketch
+ * @param[in,out] cms Count-min sketch
+ */
+void count_min_sketch_halve(count_min_sketch* cms);
+
+/**
+ * Reset all counts in the count-min sketch to 0
+ *
+ * Time complexity: O(n)
+ *
+ * @relates count_min_sketch
+ * @param[in,out] cms Count-min sketch
+ */
+void count_min_sketch_clear(count_min_sketch* cms);
+
+/**
+ * Destroy the count-min sketch
+ *
+ * Time complexity: O(1)
+ *
+ * @relates count_min_sketch
+ * @param[in,out] cms Count-min sketch
+ * @return true on success, false on failure
+ */
+bool count_min_sketch_destroy(count_min_sketch* cms);
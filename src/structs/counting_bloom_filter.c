@@ -0,0 +1,166 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "counting_bloom_filter.h"
+#include "../utils/log.h"
+
+/**
+ * Number of 4-bit counters in each word
+ */
+#define COUNTERS_PER_WORD 16
+
+bool counting_bloom_filter_init(counting_bloom_filter* cbf, const size_t size) {
+    memset(cbf, 0, sizeof(counting_bloom_filter));
+
+    // Rounded like a bit_array, so a compacted bloom_filter has the same number of bits
+    cbf->size = size == 0 ? 32 : (size + 31) / 32 * 32;
+    cbf->hash_count = 2;
+
+    cbf->counters = calloc(cbf->size / COUNTERS_PER_WORD, sizeof(uint64_t));
+    if (cbf->counters == NULL) {
+        log_perror("calloc() failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool counting_bloom_filter_init_with_fpr(counting_bloom_filter* cbf, const size_t n, const double fpr) {
+    if (n == 0 || !(fpr > 0 && fpr < 1)) {
+        log_error("invalid counting bloom filter size: %zu keys with a false positive rate of %f", n, fpr);
+        return false;
+    }
+
+    // Same as bloom_filter_init_with_fpr()
+    const double size = ceil(-(double)n * log(fpr) / (M_LN2 * M_LN2));
+    if (!counting_bloom_filter_init(cbf, (size_t)size)) {
+        return false;
+    }
+
+    const double hash_count = round(size / (double)n * M_LN2);
+    cbf->hash_count = hash_count < 1 ? 1 : (size_t)hash_count;
+
+    return true;
+}
+
+/**
+ * Get a counter's value
+ *
+ * @param[in] cbf Counting bloom filter
+ * @param[in] index Counter index
+ * @return Counter value
+ */
+static inline uint8_t counter_get(const counting_bloom_filter* cbf, const uint64_t index) {
+    return (cbf->counters[index / COUNTERS_PER_WORD] >> (index % COUNTERS_PER_WORD * 4)) & 0xf;
+}
+
+bool counting_bloom_filter_add(counting_bloom_filter* cbf, const uint8_t* key, const size_t key_len) {
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+
+    for (size_t i = 0; i < cbf->hash_count; ++i) {
+        const uint64_t index = bloom_filter_bit(hashes, i, cbf->size);
+        const uint8_t count = counter_get(cbf, index);
+
+        if (count < COUNTING_BLOOM_FILTER_MAX_COUNT) {
+            cbf->counters[index / COUNTERS_PER_WORD] += 1ULL << (index % COUNTERS_PER_WORD * 4);
+            cbf->saturated += count + 1 == COUNTING_BLOOM_FILTER_MAX_COUNT;
+        }
+    }
+
+    return true;
+}
+
+bool counting_bloom_filter_check(const counting_bloom_filter* cbf, const uint8_t* key, const size_t key_len) {
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+
+    for (size_t i = 0; i < cbf->hash_count; ++i) {
+        if (counter_get(cbf, bloom_filter_bit(hashes, i, cbf->size)) == 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool counting_bloom_filter_remove(counting_bloom_filter* cbf, const uint8_t* key, const size_t key_len) {
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+
+    // Check first, so removing a key that isn't a member doesn't decrement some of its counters
+    for (size_t i = 0; i < cbf->hash_count; ++i) {
+        if (counter_get(cbf, bloom_filter_bit(hashes, i, cbf->size)) == 0) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < cbf->hash_count; ++i) {
+        const uint64_t index = bloom_filter_bit(hashes, i, cbf->size);
+        const uint8_t count = counter_get(cbf, index);
+
+        // A key can hit the same counter more than once, so it can already be 0
+        if (count > 0 && count < COUNTING_BLOOM_FILTER_MAX_COUNT) {
+            cbf->counters[index / COUNTERS_PER_WORD] -= 1ULL << (index % COUNTERS_PER_WORD * 4);
+        }
+    }
+
+    return true;
+}
+
+size_t counting_bloom_filter_saturated(const counting_bloom_filter* cbf) {
+    return cbf->saturated;
+}
+
+/**
+ * Get a bit for each counter in a word that isn't 0
+ *
+ * @param[in] word Counters
+ * @return Bit i is set if counter i isn't 0
+ */
+static inline uint32_t nonzero_counters(const uint64_t word) {
+    // Fold each counter onto its lowest bit, then gather every 4th bit
+    uint64_t bits = (word | word >> 1 | word >> 2 | word >> 3) & 0x1111111111111111ULL;
+    bits = (bits | bits >> 3) & 0x0303030303030303ULL;
+    bits = (bits | bits >> 6) & 0x000f000f000f000fULL;
+    bits = (bits | bits >> 12) & 0x000000ff000000ffULL;
+    bits = (bits | bits >> 24) & 0x000000000000ffffULL;
+
+    return (uint32_t)bits;
+}
+
+bool counting_bloom_filter_compact(const counting_bloom_filter* cbf, bloom_filter* bf_out) {
+    if (!bloom_filter_init(bf_out, cbf->size)) {
+        return false;
+    }
+
+    bf_out->hash_count = cbf->hash_count;
+
+    // Each bit array element holds the bits of 2 words of counters
+    uint32_t* p_bits = bf_out->bit_array->bit_array;
+    for (size_t i = 0; i < cbf->size / COUNTERS_PER_WORD; i += 2) {
+        p_bits[i / 2] = nonzero_counters(cbf->counters[i]) | nonzero_counters(cbf->counters[i + 1]) << 16;
+    }
+
+    return true;
+}
+
+void counting_bloom_filter_clear(counting_bloom_filter* cbf) {
+    memset(cbf->counters, 0, cbf->size / COUNTERS_PER_WORD * sizeof(uint64_t));
+    cbf->saturated = 0;
+}
+
+bool counting_bloom_filter_destroy(counting_bloom_filter* cbf) {
+    if (cbf->counters != NULL) {
+        free(cbf->counters);
+        cbf->counters = nullptr;
+    }
+
+    cbf->size = 0;
+    cbf->hash_count = 0;
+    cbf->saturated = 0;
+
+    return true;
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "bloom_filter.h"
+
+/**
+ * Max value of a counter (counters are 4 bits wide, and saturate)
+ */
+#define COUNTING_BLOOM_FILTER_MAX_COUNT 15
+
+/**
+ * A counting bloom filter is a bloom filter (see bloom_filter) that keeps a small counter for each position instead of
+ * a bit, so keys can be removed as well as added. Adding a key increments its k counters, removing it decrements them,
+ * and a key is a member if none of its counters are 0.
+ *
+ * Counters are 4 bits (16 to a 64-bit word), so the filter takes 4 times the memory of a bloom_filter with the same
+ * number of positions. Keys map to positions with the same hashes as bloom_filter, so
+ * counting_bloom_filter_compact() can turn the counters into a bloom_filter with exactly the same members, for read
+ * only serving.
+ *
+ * A counter that reaches COUNTING_BLOOM_FILTER_MAX_COUNT saturates: its real count isn't known anymore, so it's never
+ * decremented again (which would cause false negatives). Saturation needs 15 keys on one position, which is very
+ * unlikely in a filter that's sized for its keys, and counting_bloom_filter_saturated() reports it when it happens.
+ *
+ * Only keys that were added should be removed. Removing a key that wasn't added (but is a false positive) decrements
+ * other keys' counters, and can make them false negatives.
+ *
+ * **Example**
+ * ```c
+ * counting_bloom_filter cbf;
+ * counting_bloom_filter_init_with_fpr(&cbf, 1000, 0.01); // 1% false positives with up to 1000 keys
+ *
+ * counting_bloom_filter_add(&cbf, (uint8_t *)"foo", 3);
+ * assert(counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3));
+ *
+ * counting_bloom_filter_remove(&cbf, (uint8_t *)"foo", 3);
+ * assert(!counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3));
+ *
+ * bloom_filter bf;
+ * counting_bloom_filter_compact(&cbf, &bf); // Read only copy
+ *
+ * bloom_filter_destroy(&bf);
+ * counting_bloom_filter_destroy(&cbf);
+ * ```
+ */
+typedef struct counting_bloom_filter {
+    /**
+     * Number of hash functions to use (see bloom_filter)
+     */
+    size_t hash_count;
+
+    /**
+     * Number of counters (always a multiple of 32, like the size of a bloom_filter's bit array)
+     */
+    size_t size;
+
+    /**
+     * Counters, 16 to a word
+     */
+    uint64_t* counters;
+
+    /**
+     * Number of counters that have saturated
+     */
+    size_t saturated;
+} counting_bloom_filter;
+
+/**
+ * Initialize the counting bloom filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates counting_bloom_filter
+ * @param[out] cbf Counting bloom filter
+ * @param[in] size Number of counters (rounded up to a multiple of 32)
+ * @return true on success, false on failure
+ */
+bool counting_bloom_filter_init(counting_bloom_filter* cbf, size_t size);
+
+/**
+ * Initialize the counting bloom filter, sized for a target false positive rate
+ * The number of counters and hash functions is the same as bloom_filter_init_with_fpr() picks.
+ *
+ * Time complexity: O(m)
+ *
+ * @relates counting_bloom_filter
+ * @param[out] cbf Counting bloom filter
+ * @param[in] n Expected number of keys
+ * @param[in] fpr Target false positive rate (between 0 and 1, exclusive)
+ * @return true on success, false on failure
+ */
+bool counting_bloom_filter_init_with_fpr(counting_bloom_filter* cbf, size_t n, double fpr);
+
+/**
+ * Add a key to the counting bloom filter
+ *
+ * Time complexity: O(k)
+ *
+ * @relates counting_bloom_filter
+ * @param[in,out] cbf Counting bloom filter
+ * @param[in] key Key to add
+ * @param[in] key_len Length of the key
+ * @return true on success, false on failure
+ */
+bool counting_bloom_filter_add(counting_bloom_filter* cbf, const uint8_t* key, size_t key_len);
+
+/**
+ * Remove a key from the counting bloom filter
+ *
+ * The key must have been added (see counting_bloom_filter). Nothing is changed if the key isn't a member.
+ *
+ * Time complexity: O(k)
+ *
+ * @relates counting_bloom_filter
+ * @param[in,out] cbf Counting bloom filter
+ * @param[in] key Key to remove
+ * @param[in] key_len Length of the key
+ * @return true if the key was removed, false if it isn't a member
+ */
+bool counting_bloom_filter_remove(counting_bloom_filter* cbf, const uint8_t* key, size_t key_len);
+
+/**
+ * Check if a key is in the counting bloom filter
+ *
+ * False positives are possible (meaning this can indicate that a key is a member when it's not)
+ * False negatives are impossible (meaning this can't indicate that a key is not a member when it is), as long as only
+ * keys that were added are removed
+ *
+ * Time complexity: O(k)
+ *
+ * @relates counting_bloom_filter
+ * @param[in] cbf Counting bloom filter
+ * @param[in] key Key to check
+ * @param[in] key_len Length of the key
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool counting_bloom_filter_check(const counting_bloom_filter* cbf, const uint8_t* key, size_t key_len);
+
+/**
+ * Get the number of counters that have saturated (overflowed)
+ *
+ * Saturated counters are never decremented, so removed keys on them stay (false positive) members until the filter is
+ * cleared. A growing number means the filter is too small for its keys.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates counting_bloom_filter
+ * @param[in] cbf Counting bloom filter
+ * @return Number of saturated counters
+ */
+size_t counting_bloom_filter_saturated(const counting_bloom_filter* cbf);
+
+/**
+ * Compact the counting bloom filter into a (4 times smaller) bloom filter with the same members
+ *
+ * Each bit of the bloom filter is set if its counter isn't 0, and it has the same number of hash functions, so checking
+ * a key in either filter gives the same result. The bloom filter doesn't change if the counting bloom filter does.
+ *
+ * Time complexity: O(m)
+ *
+ * @relates counting_bloom_filter
+ * @param[in] cbf Counting bloom filter
+ * @param[out] bf_out Bloom filter to initialize (destroy with bloom_filter_destroy())
+ * @return true on success, false on failure
+ */
+bool counting_bloom_filter_compact(const counting_bloom_filter* cbf, bloom_filter* bf_out);
+
+/**
+ * Remove all keys from the counting bloom filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates counting_bloom_filter
+ * @param[in,out] cbf Counting bloom filter
+ */
+void counting_bloom_filter_clear(counting_bloom_filter* cbf);
+
+/**
+ * Destroy the counting bloom filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates counting_bloom_filter
+ * @param[in,out] cbf Counting bloom filter
+ * @return true on success, false on failure
+ */
+bool counting_bloom_filter_destroy(counting_bloom_filter* cbf);
@@ -0,0 +1,305 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cuckoo_filter.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+bool cuckoo_filter_init(cuckoo_filter* cf, const size_t capacity, const uint8_t fingerprint_bits) {
+    memset(cf, 0, sizeof(cuckoo_filter));
+
+    if (fingerprint_bits != 8 && fingerprint_bits != 16) {
+        log_error("invalid cuckoo filter fingerprint size: %u bits (must be 8 or 16)", fingerprint_bits);
+        return false;
+    }
+
+    const double buckets = ceil((double)capacity / (CUCKOO_FILTER_BUCKET_SLOTS * CUCKOO_FILTER_MAX_LOAD_FACTOR));
+    cf->bucket_count = buckets < 1 ? 1 : (size_t)buckets;
+
+    cf->fingerprint_bits = fingerprint_bits;
+    cf->rng = 0x9e3779b97f4a7c15ULL;
+
+    cf->buckets = calloc(cf->bucket_count, CUCKOO_FILTER_BUCKET_SLOTS * fingerprint_bits / 8);
+    if (cf->buckets == NULL) {
+        log_perror("calloc() failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool cuckoo_filter_init_with_fpr(cuckoo_filter* cf, const size_t n, const double fpr) {
+    // A check compares against 2 buckets of fingerprints, so the rate is about 2 * slots / 2^f
+    const double bits = ceil(log2(2 * CUCKOO_FILTER_BUCKET_SLOTS / fpr));
+    if (n == 0 || !(fpr > 0 && fpr < 1) || bits > 16) {
+        log_error("invalid cuckoo filter size: %zu keys with a false positive rate of %f", n, fpr);
+        return false;
+    }
+
+    return cuckoo_filter_init(cf, n, bits <= 8 ? 8 : 16);
+}
+
+/**
+ * Hash a key into its fingerprint and first bucket
+ *
+ * @param[in] cf Cuckoo filter
+ * @param[in] key Key to hash
+ * @param[in] key_len Length of the key
+ * @param[out] bucket_out First bucket
+ * @return Fingerprint (never 0, which marks empty slots)
+ */
+static inline uint16_t key_fingerprint(
+    const cuckoo_filter* cf,
+    const uint8_t* key,
+    const size_t key_len,
+    size_t* bucket_out
+) {
+    uint64_t hash[2];
+    murmur3_128(key, key_len, 0x5f3759df, hash); // Seed: Fast inverse sqrt const
+
+    // Multiply and shift instead of modulo (Lemire's fast range reduction)
+    *bucket_out = (size_t)(((unsigned __int128)hash[1] * cf->bucket_count) >> 64);
+
+    const uint16_t fingerprint = (uint16_t)(hash[0] & ((1U << cf->fingerprint_bits) - 1));
+    return fingerprint == 0 ? 1 : fingerprint;
+}
+
+/**
+ * Get the other bucket a fingerprint can be in (works in both directions)
+ *
+ * @param[in] cf Cuckoo filter
+ * @param[in] bucket One of the fingerprint's buckets
+ * @param[in] fingerprint Fingerprint
+ * @return The fingerprint's other bucket
+ */
+static inline size_t alt_bucket(const cuckoo_filter* cf, const size_t bucket, const uint16_t fingerprint) {
+    // (h(f) - bucket) mod m maps each bucket to the other one, for any number of buckets (the paper's bucket xor h(f)
+    // only does for a power of 2, which can leave the filter almost half empty)
+    const size_t offset = (size_t)(murmur3_fmix64(fingerprint) % cf->bucket_count);
+    return offset >= bucket ? offset - bucket : offset + cf->bucket_count - bucket;
+}
+
+static inline uint16_t slot_get(const cuckoo_filter* cf, const size_t bucket, const size_t slot) {
+    if (cf->fingerprint_bits == 8) {
+        return cf->buckets[bucket * CUCKOO_FILTER_BUCKET_SLOTS + slot];
+    }
+
+    return ((const uint16_t *)cf->buckets)[bucket * CUCKOO_FILTER_BUCKET_SLOTS + slot];
+}
+
+static inline void slot_set(const cuckoo_filter* cf, const size_t bucket, const size_t slot, const uint16_t fingerprint) {
+    if (cf->fingerprint_bits == 8) {
+        cf->buckets[bucket * CUCKOO_FILTER_BUCKET_SLOTS + slot] = (uint8_t)fingerprint;
+    }
+    else {
+        ((uint16_t *)cf->buckets)[bucket * CUCKOO_FILTER_BUCKET_SLOTS + slot] = fingerprint;
+    }
+}
+
+/**
+ * Check if a bucket holds a fingerprint, comparing all of its slots at once
+ *
+ * @param[in] cf Cuckoo filter
+ * @param[in] bucket Bucket
+ * @param[in] fingerprint Fingerprint
+ * @return true if any slot holds the fingerprint, false if not
+ */
+static inline bool bucket_contains(const cuckoo_filter* cf, const size_t bucket, const uint16_t fingerprint) {
+    // Slots that hold the fingerprint are 0 after the xor, and a word has a zero slot if subtracting 1 from each slot
+    // borrows out of one that had its high bit clear. Slots are stored as 8 or 16-bit values, so the whole bucket is
+    // loaded with memcpy() (still a single load) instead of through a wider pointer type.
+    if (cf->fingerprint_bits == 8) {
+        uint32_t word;
+        memcpy(&word, cf->buckets + bucket * sizeof(word), sizeof(word));
+
+        const uint32_t slots = word ^ (fingerprint * 0x01010101U);
+        return ((slots - 0x01010101U) & ~slots & 0x80808080U) != 0;
+    }
+
+    uint64_t word;
+    memcpy(&word, cf->buckets + bucket * sizeof(word), sizeof(word));
+
+    const uint64_t slots = word ^ (fingerprint * 0x0001000100010001ULL);
+    return ((slots - 0x0001000100010001ULL) & ~slots & 0x8000800080008000ULL) != 0;
+}
+
+/**
+ * Put a fingerprint in an empty slot of a bucket
+ *
+ * @param[in,out] cf Cuckoo filter
+ * @param[in] bucket Bucket
+ * @param[in] fingerprint Fingerprint
+ * @return true on success, false if the bucket is full
+ */
+static bool bucket_insert(const cuckoo_filter* cf, const size_t bucket, const uint16_t fingerprint) {
+    for (size_t i = 0; i < CUCKOO_FILTER_BUCKET_SLOTS; ++i) {
+        if (slot_get(cf, bucket, i) == 0) {
+            slot_set(cf, bucket, i, fingerprint);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Clear a slot holding a fingerprint in a bucket
+ *
+ * @param[in,out] cf Cuckoo filter
+ * @param[in] bucket Bucket
+ * @param[in] fingerprint Fingerprint
+ * @return true on success, false if the bucket doesn't hold the fingerprint
+ */
+static bool bucket_delete(const cuckoo_filter* cf, const size_t bucket, const uint16_t fingerprint) {
+    for (size_t i = 0; i < CUCKOO_FILTER_BUCKET_SLOTS; ++i) {
+        if (slot_get(cf, bucket, i) == fingerprint) {
+            slot_set(cf, bucket, i, 0);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Get the next random number for picking evictions (xorshift64)
+ *
+ * @param[in,out] cf Cuckoo filter
+ * @return Random number
+ */
+static inline uint64_t next_random(cuckoo_filter* cf) {
+    cf->rng ^= cf->rng << 13;
+    cf->rng ^= cf->rng >> 7;
+    cf->rng ^= cf->rng << 17;
+    return cf->rng;
+}
+
+/**
+ * Put a fingerprint in one of its buckets, moving other fingerprints to their other buckets to make room if needed
+ * If there's still no room after CUCKOO_FILTER_MAX_KICKS moves, the last fingerprint that was moved becomes the victim.
+ *
+ * @param[in,out] cf Cuckoo filter (without a victim)
+ * @param[in] bucket One of the fingerprint's buckets
+ * @param[in] fingerprint Fingerprint
+ */
+static void insert_fingerprint(cuckoo_filter* cf, size_t bucket, uint16_t fingerprint) {
+    if (bucket_insert(cf, bucket, fingerprint) || bucket_insert(cf, alt_bucket(cf, bucket, fingerprint), fingerprint)) {
+        return;
+    }
+
+    // Both buckets are full: swap the fingerprint with a random one from either bucket, and move that one to its
+    // other bucket, until one of them lands in a bucket with a free slot
+    if (next_random(cf) & 1) {
+        bucket = alt_bucket(cf, bucket, fingerprint);
+    }
+
+    for (size_t kicks = 0; kicks < CUCKOO_FILTER_MAX_KICKS; ++kicks) {
+        const size_t slot = (size_t)(next_random(cf) >> 32) % CUCKOO_FILTER_BUCKET_SLOTS;
+
+        const uint16_t evicted = slot_get(cf, bucket, slot);
+        slot_set(cf, bucket, slot, fingerprint);
+        fingerprint = evicted;
+
+        bucket = alt_bucket(cf, bucket, fingerprint);
+        if (bucket_insert(cf, bucket, fingerprint)) {
+            return;
+        }
+    }
+
+    // The filter is full. Keep the fingerprint that has nowhere to go aside instead of losing a key.
+    cf->has_victim = true;
+    cf->victim_fingerprint = fingerprint;
+    cf->victim_bucket = bucket;
+}
+
+bool cuckoo_filter_add(cuckoo_filter* cf, const uint8_t* key, const size_t key_len) {
+    if (cf->has_victim) {
+        return false;
+    }
+
+    size_t bucket;
+    const uint16_t fingerprint = key_fingerprint(cf, key, key_len, &bucket);
+
+    // The key is added even if this fills the filter (some fingerprint becomes the victim)
+    insert_fingerprint(cf, bucket, fingerprint);
+    ++cf->size;
+
+    return true;
+}
+
+/**
+ * Check if the kept aside victim fingerprint matches a key
+ *
+ * @param[in] cf Cuckoo filter
+ * @param[in] bucket Key's first bucket
+ * @param[in] fingerprint Key's fingerprint
+ * @return true if it matches, false if not
+ */
+static inline bool victim_matches(const cuckoo_filter* cf, const size_t bucket, const uint16_t fingerprint) {
+    return cf->has_victim &&
+           cf->victim_fingerprint == fingerprint &&
+           (cf->victim_bucket == bucket || cf->victim_bucket == alt_bucket(cf, bucket, fingerprint));
+}
+
+bool cuckoo_filter_remove(cuckoo_filter* cf, const uint8_t* key, const size_t key_len) {
+    size_t bucket;
+    const uint16_t fingerprint = key_fingerprint(cf, key, key_len, &bucket);
+
+    if (victim_matches(cf, bucket, fingerprint)) {
+        cf->has_victim = false;
+        --cf->size;
+        return true;
+    }
+
+    if (!bucket_delete(cf, bucket, fingerprint) && !bucket_delete(cf, alt_bucket(cf, bucket, fingerprint), fingerprint)) {
+        return false;
+    }
+
+    --cf->size;
+
+    // A slot is free now, so there may be room for the victim again
+    if (cf->has_victim) {
+        cf->has_victim = false;
+        insert_fingerprint(cf, cf->victim_bucket, cf->victim_fingerprint);
+    }
+
+    return true;
+}
+
+bool cuckoo_filter_check(const cuckoo_filter* cf, const uint8_t* key, const size_t key_len) {
+    size_t bucket;
+    const uint16_t fingerprint = key_fingerprint(cf, key, key_len, &bucket);
+
+    return bucket_contains(cf, bucket, fingerprint) ||
+           bucket_contains(cf, alt_bucket(cf, bucket, fingerprint), fingerprint) ||
+           victim_matches(cf, bucket, fingerprint);
+}
+
+size_t cuckoo_filter_size(const cuckoo_filter* cf) {
+    return cf->size;
+}
+
+size_t cuckoo_filter_bytes(const cuckoo_filter* cf) {
+    return cf->bucket_count * CUCKOO_FILTER_BUCKET_SLOTS * cf->fingerprint_bits / 8;
+}
+
+void cuckoo_filter_clear(cuckoo_filter* cf) {
+    memset(cf->buckets, 0, cuckoo_filter_bytes(cf));
+    cf->size = 0;
+    cf->has_victim = false;
+}
+
+bool cuckoo_filter_destroy(cuckoo_filter* cf) {
+    if (cf->buckets != NULL) {
+        free(cf->buckets);
+        cf->buckets = nullptr;
+    }
+
+    cf->bucket_count = 0;
+    cf->size = 0;
+    cf->has_victim = false;
+
+    return true;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Number of fingerprints per bucket
+ */
+#define CUCKOO_FILTER_BUCKET_SLOTS 4
+
+/**
+ * Max number of fingerprints an add moves to their other bucket before the filter is considered full
+ */
+#define CUCKOO_FILTER_MAX_KICKS 500
+
+/**
+ * Load factor (fraction of slots used) the filter is sized for
+ * 2 choice, 4-way buckets can be filled to about 95% before adds start failing
+ */
+#define CUCKOO_FILTER_MAX_LOAD_FACTOR 0.95
+
+/**
+ * A cuckoo filter is an approximate membership set like bloom_filter, that also supports removing keys.
+ * https://www.cs.cmu.edu/~dga/papers/cuckoo-conext2014.pdf
+ *
+ * It stores a small fingerprint of each key (8 or 16 bits) in one of two 4-slot buckets. The key's murmur3_128() hash
+ * picks the fingerprint and the first bucket, and the second bucket is a hash of the fingerprint minus the first one
+ * (mod the number of buckets), so either bucket can be found from the other one and the fingerprint alone. Adding a key to two full buckets evicts a
+ * random fingerprint to its other bucket, and so on (cuckoo hashing), for up to CUCKOO_FILTER_MAX_KICKS moves.
+ *
+ * A check reads two buckets, and compares the fingerprint with all 4 slots of each at once (SWAR). False positives
+ * happen when another key in one of the two buckets has the same fingerprint, which is about 8 / 2^f, so 8-bit
+ * fingerprints give about 3% and 16-bit ones about 0.012%. At about 0.01% and below, a cuckoo filter takes fewer bits
+ * per key than a bloom filter, and unlike one it supports removing keys.
+ *
+ * Cuckoo filters can't grow (keys aren't stored, so they can't be rehashed), and adds fail once the filter is full. Only
+ * keys that were added should be removed: removing a key that wasn't added (but is a false positive) removes another
+ * key's fingerprint. The same key can be added more than once (and should then be removed as many times), but only 8
+ * copies fit in its two buckets.
+ *
+ * **Example**
+ * ```c
+ * cuckoo_filter cf;
+ * cuckoo_filter_init_with_fpr(&cf, 1000, 0.001); // 0.1% false positives with up to 1000 keys
+ *
+ * cuckoo_filter_add(&cf, (uint8_t *)"foo", 3);
+ * assert(cuckoo_filter_check(&cf, (uint8_t *)"foo", 3));
+ *
+ * cuckoo_filter_remove(&cf, (uint8_t *)"foo", 3);
+ * assert(!cuckoo_filter_check(&cf, (uint8_t *)"foo", 3));
+ *
+ * cuckoo_filter_destroy(&cf);
+ * ```
+ */
+typedef struct cuckoo_filter {
+    /**
+     * Buckets of CUCKOO_FILTER_BUCKET_SLOTS fingerprints (0 for an empty slot)
+     */
+    uint8_t* buckets;
+
+    /**
+     * Number of buckets
+     */
+    size_t bucket_count;
+
+    /**
+     * Bits per fingerprint (8 or 16)
+     */
+    uint8_t fingerprint_bits;
+
+    /**
+     * Number of keys in the filter
+     */
+    size_t size;
+
+    /**
+     * Fingerprint that was evicted by the add that filled the filter, and one of its buckets
+     * Keeping it means that add doesn't lose another key. Adds fail while there is one.
+     */
+    bool has_victim;
+    uint16_t victim_fingerprint;
+    size_t victim_bucket;
+
+    /**
+     * Random state for picking which fingerprint to evict
+     */
+    uint64_t rng;
+} cuckoo_filter;
+
+/**
+ * Initialize the cuckoo filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates cuckoo_filter
+ * @param[out] cf Cuckoo filter
+ * @param[in] capacity Number of keys the filter should fit (at up to CUCKOO_FILTER_MAX_LOAD_FACTOR)
+ * @param[in] fingerprint_bits Bits per fingerprint (8 or 16)
+ * @return true on success, false on failure
+ */
+bool cuckoo_filter_init(cuckoo_filter* cf, size_t capacity, uint8_t fingerprint_bits);
+
+/**
+ * Initialize the cuckoo filter, with the smallest fingerprints that give a target false positive rate
+ *
+ * Time complexity: O(m)
+ *
+ * @relates cuckoo_filter
+ * @param[out] cf Cuckoo filter
+ * @param[in] n Expected number of keys
+ * @param[in] fpr Target false positive rate (at least 2^-13, about 0.012%, and less than 1)
+ * @return true on success, false on failure
+ */
+bool cuckoo_filter_init_with_fpr(cuckoo_filter* cf, size_t n, double fpr);
+
+/**
+ * Add a key to the cuckoo filter
+ *
+ * Time complexity: O(1) (amortized)
+ *
+ * @relates cuckoo_filter
+ * @param[in,out] cf Cuckoo filter
+ * @param[in] key Key to add
+ * @param[in] key_len Length of the key
+ * @return true on success, false if the filter is full
+ */
+bool cuckoo_filter_add(cuckoo_filter* cf, const uint8_t* key, size_t key_len);
+
+/**
+ * Remove a key from the cuckoo filter
+ *
+ * The key must have been added (see cuckoo_filter). Nothing is changed if the key isn't a member.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_filter
+ * @param[in,out] cf Cuckoo filter
+ * @param[in] key Key to remove
+ * @param[in] key_len Length of the key
+ * @return true if the key was removed, false if it isn't a member
+ */
+bool cuckoo_filter_remove(cuckoo_filter* cf, const uint8_t* key, size_t key_len);
+
+/**
+ * Check if a key is in the cuckoo filter
+ *
+ * False positives are possible (meaning this can indicate that a key is a member when it's not)
+ * False negatives are impossible (meaning this can't indicate that a key is not a member when it is), as long as only
+ * keys that were added are removed
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_filter
+ * @param[in] cf Cuckoo filter
+ * @param[in] key Key to check
+ * @param[in] key_len Length of the key
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool cuckoo_filter_check(const cuckoo_filter* cf, const uint8_t* key, size_t key_len);
+
+/**
+ * Get the number of keys in the cuckoo filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_filter
+ * @param[in] cf Cuckoo filter
+ * @return Number of keys
+ */
+size_t cuckoo_filter_size(const cuckoo_filter* cf);
+
+/**
+ * Get the size of the cuckoo filter's buckets
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_filter
+ * @param[in] cf Cuckoo filter
+ * @return Size in bytes
+ */
+size_t cuckoo_filter_bytes(const cuckoo_filter* cf);
+
+/**
+ * Remove all keys from the cuckoo filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates cuckoo_filter
+ * @param[in,out] cf Cuckoo filter
+ */
+void cuckoo_filter_clear(cuckoo_filter* cf);
+
+/**
+ * Destroy the cuckoo filter
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_filter
+ * @param[in,out] cf Cuckoo filter
+ * @return true on success, false on failure
+ */
+bool cuckoo_filter_destroy(cuckoo_filter* cf);
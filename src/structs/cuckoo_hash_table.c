@@ -0,0 +1,439 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cuckoo_hash_table.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+static_assert(sizeof(cuckoo_hash_table_bucket) == 64, "cuckoo hash table buckets must fill exactly one cache line");
+
+/**
+ * Seeds that the key's hash is mixed with to pick its two buckets (same as bloom_filter's)
+ */
+#define BUCKET_SEED1 0x5f3759df // Fast inverse sqrt const
+#define BUCKET_SEED2 0x9e3779b9 // Golden ratio prime
+
+/**
+ * Number of times the table doubles while trying to place a key (or rebuild) before giving up
+ * Only keys that share the same full hash with more than 2 * CUCKOO_HASH_TABLE_BUCKET_SLOTS other keys can't be placed
+ * at any size, so this is only reached with a bad key hash function
+ */
+#define MAX_GROW_ATTEMPTS 4
+
+/**
+ * Node in an insert's breadth-first search
+ */
+typedef struct search_node {
+    size_t bucket;
+
+    /**
+     * Node this bucket was reached from (or -1 for one of the key's own buckets)
+     */
+    int32_t parent;
+
+    /**
+     * Slot in the parent's bucket whose entry would move to this bucket
+     */
+    uint8_t parent_slot;
+} search_node;
+
+/**
+ * Find a key's two buckets
+ *
+ * @param[in] ct Cuckoo hash table
+ * @param[in] hash Full hash of key
+ * @param[out] bucket1 First bucket
+ * @param[out] bucket2 Second bucket (may be the same as the first)
+ */
+static inline void key_buckets(const cuckoo_hash_table* ct, const uint32_t hash, size_t* bucket1, size_t* bucket2) {
+    const size_t mask = ct->bucket_size - 1;
+    *bucket1 = murmur3((const uint8_t*)&hash, sizeof(hash), BUCKET_SEED1) & mask;
+    *bucket2 = murmur3((const uint8_t*)&hash, sizeof(hash), BUCKET_SEED2) & mask;
+}
+
+/**
+ * Find the other bucket an entry can be in
+ *
+ * @param[in] ct Cuckoo hash table
+ * @param[in] hash Full hash of the entry's key
+ * @param[in] bucket Bucket the entry is in
+ * @return Other bucket (the same bucket if both of the key's buckets are the same)
+ */
+static inline size_t alternate_bucket(const cuckoo_hash_table* ct, const uint32_t hash, const size_t bucket) {
+    size_t bucket1, bucket2;
+    key_buckets(ct, hash, &bucket1, &bucket2);
+
+    return bucket == bucket1 ? bucket2 : bucket1;
+}
+
+/**
+ * Number of buckets needed to hold a number of entries below the max load factor
+ *
+ * @param[in] size Number of entries
+ * @return Number of buckets (power of 2)
+ */
+static size_t bucket_size_for(const size_t size) {
+    size_t bucket_size = 1;
+    while (bucket_size * CUCKOO_HASH_TABLE_BUCKET_SLOTS * CUCKOO_HASH_TABLE_MAX_LOAD_FACTOR < size) {
+        bucket_size <<= 1;
+    }
+
+    return bucket_size;
+}
+
+/**
+ * Allocate empty, cache line aligned buckets
+ *
+ * @param[in] bucket_size Number of buckets
+ * @return Buckets, or NULL on failure
+ */
+static cuckoo_hash_table_bucket* alloc_buckets(const size_t bucket_size) {
+    cuckoo_hash_table_bucket* buckets = aligned_alloc(64, bucket_size * sizeof(cuckoo_hash_table_bucket));
+    if (buckets == NULL) {
+        log_perror("aligned_alloc() failed");
+        return nullptr;
+    }
+
+    memset(buckets, 0, bucket_size * sizeof(cuckoo_hash_table_bucket));
+
+    return buckets;
+}
+
+/**
+ * Find a key's bucket and slot
+ *
+ * @param[in] ct Cuckoo hash table
+ * @param[in] key Key to find
+ * @param[in] hash Full hash of key
+ * @param[out] slot_out Slot in the returned bucket
+ * @return Bucket, or NULL if not found
+ */
+static cuckoo_hash_table_bucket* find_entry(
+    const cuckoo_hash_table* ct,
+    const void* key,
+    const uint32_t hash,
+    size_t* slot_out
+) {
+    size_t bucket1, bucket2;
+    key_buckets(ct, hash, &bucket1, &bucket2);
+
+    // Fetch both cache lines at once, rather than waiting for the first before requesting the second
+    __builtin_prefetch(&ct->buckets[bucket2]);
+
+    cuckoo_hash_table_bucket* candidates[2] = {&ct->buckets[bucket1], &ct->buckets[bucket2]};
+    for (size_t c = 0; c < 2; ++c) {
+        cuckoo_hash_table_bucket* p_bucket = candidates[c];
+        for (size_t i = 0; i < CUCKOO_HASH_TABLE_BUCKET_SLOTS; ++i) {
+            if (p_bucket->hashes[i] == hash && p_bucket->keys[i] != NULL && ct->key_cmp(p_bucket->keys[i], key) == 0) {
+                *slot_out = i;
+                return p_bucket;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Check if a bucket is on the search path that leads to a node
+ * Paths never visit a bucket twice, so every entry that's moved along a path is the one that was found there
+ *
+ * @param[in] nodes Search nodes
+ * @param[in] node Last node of the path
+ * @param[in] bucket Bucket to find
+ * @return true if the bucket is on the path
+ */
+static bool on_path(const search_node* nodes, int32_t node, const size_t bucket) {
+    for (; node != -1; node = nodes[node].parent) {
+        if (nodes[node].bucket == bucket) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Insert a new entry without growing the table
+ *
+ * If both of the key's buckets are full, this searches breadth-first for the shortest chain of entries that can each
+ * move to their other bucket, ending in a bucket with a free slot, then moves them (last first) to free a slot for the
+ * new entry.
+ *
+ * @param[in,out] ct Cuckoo hash table
+ * @param[in] key Pointer to key (not already in the table)
+ * @param[in] hash Full hash of key
+ * @param[in] value Pointer to value
+ * @return true on success, false if no free slot was found
+ */
+static bool insert_entry(cuckoo_hash_table* ct, void* key, const uint32_t hash, void* value) {
+    search_node nodes[CUCKOO_HASH_TABLE_MAX_SEARCH];
+    size_t node_count = 0;
+
+    size_t bucket1, bucket2;
+    key_buckets(ct, hash, &bucket1, &bucket2);
+
+    nodes[node_count++] = (search_node){.bucket = bucket1, .parent = -1};
+    if (bucket2 != bucket1) {
+        nodes[node_count++] = (search_node){.bucket = bucket2, .parent = -1};
+    }
+
+    for (size_t head = 0; head < node_count; ++head) {
+        const cuckoo_hash_table_bucket* p_bucket = &ct->buckets[nodes[head].bucket];
+
+        size_t free_slot = 0;
+        while (free_slot < CUCKOO_HASH_TABLE_BUCKET_SLOTS && p_bucket->keys[free_slot] != NULL) {
+            ++free_slot;
+        }
+
+        if (free_slot < CUCKOO_HASH_TABLE_BUCKET_SLOTS) {
+            // Shift the entries along the path back, starting from the free slot
+            size_t node = head;
+            size_t slot = free_slot;
+            while (nodes[node].parent != -1) {
+                const search_node* p_parent = &nodes[nodes[node].parent];
+                cuckoo_hash_table_bucket* p_to = &ct->buckets[nodes[node].bucket];
+                cuckoo_hash_table_bucket* p_from = &ct->buckets[p_parent->bucket];
+
+                p_to->hashes[slot] = p_from->hashes[nodes[node].parent_slot];
+                p_to->keys[slot] = p_from->keys[nodes[node].parent_slot];
+                p_to->values[slot] = p_from->values[nodes[node].parent_slot];
+
+                slot = nodes[node].parent_slot;
+                node = nodes[node].parent;
+            }
+
+            cuckoo_hash_table_bucket* p_target = &ct->buckets[nodes[node].bucket];
+            p_target->hashes[slot] = hash;
+            p_target->keys[slot] = key;
+            p_target->values[slot] = value;
+
+            return true;
+        }
+
+        // Full, so queue the other bucket of each of its entries
+        for (size_t i = 0; i < CUCKOO_HASH_TABLE_BUCKET_SLOTS && node_count < CUCKOO_HASH_TABLE_MAX_SEARCH; ++i) {
+            const size_t alternate = alternate_bucket(ct, p_bucket->hashes[i], nodes[head].bucket);
+            if (!on_path(nodes, head, alternate)) {
+                nodes[node_count++] = (search_node){.bucket = alternate, .parent = head, .parent_slot = i};
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Rebuild the table with a new number of buckets
+ *
+ * @param[in,out] ct Cuckoo hash table
+ * @param[in] bucket_size New number of buckets (power of 2)
+ * @return true on success, false on failure (the table is unchanged)
+ */
+static bool resize(cuckoo_hash_table* ct, const size_t bucket_size) {
+    cuckoo_hash_table old = *ct;
+
+    ct->buckets = alloc_buckets(bucket_size);
+    if (ct->buckets == NULL) {
+        *ct = old;
+        return false;
+    }
+
+    ct->bucket_size = bucket_size;
+
+    for (size_t b = 0; b < old.bucket_size; ++b) {
+        const cuckoo_hash_table_bucket* p_bucket = &old.buckets[b];
+        for (size_t i = 0; i < CUCKOO_HASH_TABLE_BUCKET_SLOTS; ++i) {
+            if (p_bucket->keys[i] != NULL &&
+                !insert_entry(ct, p_bucket->keys[i], p_bucket->hashes[i], p_bucket->values[i])) {
+                free(ct->buckets);
+                *ct = old;
+                return false;
+            }
+        }
+    }
+
+    free(old.buckets);
+
+    return true;
+}
+
+/**
+ * Rebuild the table with at least a number of buckets, doubling it until every entry fits
+ *
+ * @param[in,out] ct Cuckoo hash table
+ * @param[in] bucket_size Min number of buckets (power of 2)
+ * @return true on success, false on failure (the table is unchanged)
+ */
+static bool grow(cuckoo_hash_table* ct, size_t bucket_size) {
+    for (size_t attempt = 0; attempt < MAX_GROW_ATTEMPTS; ++attempt, bucket_size <<= 1) {
+        if (resize(ct, bucket_size)) {
+            return true;
+        }
+    }
+
+    log_error("failed to resize cuckoo hash table (too many keys with the same hash?)");
+    return false;
+}
+
+bool cuckoo_hash_table_init(
+    cuckoo_hash_table* ct,
+    const uint32_t size,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(ct, 0, sizeof(cuckoo_hash_table));
+
+    ct->bucket_size = bucket_size_for(size);
+    ct->buckets = alloc_buckets(ct->bucket_size);
+    if (ct->buckets == NULL) {
+        return false;
+    }
+
+    ct->key_cmp = key_cmp == NULL ? value_cmp_string : key_cmp;
+    ct->key_hash = key_hash == NULL ? hash_table_key_hash_string : key_hash;
+
+    return true;
+}
+
+bool cuckoo_hash_table_rehash(cuckoo_hash_table* ct, const uint32_t new_size) {
+    if (ct->buckets == NULL) {
+        log_error("cuckoo hash table not initialized");
+        return false;
+    }
+
+    if (new_size < ct->entry_size) {
+        log_error("new size %u is smaller than entry count %zu", new_size, ct->entry_size);
+        return false;
+    }
+
+    return grow(ct, bucket_size_for(new_size));
+}
+
+bool cuckoo_hash_table_set(cuckoo_hash_table* ct, void* key, void* value) {
+    if (ct->buckets == NULL) {
+        log_error("cuckoo hash table not initialized");
+        return false;
+    }
+
+    if (key == NULL) {
+        log_error("cuckoo hash table keys can't be NULL");
+        return false;
+    }
+
+    const uint32_t hash = (*ct->key_hash)(key, SIZE_MAX);
+
+    size_t slot;
+    cuckoo_hash_table_bucket* p_bucket = find_entry(ct, key, hash, &slot);
+    if (p_bucket != NULL) {
+        // Update existing entry
+        p_bucket->values[slot] = value;
+        return true;
+    }
+
+    if (ct->entry_size + 1 > ct->bucket_size * CUCKOO_HASH_TABLE_BUCKET_SLOTS * CUCKOO_HASH_TABLE_MAX_LOAD_FACTOR &&
+        !grow(ct, ct->bucket_size * 2)) {
+        return false;
+    }
+
+    for (size_t attempt = 0; !insert_entry(ct, key, hash, value); ++attempt) {
+        if (attempt == MAX_GROW_ATTEMPTS || !grow(ct, ct->bucket_size * 2)) {
+            log_error("failed to insert into cuckoo hash table (too many keys with the same hash?)");
+            return false;
+        }
+    }
+
+    ++ct->entry_size;
+
+    return true;
+}
+
+void* cuckoo_hash_table_get(const cuckoo_hash_table* ct, const void* key) {
+    if (ct->buckets == NULL) {
+        log_error("cuckoo hash table not initialized");
+        return nullptr;
+    }
+
+    size_t slot;
+    const cuckoo_hash_table_bucket* p_bucket = find_entry(ct, key, (*ct->key_hash)(key, SIZE_MAX), &slot);
+    if (p_bucket == NULL) {
+        return nullptr;
+    }
+
+    return p_bucket->values[slot];
+}
+
+bool cuckoo_hash_table_contains(const cuckoo_hash_table* ct, const void* key) {
+    if (ct->buckets == NULL) {
+        log_error("cuckoo hash table not initialized");
+        return false;
+    }
+
+    size_t slot;
+    return find_entry(ct, key, (*ct->key_hash)(key, SIZE_MAX), &slot) != NULL;
+}
+
+bool cuckoo_hash_table_del(cuckoo_hash_table* ct, const void* key) {
+    if (ct->buckets == NULL) {
+        log_error("cuckoo hash table not initialized");
+        return false;
+    }
+
+    size_t slot;
+    cuckoo_hash_table_bucket* p_bucket = find_entry(ct, key, (*ct->key_hash)(key, SIZE_MAX), &slot);
+    if (p_bucket == NULL) {
+        return false;
+    }
+
+    p_bucket->keys[slot] = nullptr;
+    p_bucket->values[slot] = nullptr;
+    --ct->entry_size;
+
+    return true;
+}
+
+bool cuckoo_hash_table_iter(
+    cuckoo_hash_table* ct,
+    const hash_table_iter_func iter_func,
+    void* iter_func_user_arg
+) {
+    if (ct->buckets == NULL) {
+        log_error("cuckoo hash table not initialized");
+        return false;
+    }
+
+    for (size_t b = 0; b < ct->bucket_size; ++b) {
+        const cuckoo_hash_table_bucket* p_bucket = &ct->buckets[b];
+        for (size_t i = 0; i < CUCKOO_HASH_TABLE_BUCKET_SLOTS; ++i) {
+            if (p_bucket->keys[i] != NULL) {
+                hash_table_entry entry = {
+                    .key = p_bucket->keys[i],
+                    .value = p_bucket->values[i],
+                    .hash = p_bucket->hashes[i],
+                };
+                iter_func(&entry, b, iter_func_user_arg);
+            }
+        }
+    }
+
+    return true;
+}
+
+size_t cuckoo_hash_table_size(const cuckoo_hash_table* ct) {
+    return ct->entry_size;
+}
+
+bool cuckoo_hash_table_destroy(cuckoo_hash_table* ct) {
+    if (ct->buckets == NULL) {
+        return false;
+    }
+
+    free(ct->buckets);
+    ct->buckets = nullptr;
+
+    ct->bucket_size = 0;
+    ct->entry_size = 0;
+
+    return true;
+}
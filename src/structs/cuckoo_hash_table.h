@@ -0,0 +1,220 @@
+#pragma once
+
+#include <stdalign.h>
+#include <stdint.h>
+
+#include "hash_table.h"
+#include "../utils/value.h"
+
+/**
+ * Number of entries per bucket (as many as fit in one 64 byte cache line along with their hashes)
+ */
+#define CUCKOO_HASH_TABLE_BUCKET_SLOTS 3
+
+/**
+ * Max number of buckets an insert's breadth-first search for a free slot visits before the table grows
+ */
+#define CUCKOO_HASH_TABLE_MAX_SEARCH 256
+
+/**
+ * Load factor (fraction of slots used) above which the table grows before trying to insert
+ * 2 choice, 3-way buckets can be filled to about 95% before inserts start failing, so this leaves some headroom for
+ * short searches
+ */
+#define CUCKOO_HASH_TABLE_MAX_LOAD_FACTOR 0.9
+
+/**
+ * Cuckoo hash table bucket (exactly one cache line)
+ */
+typedef struct cuckoo_hash_table_bucket {
+    /**
+     * Full hash of each slot's key
+     */
+    alignas(64) uint32_t hashes[CUCKOO_HASH_TABLE_BUCKET_SLOTS];
+
+    /**
+     * Key of each slot, or NULL for an empty slot
+     */
+    void* keys[CUCKOO_HASH_TABLE_BUCKET_SLOTS];
+
+    void* values[CUCKOO_HASH_TABLE_BUCKET_SLOTS];
+} cuckoo_hash_table_bucket;
+
+/**
+ * A bucketized cuckoo hash table: every key can only be in one of two buckets, so a lookup touches at most two cache
+ * lines (the two buckets are fetched in parallel) no matter how skewed the keys are. There are no chains or probe
+ * sequences that can grow long.
+ *
+ * The two buckets are picked by mixing the key's hash with two murmur3 seeds (like bloom_filter does). An insert goes into
+ * whichever of the two buckets has a free slot. If both are full, a breadth-first search over the entries that could
+ * move to their other bucket finds the shortest chain of moves that frees a slot, and the entries along it are shifted
+ * back. If no chain is found within CUCKOO_HASH_TABLE_MAX_SEARCH buckets, the table doubles and tries again.
+ *
+ * This exposes the same surface as hash_table for the value_cmp_func and hash_table_key_hash_func hooks, so it can be
+ * swapped in on latency critical paths. The key hash function is called with ht_size set to SIZE_MAX, and should return
+ * the full 32-bit hash. Keys can't be NULL.
+ *
+ * **Example**
+ * ```c
+ * cuckoo_hash_table ct;
+ * cuckoo_hash_table_init(&ct, 10, NULL, NULL); // Grows automatically
+ *
+ * cuckoo_hash_table_set(&ct, "foo", "one");
+ * cuckoo_hash_table_set(&ct, "foo", "two");
+ * cuckoo_hash_table_set(&ct, "bar", "three");
+ *
+ * char *foo = cuckoo_hash_table_get(&ct, "foo");
+ * assert(strcmp(foo, "two") == 0);
+ *
+ * cuckoo_hash_table_destroy(&ct);
+ * ```
+ */
+typedef struct cuckoo_hash_table {
+    /**
+     * Buckets
+     */
+    cuckoo_hash_table_bucket* buckets;
+
+    /**
+     * Number of buckets (always a power of 2)
+     */
+    size_t bucket_size;
+
+    /**
+     * Number of stored entries
+     */
+    size_t entry_size;
+
+    /**
+     * Key comparator function
+     * Default: String comparator
+     */
+    value_cmp_func key_cmp;
+
+    /**
+     * Key hash function
+     * Default: String hash function
+     */
+    hash_table_key_hash_func key_hash;
+} cuckoo_hash_table;
+
+/**
+ * Initialize the cuckoo hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates cuckoo_hash_table
+ * @param[out] ct Cuckoo hash table
+ * @param[in] size Number of entries to reserve space for
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool cuckoo_hash_table_init(
+    cuckoo_hash_table* ct,
+    uint32_t size,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash
+);
+
+/**
+ * Resize and rebuild the cuckoo hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates cuckoo_hash_table
+ * @param[in,out] ct Cuckoo hash table
+ * @param[in] new_size Number of entries to reserve space for (can't be less than the current number of entries)
+ * @return true on success, false on failure
+ */
+bool cuckoo_hash_table_rehash(cuckoo_hash_table* ct, uint32_t new_size);
+
+/**
+ * Set a value in the cuckoo hash table
+ *
+ * Time complexity: O(1) amortized
+ *
+ * @relates cuckoo_hash_table
+ * @param[in,out] ct Cuckoo hash table
+ * @param[in] key Pointer to key
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+bool cuckoo_hash_table_set(cuckoo_hash_table* ct, void* key, void* value);
+
+/**
+ * Get value from the cuckoo hash table
+ *
+ * Time complexity: O(1) (worst case)
+ *
+ * @relates cuckoo_hash_table
+ * @param[in] ct Cuckoo hash table
+ * @param[in] key Entry key to get value for
+ * @return Value pointer, or NULL if not found
+ */
+void* cuckoo_hash_table_get(const cuckoo_hash_table* ct, const void* key);
+
+/**
+ * Check if a key is in the cuckoo hash table
+ *
+ * Time complexity: O(1) (worst case)
+ *
+ * @relates cuckoo_hash_table
+ * @param[in] ct Cuckoo hash table
+ * @param[in] key Key to find
+ * @return true if found
+ */
+bool cuckoo_hash_table_contains(const cuckoo_hash_table* ct, const void* key);
+
+/**
+ * Delete entry from the cuckoo hash table
+ *
+ * Time complexity: O(1) (worst case)
+ *
+ * @relates cuckoo_hash_table
+ * @param[in,out] ct Cuckoo hash table
+ * @param[in] key Entry key to delete
+ * @return true on success, false on failure
+ */
+bool cuckoo_hash_table_del(cuckoo_hash_table* ct, const void* key);
+
+/**
+ * Iterate cuckoo hash table keys and values
+ *
+ * The entries passed to the callback are temporary copies, so changing them doesn't change the table.
+ *
+ * Time complexity: O(n)
+ *
+ * @relates cuckoo_hash_table
+ * @param ct Cuckoo hash table
+ * @param[in] iter_func Iterator callback function (index is the bucket index)
+ * @param iter_func_user_arg Optional argument to pass to callback function
+ * @return true on success, false on failure
+ */
+bool cuckoo_hash_table_iter(
+    cuckoo_hash_table* ct,
+    hash_table_iter_func iter_func,
+    void* iter_func_user_arg
+);
+
+/**
+ * Get the number of entries in the cuckoo hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_hash_table
+ * @param[in] ct Cuckoo hash table
+ * @return Number of entries
+ */
+size_t cuckoo_hash_table_size(const cuckoo_hash_table* ct);
+
+/**
+ * Destroy the cuckoo hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates cuckoo_hash_table
+ * @param[in,out] ct Cuckoo hash table
+ * @return true on success, false on failure
+ */
+bool cuckoo_hash_table_destroy(cuckoo_hash_table* ct);
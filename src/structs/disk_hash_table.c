@@ -0,0 +1,432 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "disk_hash_table.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+/**
+ * Seed that written files hash their keys with
+ * Unlike hash_table's seed this can't change between processes, since the hashes are stored in the file
+ */
+#define WRITE_SEED 0x9747b28cU
+
+/**
+ * Byte order marker (see disk_hash_table_header.byte_order)
+ */
+#define BYTE_ORDER_MARK 0x01020304U
+
+/**
+ * Number of temporary file names create_temp_file() tries before giving up
+ */
+#define TEMP_FILE_ATTEMPTS 100
+
+/**
+ * Distinguishes temporary files created by the same process
+ */
+static _Atomic uint64_t temp_file_counter = 0;
+
+/**
+ * Round a file offset up to the next 8 byte boundary
+ *
+ * @param[in] offset Offset
+ * @return Aligned offset
+ */
+static inline uint64_t align_offset(const uint64_t offset) {
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+/**
+ * Writer state, passed to write_entry() by hash_table_iter()
+ */
+typedef struct write_context {
+    FILE* file;
+    disk_hash_table_slot* slots;
+    uint32_t slot_mask;
+
+    disk_hash_table_value_len_func value_len;
+    void* value_len_user_arg;
+
+    /**
+     * Offset of the next record
+     */
+    uint64_t offset;
+
+    /**
+     * Set if writing any entry failed
+     */
+    bool failed;
+} write_context;
+
+/**
+ * Write zero bytes to pad the file up to an 8 byte boundary
+ *
+ * @param[in,out] ctx Writer state
+ * @return true on success, false on failure
+ */
+static bool write_padding(write_context* ctx) {
+    static const uint8_t zeros[8] = {0};
+
+    const uint64_t aligned = align_offset(ctx->offset);
+    if (aligned != ctx->offset && fwrite(zeros, 1, aligned - ctx->offset, ctx->file) != aligned - ctx->offset) {
+        return false;
+    }
+
+    ctx->offset = aligned;
+    return true;
+}
+
+/**
+ * Append an entry's record to the file and add its slot
+ * {@see hash_table_iter_func}
+ */
+static void write_entry(hash_table_entry* entry, const size_t _index, void* user_arg) {
+    write_context* ctx = user_arg;
+    if (ctx->failed) {
+        return;
+    }
+
+    const size_t key_len = entry->key_len != 0 ? entry->key_len : strlen(entry->key);
+    const size_t value_len = ctx->value_len != NULL
+        ? ctx->value_len(entry->value, ctx->value_len_user_arg)
+        : strlen(entry->value);
+
+    if (key_len > UINT32_MAX || value_len >= UINT32_MAX) {
+        log_error("disk hash table key or value is too large");
+        ctx->failed = true;
+        return;
+    }
+
+    const uint32_t hash = murmur3(entry->key, key_len, WRITE_SEED);
+
+    uint32_t slot = hash & ctx->slot_mask;
+    while (ctx->slots[slot].offset != 0) {
+        slot = (slot + 1) & ctx->slot_mask;
+    }
+
+    ctx->slots[slot].hash = hash;
+    ctx->slots[slot].key_len = key_len;
+    ctx->slots[slot].offset = ctx->offset;
+
+    const disk_hash_table_record record = {
+        .key_len = key_len,
+        .value_len = value_len,
+    };
+    static const uint8_t nul = 0;
+
+    if (fwrite(&record, sizeof(record), 1, ctx->file) != 1 ||
+        fwrite(entry->key, 1, key_len, ctx->file) != key_len) {
+        log_perror("fwrite() failed for disk hash table record");
+        ctx->failed = true;
+        return;
+    }
+
+    ctx->offset += sizeof(record) + key_len;
+
+    if (!write_padding(ctx) ||
+        fwrite(entry->value, 1, value_len, ctx->file) != value_len ||
+        fwrite(&nul, 1, 1, ctx->file) != 1) {
+        log_perror("fwrite() failed for disk hash table record");
+        ctx->failed = true;
+        return;
+    }
+
+    ctx->offset += value_len + 1;
+
+    if (!write_padding(ctx)) {
+        log_perror("fwrite() failed for disk hash table record");
+        ctx->failed = true;
+    }
+}
+
+/**
+ * Create a uniquely named temporary file next to a path
+ *
+ * Unlike mkstemp(), which always creates files as owner-only, this creates the file with mode 0666, so it gets the
+ * same permissions (after the umask) as a file created by fopen().
+ *
+ * @param[in] path Path that the file will be renamed to
+ * @param[out] tmp_path Temporary file path
+ * @param[in] tmp_path_size Size of the tmp_path buffer
+ * @return Open file descriptor, or -1 on failure
+ */
+static int create_temp_file(const char* path, char* tmp_path, const size_t tmp_path_size) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    for (size_t attempt = 0; attempt < TEMP_FILE_ATTEMPTS; ++attempt) {
+        const uint64_t suffix = murmur3_fmix64(
+            ((uint64_t)getpid() << 32) ^
+            ((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec) ^
+            (atomic_fetch_add(&temp_file_counter, 1) * 0x9e3779b97f4a7c15ULL)
+        );
+
+        const int tmp_path_len = snprintf(tmp_path, tmp_path_size, "%s.%016llx", path, (unsigned long long)suffix);
+        if (tmp_path_len < 0 || (size_t)tmp_path_len >= tmp_path_size) {
+            log_error("disk hash table path is too long");
+            return -1;
+        }
+
+        const int fd = open(tmp_path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd != -1 || errno != EEXIST) {
+            if (fd == -1) {
+                log_perror("open() failed for %s", tmp_path);
+            }
+            return fd;
+        }
+    }
+
+    log_error("failed to create a unique temporary file for %s", path);
+    return -1;
+}
+
+bool disk_hash_table_write(
+    hash_table* ht,
+    const char* path,
+    const disk_hash_table_value_len_func value_len,
+    void* value_len_user_arg
+) {
+    const size_t entry_size = hash_table_size(ht);
+
+    // At most half full, so probes stay short and always end at an empty slot
+    uint64_t slot_count = 1;
+    while (slot_count < entry_size * 2) {
+        slot_count <<= 1;
+    }
+
+    if (slot_count > UINT32_MAX) {
+        log_error("disk hash table has too many entries");
+        return false;
+    }
+
+    write_context ctx = {
+        .slots = calloc(slot_count, sizeof(disk_hash_table_slot)),
+        .slot_mask = slot_count - 1,
+        .value_len = value_len,
+        .value_len_user_arg = value_len_user_arg,
+        .offset = sizeof(disk_hash_table_header) + slot_count * sizeof(disk_hash_table_slot),
+    };
+
+    if (ctx.slots == NULL) {
+        log_perror("calloc() failed for disk hash table slots");
+        return false;
+    }
+
+    // A unique temporary file next to the target, so concurrent writers of the same path don't clobber each other
+    char tmp_path[PATH_MAX];
+    const int fd = create_temp_file(path, tmp_path, sizeof(tmp_path));
+    if (fd == -1) {
+        free(ctx.slots);
+        return false;
+    }
+
+    ctx.file = fdopen(fd, "wb");
+    if (ctx.file == NULL) {
+        log_perror("fdopen() failed for %s", tmp_path);
+        close(fd);
+        unlink(tmp_path);
+        free(ctx.slots);
+        return false;
+    }
+
+    // Records go after the header and slot table, which are written once every slot is known
+    if (fseek(ctx.file, (long)ctx.offset, SEEK_SET) != 0) {
+        log_perror("fseek() failed for %s", tmp_path);
+        ctx.failed = true;
+    }
+
+    if (!ctx.failed && !hash_table_iter(ht, write_entry, &ctx)) {
+        ctx.failed = true;
+    }
+
+    if (!ctx.failed) {
+        disk_hash_table_header header = {
+            .version = DISK_HASH_TABLE_VERSION,
+            .byte_order = BYTE_ORDER_MARK,
+            .seed = WRITE_SEED,
+            .slot_count = slot_count,
+            .entry_count = entry_size,
+            .file_size = ctx.offset,
+        };
+        memcpy(header.magic, DISK_HASH_TABLE_MAGIC, sizeof(header.magic));
+
+        if (fseek(ctx.file, 0, SEEK_SET) != 0 ||
+            fwrite(&header, sizeof(header), 1, ctx.file) != 1 ||
+            fwrite(ctx.slots, sizeof(disk_hash_table_slot), slot_count, ctx.file) != slot_count ||
+            fflush(ctx.file) != 0 ||
+            fsync(fileno(ctx.file)) != 0) {
+            log_perror("failed to write %s", tmp_path);
+            ctx.failed = true;
+        }
+    }
+
+    free(ctx.slots);
+
+    if (fclose(ctx.file) != 0 && !ctx.failed) {
+        log_perror("fclose() failed for %s", tmp_path);
+        ctx.failed = true;
+    }
+
+    if (!ctx.failed && rename(tmp_path, path) != 0) {
+        log_perror("rename() failed for %s", path);
+        ctx.failed = true;
+    }
+
+    if (ctx.failed) {
+        unlink(tmp_path);
+        return false;
+    }
+
+    return true;
+}
+
+bool disk_hash_table_open(disk_hash_table* dht, const char* path) {
+    memset(dht, 0, sizeof(disk_hash_table));
+
+    const int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        log_perror("open() failed for %s", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        log_perror("fstat() failed for %s", path);
+        close(fd);
+        return false;
+    }
+
+    if (st.st_size < (off_t)sizeof(disk_hash_table_header)) {
+        log_error("%s is not a disk hash table", path);
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the file open
+
+    if (data == MAP_FAILED) {
+        log_perror("mmap() failed for %s", path);
+        return false;
+    }
+
+    const disk_hash_table_header* header = data;
+    if (memcmp(header->magic, DISK_HASH_TABLE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->byte_order != BYTE_ORDER_MARK) {
+        log_error("%s is not a disk hash table (or was written on a machine with a different byte order)", path);
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    if (header->version != DISK_HASH_TABLE_VERSION) {
+        log_error("%s has unsupported disk hash table version %u", path, header->version);
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    const uint64_t slot_count = header->slot_count;
+    if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 || header->entry_count >= slot_count ||
+        header->file_size != (uint64_t)st.st_size ||
+        sizeof(disk_hash_table_header) + slot_count * sizeof(disk_hash_table_slot) > header->file_size) {
+        log_error("%s is corrupt (bad header)", path);
+        munmap(data, st.st_size);
+        return false;
+    }
+
+    // Lookups jump around the file, so readahead would mostly read pages that aren't needed
+    posix_madvise(data, st.st_size, POSIX_MADV_RANDOM);
+
+    dht->data = data;
+    dht->data_size = st.st_size;
+    dht->slots = (const disk_hash_table_slot*)(dht->data + sizeof(disk_hash_table_header));
+    dht->slot_mask = slot_count - 1;
+    dht->seed = header->seed;
+    dht->entry_size = header->entry_count;
+
+    return true;
+}
+
+const void* disk_hash_table_get_n(
+    const disk_hash_table* dht,
+    const void* key,
+    const size_t key_len,
+    size_t* value_len
+) {
+    if (dht->data == NULL) {
+        log_error("disk hash table not open");
+        return nullptr;
+    }
+
+    const uint32_t hash = murmur3(key, key_len, dht->seed);
+
+    // Bounded by the slot count, so a corrupt file without empty slots can't loop forever
+    uint32_t slot = hash & dht->slot_mask;
+    for (uint64_t probes = 0; probes <= dht->slot_mask; ++probes, slot = (slot + 1) & dht->slot_mask) {
+        const disk_hash_table_slot* p_slot = &dht->slots[slot];
+        if (p_slot->offset == 0) {
+            break;
+        }
+
+        if (p_slot->hash != hash || p_slot->key_len != key_len) {
+            continue;
+        }
+
+        // Bounds are checked here instead of when the file is opened, so opening doesn't have to read every record
+        const uint64_t key_offset = p_slot->offset + sizeof(disk_hash_table_record);
+        if (key_offset > dht->data_size || key_len > dht->data_size - key_offset) {
+            log_error("disk hash table is corrupt (record out of bounds)");
+            return nullptr;
+        }
+
+        const disk_hash_table_record* record = (const disk_hash_table_record*)(dht->data + p_slot->offset);
+        if (record->key_len != key_len || memcmp(dht->data + key_offset, key, key_len) != 0) {
+            continue;
+        }
+
+        const uint64_t value_offset = align_offset(key_offset + key_len);
+        if (value_offset > dht->data_size || (uint64_t)record->value_len + 1 > dht->data_size - value_offset) {
+            log_error("disk hash table is corrupt (record out of bounds)");
+            return nullptr;
+        }
+
+        if (value_len != NULL) {
+            *value_len = record->value_len;
+        }
+
+        return dht->data + value_offset;
+    }
+
+    return nullptr;
+}
+
+const void* disk_hash_table_get(const disk_hash_table* dht, const char* key, size_t* value_len) {
+    return disk_hash_table_get_n(dht, key, strlen(key), value_len);
+}
+
+size_t disk_hash_table_size(const disk_hash_table* dht) {
+    return dht->entry_size;
+}
+
+bool disk_hash_table_close(disk_hash_table* dht) {
+    if (dht->data == NULL) {
+        log_error("disk hash table not open");
+        return false;
+    }
+
+    if (munmap((void*)dht->data, dht->data_size) != 0) {
+        log_perror("munmap() failed");
+        return false;
+    }
+
+    memset(dht, 0, sizeof(disk_hash_table));
+
+    return true;
+}
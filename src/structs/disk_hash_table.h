@@ -0,0 +1,241 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hash_table.h"
+
+/**
+ * Magic bytes at the start of a disk hash table file
+ */
+#define DISK_HASH_TABLE_MAGIC "LUPRADHT"
+
+/**
+ * File format version (bumped whenever the layout changes)
+ */
+#define DISK_HASH_TABLE_VERSION 1
+
+/**
+ * Disk hash table file header
+ *
+ * All integers are stored in the byte order of the machine that wrote the file (checked with byte_order), and all
+ * offsets are relative to the start of the file, so a mapping can be used at any address.
+ */
+typedef struct disk_hash_table_header {
+    char magic[8];
+    uint32_t version;
+
+    /**
+     * Always 0x01020304 as written by the writer (a file from a machine with a different byte order won't match)
+     */
+    uint32_t byte_order;
+
+    /**
+     * Seed the keys were hashed with (murmur3)
+     */
+    uint32_t seed;
+
+    /**
+     * Number of slots (power of 2)
+     */
+    uint32_t slot_count;
+
+    /**
+     * Number of entries
+     */
+    uint64_t entry_count;
+
+    /**
+     * Total file size in bytes
+     */
+    uint64_t file_size;
+} disk_hash_table_header;
+
+/**
+ * Disk hash table slot
+ * The slot table follows the header, and is probed linearly starting at slot (hash & (slot_count - 1))
+ */
+typedef struct disk_hash_table_slot {
+    /**
+     * Full hash of the key
+     */
+    uint32_t hash;
+
+    /**
+     * Length of the key in bytes (checked before the record is touched, so a miss rarely reads the heap)
+     */
+    uint32_t key_len;
+
+    /**
+     * Offset of the entry's record, or 0 for an empty slot
+     */
+    uint64_t offset;
+} disk_hash_table_slot;
+
+/**
+ * Disk hash table record header
+ * Records follow the slot table and are 8 byte aligned. Each holds the key, padding up to an 8 byte boundary, then the
+ * value followed by a NUL byte (so string values can be used as-is).
+ */
+typedef struct disk_hash_table_record {
+    uint32_t key_len;
+    uint32_t value_len;
+} disk_hash_table_record;
+
+/**
+ * Value length function, used by the writer to find out how many bytes of a value to store
+ *
+ * @param[in] value Value
+ * @param user_arg Optional user arg
+ * @return Value length in bytes
+ */
+typedef size_t (*disk_hash_table_value_len_func)(const void* value, void* user_arg);
+
+/**
+ * An immutable hash table that's read directly from a memory mapped file.
+ *
+ * disk_hash_table_write() serializes a populated hash_table (with NUL-terminated string keys or binary keys, see
+ * hash_table_set_n()) into a compact, position-independent file (CDB-like: a header, an open addressed slot table, then
+ * a heap of key/value records). disk_hash_table_open() maps the file read-only, so opening is a single mmap() no matter
+ * how large the table is: nothing is parsed, copied or allocated, pages are only read in as lookups touch them, and the
+ * page cache is shared by every process that maps the same file.
+ *
+ * Lookups return pointers into the mapping, which stay valid until the table is closed. Values are 8 byte aligned.
+ *
+ * Files are written to a uniquely named temporary file next to the target and renamed into place, so a process that maps
+ * the old file keeps a consistent view while a new one is built, and concurrent writers of the same path never mix their
+ * output (the last rename wins).
+ *
+ * **Example**
+ * ```c
+ * hash_table ht;
+ * hash_table_init(&ht, 10, NULL, NULL);
+ * hash_table_set(&ht, "foo", "one");
+ * hash_table_set(&ht, "bar", "two");
+ *
+ * disk_hash_table_write(&ht, "table.dht", NULL, NULL); // String values
+ * hash_table_destroy(&ht);
+ *
+ * disk_hash_table dht;
+ * disk_hash_table_open(&dht, "table.dht");
+ *
+ * size_t value_len;
+ * const char* foo = disk_hash_table_get(&dht, "foo", &value_len);
+ * assert(strcmp(foo, "one") == 0);
+ *
+ * disk_hash_table_close(&dht);
+ * ```
+ */
+typedef struct disk_hash_table {
+    /**
+     * Start of the mapping
+     */
+    const uint8_t* data;
+
+    /**
+     * Size of the mapping in bytes
+     */
+    size_t data_size;
+
+    /**
+     * Slot table (in the mapping)
+     */
+    const disk_hash_table_slot* slots;
+
+    /**
+     * Number of slots - 1
+     */
+    uint32_t slot_mask;
+
+    /**
+     * Hash seed
+     */
+    uint32_t seed;
+
+    /**
+     * Number of entries
+     */
+    size_t entry_size;
+} disk_hash_table;
+
+/**
+ * Write a hash table to a disk hash table file
+ *
+ * The table's keys must be NUL-terminated strings, or binary keys added with hash_table_set_n().
+ *
+ * Time complexity: O(n)
+ *
+ * @relates disk_hash_table
+ * @param[in] ht Hash table to write
+ * @param[in] path File path (replaced if it exists)
+ * @param[in] value_len Value length function (or NULL if values are NUL-terminated strings)
+ * @param value_len_user_arg Optional argument to pass to the value length function
+ * @return true on success, false on failure
+ */
+bool disk_hash_table_write(
+    hash_table* ht,
+    const char* path,
+    disk_hash_table_value_len_func value_len,
+    void* value_len_user_arg
+);
+
+/**
+ * Open (memory map) a disk hash table file
+ *
+ * Time complexity: O(1)
+ *
+ * @relates disk_hash_table
+ * @param[out] dht Disk hash table
+ * @param[in] path File path
+ * @return true on success, false on failure
+ */
+bool disk_hash_table_open(disk_hash_table* dht, const char* path);
+
+/**
+ * Get a value from the disk hash table with a binary key
+ *
+ * Time complexity: O(1)
+ *
+ * @relates disk_hash_table
+ * @param[in] dht Disk hash table
+ * @param[in] key Pointer to key bytes
+ * @param[in] key_len Key length in bytes
+ * @param[out] value_len Value length in bytes (or NULL if not needed)
+ * @return Value pointer (into the mapping), or NULL if not found
+ */
+const void* disk_hash_table_get_n(const disk_hash_table* dht, const void* key, size_t key_len, size_t* value_len);
+
+/**
+ * Get a value from the disk hash table with a NUL-terminated string key
+ *
+ * Time complexity: O(1)
+ *
+ * @relates disk_hash_table
+ * @param[in] dht Disk hash table
+ * @param[in] key Key
+ * @param[out] value_len Value length in bytes (or NULL if not needed)
+ * @return Value pointer (into the mapping), or NULL if not found
+ */
+const void* disk_hash_table_get(const disk_hash_table* dht, const char* key, size_t* value_len);
+
+/**
+ * Get the number of entries in the disk hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates disk_hash_table
+ * @param[in] dht Disk hash table
+ * @return Number of entries
+ */
+size_t disk_hash_table_size(const disk_hash_table* dht);
+
+/**
+ * Close (unmap) the disk hash table
+ * Pointers returned by lookups are invalid after this
+ *
+ * Time complexity: O(1)
+ *
+ * @relates disk_hash_table
+ * @param[in,out] dht Disk hash table
+ * @return true on success, false on failure
+ */
+bool disk_hash_table_close(disk_hash_table* dht);
@@ -0,0 +1,598 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "flat_hash_table.h"
+#include "../utils/log.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Number of control bytes that are probed at a time
+ */
+#define GROUP_WIDTH 16
+
+/**
+ * Control byte for a slot that has never been used
+ */
+#define CTRL_EMPTY ((int8_t)-128)
+
+/**
+ * Control byte for a slot whose entry was deleted (tombstone)
+ * Probing has to continue past these, but they can be reused by inserts
+ */
+#define CTRL_DELETED ((int8_t)-2)
+
+/**
+ * Key length passed to lookups for keys that are compared with the table's key_cmp function (rather than memcmp())
+ */
+#define KEY_LEN_CMP SIZE_MAX
+
+/**
+ * Bit mask of matching slots in a control byte group
+ * Slot i of the group is represented by bit (i << GROUP_MASK_SHIFT)
+ */
+typedef uint64_t group_mask;
+
+#if defined(__SSE2__)
+
+#define GROUP_MASK_SHIFT 0
+
+static inline group_mask group_match(const int8_t* ctrl, const int8_t h2) {
+    const __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), group));
+}
+
+static inline group_mask group_match_empty_or_deleted(const int8_t* ctrl) {
+    // Empty and deleted are the only negative values below -1
+    const __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint16_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), group));
+}
+
+#elif defined(__ARM_NEON)
+
+#define GROUP_MASK_SHIFT 2
+
+/**
+ * NEON has no movemask, so narrow each 8-bit lane to a nibble and keep one bit per nibble
+ *
+ * @param[in] eq Lane-wise comparison result
+ * @return Group mask
+ */
+static inline group_mask neon_group_mask(const uint8x16_t eq) {
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+}
+
+static inline group_mask group_match(const int8_t* ctrl, const int8_t h2) {
+    return neon_group_mask(vceqq_s8(vld1q_s8(ctrl), vdupq_n_s8(h2)));
+}
+
+static inline group_mask group_match_empty_or_deleted(const int8_t* ctrl) {
+    return neon_group_mask(vcltq_s8(vld1q_s8(ctrl), vdupq_n_s8(-1)));
+}
+
+#else
+
+#define GROUP_MASK_SHIFT 0
+
+static inline group_mask group_match(const int8_t* ctrl, const int8_t h2) {
+    group_mask mask = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+        if (ctrl[i] == h2) {
+            mask |= (group_mask)1 << i;
+        }
+    }
+
+    return mask;
+}
+
+static inline group_mask group_match_empty_or_deleted(const int8_t* ctrl) {
+    group_mask mask = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+        if (ctrl[i] < -1) {
+            mask |= (group_mask)1 << i;
+        }
+    }
+
+    return mask;
+}
+
+#endif
+
+static inline group_mask group_match_empty(const int8_t* ctrl) {
+    return group_match(ctrl, CTRL_EMPTY);
+}
+
+/**
+ * Get the group offset of the lowest set slot in a group mask
+ *
+ * @param[in] mask Non-zero group mask
+ * @return Slot offset within the group
+ */
+static inline size_t group_mask_first(const group_mask mask) {
+    return (size_t)__builtin_ctzll(mask) >> GROUP_MASK_SHIFT;
+}
+
+/**
+ * Compute the 64-bit probe hash for a key hash
+ * The key hash is only 32 bits, so it's remixed to spread it across h1 (position) and h2 (control byte)
+ *
+ * @param[in] key_hash Full key hash
+ * @return Probe hash
+ */
+static inline uint64_t probe_hash(const uint32_t key_hash) {
+    // murmur3 fmix64 finalizer
+    uint64_t h = key_hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline size_t h1(const uint64_t hash) {
+    return (size_t)(hash >> 7);
+}
+
+static inline int8_t h2(const uint64_t hash) {
+    return (int8_t)(hash & 0x7f);
+}
+
+/**
+ * Set a control byte (and its mirror if it's in the first group)
+ *
+ * @param[in,out] ft Flat hash table
+ * @param[in] index Slot index
+ * @param[in] value Control byte
+ */
+static inline void set_ctrl(const flat_hash_table* ft, const size_t index, const int8_t value) {
+    ft->ctrl[index] = value;
+    if (index < GROUP_WIDTH) {
+        ft->ctrl[ft->capacity + index] = value;
+    }
+}
+
+/**
+ * Max number of entries that can be stored at a given capacity (7/8 max load factor)
+ *
+ * @param[in] capacity Slot count
+ * @return Max entries
+ */
+static inline size_t max_entries(const size_t capacity) {
+    return capacity - capacity / 8;
+}
+
+/**
+ * Compute the slot count needed to store a number of entries
+ *
+ * @param[in] size Number of entries
+ * @return Slot count (power of 2, at least GROUP_WIDTH)
+ */
+static size_t capacity_for(const size_t size) {
+    size_t capacity = GROUP_WIDTH;
+    while (max_entries(capacity) < size) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+/**
+ * Find the slot index holding a key
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] ft Flat hash table
+ * @param[in] key Key to find
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] key_hash Full hash of key
+ * @return Slot index or SIZE_MAX if not found
+ */
+static size_t find_slot(
+    const flat_hash_table* ft,
+    const void* key,
+    const size_t key_len,
+    const uint32_t key_hash
+) {
+    const uint64_t hash = probe_hash(key_hash);
+    const size_t mask = ft->capacity - 1;
+    const int8_t tag = h2(hash);
+    size_t pos = h1(hash) & mask;
+
+    for (size_t step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+        const int8_t* group = ft->ctrl + pos;
+
+        for (group_mask match = group_match(group, tag); match != 0; match &= match - 1) {
+            const size_t index = (pos + group_mask_first(match)) & mask;
+            const hash_table_entry* p_slot = &ft->slots[index];
+            if (p_slot->hash != key_hash) {
+                continue;
+            }
+
+            const bool matches = key_len == KEY_LEN_CMP
+                ? (*ft->key_cmp)(p_slot->key, key) == 0
+                : p_slot->key_len == key_len && memcmp(p_slot->key, key, key_len) == 0;
+            if (matches) {
+                return index;
+            }
+        }
+
+        if (group_match_empty(group) != 0) {
+            // An empty slot ends the probe sequence
+            return SIZE_MAX;
+        }
+
+        pos = (pos + step) & mask;
+    }
+}
+
+/**
+ * Find the first empty or deleted slot in a hash's probe sequence
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] ft Flat hash table
+ * @param[in] hash Probe hash
+ * @return Slot index
+ */
+static size_t find_insert_slot(const flat_hash_table* ft, const uint64_t hash) {
+    const size_t mask = ft->capacity - 1;
+    size_t pos = h1(hash) & mask;
+
+    for (size_t step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+        const group_mask match = group_match_empty_or_deleted(ft->ctrl + pos);
+        if (match != 0) {
+            return (pos + group_mask_first(match)) & mask;
+        }
+
+        pos = (pos + step) & mask;
+    }
+}
+
+/**
+ * Allocate empty control bytes and slots
+ *
+ * @param[out] ft Flat hash table
+ * @param[in] capacity Slot count (power of 2)
+ * @return true on success, false on failure
+ */
+static bool alloc_slots(flat_hash_table* ft, const size_t capacity) {
+    ft->ctrl = malloc(capacity + GROUP_WIDTH);
+    if (ft->ctrl == NULL) {
+        log_perror("malloc() failed");
+        return false;
+    }
+
+    ft->slots = malloc(capacity * sizeof(hash_table_entry));
+    if (ft->slots == NULL) {
+        log_perror("malloc() failed");
+        free(ft->ctrl);
+        ft->ctrl = nullptr;
+        return false;
+    }
+
+    memset(ft->ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+    ft->capacity = capacity;
+    ft->growth_left = max_entries(capacity);
+
+    return true;
+}
+
+/**
+ * Move all entries into a new slot array
+ *
+ * Time complexity: O(n)
+ *
+ * @param[in,out] ft Flat hash table
+ * @param[in] new_capacity New slot count (power of 2)
+ * @return true on success, false on failure
+ */
+static bool resize(flat_hash_table* ft, const size_t new_capacity) {
+    int8_t* old_ctrl = ft->ctrl;
+    hash_table_entry* old_slots = ft->slots;
+    const size_t old_capacity = ft->capacity;
+
+    if (!alloc_slots(ft, new_capacity)) {
+        ft->ctrl = old_ctrl;
+        ft->slots = old_slots;
+        return false;
+    }
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_ctrl[i] >= 0) {
+            // Reuse the stored hash instead of rehashing the key
+            const uint64_t hash = probe_hash(old_slots[i].hash);
+            const size_t index = find_insert_slot(ft, hash);
+            set_ctrl(ft, index, h2(hash));
+            ft->slots[index] = old_slots[i];
+        }
+    }
+
+    ft->growth_left -= ft->entry_size;
+
+    free(old_ctrl);
+    free(old_slots);
+
+    return true;
+}
+
+bool flat_hash_table_init(
+    flat_hash_table* ft,
+    const uint32_t size,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(ft, 0, sizeof(flat_hash_table));
+
+    if (!alloc_slots(ft, capacity_for(size))) {
+        return false;
+    }
+
+    ft->key_cmp = key_cmp == NULL ? value_cmp_string : key_cmp;
+    ft->key_hash = key_hash == NULL ? hash_table_key_hash_string : key_hash;
+
+    return true;
+}
+
+bool flat_hash_table_rehash(flat_hash_table* ft, const uint32_t new_size) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return false;
+    }
+
+    if (new_size < ft->entry_size) {
+        log_error("new size %u is smaller than entry count %zu", new_size, ft->entry_size);
+        return false;
+    }
+
+    return resize(ft, capacity_for(new_size));
+}
+
+/**
+ * Set a value in the flat hash table
+ *
+ * @param[in,out] ft Flat hash table
+ * @param[in] key Pointer to key
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] key_hash Full hash of key
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+static bool set_value(
+    flat_hash_table* ft,
+    void* key,
+    const size_t key_len,
+    const uint32_t key_hash,
+    void* value
+) {
+    const uint64_t hash = probe_hash(key_hash);
+
+    size_t index = find_slot(ft, key, key_len, key_hash);
+    if (index != SIZE_MAX) {
+        // Update existing entry
+        ft->slots[index].value = value;
+        return true;
+    }
+
+    index = find_insert_slot(ft, hash);
+    if (ft->growth_left == 0 && ft->ctrl[index] == CTRL_EMPTY) {
+        // Out of empty slots: grow, or just clear tombstones if the table is mostly deleted slots
+        const size_t new_capacity = ft->entry_size * 16 <= ft->capacity * 7 ? ft->capacity : ft->capacity * 2;
+        if (!resize(ft, new_capacity)) {
+            return false;
+        }
+
+        index = find_insert_slot(ft, hash);
+    }
+
+    if (ft->ctrl[index] == CTRL_EMPTY) {
+        --ft->growth_left;
+    }
+
+    set_ctrl(ft, index, h2(hash));
+
+    hash_table_entry* p_entry = &ft->slots[index];
+    memset(p_entry, 0, sizeof(hash_table_entry));
+    p_entry->key = key;
+    p_entry->key_len = key_len == KEY_LEN_CMP ? 0 : key_len;
+    p_entry->value = value;
+    p_entry->hash = key_hash;
+
+    ++ft->entry_size;
+
+    return true;
+}
+
+bool flat_hash_table_set(flat_hash_table* ft, void* key, void* value) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return false;
+    }
+
+    return set_value(ft, key, KEY_LEN_CMP, (*ft->key_hash)(key, SIZE_MAX), value);
+}
+
+bool flat_hash_table_set_n(flat_hash_table* ft, void* key, const size_t key_len, void* value) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return false;
+    }
+
+    if (key_len == KEY_LEN_CMP) {
+        log_error("invalid key length");
+        return false;
+    }
+
+    return set_value(ft, key, key_len, hash_table_hash_bytes(key, key_len), value);
+}
+
+hash_table_entry* flat_hash_table_get_entry(const flat_hash_table* ft, const void* key) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return nullptr;
+    }
+
+    const size_t index = find_slot(ft, key, KEY_LEN_CMP, (*ft->key_hash)(key, SIZE_MAX));
+    if (index == SIZE_MAX) {
+        // No entry
+        return nullptr;
+    }
+
+    return &ft->slots[index];
+}
+
+hash_table_entry* flat_hash_table_get_entry_n(const flat_hash_table* ft, const void* key, const size_t key_len) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return nullptr;
+    }
+
+    const size_t index = find_slot(ft, key, key_len, hash_table_hash_bytes(key, key_len));
+    if (index == SIZE_MAX) {
+        // No entry
+        return nullptr;
+    }
+
+    return &ft->slots[index];
+}
+
+void* flat_hash_table_get(const flat_hash_table* ft, const void* key) {
+    const hash_table_entry* entry = flat_hash_table_get_entry(ft, key);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    return entry->value;
+}
+
+void* flat_hash_table_get_n(const flat_hash_table* ft, const void* key, const size_t key_len) {
+    const hash_table_entry* entry = flat_hash_table_get_entry_n(ft, key, key_len);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    return entry->value;
+}
+
+/**
+ * Delete the entry in a slot
+ *
+ * @param[in,out] ft Flat hash table
+ * @param[in] index Slot index
+ */
+static void delete_slot(flat_hash_table* ft, const size_t index) {
+    // Leave a tombstone so probe sequences that pass through this slot keep going
+    set_ctrl(ft, index, CTRL_DELETED);
+    memset(&ft->slots[index], 0, sizeof(hash_table_entry));
+    --ft->entry_size;
+}
+
+bool flat_hash_table_del(flat_hash_table* ft, const void* key) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return false;
+    }
+
+    const size_t index = find_slot(ft, key, KEY_LEN_CMP, (*ft->key_hash)(key, SIZE_MAX));
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    delete_slot(ft, index);
+
+    return true;
+}
+
+bool flat_hash_table_del_n(flat_hash_table* ft, const void* key, const size_t key_len) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return false;
+    }
+
+    const size_t index = find_slot(ft, key, key_len, hash_table_hash_bytes(key, key_len));
+    if (index == SIZE_MAX) {
+        return false;
+    }
+
+    delete_slot(ft, index);
+
+    return true;
+}
+
+bool flat_hash_table_iter(
+    flat_hash_table* ft,
+    const hash_table_iter_func iter_func,
+    void* iter_func_user_arg
+) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return false;
+    }
+
+    for (size_t i = 0; i < ft->capacity; ++i) {
+        if (ft->ctrl[i] >= 0) {
+            iter_func(&ft->slots[i], i, iter_func_user_arg);
+        }
+    }
+
+    return true;
+}
+
+size_t flat_hash_table_keys(flat_hash_table* ft, void** keys) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return -1;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < ft->capacity; ++i) {
+        if (ft->ctrl[i] >= 0) {
+            keys[count++] = ft->slots[i].key;
+        }
+    }
+
+    return count;
+}
+
+size_t flat_hash_table_values(flat_hash_table* ft, void** values) {
+    if (ft->ctrl == NULL) {
+        log_error("flat hash table not initialized");
+        return -1;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < ft->capacity; ++i) {
+        if (ft->ctrl[i] >= 0) {
+            values[count++] = ft->slots[i].value;
+        }
+    }
+
+    return count;
+}
+
+size_t flat_hash_table_size(const flat_hash_table* ft) {
+    return ft->entry_size;
+}
+
+bool flat_hash_table_destroy(flat_hash_table* ft) {
+    if (ft->ctrl == NULL) {
+        return false;
+    }
+
+    free(ft->ctrl);
+    ft->ctrl = nullptr;
+
+    free(ft->slots);
+    ft->slots = nullptr;
+
+    ft->capacity = 0;
+    ft->entry_size = 0;
+    ft->growth_left = 0;
+
+    return true;
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hash_table.h"
+#include "../utils/value.h"
+
+/**
+ * An open addressed hash table that stores its entries inline in a flat slot array (Swiss table style).
+ *
+ * Each slot has a matching control byte that is either empty, deleted, or holds 7 bits of the key's hash. Lookups
+ * compare the control bytes of 16 slots at a time (using SSE2 or NEON when available, otherwise a scalar loop) and only
+ * call the key comparator on slots whose hash bits match. Because there are no per-entry allocations or linked lists,
+ * a lookup typically touches one control byte group and one slot.
+ *
+ * This exposes the same surface as hash_table (including the value_cmp_func and hash_table_key_hash_func hooks), so it
+ * can be swapped in wherever a hash_table is used. The key hash function is called with ht_size set to SIZE_MAX, and
+ * should return the full 32-bit hash. Binary keys can be used with the *_n functions, the same way as hash_table_set_n().
+ *
+ * Entry pointers (from flat_hash_table_get_entry() or iteration) are only valid until the next insert, since the
+ * table may grow and move its slots.
+ *
+ * **Example**
+ * ```c
+ * flat_hash_table ft;
+ * flat_hash_table_init(&ft, 10, NULL, NULL); // Grows automatically
+ *
+ * flat_hash_table_set(&ft, "foo", "one");
+ * flat_hash_table_set(&ft, "foo", "two");
+ * flat_hash_table_set(&ft, "bar", "three");
+ *
+ * char *foo = flat_hash_table_get(&ft, "foo");
+ * char *bar = flat_hash_table_get(&ft, "bar");
+ *
+ * assert(strcmp(foo, "two") == 0);
+ * assert(strcmp(bar, "three") == 0);
+ *
+ * flat_hash_table_destroy(&ft);
+ * ```
+ */
+typedef struct flat_hash_table {
+    /**
+     * Number of slots (always a power of 2)
+     */
+    size_t capacity;
+
+    /**
+     * Number of stored entries
+     */
+    size_t entry_size;
+
+    /**
+     * Number of empty slots that can still be filled before the table must grow
+     */
+    size_t growth_left;
+
+    /**
+     * Control bytes (capacity + 16 bytes; the first 16 are mirrored at the end so a group can always be loaded)
+     */
+    int8_t* ctrl;
+
+    /**
+     * Slot array
+     */
+    hash_table_entry* slots;
+
+    /**
+     * Key comparator function
+     * Default: String comparator
+     */
+    value_cmp_func key_cmp;
+
+    /**
+     * Key hash function
+     * Default: String hash function
+     */
+    hash_table_key_hash_func key_hash;
+} flat_hash_table;
+
+/**
+ * Initialize the flat hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates flat_hash_table
+ * @param[out] ft Flat hash table
+ * @param[in] size Number of entries to reserve space for
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_init(
+    flat_hash_table* ft,
+    uint32_t size,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash
+);
+
+/**
+ * Resize and rebuild the flat hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates flat_hash_table
+ * @param[in,out] ft Flat hash table
+ * @param[in] new_size Number of entries to reserve space for (can't be less than the current number of entries)
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_rehash(flat_hash_table* ft, uint32_t new_size);
+
+/**
+ * Set a value in the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in,out] ft Flat hash table
+ * @param[in] key Pointer to key
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_set(flat_hash_table* ft, void* key, void* value);
+
+/**
+ * Set a value for a binary key in the flat hash table
+ *
+ * The key isn't copied, so it must stay valid (and unchanged) while it's in the table.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in,out] ft Flat hash table
+ * @param[in] key Pointer to key
+ * @param[in] key_len Key length in bytes
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_set_n(flat_hash_table* ft, void* key, size_t key_len, void* value);
+
+/**
+ * Get entry from the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @param[in] key Key to get entry for
+ * @return Entry (valid until the next insert) or NULL if not found
+ */
+hash_table_entry* flat_hash_table_get_entry(const flat_hash_table* ft, const void* key);
+
+/**
+ * Get entry for a binary key from the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @param[in] key Key to get entry for
+ * @param[in] key_len Key length in bytes
+ * @return Entry (valid until the next insert) or NULL if not found
+ */
+hash_table_entry* flat_hash_table_get_entry_n(const flat_hash_table* ft, const void* key, size_t key_len);
+
+/**
+ * Get value from the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @param[in] key Entry key to get value for
+ * @return Value pointer
+ */
+void* flat_hash_table_get(const flat_hash_table* ft, const void* key);
+
+/**
+ * Get value for a binary key from the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @param[in] key Entry key to get value for
+ * @param[in] key_len Key length in bytes
+ * @return Value pointer
+ */
+void* flat_hash_table_get_n(const flat_hash_table* ft, const void* key, size_t key_len);
+
+/**
+ * Delete entry from the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in,out] ft Flat hash table
+ * @param[in] key Entry key to delete
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_del(flat_hash_table* ft, const void* key);
+
+/**
+ * Delete entry for a binary key from the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in,out] ft Flat hash table
+ * @param[in] key Entry key to delete
+ * @param[in] key_len Key length in bytes
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_del_n(flat_hash_table* ft, const void* key, size_t key_len);
+
+/**
+ * Iterate flat hash table keys and values
+ *
+ * Time complexity: O(n)
+ *
+ * @relates flat_hash_table
+ * @param ft Flat hash table
+ * @param[in] iter_func Iterator callback function (index is the slot index)
+ * @param iter_func_user_arg Optional argument to pass to callback function
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_iter(
+    flat_hash_table* ft,
+    hash_table_iter_func iter_func,
+    void* iter_func_user_arg
+);
+
+/**
+ * Get all keys in the flat hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @param[out] keys Pointer to array to store key pointers in
+ * @return Number of keys, or -1 on failure
+ */
+size_t flat_hash_table_keys(flat_hash_table* ft, void** keys);
+
+/**
+ * Get all values in the flat hash table
+ *
+ * Time complexity: O(n)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @param[out] values Pointer to array to store value pointers in
+ * @return Number of values, or -1 on failure
+ */
+size_t flat_hash_table_values(flat_hash_table* ft, void** values);
+
+/**
+ * Get the number of entries in the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in] ft Flat hash table
+ * @return Number of entries
+ */
+size_t flat_hash_table_size(const flat_hash_table* ft);
+
+/**
+ * Destroy the flat hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates flat_hash_table
+ * @param[in,out] ft Flat hash table
+ * @return true on success, false on failure
+ */
+bool flat_hash_table_destroy(flat_hash_table* ft);
@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash_aggregate.h"
+#include "../utils/log.h"
+#include "../utils/parallel.h"
+
+/**
+ * Max load factor of the group slots (as a fraction), above which they grow
+ */
+#define MAX_LOAD_NUMERATOR 3
+#define MAX_LOAD_DENOMINATOR 4
+
+/**
+ * Smallest number of group slots
+ */
+#define MIN_CAPACITY 8
+
+bool hash_aggregate_init(
+    hash_aggregate* agg,
+    const uint32_t size,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(agg, 0, sizeof(hash_aggregate));
+
+    if (size == 0) {
+        log_error("invalid hash aggregate size");
+        return false;
+    }
+
+    // Enough slots for size groups without going over the max load factor
+    size_t capacity = MIN_CAPACITY;
+    while (capacity * MAX_LOAD_NUMERATOR < (size_t)size * MAX_LOAD_DENOMINATOR) {
+        capacity <<= 1;
+    }
+
+    // Empty slots have a count of 0
+    agg->groups = calloc(capacity, sizeof(hash_aggregate_group));
+    if (agg->groups == NULL) {
+        log_perror("calloc() failed for hash aggregate groups");
+        return false;
+    }
+
+    agg->capacity = capacity;
+    agg->key_cmp = key_cmp == NULL ? value_cmp_string : key_cmp;
+    agg->key_hash = key_hash == NULL ? hash_table_key_hash_string : key_hash;
+
+    return true;
+}
+
+/**
+ * Double the number of group slots, and move every group into the new slots
+ *
+ * @param[in,out] agg Hash aggregate
+ * @return true on success, false on failure
+ */
+static bool grow(hash_aggregate* agg) {
+    const size_t new_capacity = agg->capacity * 2;
+    hash_aggregate_group* p_groups = calloc(new_capacity, sizeof(hash_aggregate_group));
+    if (p_groups == NULL) {
+        log_perror("calloc() failed for hash aggregate groups");
+        return false;
+    }
+
+    for (size_t i = 0; i < agg->capacity; ++i) {
+        const hash_aggregate_group* p_group = &agg->groups[i];
+        if (p_group->state.count == 0) {
+            continue;
+        }
+
+        // Keys are unique, so each group just goes in the first empty slot
+        size_t slot = p_group->hash & (new_capacity - 1);
+        while (p_groups[slot].state.count != 0) {
+            slot = (slot + 1) & (new_capacity - 1);
+        }
+
+        p_groups[slot] = *p_group;
+    }
+
+    free(agg->groups);
+    agg->groups = p_groups;
+    agg->capacity = new_capacity;
+
+    return true;
+}
+
+/**
+ * Find a key's group slot
+ *
+ * @param[in] agg Hash aggregate
+ * @param[in] key Group key
+ * @param[in] hash Full hash of the key
+ * @return The key's group, or the empty slot where it would go
+ */
+static hash_aggregate_group* find_group(const hash_aggregate* agg, const void* key, const uint32_t hash) {
+    const size_t mask = agg->capacity - 1;
+
+    for (size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        hash_aggregate_group* p_group = &agg->groups[slot];
+        if (p_group->state.count == 0 ||
+            (p_group->hash == hash && (*agg->key_cmp)(p_group->key, key) == 0)) {
+            return p_group;
+        }
+    }
+}
+
+/**
+ * Get the state of a key's group, starting a new (empty) group if the key hasn't been seen
+ *
+ * The new group's count is set to 0, so the caller must add at least one value to it.
+ *
+ * @param[in,out] agg Hash aggregate
+ * @param[in] key Group key
+ * @return Group state (valid until the next new group), or NULL on failure
+ */
+static hash_aggregate_state* upsert_state(hash_aggregate* agg, void* key) {
+    const uint32_t hash = (*agg->key_hash)(key, SIZE_MAX);
+
+    hash_aggregate_group* p_group = find_group(agg, key, hash);
+    if (p_group->state.count != 0) {
+        return &p_group->state;
+    }
+
+    if ((agg->group_count + 1) * MAX_LOAD_DENOMINATOR > agg->capacity * MAX_LOAD_NUMERATOR) {
+        if (!grow(agg)) {
+            return nullptr;
+        }
+
+        p_group = find_group(agg, key, hash);
+    }
+
+    p_group->key = key;
+    p_group->hash = hash;
+    p_group->state.sum = 0;
+    p_group->state.min = INT64_MAX;
+    p_group->state.max = INT64_MIN;
+    ++agg->group_count;
+
+    return &p_group->state;
+}
+
+bool hash_aggregate_add(hash_aggregate* agg, void* key, const int64_t value) {
+    hash_aggregate_state* p_state = upsert_state(agg, key);
+    if (p_state == NULL) {
+        return false;
+    }
+
+    ++p_state->count;
+    p_state->sum = (int64_t)((uint64_t)p_state->sum + (uint64_t)value);
+    if (value < p_state->min) {
+        p_state->min = value;
+    }
+    if (value > p_state->max) {
+        p_state->max = value;
+    }
+
+    return true;
+}
+
+bool hash_aggregate_merge(hash_aggregate* dst, const hash_aggregate* src) {
+    for (size_t i = 0; i < src->capacity; ++i) {
+        const hash_aggregate_group* p_src = &src->groups[i];
+        if (p_src->state.count == 0) {
+            continue;
+        }
+
+        hash_aggregate_state* p_state = upsert_state(dst, p_src->key);
+        if (p_state == NULL) {
+            return false;
+        }
+
+        p_state->count += p_src->state.count;
+        p_state->sum = (int64_t)((uint64_t)p_state->sum + (uint64_t)p_src->state.sum);
+        if (p_src->state.min < p_state->min) {
+            p_state->min = p_src->state.min;
+        }
+        if (p_src->state.max > p_state->max) {
+            p_state->max = p_src->state.max;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Parallel aggregation state, shared by all threads
+ */
+struct hash_aggregate_parallel {
+    void* const* keys;
+    const int64_t* values;
+    size_t n;
+    size_t threads;
+
+    /**
+     * Partial aggregate of each thread's slice of the input
+     */
+    hash_aggregate* partials;
+
+    /**
+     * Set if each thread's partial aggregate succeeded
+     */
+    bool* success;
+};
+
+/**
+ * Aggregate a thread's slice of the input into its partial aggregate
+ * {@see parallel_func}
+ */
+static void aggregate_slice(void* arg, const size_t thread) {
+    const struct hash_aggregate_parallel* p_parallel = arg;
+    hash_aggregate* p_partial = &p_parallel->partials[thread];
+
+    const size_t start = p_parallel->n * thread / p_parallel->threads;
+    const size_t end = p_parallel->n * (thread + 1) / p_parallel->threads;
+
+    bool success = true;
+    for (size_t i = start; i < end && success; ++i) {
+        success = hash_aggregate_add(p_partial, p_parallel->keys[i], p_parallel->values[i]);
+    }
+
+    p_parallel->success[thread] = success;
+}
+
+bool hash_aggregate_add_parallel(
+    hash_aggregate* agg,
+    void* const* keys,
+    const int64_t* values,
+    const size_t n,
+    size_t threads
+) {
+    threads = parallel_threads(threads);
+
+    if (threads == 1 || n < threads) {
+        for (size_t i = 0; i < n; ++i) {
+            if (!hash_aggregate_add(agg, keys[i], values[i])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    struct hash_aggregate_parallel parallel = {
+        .keys = keys,
+        .values = values,
+        .n = n,
+        .threads = threads,
+        .partials = calloc(threads, sizeof(hash_aggregate)),
+        .success = calloc(threads, sizeof(bool)),
+    };
+
+    if (parallel.partials == NULL || parallel.success == NULL) {
+        log_perror("hash aggregate partial allocation failed");
+        free(parallel.partials);
+        free(parallel.success);
+        return false;
+    }
+
+    // Partials start at the size of the final aggregate, since each slice probably has most of the groups
+    bool success = true;
+    size_t initialized = 0;
+    for (; initialized < threads && success; ++initialized) {
+        success = hash_aggregate_init(
+            &parallel.partials[initialized],
+            agg->capacity * MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR,
+            agg->key_cmp,
+            agg->key_hash
+        );
+    }
+
+    if (success) {
+        parallel_run(threads, aggregate_slice, &parallel);
+
+        for (size_t t = 0; t < threads && success; ++t) {
+            success = parallel.success[t] && hash_aggregate_merge(agg, &parallel.partials[t]);
+        }
+    }
+
+    for (size_t t = 0; t < initialized; ++t) {
+        hash_aggregate_destroy(&parallel.partials[t]);
+    }
+
+    free(parallel.partials);
+    free(parallel.success);
+
+    return success;
+}
+
+const hash_aggregate_state* hash_aggregate_get(const hash_aggregate* agg, const void* key) {
+    const hash_aggregate_group* p_group = find_group(agg, key, (*agg->key_hash)(key, SIZE_MAX));
+    return p_group->state.count != 0 ? &p_group->state : nullptr;
+}
+
+bool hash_aggregate_iter(const hash_aggregate* agg, const hash_aggregate_iter_func iter_func, void* user_arg) {
+    if (agg->groups == NULL) {
+        log_error("hash aggregate not initialized");
+        return false;
+    }
+
+    for (size_t i = 0; i < agg->capacity; ++i) {
+        const hash_aggregate_group* p_group = &agg->groups[i];
+        if (p_group->state.count != 0) {
+            iter_func(p_group->key, &p_group->state, user_arg);
+        }
+    }
+
+    return true;
+}
+
+size_t hash_aggregate_size(const hash_aggregate* agg) {
+    return agg->group_count;
+}
+
+bool hash_aggregate_destroy(hash_aggregate* agg) {
+    if (agg->groups == NULL) {
+        return false;
+    }
+
+    free(agg->groups);
+    agg->groups = nullptr;
+    agg->capacity = 0;
+    agg->group_count = 0;
+
+    return true;
+}
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hash_table.h"
+#include "../utils/value.h"
+
+/**
+ * Aggregate state of a group
+ */
+typedef struct hash_aggregate_state {
+    /**
+     * Number of values added
+     */
+    uint64_t count;
+
+    /**
+     * Sum of the values (wraps around on overflow)
+     */
+    int64_t sum;
+
+    /**
+     * Smallest and largest values
+     */
+    int64_t min;
+    int64_t max;
+} hash_aggregate_state;
+
+/**
+ * Hash aggregate group slot
+ */
+typedef struct hash_aggregate_group {
+    /**
+     * Group key
+     */
+    void* key;
+
+    /**
+     * Full hash of the key
+     */
+    uint32_t hash;
+
+    /**
+     * Aggregate state (count is 0 while the slot is empty)
+     */
+    hash_aggregate_state state;
+} hash_aggregate_group;
+
+/**
+ * Aggregate iterator function
+ *
+ * @param[in] key Group key
+ * @param[in] state Aggregate state of the group
+ * @param user_arg Optional user arg
+ */
+typedef void (*hash_aggregate_iter_func)(const void* key, const hash_aggregate_state* state, void* user_arg);
+
+/**
+ * A hash aggregate groups values by key, and keeps the count, sum, min and max of each group (like a SQL
+ * `SELECT key, COUNT(*), SUM(value), MIN(value), MAX(value) ... GROUP BY key`).
+ *
+ * Groups are kept in an open addressed (linear probing) slot array, with each group's fixed-size state stored inline
+ * next to its key and hash. Adding a value is a single probe that updates the state in place: there's no pointer to
+ * chase to a separately allocated state, and new groups don't call the allocator (except when the array grows).
+ *
+ * Large inputs can be aggregated on several cores with hash_aggregate_add_parallel(): each thread aggregates a slice of
+ * the input into its own partial aggregate, without any locking, and the partials are merged at the end. Merging costs
+ * O(groups) per thread, so this pays off when there are many more rows than groups. Partial aggregates can also be
+ * built and merged by hand with hash_aggregate_merge().
+ *
+ * Keys aren't copied, so they must stay valid while they're in the aggregate.
+ *
+ * **Example**
+ * ```c
+ * hash_aggregate agg;
+ * hash_aggregate_init(&agg, 100, NULL, NULL); // String keys
+ *
+ * hash_aggregate_add(&agg, "foo", 1);
+ * hash_aggregate_add(&agg, "foo", 5);
+ * hash_aggregate_add(&agg, "bar", 2);
+ *
+ * const hash_aggregate_state* foo = hash_aggregate_get(&agg, "foo");
+ * assert(foo->count == 2 && foo->sum == 6 && foo->min == 1 && foo->max == 5);
+ *
+ * hash_aggregate_destroy(&agg);
+ * ```
+ */
+typedef struct hash_aggregate {
+    /**
+     * Group slots
+     */
+    hash_aggregate_group* groups;
+
+    /**
+     * Number of slots (always a power of 2)
+     */
+    size_t capacity;
+
+    /**
+     * Number of groups
+     */
+    size_t group_count;
+
+    /**
+     * Key comparator function
+     * Default: String comparator
+     */
+    value_cmp_func key_cmp;
+
+    /**
+     * Key hash function (called with ht_size set to SIZE_MAX)
+     * Default: String hash function
+     */
+    hash_table_key_hash_func key_hash;
+} hash_aggregate;
+
+/**
+ * Initialize the hash aggregate
+ *
+ * Time complexity: O(n)
+ *
+ * @relates hash_aggregate
+ * @param[out] agg Hash aggregate
+ * @param[in] size Number of groups to reserve space for (grows automatically)
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool hash_aggregate_init(
+    hash_aggregate* agg,
+    uint32_t size,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash
+);
+
+/**
+ * Add a value to its group's aggregate (starting a new group if the key hasn't been seen)
+ *
+ * Time complexity: O(1) amortized
+ *
+ * @relates hash_aggregate
+ * @param[in,out] agg Hash aggregate
+ * @param[in] key Group key
+ * @param[in] value Value to add
+ * @return true on success, false on failure
+ */
+bool hash_aggregate_add(hash_aggregate* agg, void* key, int64_t value);
+
+/**
+ * Add a batch of values to their groups' aggregates, using multiple threads
+ *
+ * This has the same result as calling hash_aggregate_add() on each value. Each thread aggregates a slice of the input
+ * into a partial aggregate of its own, and the partials are then merged into agg (on the calling thread).
+ *
+ * The key_hash and key_cmp functions are called from several threads at once, so they must be thread safe (the
+ * defaults are).
+ *
+ * Time complexity: O(n / threads + groups * threads)
+ *
+ * @relates hash_aggregate
+ * @param[in,out] agg Hash aggregate
+ * @param[in] keys Group keys
+ * @param[in] values Values (values[i] is added to the group of keys[i])
+ * @param[in] n Number of values
+ * @param[in] threads Number of threads to use, including the calling thread (or 0 for one per online CPU, see
+ *   parallel_threads())
+ * @return true on success, false on failure (agg may have some of the values added)
+ */
+bool hash_aggregate_add_parallel(
+    hash_aggregate* agg,
+    void* const* keys,
+    const int64_t* values,
+    size_t n,
+    size_t threads
+);
+
+/**
+ * Merge another aggregate's groups into this one
+ *
+ * Both aggregates must use the same key comparator and hash function.
+ *
+ * Time complexity: O(m), where m is the number of groups in src
+ *
+ * @relates hash_aggregate
+ * @param[in,out] dst Hash aggregate to merge into
+ * @param[in] src Hash aggregate to merge from (unchanged)
+ * @return true on success, false on failure (dst may have some of the groups merged)
+ */
+bool hash_aggregate_merge(hash_aggregate* dst, const hash_aggregate* src);
+
+/**
+ * Get a group's aggregate state
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_aggregate
+ * @param[in] agg Hash aggregate
+ * @param[in] key Group key
+ * @return Aggregate state (valid until the aggregate is changed), or NULL if no values were added for the key
+ */
+const hash_aggregate_state* hash_aggregate_get(const hash_aggregate* agg, const void* key);
+
+/**
+ * Iterate over every group in the hash aggregate (in no particular order)
+ *
+ * Time complexity: O(n)
+ *
+ * @relates hash_aggregate
+ * @param[in] agg Hash aggregate
+ * @param[in] iter_func Function to call with each group
+ * @param user_arg Optional argument to pass to the iterator function
+ * @return true on success, false on failure
+ */
+bool hash_aggregate_iter(const hash_aggregate* agg, hash_aggregate_iter_func iter_func, void* user_arg);
+
+/**
+ * Get the number of groups in the hash aggregate
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_aggregate
+ * @param[in] agg Hash aggregate
+ * @return Number of groups
+ */
+size_t hash_aggregate_size(const hash_aggregate* agg);
+
+/**
+ * Destroy the hash aggregate
+ *
+ * Time complexity: O(n)
+ *
+ * @relates hash_aggregate
+ * @param[in,out] agg Hash aggregate
+ * @return true on success, false on failure
+ */
+bool hash_aggregate_destroy(hash_aggregate* agg);
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../utils/log.h"
+
+/**
+ * Smallest number of slots in a generated hash map
+ */
+#define HASH_MAP_MIN_CAPACITY 8
+
+/**
+ * Hash a 64-bit integer key for a generated hash map (murmur3 fmix64 finalizer)
+ *
+ * @param[in] key Key
+ * @return Hash value
+ */
+static inline uint64_t hash_map_hash_u64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * Hash a 32-bit integer key for a generated hash map
+ *
+ * @param[in] key Key
+ * @return Hash value
+ */
+static inline uint64_t hash_map_hash_u32(const uint32_t key) {
+    return hash_map_hash_u64(key);
+}
+
+/**
+ * Compare 64-bit integer keys for a generated hash map
+ *
+ * @param[in] a First key
+ * @param[in] b Second key
+ * @return true if equal
+ */
+static inline bool hash_map_eq_u64(const uint64_t a, const uint64_t b) {
+    return a == b;
+}
+
+/**
+ * Compare 32-bit integer keys for a generated hash map
+ *
+ * @param[in] a First key
+ * @param[in] b Second key
+ * @return true if equal
+ */
+static inline bool hash_map_eq_u32(const uint32_t a, const uint32_t b) {
+    return a == b;
+}
+
+/**
+ * Declare a hash map type specialized for a key and value type
+ *
+ * Unlike hash_table, keys and values are stored by value in flat arrays (no void* boxing or per-entry allocations),
+ * and the hash and equality functions are called directly, so the compiler can inline them instead of going through
+ * function pointers. The map uses linear probing over a power of 2 number of slots, grows automatically to stay at most
+ * 3/4 full, and deletes by shifting later entries back (so there are no tombstones).
+ *
+ * This is a macro instead of a set of functions so that it supports generic types in a way that doesn't require
+ * void* pointers. All generated functions are static inline, so this can be used from a header.
+ *
+ * The hash function is called as hash_fn(key) and must return a well mixed uint64_t (low bits pick the slot), and the
+ * equality function is called as eq_fn(a, b) and must return true when keys are equal. hash_map_hash_u64(),
+ * hash_map_hash_u32(), hash_map_eq_u64() and hash_map_eq_u32() can be used for integer keys.
+ *
+ * Generated API (for a map named `name`):
+ * - `bool name_init(name* map, size_t size)`: initialize with room for size entries
+ * - `bool name_set(name* map, key_t key, val_t value)`: insert or update
+ * - `val_t* name_get(const name* map, key_t key)`: pointer to the stored value (valid until the next insert or
+ *   delete), or NULL if not found
+ * - `bool name_del(name* map, key_t key)`: delete, returns false if not found
+ * - `bool name_next(const name* map, size_t* pos, key_t* key, val_t* value)`: iterate (start with *pos = 0)
+ * - `size_t name_size(const name* map)`: number of entries
+ * - `void name_destroy(name* map)`: free the map's arrays
+ *
+ * **Example**
+ * ```c
+ * LUPRA_HASHMAP_DECLARE(counter_map, uint64_t, uint32_t, hash_map_hash_u64, hash_map_eq_u64)
+ *
+ * counter_map map;
+ * counter_map_init(&map, 100);
+ *
+ * counter_map_set(&map, 42, 1);
+ * ++*counter_map_get(&map, 42);
+ * assert(*counter_map_get(&map, 42) == 2);
+ *
+ * size_t pos = 0;
+ * uint64_t key;
+ * uint32_t count;
+ * while (counter_map_next(&map, &pos, &key, &count)) {
+ *     printf("%lu: %u\n", key, count);
+ * }
+ *
+ * counter_map_destroy(&map);
+ * ```
+ *
+ * @param name Map type name (also used as the function prefix)
+ * @param key_t Key type
+ * @param val_t Value type
+ * @param hash_fn Key hash function or function-like macro
+ * @param eq_fn Key equality function or function-like macro
+ */
+#define LUPRA_HASHMAP_DECLARE(name, key_t, val_t, hash_fn, eq_fn) \
+    typedef struct name { \
+        size_t capacity; \
+        size_t size; \
+        uint8_t* used; \
+        key_t* keys; \
+        val_t* values; \
+    } name; \
+    \
+    static inline bool name##_alloc_slots(name* map, const size_t capacity) { \
+        map->used = calloc(capacity, sizeof(uint8_t)); \
+        map->keys = malloc(capacity * sizeof(key_t)); \
+        map->values = malloc(capacity * sizeof(val_t)); \
+        if (map->used == NULL || map->keys == NULL || map->values == NULL) { \
+            log_perror("hash map allocation failed"); \
+            free(map->used); \
+            free(map->keys); \
+            free(map->values); \
+            map->used = nullptr; \
+            map->keys = nullptr; \
+            map->values = nullptr; \
+            return false; \
+        } \
+        map->capacity = capacity; \
+        return true; \
+    } \
+    \
+    static inline size_t name##_find(const name* map, const key_t key) { \
+        const size_t mask = map->capacity - 1; \
+        for (size_t i = (size_t)hash_fn(key) & mask; map->used[i]; i = (i + 1) & mask) { \
+            if (eq_fn(map->keys[i], key)) { \
+                return i; \
+            } \
+        } \
+        return SIZE_MAX; \
+    } \
+    \
+    static inline void name##_put(name* map, const key_t key, const val_t value) { \
+        const size_t mask = map->capacity - 1; \
+        size_t i = (size_t)hash_fn(key) & mask; \
+        while (map->used[i]) { \
+            i = (i + 1) & mask; \
+        } \
+        map->used[i] = 1; \
+        map->keys[i] = key; \
+        map->values[i] = value; \
+    } \
+    \
+    static inline bool name##_resize(name* map, const size_t capacity) { \
+        name old = *map; \
+        if (!name##_alloc_slots(map, capacity)) { \
+            *map = old; \
+            return false; \
+        } \
+        for (size_t i = 0; i < old.capacity; ++i) { \
+            if (old.used[i]) { \
+                name##_put(map, old.keys[i], old.values[i]); \
+            } \
+        } \
+        free(old.used); \
+        free(old.keys); \
+        free(old.values); \
+        return true; \
+    } \
+    \
+    static inline bool name##_init(name* map, const size_t size) { \
+        memset(map, 0, sizeof(name)); \
+        size_t capacity = HASH_MAP_MIN_CAPACITY; \
+        while (capacity - capacity / 4 < size) { \
+            capacity <<= 1; \
+        } \
+        return name##_alloc_slots(map, capacity); \
+    } \
+    \
+    static inline bool name##_set(name* map, const key_t key, const val_t value) { \
+        const size_t index = name##_find(map, key); \
+        if (index != SIZE_MAX) { \
+            map->values[index] = value; \
+            return true; \
+        } \
+        if (map->size + 1 > map->capacity - map->capacity / 4 && !name##_resize(map, map->capacity * 2)) { \
+            return false; \
+        } \
+        name##_put(map, key, value); \
+        ++map->size; \
+        return true; \
+    } \
+    \
+    static inline val_t* name##_get(const name* map, const key_t key) { \
+        const size_t index = name##_find(map, key); \
+        return index == SIZE_MAX ? NULL : &map->values[index]; \
+    } \
+    \
+    static inline bool name##_del(name* map, const key_t key) { \
+        size_t hole = name##_find(map, key); \
+        if (hole == SIZE_MAX) { \
+            return false; \
+        } \
+        /* Shift back later entries in the probe run that would otherwise become unreachable */ \
+        const size_t mask = map->capacity - 1; \
+        for (size_t i = (hole + 1) & mask; map->used[i]; i = (i + 1) & mask) { \
+            const size_t home = (size_t)hash_fn(map->keys[i]) & mask; \
+            if (((i - home) & mask) >= ((i - hole) & mask)) { \
+                map->keys[hole] = map->keys[i]; \
+                map->values[hole] = map->values[i]; \
+                hole = i; \
+            } \
+        } \
+        map->used[hole] = 0; \
+        --map->size; \
+        return true; \
+    } \
+    \
+    static inline bool name##_next(const name* map, size_t* pos, key_t* key, val_t* value) { \
+        for (; *pos < map->capacity; ++*pos) { \
+            if (map->used[*pos]) { \
+                *key = map->keys[*pos]; \
+                *value = map->values[*pos]; \
+                ++*pos; \
+                return true; \
+            } \
+        } \
+        return false; \
+    } \
+    \
+    static inline size_t name##_size(const name* map) { \
+        return map->size; \
+    } \
+    \
+    static inline void name##_destroy(name* map) { \
+        free(map->used); \
+        free(map->keys); \
+        free(map->values); \
+        memset(map, 0, sizeof(name)); \
+    }
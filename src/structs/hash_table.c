@@ -1,8 +1,12 @@
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 
 #include "hash_table.h"
 #include "../algos/murmur3.h"
 #include "../utils/log.h"
+#include "../utils/parallel.h"
 
 /**
  * Array builder iterator user_arg
@@ -17,31 +21,475 @@ struct hash_table_array_builder_arg {
 };
 
 /**
- * Get a hash table index pointer for the given key
- * Hashes the key then computes its index offset
+ * Key length passed to lookups for keys that are compared with the table's key_cmp function (rather than memcmp())
+ */
+#define KEY_LEN_CMP SIZE_MAX
+
+#ifdef LUPRA_HASH_TABLE_STATS
+/**
+ * Add to one of a hash table's operation counters
+ * Lookups take a const table, and counters are allowed to change under it. Relaxed atomics keep concurrent readers from
+ * racing (they can only lose counts), without the cost of a locked increment.
  *
  * @param[in] ht Hash table
- * @param[in] key Key to compute index for
- * @return Computed index
+ * @param[in] counter Counter field name
+ * @param[in] n Amount to add
  */
-static inline size_t find_index(const hash_table* ht, const void* key) {
-    return (*ht->key_hash)(key, ht->index_size) % (ht->index_size - 1);
-}
+#define COUNT(ht, counter, n) \
+    __atomic_store_n( \
+        &((hash_table *)(ht))->counters.counter, \
+        __atomic_load_n(&(ht)->counters.counter, __ATOMIC_RELAXED) + (n), \
+        __ATOMIC_RELAXED \
+    )
+#else
+#define COUNT(ht, counter, n) ((void)0)
+#endif
 
 /**
- * Default hashing function (murmur3)
+ * Compute the full hash of a key
  *
+ * @param[in] ht Hash table
  * @param[in] key Key to hash
- * @param[in] ht_size Size of hash table index
  * @return Hash value
  */
-static uint32_t default_key_hash(const void* key, size_t ht_size) {
-    static uint32_t hash_seed = -1;
-    if (hash_seed == -1) {
-        hash_seed = rand();
+static inline uint32_t hash_key(const hash_table* ht, const void* key) {
+    return (*ht->key_hash)(key, SIZE_MAX);
+}
+
+/**
+ * Number of distinct scan positions (the mixed hash space)
+ */
+#define SCAN_POSITIONS ((uint64_t)1 << 32)
+
+/**
+ * Remix a key hash before it's mapped to a bucket (murmur3 fmix32 finalizer)
+ *
+ * Buckets are picked from the high bits of the mixed hash, so this keeps weak custom hash functions (like ones that
+ * return small integers) from putting every key in the first bucket. It's a bijection, so keys with different hashes
+ * still have different mixed hashes.
+ *
+ * @param[in] hash Full hash of the key
+ * @return Mixed hash
+ */
+static inline uint32_t mix_hash(uint32_t hash) {
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+/**
+ * Get the bucket that a position in the mixed hash space maps to
+ *
+ * Buckets split the mixed hash space into contiguous ranges (in order), so at any index size, bucket i only holds
+ * entries whose mixed hash is in [bucket_start(i), bucket_start(i + 1)). hash_table_scan() relies on this.
+ *
+ * @param[in] position Mixed hash
+ * @param[in] index_size Size of the index
+ * @return Bucket offset
+ */
+static inline size_t bucket_of(const uint64_t position, const size_t index_size) {
+    return (size_t)((position * index_size) >> 32);
+}
+
+/**
+ * Get the first position in the mixed hash space that maps to a bucket
+ *
+ * @param[in] offset Bucket offset (or index_size for the end of the last bucket)
+ * @param[in] index_size Size of the index
+ * @return Mixed hash position
+ */
+static inline uint64_t bucket_start(const size_t offset, const size_t index_size) {
+    return (((uint64_t)offset << 32) + index_size - 1) / index_size;
+}
+
+/**
+ * Get a hash table index offset for the given key hash
+ *
+ * @param[in] hash Full hash of the key
+ * @param[in] index_size Size of the index to compute the offset in
+ * @return Computed index
+ */
+static inline size_t find_index(const uint32_t hash, const size_t index_size) {
+    return bucket_of(mix_hash(hash), index_size);
+}
+
+/**
+ * Seed shared by the built-in key hash functions (see hash_seed())
+ */
+static uint32_t shared_hash_seed;
+static pthread_once_t shared_hash_seed_once = PTHREAD_ONCE_INIT;
+
+static void init_hash_seed() {
+    shared_hash_seed = rand();
+}
+
+/**
+ * Get the seed shared by the built-in key hash functions
+ * It's picked on first use, once, even if several threads hash their first keys at the same time.
+ *
+ * @return Hash seed
+ */
+static inline uint32_t hash_seed() {
+    pthread_once(&shared_hash_seed_once, init_hash_seed);
+    return shared_hash_seed;
+}
+
+uint32_t hash_table_hash_bytes(const void* key, const size_t key_len) {
+    return murmur3(key, key_len, hash_seed());
+}
+
+uint32_t hash_table_key_hash_string(const void* key, const size_t ht_size) {
+    return hash_table_hash_bytes(key, strlen(key)) % (ht_size - 1);
+}
+
+/**
+ * Check if an entry holds a key
+ *
+ * @param[in] ht Hash table
+ * @param[in] entry Entry to check
+ * @param[in] key Key to find
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @return true if the entry's key matches, false otherwise
+ */
+static inline bool entry_has_key(
+    const hash_table* ht,
+    const hash_table_entry* entry,
+    const void* key,
+    const size_t key_len,
+    const uint32_t hash
+) {
+    // Only compare keys when the full hashes match
+    if (entry->hash != hash) {
+        return false;
+    }
+
+    COUNT(ht, key_cmps, 1);
+
+    if (key_len == KEY_LEN_CMP) {
+        return (*ht->key_cmp)(entry->key, key) == 0;
+    }
+
+    return entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0;
+}
+
+/**
+ * Allocate an empty index
+ *
+ * @param[in] size Number of buckets
+ * @return Index or NULL on failure
+ */
+static linked_list** alloc_index(const size_t size) {
+    linked_list** index = calloc(size, sizeof(linked_list*));
+    if (index == NULL) {
+        log_perror("calloc() failed");
+        return nullptr;
+    }
+
+    return index;
+}
+
+/**
+ * Free an index and its bucket lists (but not the entries in them)
+ *
+ * Time complexity: O(n)
+ *
+ * @param[in,out] ht Hash table
+ * @param[in,out] index Index
+ * @param[in] size Number of buckets
+ */
+static void free_index(hash_table* ht, linked_list** index, const size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        if (index[i] != NULL) {
+            linked_list_destroy(index[i]);
+            mem_pool_free(&ht->list_pool, index[i]);
+        }
+    }
+
+    free(index);
+}
+
+/**
+ * Find an entry in one of the table's indexes
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] ht Hash table
+ * @param[in] index Index to search
+ * @param[in] index_size Size of the index
+ * @param[in] key Key to find
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @return Entry or NULL if not found
+ */
+static hash_table_entry* find_entry(
+    const hash_table* ht,
+    linked_list** index,
+    const size_t index_size,
+    const void* key,
+    const size_t key_len,
+    const uint32_t hash
+) {
+    const linked_list* p_list = index[find_index(hash, index_size)];
+    if (p_list == NULL) {
+        return nullptr;
+    }
+
+    for (const list_node* p_curr = p_list->head; p_curr != NULL; p_curr = p_curr->next) {
+        hash_table_entry* p_entry = p_curr->value;
+        COUNT(ht, probes, 1);
+        if (entry_has_key(ht, p_entry, key, key_len, hash)) {
+            return p_entry;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Append an entry to its bucket in an index (without checking for an existing key)
+ * The entry's hash must already be set
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] ht Hash table
+ * @param[in,out] index Index to add entry to
+ * @param[in] index_size Size of the index
+ * @param[in] entry Entry to add
+ * @return true on success, false on failure
+ */
+static bool push_entry(
+    hash_table* ht,
+    linked_list** index,
+    const size_t index_size,
+    hash_table_entry* entry
+) {
+    const size_t offset = find_index(entry->hash, index_size);
+    if (index[offset] == NULL) {
+        // First entry: Start a new linked list
+        linked_list* p_list = mem_pool_alloc(&ht->list_pool);
+        if (p_list == NULL) {
+            return false;
+        }
+
+        linked_list_init_with_pool(p_list, &ht->node_pool);
+        index[offset] = p_list;
+        COUNT(ht, allocations, 1);
+    }
+
+    COUNT(ht, allocations, 1); // List node
+
+    return linked_list_push_tail(index[offset], entry);
+}
+
+/**
+ * Prefetch everything looking up a group of key hashes in an index will touch
+ *
+ * Each stage prefetches one level of the chain (bucket pointer, list, head node, entry, key) for the whole group before
+ * the next stage loads it, so the cache misses of different keys overlap instead of being paid one after another.
+ *
+ * @param[in] index Index the keys will be looked up in
+ * @param[in] index_size Size of the index
+ * @param[in] hashes Full hashes of the keys
+ * @param[in] n Number of hashes (at most HASH_TABLE_BATCH_GROUP_SIZE)
+ */
+static void prefetch_group(
+    linked_list** index,
+    const size_t index_size,
+    const uint32_t* hashes,
+    const size_t n
+) {
+    const list_node* heads[HASH_TABLE_BATCH_GROUP_SIZE];
+
+    for (size_t i = 0; i < n; ++i) {
+        __builtin_prefetch(&index[find_index(hashes[i], index_size)]);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const linked_list* p_list = index[find_index(hashes[i], index_size)];
+        heads[i] = nullptr;
+        if (p_list != NULL) {
+            __builtin_prefetch(p_list);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const linked_list* p_list = index[find_index(hashes[i], index_size)];
+        if (p_list != NULL && p_list->head != NULL) {
+            heads[i] = p_list->head;
+            __builtin_prefetch(heads[i]);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (heads[i] != NULL) {
+            __builtin_prefetch(heads[i]->value);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (heads[i] != NULL) {
+            const hash_table_entry* p_entry = heads[i]->value;
+            __builtin_prefetch(p_entry->key);
+        }
+    }
+}
+
+/**
+ * Hash a group of keys and prefetch their buckets in every index they could be in
+ *
+ * @param[in] ht Hash table
+ * @param[in] keys Pointers to keys
+ * @param[in] n Number of keys (at most HASH_TABLE_BATCH_GROUP_SIZE)
+ * @param[out] hashes_out Full hashes of the keys
+ */
+static void hash_group(const hash_table* ht, void* const* keys, const size_t n, uint32_t* hashes_out) {
+    for (size_t i = 0; i < n; ++i) {
+        hashes_out[i] = hash_key(ht, keys[i]);
+    }
+
+    prefetch_group(ht->index, ht->index_size, hashes_out, n);
+    if (ht->rehash_index != NULL) {
+        prefetch_group(ht->rehash_index, ht->rehash_index_size, hashes_out, n);
+    }
+}
+
+/**
+ * Start an incremental rehash to a new index size
+ *
+ * Time complexity: O(1) (plus the cost of allocating the new index)
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] new_size New index size
+ * @return true on success, false on failure
+ */
+static bool start_rehash(hash_table* ht, const size_t new_size) {
+    ht->rehash_index = alloc_index(new_size);
+    if (ht->rehash_index == NULL) {
+        return false;
+    }
+
+    ht->rehash_index_size = new_size;
+    ht->rehash_pos = 0;
+
+    COUNT(ht, rehashes, 1);
+    COUNT(ht, allocations, 1);
+
+    return true;
+}
+
+/**
+ * Swap in the new index once every bucket has been migrated
+ *
+ * @param[in,out] ht Hash table
+ */
+static void finish_rehash(hash_table* ht) {
+    free_index(ht, ht->index, ht->index_size);
+
+    ht->index = ht->rehash_index;
+    ht->index_size = ht->rehash_index_size;
+
+    ht->rehash_index = nullptr;
+    ht->rehash_index_size = 0;
+    ht->rehash_pos = 0;
+}
+
+/**
+ * Migrate all entries in a bucket of the old index to the new index
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] offset Bucket offset in the old index
+ * @return true on success, false on failure
+ */
+static bool migrate_bucket(hash_table* ht, const size_t offset) {
+    linked_list* p_list = ht->index[offset];
+
+    for (const list_node* p_curr = p_list->head; p_curr != NULL; p_curr = p_curr->next) {
+        if (!push_entry(ht, ht->rehash_index, ht->rehash_index_size, p_curr->value)) {
+            log_error("hash table is corrupt: push_entry() failed during index rebuild");
+            return false;
+        }
+    }
+
+    linked_list_destroy(p_list);
+    mem_pool_free(&ht->list_pool, p_list);
+    ht->index[offset] = nullptr;
+
+    return true;
+}
+
+bool hash_table_rehash_step(hash_table* ht, const size_t steps) {
+    if (ht->rehash_index == NULL) {
+        return true;
+    }
+
+    size_t empty_visits = steps > SIZE_MAX / HASH_TABLE_REHASH_MAX_EMPTY_VISITS
+        ? SIZE_MAX
+        : steps * HASH_TABLE_REHASH_MAX_EMPTY_VISITS;
+    for (size_t i = 0; i < steps && ht->rehash_pos < ht->index_size; ++i) {
+        // Skip over empty buckets (up to a limit so the step stays cheap)
+        while (ht->index[ht->rehash_pos] == NULL) {
+            if (++ht->rehash_pos == ht->index_size || --empty_visits == 0) {
+                break;
+            }
+        }
+
+        if (ht->rehash_pos == ht->index_size || empty_visits == 0) {
+            break;
+        }
+
+        if (!migrate_bucket(ht, ht->rehash_pos++)) {
+            return false;
+        }
+    }
+
+    if (ht->rehash_pos == ht->index_size) {
+        finish_rehash(ht);
+    }
+
+    return true;
+}
+
+bool hash_table_is_rehashing(const hash_table* ht) {
+    return ht->rehash_index != NULL;
+}
+
+/**
+ * Start growing or shrinking the index if the load factor is outside of its bounds
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] allow_shrink Whether the index can shrink (only after deletes)
+ * @return true on success, false on failure
+ */
+static bool check_load_factor(hash_table* ht, const bool allow_shrink) {
+    if (ht->rehash_index != NULL) {
+        // Already rehashing
+        return true;
+    }
+
+    const double load_factor = (double)ht->entry_size / (double)ht->index_size;
+
+    if (ht->max_load_factor > 0 && load_factor > ht->max_load_factor) {
+        return start_rehash(ht, ht->index_size * 2);
+    }
+
+    if (allow_shrink && ht->min_load_factor > 0 && load_factor < ht->min_load_factor) {
+        size_t new_size = ht->entry_size * 2;
+        if (new_size < ht->min_index_size) {
+            new_size = ht->min_index_size;
+        }
+
+        if (new_size < ht->index_size) {
+            return start_rehash(ht, new_size);
+        }
     }
 
-    return murmur3(key, strlen(key), hash_seed) % (ht_size - 1);
+    return true;
 }
 
 bool hash_table_init(
@@ -49,131 +497,816 @@ bool hash_table_init(
     const uint32_t size,
     const value_cmp_func key_cmp,
     const hash_table_key_hash_func key_hash
+) {
+    return hash_table_init_with_allocator(ht, size, key_cmp, key_hash, NULL);
+}
+
+bool hash_table_init_with_allocator(
+    hash_table* ht,
+    const uint32_t size,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash,
+    const mem_allocator* allocator
 ) {
     memset(ht, 0, sizeof(hash_table));
-    ht->index_size = size;
 
-    size_t index_size = size * sizeof(linked_list);
-    ht->index = malloc(index_size);
+    if (size == 0) {
+        log_error("hash table index size must be greater than 0");
+        return false;
+    }
+
+    if (
+        !mem_pool_init(&ht->entry_pool, sizeof(hash_table_entry), allocator) ||
+        !mem_pool_init(&ht->node_pool, sizeof(list_node), allocator) ||
+        !mem_pool_init(&ht->list_pool, sizeof(linked_list), allocator)
+    ) {
+        return false;
+    }
+
+    ht->index = alloc_index(size);
     if (ht->index == NULL) {
-        log_perror("malloc() failed");
         return false;
     }
 
-    memset(ht->index, 0, index_size);
+    COUNT(ht, allocations, 1);
 
+    ht->index_size = size;
+    ht->min_index_size = size;
     ht->entry_size = 0;
 
     ht->key_cmp = key_cmp == NULL ? value_cmp_string : key_cmp;
-    ht->key_hash = key_hash == NULL ? default_key_hash : key_hash;
+    ht->key_hash = key_hash == NULL ? hash_table_key_hash_string : key_hash;
+
+    ht->max_load_factor = HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR;
+    ht->min_load_factor = HASH_TABLE_DEFAULT_MIN_LOAD_FACTOR;
 
     return true;
 }
 
-bool hash_table_rehash(hash_table* ht, const uint32_t new_size) {
-    linked_list** old_index = ht->index;
-    const size_t old_index_size = ht->index_size;
+bool hash_table_set_load_factors(hash_table* ht, const float min_load_factor, const float max_load_factor) {
+    if (min_load_factor < 0 || max_load_factor < 0) {
+        log_error("load factors can't be negative");
+        return false;
+    }
+
+    if (max_load_factor > 0 && min_load_factor * 2 > max_load_factor) {
+        // Otherwise shrinking could immediately trigger growing (and vice versa)
+        log_error("min load factor must be at most half of the max load factor");
+        return false;
+    }
+
+    ht->min_load_factor = min_load_factor;
+    ht->max_load_factor = max_load_factor;
+
+    return true;
+}
 
-    size_t index_size = new_size * sizeof(linked_list);
-    ht->index = malloc(index_size);
+bool hash_table_rehash(hash_table* ht, const uint32_t new_size) {
     if (ht->index == NULL) {
-        log_perror("malloc() failed");
+        log_error("hash table not initialized");
         return false;
     }
 
-    memset(ht->index, 0, index_size);
-    ht->index_size = new_size;
+    if (new_size == 0) {
+        log_error("hash table index size must be greater than 0");
+        return false;
+    }
 
-    // Rebuild index
-    for (int i = 0; i < old_index_size; ++i) {
-        const linked_list* p_list = old_index[i];
-        if (p_list != NULL) {
-            const list_node* p_iter = p_list->head;
-            if (p_iter != NULL) {
-                do {
-                    hash_table_entry* p_entry = p_iter->value;
-                    if (!hash_table_set_entry(ht, p_entry)) {
-                        log_error("hash table is corrupt: hash_table_set_entry() failed during index rebuild");
-                        return false;
-                    }
-                    p_iter = p_iter->next;
-                }
-                while (p_iter != NULL);
-            }
-        }
+    // Finish any in-progress rehash, then rebuild everything at once
+    if (!hash_table_rehash_step(ht, SIZE_MAX) || !start_rehash(ht, new_size)) {
+        return false;
+    }
+
+    return hash_table_rehash_step(ht, SIZE_MAX);
+}
+
+hash_table_entry* hash_table_init_entry(
+    const void* key, size_t key_size,
+    const void* value, size_t value_size
+) {
+    hash_table_entry* p_entry = malloc(sizeof(hash_table_entry));
+    if (p_entry == NULL) {
+        log_perror("malloc() failed for entry");
+        return nullptr;
     }
 
-    free(old_index);
+    p_entry->key_len = 0;
+    p_entry->must_destroy = 1;
+    p_entry->pooled = 0;
+
+    p_entry->key = malloc(key_size);
+    if (p_entry->key == NULL) {
+        log_perror("malloc() failed for key");
+        free(p_entry);
+        return nullptr;
+    }
+
+    p_entry->value = malloc(value_size);
+    if (p_entry->value == NULL) {
+        log_perror("malloc() failed for value");
+        free(p_entry->key);
+        free(p_entry);
+        return nullptr;
+    }
+
+    memcpy(p_entry->key, key, key_size);
+    memcpy(p_entry->value, value, value_size);
+
+    return p_entry;
+}
+
+bool hash_table_destroy_entry(hash_table_entry* entry) {
+    free(entry->key);
+    entry->key = NULL;
+
+    free(entry->value);
+    entry->value = NULL;
+
+    free((void *)entry);
+
+    return true;
+}
+
+/**
+ * Free an entry owned by the hash table
+ *
+ * @param[in,out] ht Hash table
+ * @param[in,out] entry Entry
+ */
+static void free_entry(hash_table* ht, hash_table_entry* entry) {
+    if (entry->pooled) {
+        mem_pool_free(&ht->entry_pool, entry);
+        return;
+    }
+
+    if (entry->must_destroy) {
+        hash_table_destroy_entry(entry);
+        return;
+    }
+
+    free((void *)entry);
+}
+
+/**
+ * Find an entry in either index
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] ht Hash table
+ * @param[in] key Key to find
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @return Entry or NULL if not found
+ */
+static hash_table_entry* lookup_entry(
+    const hash_table* ht,
+    const void* key,
+    const size_t key_len,
+    const uint32_t hash
+) {
+    hash_table_entry* p_entry = find_entry(ht, ht->index, ht->index_size, key, key_len, hash);
+    if (p_entry == NULL && ht->rehash_index != NULL) {
+        p_entry = find_entry(ht, ht->rehash_index, ht->rehash_index_size, key, key_len, hash);
+    }
+
+    COUNT(ht, lookups, 1);
+    if (p_entry != NULL) {
+        COUNT(ht, hits, 1);
+    }
+    else {
+        COUNT(ht, misses, 1);
+    }
+
+    return p_entry;
+}
+
+/**
+ * Insert an entry whose key isn't in the table yet
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] entry Entry to insert
+ * @return true on success, false on failure
+ */
+static bool insert_entry(hash_table* ht, hash_table_entry* entry) {
+    // New entries go straight into the new index while rehashing
+    const bool inserted = ht->rehash_index != NULL
+        ? push_entry(ht, ht->rehash_index, ht->rehash_index_size, entry)
+        : push_entry(ht, ht->index, ht->index_size, entry);
+
+    if (!inserted) {
+        return false;
+    }
+
+    ++ht->entry_size;
+    if (!entry->pooled) {
+        ++ht->external_entry_size;
+    }
+
+    // The entry is in the table either way, so failing to grow the index only leaves the load factor higher
+    if (!check_load_factor(ht, false)) {
+        log_error("failed to grow hash table index");
+    }
+
+    return true;
+}
+
+/**
+ * Find the entry for a key, or insert a new one (with a NULL value) if it's not in the table
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] key Pointer to key
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @param[out] inserted Set if a new entry was inserted
+ * @return Entry, or NULL on failure
+ */
+static hash_table_entry* upsert_entry(
+    hash_table* ht,
+    void* key,
+    const size_t key_len,
+    const uint32_t hash,
+    bool* inserted
+) {
+    *inserted = false;
+
+    hash_table_entry *p_entry = lookup_entry(ht, key, key_len, hash);
+    if (p_entry != NULL) {
+        return p_entry;
+    }
+
+    // Only inserts advance a rehash, so updates cost the same as lookups (migrating can't make the key appear)
+    if (!hash_table_rehash_step(ht, 1)) {
+        return nullptr;
+    }
+
+    // Create a new entry
+    p_entry = mem_pool_alloc(&ht->entry_pool);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
+
+    COUNT(ht, allocations, 1);
+
+    memset(p_entry, 0, sizeof(hash_table_entry));
+    p_entry->key = key;
+    p_entry->key_len = key_len == KEY_LEN_CMP ? 0 : key_len;
+    p_entry->hash = hash;
+    p_entry->pooled = 1;
+
+    if (!insert_entry(ht, p_entry)) {
+        mem_pool_free(&ht->entry_pool, p_entry);
+        return nullptr;
+    }
+
+    *inserted = true;
+
+    return p_entry;
+}
+
+/**
+ * Set a value in the hash table
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] key Pointer to key
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+static bool set_value(hash_table* ht, void* key, const size_t key_len, const uint32_t hash, void* value) {
+    bool inserted;
+    hash_table_entry* p_entry = upsert_entry(ht, key, key_len, hash, &inserted);
+    if (p_entry == NULL) {
+        return false;
+    }
+
+    p_entry->value = value;
+
+    return true;
+}
+
+bool hash_table_set(hash_table* ht, void* key, void* value) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
+    }
+
+    return set_value(ht, key, KEY_LEN_CMP, hash_key(ht, key), value);
+}
+
+bool hash_table_set_many(hash_table* ht, void* const* keys, void* const* values, const size_t n) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
+    }
+
+    uint32_t hashes[HASH_TABLE_BATCH_GROUP_SIZE];
+    for (size_t start = 0; start < n; start += HASH_TABLE_BATCH_GROUP_SIZE) {
+        const size_t count = n - start < HASH_TABLE_BATCH_GROUP_SIZE ? n - start : HASH_TABLE_BATCH_GROUP_SIZE;
+
+        // Inserts can start (or advance) a rehash, which only makes the prefetches less useful, not wrong
+        hash_group(ht, keys + start, count, hashes);
+
+        for (size_t i = 0; i < count; ++i) {
+            if (!set_value(ht, keys[start + i], KEY_LEN_CMP, hashes[i], values[start + i])) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static_assert(
+    sizeof(hash_table_entry) % sizeof(void*) == 0 && sizeof(list_node) % sizeof(void*) == 0 &&
+    sizeof(linked_list) % sizeof(void*) == 0,
+    "bulk loaded blocks are indexed as arrays, so pool objects can't be padded"
+);
+
+/**
+ * Placeholder for buckets that a bulk load will start a list in, once it knows how many lists to allocate
+ */
+static linked_list bulk_load_pending_list;
+
+/**
+ * Bulk load state, shared by all threads
+ */
+struct hash_table_bulk_load {
+    hash_table* ht;
+    void* const* keys;
+    void* const* values;
+    size_t n;
+
+    size_t threads;
+    size_t partitions;
+
+    /**
+     * Full hashes of the keys
+     */
+    uint32_t* hashes;
+
+    /**
+     * Number of keys in each partition from each thread's slice of the input (threads x partitions), which then become
+     * the offsets in entries that each thread writes each partition's keys to
+     */
+    size_t* offsets;
+
+    /**
+     * Offset of each partition in entries and nodes (partitions + 1)
+     */
+    size_t* partition_starts;
+
+    /**
+     * Entries (grouped by partition, in input order within each) and their list nodes (nodes[i] holds entries[i])
+     */
+    hash_table_entry* entries;
+    list_node* nodes;
+
+    /**
+     * Number of lists each partition starts, which then become each partition's offset in lists (partitions + 1)
+     */
+    size_t* list_starts;
+    linked_list* lists;
+
+    /**
+     * Number of duplicate keys in each partition (their entries are left unused)
+     */
+    size_t* duplicates;
+
+    /**
+     * Next partition for a thread to claim
+     */
+    size_t next_partition;
+};
+
+/**
+ * Run a bulk load phase on every thread, and wait for all of them to finish
+ *
+ * @param[in,out] load Bulk load state
+ * @param[in] phase Phase function
+ */
+static void run_bulk_load_phase(struct hash_table_bulk_load* load, const parallel_func phase) {
+    load->next_partition = 0;
+    parallel_run(load->threads, phase, load);
+}
+
+/**
+ * Get the partition that a key hash belongs to
+ *
+ * Partitions are the high bits of the bucket number (which is itself the high bits of the mixed hash), so each
+ * partition is a contiguous range of buckets, and no bucket is split between two partitions.
+ *
+ * @param[in] load Bulk load state
+ * @param[in] hash Full hash of the key
+ * @return Partition
+ */
+static inline size_t bulk_load_partition(const struct hash_table_bulk_load* load, const uint32_t hash) {
+    const size_t index_size = load->ht->index_size;
+    return find_index(hash, index_size) * load->partitions / index_size;
+}
+
+/**
+ * Claim the next partition that no thread has worked on in this phase
+ *
+ * @param[in,out] load Bulk load state
+ * @param[out] partition Claimed partition
+ * @return true if a partition was claimed, false if there are none left
+ */
+static inline bool claim_bulk_load_partition(struct hash_table_bulk_load* load, size_t* partition) {
+    *partition = __atomic_fetch_add(&load->next_partition, 1, __ATOMIC_RELAXED);
+    return *partition < load->partitions;
+}
+
+/**
+ * Get a thread's slice of the input
+ *
+ * @param[in] load Bulk load state
+ * @param[in] thread Thread number
+ * @param[out] start First key in the slice
+ * @param[out] end End of the slice (exclusive)
+ */
+static inline void bulk_load_slice(
+    const struct hash_table_bulk_load* load,
+    const size_t thread,
+    size_t* start,
+    size_t* end
+) {
+    *start = load->n * thread / load->threads;
+    *end = load->n * (thread + 1) / load->threads;
+}
+
+/**
+ * Phase 1: Hash a slice of the keys, and count how many go to each partition
+ * {@see parallel_func}
+ */
+static void bulk_load_hash_phase(void* arg, const size_t thread) {
+    struct hash_table_bulk_load* load = arg;
+    size_t* p_counts = load->offsets + thread * load->partitions;
+    size_t start, end;
+    bulk_load_slice(load, thread, &start, &end);
+
+    for (size_t i = start; i < end; ++i) {
+        const uint32_t hash = hash_key(load->ht, load->keys[i]);
+        load->hashes[i] = hash;
+        ++p_counts[bulk_load_partition(load, hash)];
+    }
+}
+
+/**
+ * Phase 2: Write an entry for each key in a slice, grouped by partition
+ * Slices are written in order, so each partition's entries keep their input order.
+ * {@see parallel_func}
+ */
+static void bulk_load_scatter_phase(void* arg, const size_t thread) {
+    struct hash_table_bulk_load* load = arg;
+    size_t* p_offsets = load->offsets + thread * load->partitions;
+    size_t start, end;
+    bulk_load_slice(load, thread, &start, &end);
+
+    for (size_t i = start; i < end; ++i) {
+        const uint32_t hash = load->hashes[i];
+        hash_table_entry* p_entry = &load->entries[p_offsets[bulk_load_partition(load, hash)]++];
+
+        p_entry->key = load->keys[i];
+        p_entry->value = load->values[i];
+        p_entry->key_len = 0;
+        p_entry->hash = hash;
+        p_entry->must_destroy = 0;
+        p_entry->pooled = 1;
+    }
+}
+
+/**
+ * Phase 3: Mark the buckets that each partition needs to start a list in, and count them
+ * {@see parallel_func}
+ */
+static void bulk_load_count_phase(void* arg, const size_t _thread) {
+    struct hash_table_bulk_load* load = arg;
+    linked_list** index = load->ht->index;
+    const size_t index_size = load->ht->index_size;
+
+    size_t partition;
+    while (claim_bulk_load_partition(load, &partition)) {
+        size_t lists = 0;
+
+        for (size_t i = load->partition_starts[partition]; i < load->partition_starts[partition + 1]; ++i) {
+            const size_t offset = find_index(load->entries[i].hash, index_size);
+            if (index[offset] == NULL) {
+                index[offset] = &bulk_load_pending_list;
+                ++lists;
+            }
+        }
+
+        load->list_starts[partition] = lists;
+    }
+}
+
+/**
+ * Phase 4: Link each partition's entries into its buckets
+ * Entries with duplicate keys replace the value of the first entry with that key, and are left unused.
+ * {@see parallel_func}
+ */
+static void bulk_load_link_phase(void* arg, const size_t _thread) {
+    struct hash_table_bulk_load* load = arg;
+    hash_table* ht = load->ht;
+
+    size_t partition;
+    while (claim_bulk_load_partition(load, &partition)) {
+        linked_list* p_next_list = load->lists + load->list_starts[partition];
+        size_t duplicates = 0;
+
+        for (size_t i = load->partition_starts[partition]; i < load->partition_starts[partition + 1]; ++i) {
+            hash_table_entry* p_entry = &load->entries[i];
+            const size_t offset = find_index(p_entry->hash, ht->index_size);
+
+            if (ht->index[offset] == &bulk_load_pending_list) {
+                linked_list_init_with_pool(p_next_list, &ht->node_pool);
+                ht->index[offset] = p_next_list++;
+            }
+            else {
+                hash_table_entry* p_existing = find_entry(
+                    ht, ht->index, ht->index_size, p_entry->key, KEY_LEN_CMP, p_entry->hash
+                );
+                if (p_existing != NULL) {
+                    p_existing->value = p_entry->value;
+                    p_entry->pooled = 0; // Marks it as unused
+                    ++duplicates;
+                    continue;
+                }
+            }
+
+            load->nodes[i].value = p_entry;
+            linked_list_link_tail(ht->index[offset], &load->nodes[i]);
+        }
+
+        load->duplicates[partition] = duplicates;
+    }
+}
+
+/**
+ * Replace the index of an empty table with a new one that's big enough for a bulk load
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] n Number of entries that will be loaded
+ * @return true on success, false on failure
+ */
+static bool reset_bulk_load_index(hash_table* ht, const size_t n) {
+    size_t new_size = ht->index_size;
+    if (ht->max_load_factor > 0) {
+        const double needed = ceil((double)n / ht->max_load_factor);
+        if (needed > (double)new_size) {
+            new_size = needed >= UINT32_MAX ? UINT32_MAX : (size_t)needed;
+        }
+    }
+
+    linked_list** index = alloc_index(new_size);
+    if (index == NULL) {
+        return false;
+    }
+
+    COUNT(ht, allocations, 1);
+
+    // The table is empty, but its indexes can still hold empty lists
+    free_index(ht, ht->index, ht->index_size);
+    if (ht->rehash_index != NULL) {
+        free_index(ht, ht->rehash_index, ht->rehash_index_size);
+    }
+
+    ht->index = index;
+    ht->index_size = new_size;
+    ht->rehash_index = nullptr;
+    ht->rehash_index_size = 0;
+    ht->rehash_pos = 0;
+
+    return true;
+}
+
+/**
+ * Free a bulk load's scratch buffers
+ *
+ * @param[in,out] load Bulk load state
+ */
+static void free_bulk_load(struct hash_table_bulk_load* load) {
+    free(load->hashes);
+    free(load->offsets);
+    free(load->partition_starts);
+    free(load->list_starts);
+    free(load->duplicates);
+}
+
+/**
+ * Undo a failed bulk load, leaving the table empty
+ * The entry and node blocks are returned to their pools, so they can still be used by later inserts.
+ *
+ * @param[in,out] load Bulk load state
+ */
+static void abort_bulk_load(struct hash_table_bulk_load* load) {
+    hash_table* ht = load->ht;
+    memset(ht->index, 0, ht->index_size * sizeof(linked_list*));
+
+    for (size_t i = 0; i < load->n; ++i) {
+        mem_pool_free(&ht->entry_pool, &load->entries[i]);
+        mem_pool_free(&ht->node_pool, &load->nodes[i]);
+    }
+
+    free_bulk_load(load);
+}
+
+bool hash_table_bulk_load(
+    hash_table* ht,
+    void* const* keys,
+    void* const* values,
+    const size_t n,
+    size_t threads
+) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
+    }
+
+    if (n == 0) {
+        return true;
+    }
+
+    if (ht->entry_size > 0) {
+        // Partitions can only be built independently when they start out empty
+        return hash_table_set_many(ht, keys, values, n);
+    }
+
+    if (!reset_bulk_load_index(ht, n)) {
+        return false;
+    }
+
+    threads = parallel_threads(threads);
+
+    size_t partitions = (n + HASH_TABLE_BULK_LOAD_PARTITION_SIZE - 1) / HASH_TABLE_BULK_LOAD_PARTITION_SIZE;
+    if (partitions > HASH_TABLE_BULK_LOAD_MAX_PARTITIONS) {
+        partitions = HASH_TABLE_BULK_LOAD_MAX_PARTITIONS;
+    }
+
+    if (threads > partitions) {
+        threads = partitions;
+    }
+
+    struct hash_table_bulk_load load = {
+        .ht = ht,
+        .keys = keys,
+        .values = values,
+        .n = n,
+        .threads = threads,
+        .partitions = partitions,
+        .hashes = malloc(n * sizeof(uint32_t)),
+        .offsets = calloc(threads * partitions, sizeof(size_t)),
+        .partition_starts = malloc((partitions + 1) * sizeof(size_t)),
+        .list_starts = malloc((partitions + 1) * sizeof(size_t)),
+        .duplicates = malloc(partitions * sizeof(size_t)),
+    };
+
+    if (
+        load.hashes == NULL || load.offsets == NULL || load.partition_starts == NULL || load.list_starts == NULL ||
+        load.duplicates == NULL
+    ) {
+        log_perror("bulk load buffer allocation failed");
+        free_bulk_load(&load);
+        return false;
+    }
+
+    load.entries = mem_pool_alloc_many(&ht->entry_pool, n);
+    if (load.entries == NULL) {
+        free_bulk_load(&load);
+        return false;
+    }
+
+    load.nodes = mem_pool_alloc_many(&ht->node_pool, n);
+    if (load.nodes == NULL) {
+        for (size_t i = 0; i < n; ++i) {
+            mem_pool_free(&ht->entry_pool, &load.entries[i]);
+        }
+        free_bulk_load(&load);
+        return false;
+    }
+
+    COUNT(ht, allocations, 2);
+
+    run_bulk_load_phase(&load, bulk_load_hash_phase);
+
+    // Turn each thread's partition counts into the offsets it writes each partition's entries to
+    size_t offset = 0;
+    for (size_t p = 0; p < partitions; ++p) {
+        load.partition_starts[p] = offset;
+        for (size_t t = 0; t < threads; ++t) {
+            const size_t count = load.offsets[t * partitions + p];
+            load.offsets[t * partitions + p] = offset;
+            offset += count;
+        }
+    }
+    load.partition_starts[partitions] = offset;
+
+    run_bulk_load_phase(&load, bulk_load_scatter_phase);
+    run_bulk_load_phase(&load, bulk_load_count_phase);
+
+    // Turn each partition's list count into its offset in the list block
+    size_t list_count = 0;
+    for (size_t p = 0; p < partitions; ++p) {
+        const size_t count = load.list_starts[p];
+        load.list_starts[p] = list_count;
+        list_count += count;
+    }
+    load.list_starts[partitions] = list_count;
+
+    load.lists = mem_pool_alloc_many(&ht->list_pool, list_count);
+    if (load.lists == NULL) {
+        abort_bulk_load(&load);
+        return false;
+    }
+
+    COUNT(ht, allocations, 1);
+
+    run_bulk_load_phase(&load, bulk_load_link_phase);
+
+    // Return the entries and nodes of duplicate keys to their pools
+    size_t duplicates = 0;
+    for (size_t p = 0; p < partitions; ++p) {
+        if (load.duplicates[p] == 0) {
+            continue;
+        }
+
+        for (size_t i = load.partition_starts[p]; i < load.partition_starts[p + 1]; ++i) {
+            if (!load.entries[i].pooled) {
+                mem_pool_free(&ht->entry_pool, &load.entries[i]);
+                mem_pool_free(&ht->node_pool, &load.nodes[i]);
+            }
+        }
+
+        duplicates += load.duplicates[p];
+    }
+
+    ht->entry_size = n - duplicates;
+
+    free_bulk_load(&load);
 
     return true;
 }
 
-hash_table_entry* hash_table_init_entry(
-    const void* key, size_t key_size,
-    const void* value, size_t value_size
-) {
-    hash_table_entry* p_entry = malloc(sizeof(hash_table_entry));
-    if (p_entry == NULL) {
-        log_perror("malloc() failed for entry");
-        return nullptr;
+bool hash_table_set_n(hash_table* ht, void* key, const size_t key_len, void* value) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
     }
 
-    p_entry->must_destroy = 1;
+    if (key_len == KEY_LEN_CMP) {
+        log_error("invalid key length");
+        return false;
+    }
 
-    p_entry->key = malloc(key_size);
-    if (p_entry->key == NULL) {
-        log_perror("malloc() failed for key");
-        free(p_entry);
+    return set_value(ht, key, key_len, hash_table_hash_bytes(key, key_len), value);
+}
+
+void** hash_table_get_or_insert(hash_table* ht, void* key, bool* inserted) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
         return nullptr;
     }
 
-    p_entry->value = malloc(value_size);
-    if (p_entry->value == NULL) {
-        log_perror("malloc() failed for value");
-        free(p_entry->key);
-        free(p_entry);
+    hash_table_entry* p_entry = upsert_entry(ht, key, KEY_LEN_CMP, hash_key(ht, key), inserted);
+    if (p_entry == NULL) {
         return nullptr;
     }
 
-    memcpy(p_entry->key, key, key_size);
-    memcpy(p_entry->value, value, value_size);
-
-    return p_entry;
+    return &p_entry->value;
 }
 
-bool hash_table_destroy_entry(hash_table_entry* entry) {
-    free(entry->key);
-    entry->key = NULL;
+void** hash_table_get_or_insert_n(hash_table* ht, void* key, const size_t key_len, bool* inserted) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return nullptr;
+    }
 
-    free(entry->value);
-    entry->value = NULL;
+    if (key_len == KEY_LEN_CMP) {
+        log_error("invalid key length");
+        return nullptr;
+    }
 
-    free((void *)entry);
+    hash_table_entry* p_entry = upsert_entry(ht, key, key_len, hash_table_hash_bytes(key, key_len), inserted);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
 
-    return true;
+    return &p_entry->value;
 }
 
-bool hash_table_set(hash_table* ht, void* key, void* value) {
-    hash_table_entry *p_entry = hash_table_get_entry(ht, key);
-
-    if (p_entry != NULL) {
-        // Update existing entry
-        p_entry->value = value;
-        return true;
+void** hash_table_get_or_insert_with_hash(hash_table* ht, void* key, const uint32_t hash, bool* inserted) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return nullptr;
     }
 
-    // Create a new entry
-    p_entry = malloc(sizeof(hash_table_entry));
+    hash_table_entry* p_entry = upsert_entry(ht, key, KEY_LEN_CMP, hash, inserted);
     if (p_entry == NULL) {
-        log_perror("malloc() failed");
-        return false;
+        return nullptr;
     }
 
-    memset(p_entry, 0, sizeof(hash_table_entry));
-    p_entry->key = key;
-    p_entry->value = value;
-
-    return hash_table_set_entry(ht, p_entry);
+    return &p_entry->value;
 }
 
 bool hash_table_set_entry(hash_table* ht, hash_table_entry* entry) {
@@ -182,36 +1315,24 @@ bool hash_table_set_entry(hash_table* ht, hash_table_entry* entry) {
         return false;
     }
 
-    const size_t index = find_index(ht, entry->key);
-    linked_list* p_list = *(ht->index + index);
-    if (p_list == NULL) {
-        // First entry: Start a new linked list
-        p_list = *(ht->index + index) = malloc(sizeof(linked_list));
-        if (!linked_list_init(p_list)) {
-            free(p_list);
-            return false;
-        }
+    if (!hash_table_rehash_step(ht, 1)) {
+        return false;
     }
-    else {
-        list_node* p_curr = p_list->head;
-        do {
-            hash_table_entry* p_curr_ent = p_curr->value;
-            if ((*ht->key_cmp)(p_curr_ent->key, entry->key) == 0) {
-                // Update existing value
-                p_curr_ent->value = entry->value;
-                free(entry);
-                return true;
-            }
 
-            p_curr = p_curr->next;
-        }
-        while (p_curr != NULL);
-    }
+    // Caller-built entries are always malloc()ed, and compared with key_cmp
+    entry->hash = hash_key(ht, entry->key);
+    entry->key_len = 0;
+    entry->pooled = 0;
 
-    ++ht->entry_size;
+    hash_table_entry* p_existing = lookup_entry(ht, entry->key, KEY_LEN_CMP, entry->hash);
+    if (p_existing != NULL) {
+        // Update existing value
+        p_existing->value = entry->value;
+        free(entry);
+        return true;
+    }
 
-    // Add to list
-    return linked_list_push_tail(*(ht->index + index), entry);
+    return insert_entry(ht, entry);
 }
 
 hash_table_entry* hash_table_get_entry(const hash_table* ht, const void* key) {
@@ -220,26 +1341,39 @@ hash_table_entry* hash_table_get_entry(const hash_table* ht, const void* key) {
         return nullptr;
     }
 
-    const size_t index = find_index(ht, key);
-    const linked_list* p_list = ht->index[index];
-    if (p_list == NULL || p_list->size == 0) {
-        // No entry
-        return nullptr;
+    return lookup_entry(ht, key, KEY_LEN_CMP, hash_key(ht, key));
+}
+
+size_t hash_table_get_many(const hash_table* ht, void* const* keys, const size_t n, void** values_out) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return -1;
     }
 
-    list_node* p_curr = p_list->head;
-    do {
-        hash_table_entry* p_entry = p_curr->value;
-        if ((*ht->key_cmp)(p_entry->key, key) == 0) {
-            return p_entry;
+    size_t found = 0;
+    uint32_t hashes[HASH_TABLE_BATCH_GROUP_SIZE];
+    for (size_t start = 0; start < n; start += HASH_TABLE_BATCH_GROUP_SIZE) {
+        const size_t count = n - start < HASH_TABLE_BATCH_GROUP_SIZE ? n - start : HASH_TABLE_BATCH_GROUP_SIZE;
+
+        hash_group(ht, keys + start, count, hashes);
+
+        for (size_t i = 0; i < count; ++i) {
+            const hash_table_entry* p_entry = lookup_entry(ht, keys[start + i], KEY_LEN_CMP, hashes[i]);
+            values_out[start + i] = p_entry == NULL ? nullptr : p_entry->value;
+            found += p_entry != NULL;
         }
+    }
+
+    return found;
+}
 
-        p_curr = p_curr->next;
+hash_table_entry* hash_table_get_entry_n(const hash_table* ht, const void* key, const size_t key_len) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return nullptr;
     }
-    while (p_curr != NULL);
 
-    // No entry
-    return nullptr;
+    return lookup_entry(ht, key, key_len, hash_table_hash_bytes(key, key_len));
 }
 
 void* hash_table_get(const hash_table* ht, const void* key) {
@@ -251,41 +1385,156 @@ void* hash_table_get(const hash_table* ht, const void* key) {
     return entry->value;
 }
 
-bool hash_table_del(hash_table* ht, const void* key) {
+void* hash_table_get_n(const hash_table* ht, const void* key, const size_t key_len) {
+    hash_table_entry *entry = hash_table_get_entry_n(ht, key, key_len);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    return entry->value;
+}
+
+void* hash_table_get_with_hash(const hash_table* ht, const void* key, const uint32_t hash) {
     if (ht->index == NULL) {
         log_error("hash table not initialized");
-        return false;
+        return nullptr;
+    }
+
+    const hash_table_entry* p_entry = lookup_entry(ht, key, KEY_LEN_CMP, hash);
+    if (p_entry == NULL) {
+        return nullptr;
     }
 
-    size_t index = find_index(ht, key);
-    linked_list* p_list = ht->index[index];
-    if (p_list == NULL || p_list->size == 0) {
-        log_debug("hash table has no entry at index %zu", index);
+    return p_entry->value;
+}
+
+/**
+ * Delete the entry for a key from one of the table's indexes
+ *
+ * @param[in,out] ht Hash table
+ * @param[in,out] index Index to delete from
+ * @param[in] index_size Size of the index
+ * @param[in] key Entry key to delete
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @return true if deleted, false if not found
+ */
+static bool delete_entry(
+    hash_table* ht,
+    linked_list** index,
+    const size_t index_size,
+    const void* key,
+    const size_t key_len,
+    const uint32_t hash
+) {
+    linked_list* p_list = index[find_index(hash, index_size)];
+    if (p_list == NULL) {
         return false;
     }
 
-    int i = 0;
-    size_t deleted_count = 0;
-    list_node* p_curr = p_list->head;
-    while (p_curr != NULL) {
+    size_t i = 0;
+    for (const list_node* p_curr = p_list->head; p_curr != NULL; p_curr = p_curr->next, ++i) {
         hash_table_entry* p_entry = p_curr->value;
-        if ((*ht->key_cmp)(p_entry->key, key) == 0) {
+        COUNT(ht, probes, 1);
+        if (entry_has_key(ht, p_entry, key, key_len, hash)) {
+            // Keys are unique, so there's nothing else to delete in this bucket
             if (!linked_list_del_at(p_list, i)) {
                 log_error("linked_list_del_at() failed during delete");
                 return false;
             }
-            ++deleted_count;
-        }
-        else {
-            ++i;
+
+            if (!p_entry->pooled) {
+                --ht->external_entry_size;
+            }
+
+            free_entry(ht, p_entry);
+            --ht->entry_size;
+
+            return true;
         }
+    }
 
-        p_curr = p_curr->next;
-    };
+    return false;
+}
+
+/**
+ * Delete the entry for a key from the hash table
+ *
+ * @param[in,out] ht Hash table
+ * @param[in] key Entry key to delete
+ * @param[in] key_len Key length in bytes, or KEY_LEN_CMP to compare with key_cmp
+ * @param[in] hash Full hash of the key
+ * @return true on success, false on failure
+ */
+static bool del_value(hash_table* ht, const void* key, const size_t key_len, const uint32_t hash) {
+    if (!hash_table_rehash_step(ht, 1)) {
+        return false;
+    }
+
+    bool deleted = delete_entry(ht, ht->index, ht->index_size, key, key_len, hash);
+    if (!deleted && ht->rehash_index != NULL) {
+        deleted = delete_entry(ht, ht->rehash_index, ht->rehash_index_size, key, key_len, hash);
+    }
+
+    COUNT(ht, lookups, 1);
+    if (deleted) {
+        COUNT(ht, hits, 1);
+    }
+    else {
+        COUNT(ht, misses, 1);
+    }
+
+    if (!deleted) {
+        log_debug("hash table has no entry for key");
+        return false;
+    }
+
+    return check_load_factor(ht, true);
+}
+
+bool hash_table_del(hash_table* ht, const void* key) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
+    }
 
-    ht->entry_size -= deleted_count;
+    return del_value(ht, key, KEY_LEN_CMP, hash_key(ht, key));
+}
+
+bool hash_table_del_n(hash_table* ht, const void* key, const size_t key_len) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
+    }
+
+    return del_value(ht, key, key_len, hash_table_hash_bytes(key, key_len));
+}
 
-    return deleted_count > 0;
+/**
+ * Call an iterator function on every entry in an index
+ *
+ * @param[in] index Index
+ * @param[in] index_size Size of the index
+ * @param[in] iter_func Iterator callback function
+ * @param iter_func_user_arg Optional argument to pass to callback function
+ */
+static void iter_index(
+    linked_list** index,
+    const size_t index_size,
+    const hash_table_iter_func iter_func,
+    void* iter_func_user_arg
+) {
+    for (size_t i = 0; i < index_size; ++i) {
+        const linked_list* p_list = index[i];
+        if (p_list != NULL) {
+            const list_node* p_iter = p_list->head;
+            while (p_iter != NULL) {
+                hash_table_entry* p_entry = p_iter->value;
+                p_iter = p_iter->next;
+                iter_func(p_entry, i, iter_func_user_arg);
+            }
+        }
+    }
 }
 
 bool hash_table_iter(
@@ -303,22 +1552,156 @@ bool hash_table_iter(
         return true;
     }
 
-    for (int i = 0; i < ht->index_size; ++i) {
-        const linked_list* p_list = ht->index[i];
-        if (p_list != NULL) {
-            const list_node* p_iter = p_list->head;
-            if (p_iter != NULL) {
-                do {
-                    hash_table_entry* p_entry = p_iter->value;
-                    p_iter = p_iter->next;
-                    iter_func(p_entry, i, iter_func_user_arg);
-                }
-                while (p_iter != NULL);
+    iter_index(ht->index, ht->index_size, iter_func, iter_func_user_arg);
+    if (ht->rehash_index != NULL) {
+        iter_index(ht->rehash_index, ht->rehash_index_size, iter_func, iter_func_user_arg);
+    }
+
+    return true;
+}
+
+/**
+ * Count (or collect) the entries of a bucket whose mixed hashes are in a range
+ *
+ * @param[in] list Bucket list (or NULL)
+ * @param[in] start First mixed hash in the range
+ * @param[in] end End of the range (exclusive)
+ * @param[out] out Entries in the range (or NULL to only count them)
+ * @return Number of entries in the range
+ */
+static size_t collect_range(const linked_list* list, const uint64_t start, const uint64_t end, hash_table_entry** out) {
+    size_t count = 0;
+    if (list == NULL) {
+        return 0;
+    }
+
+    for (const list_node* p_curr = list->head; p_curr != NULL; p_curr = p_curr->next) {
+        hash_table_entry* p_entry = p_curr->value;
+        const uint32_t position = mix_hash(p_entry->hash);
+        if (position >= start && position < end) {
+            if (out != NULL) {
+                out[count] = p_entry;
             }
+            ++count;
         }
     }
 
-    return true;
+    return count;
+}
+
+/**
+ * Find the smallest mixed hash in a range among the entries of up to two buckets
+ *
+ * @param[in] lists Bucket lists (each can be NULL)
+ * @param[in] start First mixed hash in the range
+ * @param[in] end End of the range (exclusive)
+ * @return Smallest mixed hash, or end if no entries are in the range
+ */
+static uint64_t min_position(const linked_list* lists[2], const uint64_t start, const uint64_t end) {
+    uint64_t min = end;
+    for (size_t i = 0; i < 2; ++i) {
+        if (lists[i] == NULL) {
+            continue;
+        }
+
+        for (const list_node* p_curr = lists[i]->head; p_curr != NULL; p_curr = p_curr->next) {
+            const uint32_t position = mix_hash(((const hash_table_entry*)p_curr->value)->hash);
+            if (position >= start && position < min) {
+                min = position;
+            }
+        }
+    }
+
+    return min;
+}
+
+size_t hash_table_scan(const hash_table* ht, uint64_t* cursor, const size_t batch, hash_table_entry** out) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return -1;
+    }
+
+    if (batch == 0 || *cursor >= SCAN_POSITIONS) {
+        log_error("invalid scan batch size or cursor");
+        return -1;
+    }
+
+    size_t count = 0;
+    size_t empty_visits = batch > SIZE_MAX / HASH_TABLE_SCAN_MAX_EMPTY_VISITS
+        ? SIZE_MAX
+        : batch * HASH_TABLE_SCAN_MAX_EMPTY_VISITS;
+    uint64_t position = *cursor;
+
+    while (position < SCAN_POSITIONS) {
+        // The range of positions covered by the cursor's bucket in both indexes
+        const size_t offset = bucket_of(position, ht->index_size);
+        uint64_t end = bucket_start(offset + 1, ht->index_size);
+        const linked_list* lists[2] = {ht->index[offset], nullptr};
+
+        if (ht->rehash_index != NULL) {
+            const size_t rehash_offset = bucket_of(position, ht->rehash_index_size);
+            const uint64_t rehash_end = bucket_start(rehash_offset + 1, ht->rehash_index_size);
+            if (rehash_end < end) {
+                end = rehash_end;
+            }
+
+            lists[1] = ht->rehash_index[rehash_offset];
+        }
+
+        const size_t range_count = collect_range(lists[0], position, end, NULL) +
+            collect_range(lists[1], position, end, NULL);
+
+        if (range_count == 0) {
+            position = end;
+            if (--empty_visits == 0) {
+                // Keep each call's cost bounded on sparse tables
+                break;
+            }
+
+            continue;
+        }
+
+        if (count + range_count <= batch) {
+            count += collect_range(lists[0], position, end, out + count);
+            count += collect_range(lists[1], position, end, out + count);
+            position = end;
+            continue;
+        }
+
+        // Not enough room for the whole range: return it in hash order, as far as it fits (entries that share a hash
+        // are always returned together, so the cursor never has to point inside a group of them)
+        while (position < end) {
+            const uint64_t group = min_position(lists, position, end);
+            if (group == end) {
+                position = end;
+                break;
+            }
+
+            const size_t group_count = collect_range(lists[0], group, group + 1, NULL) +
+                collect_range(lists[1], group, group + 1, NULL);
+            if (count + group_count > batch) {
+                position = group;
+                break;
+            }
+
+            count += collect_range(lists[0], group, group + 1, out + count);
+            count += collect_range(lists[1], group, group + 1, out + count);
+            position = group + 1;
+        }
+
+        if (position < end) {
+            if (count == 0) {
+                log_error("more than %zu entries share a hash; scan with a larger batch", batch);
+                return -1;
+            }
+
+            break;
+        }
+    }
+
+    *cursor = position >= SCAN_POSITIONS ? 0 : position;
+
+    return count;
 }
 
 /**
@@ -355,6 +1738,58 @@ size_t hash_table_size(const hash_table* ht) {
     return ht->entry_size;
 }
 
+/**
+ * Add the chain lengths of an index to a stats snapshot
+ *
+ * @param[in] index Index
+ * @param[in] index_size Size of the index
+ * @param[in,out] stats Statistics
+ */
+static void add_chain_stats(linked_list** index, const size_t index_size, hash_table_stats_snapshot* stats) {
+    for (size_t i = 0; i < index_size; ++i) {
+        const size_t chain = index[i] == NULL ? 0 : index[i]->size;
+
+        stats->used_buckets += chain > 0;
+        if (chain > stats->max_chain) {
+            stats->max_chain = chain;
+        }
+
+        ++stats->chain_histogram[chain < HASH_TABLE_STATS_HISTOGRAM_SIZE ? chain : HASH_TABLE_STATS_HISTOGRAM_SIZE - 1];
+    }
+}
+
+bool hash_table_stats(const hash_table* ht, hash_table_stats_snapshot* stats_out) {
+    if (ht->index == NULL) {
+        log_error("hash table not initialized");
+        return false;
+    }
+
+    memset(stats_out, 0, sizeof(hash_table_stats_snapshot));
+
+    stats_out->entry_size = ht->entry_size;
+    stats_out->index_size = ht->index_size;
+    stats_out->rehash_index_size = ht->rehash_index_size;
+    stats_out->load_factor = (double)ht->entry_size / (double)ht->index_size;
+
+    add_chain_stats(ht->index, ht->index_size, stats_out);
+    if (ht->rehash_index != NULL) {
+        add_chain_stats(ht->rehash_index, ht->rehash_index_size, stats_out);
+    }
+
+#ifdef LUPRA_HASH_TABLE_STATS
+    stats_out->counters_enabled = true;
+    stats_out->counters = ht->counters;
+#endif
+
+    return true;
+}
+
+void hash_table_reset_counters(hash_table* ht) {
+#ifdef LUPRA_HASH_TABLE_STATS
+    memset(&ht->counters, 0, sizeof(hash_table_counters));
+#endif
+}
+
 /**
  * Iterator callback function that builds an array of values
  *
@@ -386,7 +1821,7 @@ size_t hash_table_values(hash_table* ht, void** values) {
 }
 
 /**
- * Iterator callback function that destroys all entries
+ * Iterator callback function that destroys entries that weren't allocated from the entry pool
  *
  * @param[in] entry Iterated hash table entry
  * @param[in] _index Iteration index (ignored)
@@ -397,12 +1832,14 @@ static void destroy_iter_func(
     const size_t _index,
     void* _user_arg
 ) {
-    if (entry->must_destroy) {
-        hash_table_destroy_entry(entry);
-        return;
-    }
+    if (!entry->pooled) {
+        if (entry->must_destroy) {
+            hash_table_destroy_entry(entry);
+            return;
+        }
 
-    free((void *)entry);
+        free((void *)entry);
+    }
 }
 
 bool hash_table_destroy(hash_table* ht) {
@@ -410,14 +1847,25 @@ bool hash_table_destroy(hash_table* ht) {
         return false;
     }
 
-    if (!hash_table_iter(ht, destroy_iter_func, NULL)) {
+    // Pooled entries, lists and nodes are released in bulk with their pools
+    if (ht->external_entry_size > 0 && !hash_table_iter(ht, destroy_iter_func, NULL)) {
         return false;
     }
 
     free(ht->index);
     ht->index = nullptr;
 
+    if (ht->rehash_index != NULL) {
+        free(ht->rehash_index);
+        ht->rehash_index = nullptr;
+    }
+
+    mem_pool_destroy(&ht->entry_pool);
+    mem_pool_destroy(&ht->node_pool);
+    mem_pool_destroy(&ht->list_pool);
+
     ht->entry_size = 0;
+    ht->external_entry_size = 0;
 
     return true;
 }
@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 #include "linked_list.h"
+#include "../utils/mem_pool.h"
 #include "../utils/value.h"
 
 /**
@@ -12,22 +13,145 @@ typedef struct hash_table_entry {
     void* key;
     void* value;
 
+    /**
+     * Length of the key in bytes for entries added with hash_table_set_n() (0 otherwise)
+     */
+    size_t key_len;
+
+    /**
+     * Full hash of the key (set by the table when the entry is added)
+     * Lookups compare this before calling the key comparator, and resizing reuses it instead of rehashing the key
+     */
+    uint32_t hash;
+
     /**
      * If set to 1, then ht_destroy_entry() will automatically
      * be called on this entry when ht_destroy() was called
      */
     uint8_t must_destroy;
+
+    /**
+     * Set if the entry was allocated from the hash table's entry pool (by hash_table_set())
+     */
+    uint8_t pooled;
 } hash_table_entry;
 
 /**
  * Key hashing function
  *
+ * Tables that need the full (unreduced) hash, like flat_hash_table, pass SIZE_MAX as ht_size.
+ *
  * @param[in] key Key to hash
- * @param[in] ht_size Size of the key
+ * @param[in] ht_size Size of the hash table index
  * @return Hash value
  */
 typedef uint32_t (*hash_table_key_hash_func)(const void* key, size_t ht_size);
 
+/**
+ * Key hashing function for NUL-terminated string keys (murmur3)
+ * This is the default used when no key hash function is given
+ * {@see hash_table_key_hash_func}
+ */
+uint32_t hash_table_key_hash_string(const void* key, size_t ht_size);
+
+/**
+ * Hash a binary key (murmur3, using the same seed as hash_table_key_hash_string())
+ * This is the hash used for keys passed to the *_n functions (like hash_table_set_n())
+ *
+ * @param[in] key Key to hash
+ * @param[in] key_len Key length in bytes
+ * @return Full hash value
+ */
+uint32_t hash_table_hash_bytes(const void* key, size_t key_len);
+
+/**
+ * Default max load factor (see hash_table_set_load_factors())
+ */
+#define HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR 1.0f
+
+/**
+ * Default min load factor (see hash_table_set_load_factors())
+ */
+#define HASH_TABLE_DEFAULT_MIN_LOAD_FACTOR 0.1f
+
+/**
+ * Max number of empty buckets visited per rehash step, so a step's cost stays bounded on sparse tables
+ */
+#define HASH_TABLE_REHASH_MAX_EMPTY_VISITS 10
+
+/**
+ * Number of keys that batch operations (like hash_table_get_many()) prefetch at a time
+ */
+#define HASH_TABLE_BATCH_GROUP_SIZE 16
+
+/**
+ * Max number of empty buckets hash_table_scan() visits per requested entry, so a call's cost stays bounded on sparse
+ * tables
+ */
+#define HASH_TABLE_SCAN_MAX_EMPTY_VISITS 10
+
+/**
+ * Number of entries hash_table_bulk_load() aims to put in each partition, so a partition's buckets and entries mostly
+ * stay in cache while it's built
+ */
+#define HASH_TABLE_BULK_LOAD_PARTITION_SIZE 16384
+
+/**
+ * Max number of partitions hash_table_bulk_load() splits entries into
+ */
+#define HASH_TABLE_BULK_LOAD_MAX_PARTITIONS 4096
+
+/**
+ * Number of chain length histogram buckets in hash_table_stats_snapshot (the last one counts all longer chains)
+ */
+#define HASH_TABLE_STATS_HISTOGRAM_SIZE 16
+
+/**
+ * Hash table operation counters
+ *
+ * These are only collected when the library is built with LUPRA_HASH_TABLE_STATS defined (the CMake option of the same
+ * name). Otherwise they aren't part of hash_table at all, and counting compiles away to nothing.
+ *
+ * Counters are updated with relaxed atomic loads and stores rather than atomic increments, so they don't slow down
+ * lookups, but concurrent readers of a table can lose some counts.
+ */
+typedef struct hash_table_counters {
+    /**
+     * Key lookups (by gets, sets and deletes)
+     */
+    uint64_t lookups;
+
+    /**
+     * Lookups that found their key
+     */
+    uint64_t hits;
+
+    /**
+     * Lookups that didn't find their key
+     */
+    uint64_t misses;
+
+    /**
+     * Bucket entries visited by lookups
+     */
+    uint64_t probes;
+
+    /**
+     * Full key comparisons (key_cmp or memcmp() calls) made by lookups, which only happen when the full hashes match
+     */
+    uint64_t key_cmps;
+
+    /**
+     * Index resizes started
+     */
+    uint64_t rehashes;
+
+    /**
+     * Objects allocated by the table (entries, bucket lists, list nodes and indexes)
+     */
+    uint64_t allocations;
+} hash_table_counters;
+
 /**
  * A closed addressed hash table (also commonly known as hash map, dictionary, or associative array) is a structure for
  * storing values at unique keys. These entries aren't ordered and there can only be one value for a given key.
@@ -35,10 +159,24 @@ typedef uint32_t (*hash_table_key_hash_func)(const void* key, size_t ht_size);
  * Hash tables are useful for lookup tables when you need to quickly find or store something that can be uniquely
  * identified by its key.
  *
+ * The index automatically grows (doubles) when the load factor goes above max_load_factor, and shrinks when deletes
+ * take it below min_load_factor. Resizing is incremental: a second index is allocated and buckets are migrated to it a
+ * few at a time on each set/delete (or via hash_table_rehash_step()), so no single operation pays for moving every
+ * entry. Lookups check both indexes while a rehash is in progress.
+ *
+ * Keys are normally compared and hashed with the key_cmp and key_hash functions (NUL-terminated strings by default).
+ * Binary keys (like packed structs or UUIDs) can instead be passed as a pointer and length to the *_n functions
+ * (hash_table_set_n(), hash_table_get_n(), hash_table_del_n()), which hash the bytes directly and compare keys with a
+ * length check and memcmp(). A table should use one or the other for all of its keys.
+ *
+ * Entries, bucket lists and list nodes are allocated from slab pools (see mem_pool), so inserts rarely call the
+ * allocator, and hash_table_destroy() can free everything a slab at a time. The slab allocator can be customized with
+ * hash_table_init_with_allocator().
+ *
  * **Example**
  * ```c
  * hash_table ht;
- * hash_table_init(&ht, 10, NULL, NULL); // Max 10 items before collisions increase
+ * hash_table_init(&ht, 10, NULL, NULL); // Initial index size of 10 (grows automatically)
  *
  * hash_table_set(&ht, "foo", "one");
  * hash_table_set(&ht, "foo", "two");
@@ -82,8 +220,115 @@ typedef struct hash_table {
      * Default: String hash function
      */
     hash_table_key_hash_func key_hash;
+
+    /**
+     * Index that entries are being migrated to during an incremental rehash
+     * NULL when no rehash is in progress
+     */
+    linked_list** rehash_index;
+
+    /**
+     * Size of rehash_index
+     */
+    size_t rehash_index_size;
+
+    /**
+     * Next bucket of index to migrate to rehash_index
+     */
+    size_t rehash_pos;
+
+    /**
+     * Smallest size the index can automatically shrink to (the size passed to hash_table_init())
+     */
+    size_t min_index_size;
+
+    /**
+     * Load factor (entries per bucket) above which the index automatically grows, or 0 to never grow
+     * Default: HASH_TABLE_DEFAULT_MAX_LOAD_FACTOR
+     */
+    float max_load_factor;
+
+    /**
+     * Load factor (entries per bucket) below which the index automatically shrinks, or 0 to never shrink
+     * Default: HASH_TABLE_DEFAULT_MIN_LOAD_FACTOR
+     */
+    float min_load_factor;
+
+    /**
+     * Pool that entries created by hash_table_set() are allocated from
+     */
+    mem_pool entry_pool;
+
+    /**
+     * Pool that bucket list nodes are allocated from
+     */
+    mem_pool node_pool;
+
+    /**
+     * Pool that bucket lists are allocated from
+     */
+    mem_pool list_pool;
+
+    /**
+     * Number of stored entries that weren't allocated from entry_pool (added with hash_table_set_entry())
+     * When this is 0, hash_table_destroy() can release all entries at once by destroying the pools
+     */
+    size_t external_entry_size;
+
+#ifdef LUPRA_HASH_TABLE_STATS
+    /**
+     * Operation counters
+     */
+    hash_table_counters counters;
+#endif
 } hash_table;
 
+/**
+ * Point in time hash table statistics (see hash_table_stats())
+ */
+typedef struct hash_table_stats_snapshot {
+    /**
+     * Number of stored entries
+     */
+    size_t entry_size;
+
+    /**
+     * Size of the index (and of the index being rehashed to, or 0 if there's no rehash in progress)
+     */
+    size_t index_size;
+    size_t rehash_index_size;
+
+    /**
+     * Entries per bucket (entry_size / index_size)
+     */
+    double load_factor;
+
+    /**
+     * Number of non-empty buckets (in both indexes)
+     */
+    size_t used_buckets;
+
+    /**
+     * Length of the longest bucket chain
+     */
+    size_t max_chain;
+
+    /**
+     * Number of buckets (in both indexes) with each chain length (the last one counts all longer chains too)
+     */
+    size_t chain_histogram[HASH_TABLE_STATS_HISTOGRAM_SIZE];
+
+    /**
+     * Set if the library was built with LUPRA_HASH_TABLE_STATS (otherwise counters are all 0)
+     */
+    bool counters_enabled;
+
+    /**
+     * Operation counters since the table was initialized (or the counters were last reset)
+     */
+    hash_table_counters counters;
+} hash_table_stats_snapshot;
+
 /**
  * Initialize the hash table
  *
@@ -103,9 +348,46 @@ bool hash_table_init(
     hash_table_key_hash_func key_hash
 );
 
+/**
+ * Initialize the hash table with a custom allocator for its slab pools
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[out] ht Hash table
+ * @param[in] size Index size
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @param[in] allocator Allocator for entry, list and node slabs (or NULL to use malloc())
+ * @return true on success, false on failure
+ */
+bool hash_table_init_with_allocator(
+    hash_table* ht,
+    uint32_t size,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash,
+    const mem_allocator* allocator
+);
+
+/**
+ * Set the load factors that trigger automatic growth and shrinking of the index
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] min_load_factor Shrink when entries per bucket drop below this after a delete (0 to never shrink)
+ * @param[in] max_load_factor Grow when entries per bucket go above this after an insert (0 to never grow)
+ * @return true on success, false on failure
+ */
+bool hash_table_set_load_factors(hash_table* ht, float min_load_factor, float max_load_factor);
+
 /**
  * Resize and rebuild the hash table
  *
+ * Unlike automatic resizing, this migrates every entry before returning (finishing any incremental rehash that was
+ * already in progress first).
+ *
  * Time complexity: O(n)
  *
  * @relates hash_table
@@ -115,6 +397,31 @@ bool hash_table_init(
  */
 bool hash_table_rehash(hash_table* ht, uint32_t new_size);
 
+/**
+ * Migrate buckets of an in-progress incremental rehash
+ *
+ * This can be called while idle to finish a rehash sooner. It does nothing if no rehash is in progress.
+ *
+ * Time complexity: O(steps)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] steps Number of buckets to migrate
+ * @return true on success, false on failure
+ */
+bool hash_table_rehash_step(hash_table* ht, size_t steps);
+
+/**
+ * Check if an incremental rehash is in progress
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @return true if rehashing, false otherwise
+ */
+bool hash_table_is_rehashing(const hash_table* ht);
+
 /**
  * Initialize a new hash table entry by creating a copy of key/value
  *
@@ -158,6 +465,125 @@ bool hash_table_destroy_entry(hash_table_entry* entry);
  */
 bool hash_table_set(hash_table* ht, void* key, void* value);
 
+/**
+ * Set a value for a binary key in the hash table
+ *
+ * The key isn't copied, so it must stay valid (and unchanged) while it's in the table.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] key Pointer to key
+ * @param[in] key_len Key length in bytes
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+bool hash_table_set_n(hash_table* ht, void* key, size_t key_len, void* value);
+
+/**
+ * Set values for a batch of keys in the hash table
+ *
+ * This has the same result as calling hash_table_set() on each key in order (so if a key appears more than once, the
+ * last value wins), but keys are hashed and their buckets prefetched HASH_TABLE_BATCH_GROUP_SIZE at a time, so the
+ * cache misses of different keys overlap.
+ *
+ * Time complexity: O(n)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] keys Pointers to keys
+ * @param[in] values Pointers to values (values[i] is set for keys[i])
+ * @param[in] n Number of keys
+ * @return true on success, false on failure (keys before the failed one will have been set)
+ */
+bool hash_table_set_many(hash_table* ht, void* const* keys, void* const* values, size_t n);
+
+/**
+ * Load a batch of keys into an empty hash table, using multiple threads
+ *
+ * This has the same result as hash_table_set_many() (so if a key appears more than once, the last value wins), but
+ * builds the table in parallel:
+ *   1. The index is sized for all n entries up front (per max_load_factor), so there's no rehashing.
+ *   2. Keys are hashed in parallel, and radix partitioned by the high bits of their mixed hash. Since buckets are
+ *      ranges of the mixed hash, each partition owns a separate range of buckets.
+ *   3. Each partition's buckets are built by one thread, without locks.
+ *
+ * Entries, list nodes and bucket lists are each allocated as one block (see mem_pool_alloc_many()), instead of one at a
+ * time. They're still pooled, so they can be deleted or replaced like any other entry afterwards.
+ *
+ * The key_hash and key_cmp functions are called from several threads at once, so they must be thread safe (the
+ * defaults are). If the table isn't empty, this falls back to hash_table_set_many().
+ *
+ * Time complexity: O(n / threads)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] keys Pointers to keys
+ * @param[in] values Pointers to values (values[i] is set for keys[i])
+ * @param[in] n Number of keys
+ * @param[in] threads Number of threads to use, including the calling thread (or 0 for one per online CPU, see
+ *   parallel_threads()). Small batches use fewer threads.
+ * @return true on success, false on failure (an empty table is left empty)
+ */
+bool hash_table_bulk_load(hash_table* ht, void* const* keys, void* const* values, size_t n, size_t threads);
+
+/**
+ * Get the value slot for a key, inserting a new entry if the key isn't in the table
+ *
+ * This finds or inserts the entry with a single lookup, so read-modify-write updates (like counters or aggregates)
+ * don't need a hash_table_get() followed by a hash_table_set(). New entries have a NULL value, for the caller to fill
+ * in through the returned slot.
+ *
+ * **Example**
+ * ```c
+ * bool inserted;
+ * void** slot = hash_table_get_or_insert(&ht, "foo", &inserted);
+ * *slot = (void *)((uintptr_t)*slot + 1); // Count occurrences of "foo"
+ * ```
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] key Pointer to key (stored if it's inserted)
+ * @param[out] inserted Set if the key wasn't in the table
+ * @return Pointer to the entry's value, which stays valid until the entry is deleted (or NULL on failure)
+ */
+void** hash_table_get_or_insert(hash_table* ht, void* key, bool* inserted);
+
+/**
+ * Get the value slot for a binary key, inserting a new entry if the key isn't in the table
+ * {@see hash_table_get_or_insert}
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] key Pointer to key (stored if it's inserted)
+ * @param[in] key_len Key length in bytes
+ * @param[out] inserted Set if the key wasn't in the table
+ * @return Pointer to the entry's value, which stays valid until the entry is deleted (or NULL on failure)
+ */
+void** hash_table_get_or_insert_n(hash_table* ht, void* key, size_t key_len, bool* inserted);
+
+/**
+ * Get the value slot for a key whose hash is already known, inserting a new entry if the key isn't in the table
+ * {@see hash_table_get_or_insert}
+ *
+ * This saves hashing the key again when the caller has already hashed it (e.g. to partition its input).
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] key Pointer to key (stored if it's inserted)
+ * @param[in] hash Full hash of the key, which must be key_hash(key, SIZE_MAX)
+ * @param[out] inserted Set if the key wasn't in the table
+ * @return Pointer to the entry's value, which stays valid until the entry is deleted (or NULL on failure)
+ */
+void** hash_table_get_or_insert_with_hash(hash_table* ht, void* key, uint32_t hash, bool* inserted);
+
 /**
  * Set entry in the hash table
  *
@@ -165,7 +591,7 @@ bool hash_table_set(hash_table* ht, void* key, void* value);
  *
  * @relates hash_table
  * @param[in,out] ht Hash table
- * @param[in] entry Entry to set
+ * @param[in] entry Entry to set, allocated with malloc() (e.g. by hash_table_init_entry()). The table takes ownership.
  * @return true on success, false on failure
  */
 bool hash_table_set_entry(hash_table* ht, hash_table_entry* entry);
@@ -182,6 +608,38 @@ bool hash_table_set_entry(hash_table* ht, hash_table_entry* entry);
  */
 hash_table_entry* hash_table_get_entry(const hash_table* ht, const void* key);
 
+/**
+ * Get values for a batch of keys from the hash table
+ *
+ * This has the same result as calling hash_table_get() on each key, but keys are hashed and their buckets, list nodes
+ * and entries are prefetched HASH_TABLE_BATCH_GROUP_SIZE at a time before any of them are compared. This is much faster
+ * than separate lookups when the table doesn't fit in cache, since each lookup no longer waits for the previous one's
+ * cache misses.
+ *
+ * Time complexity: O(n)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @param[in] keys Pointers to keys
+ * @param[in] n Number of keys
+ * @param[out] values_out Value pointers (values_out[i] is the value for keys[i], or NULL if not found)
+ * @return Number of keys found, or -1 on failure
+ */
+size_t hash_table_get_many(const hash_table* ht, void* const* keys, size_t n, void** values_out);
+
+/**
+ * Get entry for a binary key from the hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @param[in] key Key to get entry for
+ * @param[in] key_len Key length in bytes
+ * @return Entry or NULL if not found
+ */
+hash_table_entry* hash_table_get_entry_n(const hash_table* ht, const void* key, size_t key_len);
+
 /**
  * Get value from the hash table
  *
@@ -194,6 +652,33 @@ hash_table_entry* hash_table_get_entry(const hash_table* ht, const void* key);
  */
 void* hash_table_get(const hash_table* ht, const void* key);
 
+/**
+ * Get value for a binary key from the hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @param[in] key Entry key to get value for
+ * @param[in] key_len Key length in bytes
+ * @return Value pointer
+ */
+void* hash_table_get_n(const hash_table* ht, const void* key, size_t key_len);
+
+/**
+ * Get value for a key whose hash is already known from the hash table
+ * {@see hash_table_get_or_insert_with_hash}
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @param[in] key Entry key to get value for
+ * @param[in] hash Full hash of the key, which must be key_hash(key, SIZE_MAX)
+ * @return Value pointer, or NULL if not found
+ */
+void* hash_table_get_with_hash(const hash_table* ht, const void* key, uint32_t hash);
+
 /**
  * Delete entry from the hash table
  *
@@ -206,6 +691,19 @@ void* hash_table_get(const hash_table* ht, const void* key);
  */
 bool hash_table_del(hash_table* ht, const void* key);
 
+/**
+ * Delete entry for a binary key from the hash table
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ * @param[in] key Entry key to delete
+ * @param[in] key_len Key length in bytes
+ * @return true on success, false on failure
+ */
+bool hash_table_del_n(hash_table* ht, const void* key, size_t key_len);
+
 /**
  * Hash table iterator callback function
  *
@@ -237,6 +735,43 @@ bool hash_table_iter(
     void* iter_func_user_arg
 );
 
+/**
+ * Return the next batch of entries in a resumable scan of the hash table
+ *
+ * Start with *cursor set to 0 and call this until it sets *cursor back to 0. Each call returns at most batch entries and
+ * visits a bounded number of empty buckets (so a call can return no entries while the scan isn't done yet), which lets a
+ * large table be walked in small slices.
+ *
+ * The cursor is a position in the (remixed) hash space rather than a bucket offset, and buckets always cover
+ * contiguous ranges of it in order, so entries that stay in the table for the whole scan are returned exactly once,
+ * even if the table grows, shrinks or is incrementally rehashed between calls. Entries added or deleted during the
+ * scan may or may not be returned. Entries that share a full hash are always returned in the same call (if more than
+ * batch entries share one, the call fails).
+ *
+ * **Example**
+ * ```c
+ * uint64_t cursor = 0;
+ * hash_table_entry* entries[100];
+ * do {
+ *     size_t count = hash_table_scan(&ht, &cursor, 100, entries);
+ *     for (size_t i = 0; i < count; ++i) {
+ *         process(entries[i]);
+ *     }
+ * }
+ * while (cursor != 0);
+ * ```
+ *
+ * Time complexity: O(batch)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @param[in,out] cursor Scan position (0 to start, set to 0 when the scan is done)
+ * @param[in] batch Max number of entries to return
+ * @param[out] out Array of at least batch entry pointers to store returned entries in (valid until they're deleted)
+ * @return Number of entries returned, or -1 on failure
+ */
+size_t hash_table_scan(const hash_table* ht, uint64_t* cursor, size_t batch, hash_table_entry** out);
+
 /**
  * Get all keys in the hash table
  *
@@ -272,6 +807,29 @@ size_t hash_table_values(hash_table* ht, void** values);
  */
 size_t hash_table_size(const hash_table* ht);
 
+/**
+ * Get statistics about the hash table's layout and (if enabled) its operation counters
+ * Chain lengths show whether lookups are slow because of the load factor or because of clustering (a weak hash).
+ *
+ * Time complexity: O(n)
+ *
+ * @relates hash_table
+ * @param[in] ht Hash table
+ * @param[out] stats_out Statistics
+ * @return true on success, false on failure
+ */
+bool hash_table_stats(const hash_table* ht, hash_table_stats_snapshot* stats_out);
+
+/**
+ * Reset the hash table's operation counters to 0 (does nothing unless built with LUPRA_HASH_TABLE_STATS)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates hash_table
+ * @param[in,out] ht Hash table
+ */
+void hash_table_reset_counters(hash_table* ht);
+
 /**
  * Destroy the hash table
  *
@@ -115,6 +115,21 @@ static bool heapify_up(heap* h, const size_t index) {
     return true;
 }
 
+/**
+ * Check if a value can be above another value in the heap
+ *
+ * Time complexity: O(1)
+ *
+ * @param h Heap
+ * @param upper Value that would be closer to the root
+ * @param lower Value that would be further from the root
+ * @return true if upper belongs above (or level with) lower
+ */
+static inline bool in_order(const heap* h, const void* upper, const void* lower) {
+    const int cmp_result = h->value_cmp(upper, lower);
+    return h->type == MIN_HEAP ? cmp_result <= 0 : cmp_result >= 0;
+}
+
 /**
  * Push value down heap (e.g., head to tail)
  *
@@ -132,88 +147,32 @@ static bool heapify_down(heap* h, const size_t index) {
         return true;
     }
 
-    void* left_val = array_list_get_at(h->heap_array, left_idx);
-    void* right_val = array_list_get_at(h->heap_array, right_idx);
-    void* val = array_list_get_at(h->heap_array, index);
-
-    const int lv_rv_cmp_result = h->value_cmp(left_val, right_val);
-
-    if (h->type == MIN_HEAP) {
-        if (
-            // left_val > val > right_val
-            lv_rv_cmp_result > 0 /* left_val > right_val */ &&
-            h->value_cmp(val, right_val) > 0 /* val > right_val */
-        ) {
-            // Swap value with the right so that it's smallest
-            if (
-                !array_list_set_at(h->heap_array, index, right_val) ||
-                !array_list_set_at(h->heap_array, right_idx, val)
-            ) {
-                log_error("failed to swap value with right");
-                return false;
-            }
-
-            return heapify_down(h, right_idx); // Continue down the right side
-        }
-
-        if (
-            // left_val <= val <= right
-            lv_rv_cmp_result <= 0 /* right_val >= left_val */ &&
-            h->value_cmp(val, left_val) >= 0 /* val >= left_val */
-        ) {
-            // Swap value with the left so that it's smallest
-            if (
-                !array_list_set_at(h->heap_array, index, left_val) ||
-                !array_list_set_at(h->heap_array, left_idx, val)
-            ) {
-                log_error("failed to swap value with left");
-                return false;
-            }
-
-            return heapify_down(h, left_idx); // Continue down the left side
+    // Slots past size still hold popped values, so the right child only counts if it's in the heap
+    size_t child_idx = left_idx;
+    void* child_val = array_list_get_at(h->heap_array, left_idx);
+    if (right_idx < h->size) {
+        void* right_val = array_list_get_at(h->heap_array, right_idx);
+        if (!in_order(h, child_val, right_val)) {
+            child_idx = right_idx;
+            child_val = right_val;
         }
     }
 
-    if (h->type == MAX_HEAP) {
-        // left_val < val < right_val
-        // left_val >= val >= right
-
-        if (
-            // left_val < val < right_val
-            lv_rv_cmp_result < 0 /* left_val < right_val */ &&
-            h->value_cmp(val, right_val) < 0 /* val < right_val */
-        ) {
-            // Swap value with the right so that it's largest
-            if (
-                !array_list_set_at(h->heap_array, index, right_val) ||
-                !array_list_set_at(h->heap_array, right_idx, val)
-            ) {
-                log_error("failed to swap value with right");
-                return false;
-            }
-
-            return heapify_down(h, right_idx); // Continue down the right side
-        }
+    void* val = array_list_get_at(h->heap_array, index);
+    if (in_order(h, val, child_val)) {
+        return true;
+    }
 
-        if (
-            // left_val >= val => right
-            lv_rv_cmp_result >= 0 /* right_val <= left_val */ &&
-            h->value_cmp(val, left_val) <= 0 /* val <= left_val */
-        ) {
-            // Swap value with the left so that it's largest
-            if (
-                !array_list_set_at(h->heap_array, index, left_val) ||
-                !array_list_set_at(h->heap_array, left_idx, val)
-            ) {
-                log_error("failed to swap value with left");
-                return false;
-            }
-
-            return heapify_down(h, left_idx); // Continue down the left side
-        }
+    // Swap value with the child that belongs above the other
+    if (
+        !array_list_set_at(h->heap_array, index, child_val) ||
+        !array_list_set_at(h->heap_array, child_idx, val)
+    ) {
+        log_error("failed to swap value with child");
+        return false;
     }
 
-    return true;
+    return heapify_down(h, child_idx);
 }
 
 bool heap_push(heap* h, void* value) {
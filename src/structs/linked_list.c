@@ -9,13 +9,14 @@
  *
  * Time complexity: O(1)
  *
+ * @param[in,out] lst List the node is for
  * @param[in] value Value of node
  * @return List node
  */
-static list_node* make_node(void* value) {
-    list_node* item = malloc(sizeof(list_node));
+static list_node* make_node(const linked_list* lst, void* value) {
+    list_node* item = lst->node_pool != NULL ? mem_pool_alloc(lst->node_pool) : malloc(sizeof(list_node));
     if (item == NULL) {
-        log_perror("malloc() failed");
+        log_perror("node allocation failed");
         return nullptr;
     }
 
@@ -26,6 +27,23 @@ static list_node* make_node(void* value) {
     return item;
 }
 
+/**
+ * Free a list node
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] lst List the node was created for
+ * @param[in] node Node to free
+ */
+static void free_node(const linked_list* lst, list_node* node) {
+    if (lst->node_pool != NULL) {
+        mem_pool_free(lst->node_pool, node);
+        return;
+    }
+
+    free(node);
+}
+
 /**
  * Find a list node at a given position
  *
@@ -53,9 +71,14 @@ static list_node* find_node_at(list_node* list, const size_t pos) {
 }
 
 bool linked_list_init(linked_list* lst) {
+    return linked_list_init_with_pool(lst, NULL);
+}
+
+bool linked_list_init_with_pool(linked_list* lst, mem_pool* node_pool) {
     lst->head = nullptr;
     lst->tail = nullptr;
     lst->size = 0;
+    lst->node_pool = node_pool;
 
     return true;
 }
@@ -69,7 +92,7 @@ bool linked_list_insert_at(linked_list* lst, void* value, const size_t pos) {
         return false;
     }
 
-    list_node* p_node = make_node(value);
+    list_node* p_node = make_node(lst, value);
     if (p_node == NULL) {
         return false;
     }
@@ -132,7 +155,7 @@ bool linked_list_del_at(linked_list* lst, const size_t pos) {
     p_node->prev = nullptr;
     p_node->next = nullptr;
 
-    free(p_node);
+    free_node(lst, p_node);
     --lst->size;
 
     return true;
@@ -149,7 +172,7 @@ void* linked_list_head(const linked_list* lst) {
 bool linked_list_push_head(linked_list* lst, void* value) {
     list_node* p_head = lst->head;
 
-    list_node* p_node = make_node(value);
+    list_node* p_node = make_node(lst, value);
     if (p_node == NULL) {
         return false;
     }
@@ -181,9 +204,17 @@ void* linked_list_pop_head(linked_list* lst) {
 
     void* value = p_node->value;
     lst->head = p_node->next;
-    p_node->next = nullptr;
 
-    free(p_node);
+    if (lst->head == NULL) {
+        // List is now empty
+        lst->tail = nullptr;
+    }
+    else {
+        lst->head->prev = nullptr;
+        p_node->next = nullptr;
+    }
+
+    free_node(lst, p_node);
     --lst->size;
 
     return value;
@@ -200,7 +231,7 @@ void* linked_list_tail(const linked_list* lst) {
 bool linked_list_push_tail(linked_list* lst, void* value) {
     list_node* p_tail = lst->tail;
 
-    list_node* p_node = make_node(value);
+    list_node* p_node = make_node(lst, value);
     if (p_node == NULL) {
         return false;
     }
@@ -243,12 +274,71 @@ void* linked_list_pop_tail(linked_list* lst) {
 
     void* value = p_node->value;
 
-    free(p_node);
+    free_node(lst, p_node);
     --lst->size;
 
     return value;
 }
 
+void linked_list_link_head(linked_list* lst, list_node* node) {
+    node->prev = nullptr;
+    node->next = lst->head;
+
+    if (lst->head != NULL) {
+        lst->head->prev = node;
+    }
+    else {
+        lst->tail = node;
+    }
+
+    lst->head = node;
+    ++lst->size;
+}
+
+void linked_list_link_tail(linked_list* lst, list_node* node) {
+    node->prev = lst->tail;
+    node->next = nullptr;
+
+    if (lst->tail != NULL) {
+        lst->tail->next = node;
+    }
+    else {
+        lst->head = node;
+    }
+
+    lst->tail = node;
+    ++lst->size;
+}
+
+void linked_list_unlink(linked_list* lst, list_node* node) {
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    }
+    else {
+        lst->head = node->next;
+    }
+
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    }
+    else {
+        lst->tail = node->prev;
+    }
+
+    node->prev = nullptr;
+    node->next = nullptr;
+    --lst->size;
+}
+
+void linked_list_move_to_head(linked_list* lst, list_node* node) {
+    if (lst->head == node) {
+        return;
+    }
+
+    linked_list_unlink(lst, node);
+    linked_list_link_head(lst, node);
+}
+
 void linked_list_forward_iter(
     const linked_list* lst,
     const list_iter_func iter_func,
@@ -294,18 +384,18 @@ void linked_list_backward_iter(
  *
  * @param[in] item Iterated list node
  * @param[in] _index Iteration index
- * @param _user_arg Ignored
+ * @param[in] user_arg List being destroyed
  */
 static void destroy_iter_func(
     const list_node* item,
     size_t _index,
-    void* _user_arg
+    void* user_arg
 ) {
-    free((void *)item);
+    free_node(user_arg, (list_node *)item);
 }
 
 bool linked_list_destroy(linked_list* lst) {
-    linked_list_forward_iter(lst, destroy_iter_func, NULL);
+    linked_list_forward_iter(lst, destroy_iter_func, lst);
 
     lst->head = nullptr;
     lst->tail = nullptr;
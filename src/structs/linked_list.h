@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../utils/mem_pool.h"
+
 /**
  * Doubly-linked list node
  *
@@ -36,6 +38,12 @@ typedef struct linked_list_node {
 typedef struct linked_list {
     list_node *head, *tail;
     size_t size;
+
+    /**
+     * Pool that nodes are allocated from, or NULL to use malloc()
+     * This is owned by the caller and can be shared by many lists
+     */
+    mem_pool* node_pool;
 } linked_list;
 
 /**
@@ -49,6 +57,18 @@ typedef struct linked_list {
  */
 bool linked_list_init(linked_list* lst);
 
+/**
+ * Initialize the linked list with nodes allocated from a memory pool
+ *
+ * Time complexity: O(1)
+ *
+ * @relates linked_list
+ * @param[out] lst Empty list to initialize
+ * @param[in] node_pool Pool of sizeof(list_node) objects (must outlive the list), or NULL to use malloc()
+ * @return true on success, false on failure
+ */
+bool linked_list_init_with_pool(linked_list* lst, mem_pool* node_pool);
+
 /**
  * Insert a value into the list at position
  *
@@ -154,6 +174,55 @@ bool linked_list_push_tail(linked_list* lst, void* value);
  */
 void* linked_list_pop_tail(linked_list* lst);
 
+/**
+ * Link a node (that isn't in any list) to the head of the list
+ *
+ * This and the other node functions work on nodes that the caller owns, usually embedded in another struct (an
+ * intrusive list), so nothing is allocated and a node can be moved or removed without searching for it. Nodes linked
+ * this way must be unlinked before linked_list_destroy() is called, since it frees every node still in the list.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates linked_list
+ * @param[in,out] lst List
+ * @param[in,out] node Node to link (its value is left as is)
+ */
+void linked_list_link_head(linked_list* lst, list_node* node);
+
+/**
+ * Link a node (that isn't in any list) to the tail of the list
+ * {@see linked_list_link_head}
+ *
+ * Time complexity: O(1)
+ *
+ * @relates linked_list
+ * @param[in,out] lst List
+ * @param[in,out] node Node to link (its value is left as is)
+ */
+void linked_list_link_tail(linked_list* lst, list_node* node);
+
+/**
+ * Unlink a node from the list without freeing it
+ *
+ * Time complexity: O(1)
+ *
+ * @relates linked_list
+ * @param[in,out] lst List the node is in
+ * @param[in,out] node Node to unlink
+ */
+void linked_list_unlink(linked_list* lst, list_node* node);
+
+/**
+ * Move a node that's in the list to its head
+ *
+ * Time complexity: O(1)
+ *
+ * @relates linked_list
+ * @param[in,out] lst List the node is in
+ * @param[in,out] node Node to move
+ */
+void linked_list_move_to_head(linked_list* lst, list_node* node);
+
 /**
  * List iterator callback function
  *
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lru_cache.h"
+#include "../utils/log.h"
+
+/**
+ * Initial hash table index size when there's no entry count limit to size it from
+ */
+#define DEFAULT_TABLE_SIZE 64
+
+bool lru_cache_init(
+    lru_cache* cache,
+    const size_t max_entries,
+    const size_t max_bytes,
+    const lru_cache_policy policy,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(cache, 0, sizeof(lru_cache));
+
+    const size_t table_size = max_entries != 0 && max_entries < UINT32_MAX ? max_entries : DEFAULT_TABLE_SIZE;
+    if (!hash_table_init(&cache->table, table_size, key_cmp, key_hash)) {
+        return false;
+    }
+
+    if (!mem_pool_init(&cache->entry_pool, sizeof(lru_cache_entry), NULL)) {
+        hash_table_destroy(&cache->table);
+        return false;
+    }
+
+    linked_list_init(&cache->list);
+
+    cache->max_entries = max_entries;
+    cache->max_bytes = max_bytes;
+    cache->policy = policy;
+
+    return true;
+}
+
+void lru_cache_set_evict_func(lru_cache* cache, const lru_cache_evict_func evict_func, void* evict_user_arg) {
+    cache->evict_func = evict_func;
+    cache->evict_user_arg = evict_user_arg;
+}
+
+/**
+ * Remove an entry from the table and recency list, and free it
+ *
+ * @param[in,out] cache LRU cache
+ * @param[in] entry Entry to remove
+ */
+static void remove_entry(lru_cache* cache, lru_cache_entry* entry) {
+    hash_table_del(&cache->table, entry->key);
+    linked_list_unlink(&cache->list, &entry->node);
+    cache->byte_size -= entry->size;
+
+    mem_pool_free(&cache->entry_pool, entry);
+}
+
+/**
+ * Check if the cache needs to evict an entry to make room for a new one
+ *
+ * @param[in] cache LRU cache
+ * @param[in] size Size of the new entry in bytes
+ * @return true if an entry needs to be evicted first
+ */
+static inline bool needs_room(const lru_cache* cache, const size_t size) {
+    return (cache->max_entries != 0 && cache->list.size >= cache->max_entries) ||
+           (cache->max_bytes != 0 && cache->byte_size + size > cache->max_bytes);
+}
+
+/**
+ * Mark an entry as used, according to the cache's policy
+ *
+ * @param[in,out] cache LRU cache
+ * @param[in,out] entry Entry that was used
+ */
+static inline void touch_entry(lru_cache* cache, lru_cache_entry* entry) {
+    if (cache->policy == LRU_CACHE_POLICY_CLOCK) {
+        entry->referenced = true;
+    }
+    else {
+        linked_list_move_to_head(&cache->list, &entry->node);
+    }
+}
+
+bool lru_cache_put(lru_cache* cache, void* key, void* value, const size_t size) {
+    if (cache->max_bytes != 0 && size > cache->max_bytes) {
+        log_error("LRU cache entry of %zu bytes is larger than the cache (%zu bytes)", size, cache->max_bytes);
+        return false;
+    }
+
+    lru_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    const bool is_new = p_entry == NULL;
+    if (!is_new) {
+        // Take the old entry out of the list while making room, so it can't be evicted
+        linked_list_unlink(&cache->list, &p_entry->node);
+        cache->byte_size -= p_entry->size;
+    }
+    else {
+        p_entry = mem_pool_alloc(&cache->entry_pool);
+        if (p_entry == NULL) {
+            log_error("LRU cache entry allocation failed");
+            return false;
+        }
+
+        p_entry->node.value = p_entry;
+        p_entry->key = key;
+        p_entry->referenced = false;
+    }
+
+    // Evict before inserting, so the new entry is never the one picked
+    while (needs_room(cache, size) && lru_cache_evict(cache)) {
+    }
+
+    if (is_new && !hash_table_set(&cache->table, key, p_entry)) {
+        mem_pool_free(&cache->entry_pool, p_entry);
+        return false;
+    }
+
+    p_entry->value = value;
+    p_entry->size = size;
+
+    linked_list_link_head(&cache->list, &p_entry->node);
+    cache->byte_size += size;
+
+    return true;
+}
+
+void* lru_cache_get(lru_cache* cache, const void* key) {
+    lru_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
+
+    touch_entry(cache, p_entry);
+
+    return p_entry->value;
+}
+
+void* lru_cache_peek(const lru_cache* cache, const void* key) {
+    const lru_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
+
+    return p_entry->value;
+}
+
+bool lru_cache_del(lru_cache* cache, const void* key) {
+    lru_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    if (p_entry == NULL) {
+        return false;
+    }
+
+    remove_entry(cache, p_entry);
+
+    return true;
+}
+
+bool lru_cache_evict(lru_cache* cache) {
+    if (cache->list.tail == NULL) {
+        return false;
+    }
+
+    lru_cache_entry* p_victim = cache->list.tail->value;
+
+    if (cache->policy == LRU_CACHE_POLICY_CLOCK) {
+        // Referenced entries get a second chance at the front. This ends after at most one pass, since the bits are cleared.
+        while (p_victim->referenced) {
+            p_victim->referenced = false;
+            linked_list_move_to_head(&cache->list, &p_victim->node);
+            p_victim = cache->list.tail->value;
+        }
+    }
+
+    void* key = p_victim->key;
+    void* value = p_victim->value;
+
+    remove_entry(cache, p_victim);
+
+    if (cache->evict_func != NULL) {
+        cache->evict_func(key, value, cache->evict_user_arg);
+    }
+
+    return true;
+}
+
+size_t lru_cache_size(const lru_cache* cache) {
+    return cache->list.size;
+}
+
+size_t lru_cache_byte_size(const lru_cache* cache) {
+    return cache->byte_size;
+}
+
+bool lru_cache_destroy(lru_cache* cache) {
+    // Entries are all freed with their pool, so the list only needs to be forgotten
+    cache->list.head = nullptr;
+    cache->list.tail = nullptr;
+    cache->list.size = 0;
+    cache->byte_size = 0;
+
+    const bool table_destroyed = hash_table_destroy(&cache->table);
+    const bool pool_destroyed = mem_pool_destroy(&cache->entry_pool);
+
+    return table_destroyed && pool_destroyed;
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hash_table.h"
+#include "linked_list.h"
+#include "../utils/mem_pool.h"
+#include "../utils/value.h"
+
+/**
+ * How an LRU cache picks which entry to evict
+ */
+typedef enum lru_cache_policy {
+    /**
+     * Exact LRU: every hit moves the entry to the front of the recency list
+     */
+    LRU_CACHE_POLICY_LRU,
+
+    /**
+     * CLOCK (second chance): a hit only sets the entry's referenced bit. Eviction looks at the oldest entry, and gives
+     * it another pass (clearing the bit) if it was referenced since it was last looked at. Hits don't touch the list, at
+     * the cost of approximating LRU order.
+     */
+    LRU_CACHE_POLICY_CLOCK,
+} lru_cache_policy;
+
+/**
+ * LRU cache entry
+ * The list node is embedded (intrusive), so the hash table entry leads straight to the entry's place in the recency list
+ */
+typedef struct lru_cache_entry {
+    /**
+     * Recency list node (value points back to this entry)
+     */
+    list_node node;
+
+    void* key;
+    void* value;
+
+    /**
+     * Size of the entry in bytes (counted against max_bytes)
+     */
+    size_t size;
+
+    /**
+     * Set by hits in CLOCK mode
+     */
+    bool referenced;
+} lru_cache_entry;
+
+/**
+ * Eviction callback function, called when an entry is evicted to keep the cache within its capacity
+ *
+ * @param[in] key Evicted entry's key
+ * @param[in] value Evicted entry's value
+ * @param user_arg Optional user arg
+ */
+typedef void (*lru_cache_evict_func)(void* key, void* value, void* user_arg);
+
+/**
+ * A least recently used (LRU) cache is a key/value store with a bounded capacity: when it's full, the entry that was
+ * used least recently is evicted to make room.
+ *
+ * Keys map (with a hash_table) directly to entries that embed their node in the recency list, so get, put and evict are
+ * all O(1). The capacity can be bounded by entry count, by the total byte size given with each put, or both. An optional
+ * callback is called with each evicted entry, so its key and value can be freed.
+ *
+ * The CLOCK policy (see lru_cache_policy) avoids the list updates that exact LRU does on every hit, which matters most
+ * for caches with a high hit rate.
+ *
+ * Keys and values aren't copied or freed by the cache.
+ *
+ * **Example**
+ * ```c
+ * lru_cache cache;
+ * lru_cache_init(&cache, 2, 0, LRU_CACHE_POLICY_LRU, NULL, NULL); // At most 2 entries, string keys
+ *
+ * lru_cache_put(&cache, "foo", "one", 0);
+ * lru_cache_put(&cache, "bar", "two", 0);
+ * lru_cache_get(&cache, "foo"); // "foo" is now the most recently used
+ * lru_cache_put(&cache, "spangle", "three", 0); // Evicts "bar"
+ *
+ * assert(lru_cache_get(&cache, "bar") == NULL);
+ *
+ * lru_cache_destroy(&cache);
+ * ```
+ */
+typedef struct lru_cache {
+    /**
+     * Key -> lru_cache_entry
+     */
+    hash_table table;
+
+    /**
+     * Recency list (most recently used or inserted first)
+     */
+    linked_list list;
+
+    /**
+     * Entry pool
+     */
+    mem_pool entry_pool;
+
+    /**
+     * Max number of entries, or 0 for no limit
+     */
+    size_t max_entries;
+
+    /**
+     * Max total size of entries in bytes, or 0 for no limit
+     */
+    size_t max_bytes;
+
+    /**
+     * Total size of entries in bytes
+     */
+    size_t byte_size;
+
+    lru_cache_policy policy;
+
+    /**
+     * Eviction callback (or NULL)
+     */
+    lru_cache_evict_func evict_func;
+    void* evict_user_arg;
+} lru_cache;
+
+/**
+ * Initialize the LRU cache
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[out] cache LRU cache
+ * @param[in] max_entries Max number of entries, or 0 for no limit
+ * @param[in] max_bytes Max total size of entries in bytes, or 0 for no limit
+ * @param[in] policy Eviction policy
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool lru_cache_init(
+    lru_cache* cache,
+    size_t max_entries,
+    size_t max_bytes,
+    lru_cache_policy policy,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash
+);
+
+/**
+ * Set the eviction callback
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[in,out] cache LRU cache
+ * @param[in] evict_func Called with each entry that's evicted to stay within capacity (or NULL)
+ * @param evict_user_arg Optional argument to pass to the eviction callback
+ */
+void lru_cache_set_evict_func(lru_cache* cache, lru_cache_evict_func evict_func, void* evict_user_arg);
+
+/**
+ * Insert or replace an entry in the LRU cache, first evicting least recently used entries if there isn't room for it
+ *
+ * The entry becomes the most recently used. Replacing an entry doesn't call the eviction callback for the old value.
+ *
+ * Time complexity: O(1) (amortized over evictions)
+ *
+ * @relates lru_cache
+ * @param[in,out] cache LRU cache
+ * @param[in] key Pointer to key
+ * @param[in] value Pointer to value
+ * @param[in] size Size of the entry in bytes (only used if max_bytes is set, and can't be more than max_bytes)
+ * @return true on success, false on failure
+ */
+bool lru_cache_put(lru_cache* cache, void* key, void* value, size_t size);
+
+/**
+ * Get a value from the LRU cache, marking it as recently used
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[in,out] cache LRU cache
+ * @param[in] key Key to get value for
+ * @return Value pointer, or NULL if not found
+ */
+void* lru_cache_get(lru_cache* cache, const void* key);
+
+/**
+ * Get a value from the LRU cache without marking it as recently used
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[in] cache LRU cache
+ * @param[in] key Key to get value for
+ * @return Value pointer, or NULL if not found
+ */
+void* lru_cache_peek(const lru_cache* cache, const void* key);
+
+/**
+ * Delete an entry from the LRU cache (without calling the eviction callback)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[in,out] cache LRU cache
+ * @param[in] key Key to delete
+ * @return true on success, false if not found
+ */
+bool lru_cache_del(lru_cache* cache, const void* key);
+
+/**
+ * Evict the entry that the policy would evict next (calling the eviction callback)
+ *
+ * Time complexity: O(1) (amortized for CLOCK)
+ *
+ * @relates lru_cache
+ * @param[in,out] cache LRU cache
+ * @return true on success, false if the cache is empty
+ */
+bool lru_cache_evict(lru_cache* cache);
+
+/**
+ * Get the number of entries in the LRU cache
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[in] cache LRU cache
+ * @return Number of entries
+ */
+size_t lru_cache_size(const lru_cache* cache);
+
+/**
+ * Get the total size of the LRU cache's entries in bytes
+ *
+ * Time complexity: O(1)
+ *
+ * @relates lru_cache
+ * @param[in] cache LRU cache
+ * @return Size in bytes
+ */
+size_t lru_cache_byte_size(const lru_cache* cache);
+
+/**
+ * Destroy the LRU cache (without calling the eviction callback)
+ *
+ * Time complexity: O(n)
+ *
+ * @relates lru_cache
+ * @param[in,out] cache LRU cache
+ * @return true on success, false on failure
+ */
+bool lru_cache_destroy(lru_cache* cache);
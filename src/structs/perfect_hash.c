@@ -0,0 +1,505 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "perfect_hash.h"
+#include "hash_map.h"
+#include "../algos/murmur3.h"
+#include "../utils/log.h"
+
+/**
+ * Keys whose hash (high 32 bits) is below this go to the dense buckets (60% of keys)
+ */
+#define DENSE_KEY_THRESHOLD ((uint32_t)(0.6 * 4294967296.0))
+
+/**
+ * Seed of the first build attempt (later attempts add multiples of it)
+ */
+#define FIRST_SEED 0x9e3779b9U
+
+/**
+ * Mixed into the seed for the low 32 bits of a key's hash
+ */
+#define LOW_SEED_SALT 0x5bd1e995U
+
+/**
+ * Mixed into a key's hash before taking its fingerprint, so fingerprints aren't correlated with slots
+ */
+#define FINGERPRINT_SALT 0xc2b2ae3d27d4eb4fULL
+
+/**
+ * Hash a key to 64 bits
+ *
+ * @param[in] key Key bytes
+ * @param[in] key_len Key length in bytes
+ * @param[in] seed Seed
+ * @return Hash value
+ */
+static inline uint64_t hash_key(const void* key, const size_t key_len, const uint32_t seed) {
+    return (uint64_t)murmur3(key, key_len, seed) << 32 | murmur3(key, key_len, seed ^ LOW_SEED_SALT);
+}
+
+/**
+ * Find the bucket of a key
+ *
+ * @param[in] ph Perfect hash
+ * @param[in] hash Key hash
+ * @return Bucket
+ */
+static inline size_t bucket_of(const perfect_hash* ph, const uint64_t hash) {
+    const uint64_t low = (uint32_t)hash;
+    if ((uint32_t)(hash >> 32) < DENSE_KEY_THRESHOLD) {
+        return low * ph->dense_bucket_size >> 32;
+    }
+
+    return ph->dense_bucket_size + (low * (ph->bucket_size - ph->dense_bucket_size) >> 32);
+}
+
+/**
+ * Find the slot a pilot moves a key to
+ *
+ * @param[in] ph Perfect hash
+ * @param[in] hash Key hash
+ * @param[in] pilot Pilot of the key's bucket
+ * @return Slot in [0, slot_size)
+ */
+static inline size_t slot_of(const perfect_hash* ph, const uint64_t hash, const uint16_t pilot) {
+    const uint64_t mixed = hash_map_hash_u64(hash ^ hash_map_hash_u64(pilot + (uint64_t)ph->seed));
+    return (mixed >> 32) * ph->slot_size >> 32;
+}
+
+/**
+ * Find the index of a key
+ *
+ * @param[in] ph Perfect hash
+ * @param[in] hash Key hash
+ * @return Index in [0, key_size)
+ */
+static inline size_t index_of(const perfect_hash* ph, const uint64_t hash) {
+    const size_t slot = slot_of(ph, hash, ph->pilots[bucket_of(ph, hash)]);
+    return slot < ph->key_size ? slot : ph->remap[slot - ph->key_size];
+}
+
+/**
+ * Compute a key's fingerprint
+ *
+ * @param[in] hash Key hash
+ * @return Fingerprint (truncated to the perfect hash's fingerprint size)
+ */
+static inline uint16_t fingerprint_of(const uint64_t hash) {
+    return hash_map_hash_u64(hash ^ FINGERPRINT_SALT);
+}
+
+/**
+ * Check if a slot has a key
+ *
+ * @param[in] taken Bit set of slots that have a key
+ * @param[in] slot Slot
+ * @return true if taken
+ */
+static inline bool slot_taken(const uint64_t* taken, const size_t slot) {
+    return (taken[slot / 64] >> (slot % 64) & 1) != 0;
+}
+
+/**
+ * Working arrays for a build
+ */
+typedef struct build_state {
+    uint64_t* hashes;
+
+    /**
+     * Start of each bucket's keys in bucket_keys (bucket_size + 1 entries)
+     */
+    uint32_t* bucket_starts;
+
+    /**
+     * Key indexes, grouped by bucket
+     */
+    uint32_t* bucket_keys;
+
+    /**
+     * Buckets, largest first
+     */
+    uint32_t* bucket_order;
+
+    /**
+     * Bit set of slots that have a key
+     */
+    uint64_t* taken;
+
+    /**
+     * Slots of the bucket being placed
+     */
+    size_t* bucket_slots;
+} build_state;
+
+/**
+ * Free a build's working arrays
+ *
+ * @param[in,out] state Build state
+ */
+static void free_build_state(build_state* state) {
+    free(state->hashes);
+    free(state->bucket_starts);
+    free(state->bucket_keys);
+    free(state->bucket_order);
+    free(state->taken);
+    free(state->bucket_slots);
+}
+
+/**
+ * Group keys by bucket and sort buckets by size (largest first), using counting sorts
+ *
+ * @param[in] ph Perfect hash
+ * @param[in,out] state Build state (with hashes set)
+ * @return true on success, false if two keys have the same hash
+ */
+static bool group_buckets(const perfect_hash* ph, build_state* state) {
+    const size_t n = ph->key_size;
+    uint32_t* starts = state->bucket_starts;
+
+    memset(starts, 0, (ph->bucket_size + 1) * sizeof(uint32_t));
+    for (size_t i = 0; i < n; ++i) {
+        ++starts[bucket_of(ph, state->hashes[i]) + 1];
+    }
+
+    uint32_t max_bucket_size = 0;
+    for (size_t b = 0; b < ph->bucket_size; ++b) {
+        if (starts[b + 1] > max_bucket_size) {
+            max_bucket_size = starts[b + 1];
+        }
+        starts[b + 1] += starts[b];
+    }
+
+    // Fill each bucket from its end, using the next bucket's start as the fill position
+    for (size_t i = n; i-- > 0;) {
+        const size_t b = bucket_of(ph, state->hashes[i]);
+        state->bucket_keys[--starts[b + 1]] = i;
+    }
+
+    // starts[b + 1] now holds bucket b's start, so shift them back into place
+    memmove(starts, starts + 1, ph->bucket_size * sizeof(uint32_t));
+    starts[ph->bucket_size] = n;
+
+    // Keys with the same hash would land in the same slot for every pilot
+    for (size_t b = 0; b < ph->bucket_size; ++b) {
+        for (size_t i = starts[b]; i < starts[b + 1]; ++i) {
+            for (size_t j = starts[b]; j < i; ++j) {
+                if (state->hashes[state->bucket_keys[i]] == state->hashes[state->bucket_keys[j]]) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    uint32_t* size_counts = calloc(max_bucket_size + 2, sizeof(uint32_t));
+    if (size_counts == NULL) {
+        log_perror("calloc() failed for perfect hash bucket sizes");
+        return false;
+    }
+
+    for (size_t b = 0; b < ph->bucket_size; ++b) {
+        ++size_counts[max_bucket_size - (starts[b + 1] - starts[b]) + 1];
+    }
+    for (size_t s = 0; s <= max_bucket_size; ++s) {
+        size_counts[s + 1] += size_counts[s];
+    }
+    for (size_t b = 0; b < ph->bucket_size; ++b) {
+        state->bucket_order[size_counts[max_bucket_size - (starts[b + 1] - starts[b])]++] = b;
+    }
+
+    free(size_counts);
+
+    return true;
+}
+
+/**
+ * Search for a pilot that moves every key of a bucket to a free slot (and to distinct slots), and take the slots
+ *
+ * @param[in,out] ph Perfect hash
+ * @param[in,out] state Build state
+ * @param[in] bucket Bucket to place
+ * @return true on success, false if no pilot works
+ */
+static bool place_bucket(perfect_hash* ph, build_state* state, const size_t bucket) {
+    const uint32_t start = state->bucket_starts[bucket];
+    const uint32_t size = state->bucket_starts[bucket + 1] - start;
+
+    for (uint32_t pilot = 0; pilot <= UINT16_MAX; ++pilot) {
+        size_t i = 0;
+        for (; i < size; ++i) {
+            const size_t slot = slot_of(ph, state->hashes[state->bucket_keys[start + i]], pilot);
+            if (slot_taken(state->taken, slot)) {
+                break;
+            }
+
+            size_t j = 0;
+            while (j < i && state->bucket_slots[j] != slot) {
+                ++j;
+            }
+            if (j < i) {
+                break;
+            }
+
+            state->bucket_slots[i] = slot;
+        }
+
+        if (i == size) {
+            for (i = 0; i < size; ++i) {
+                state->taken[state->bucket_slots[i] / 64] |= (uint64_t)1 << (state->bucket_slots[i] % 64);
+            }
+
+            ph->pilots[bucket] = pilot;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Try to place every bucket with the perfect hash's current seed
+ *
+ * @param[in,out] ph Perfect hash
+ * @param[in,out] state Build state
+ * @param[in] keys Keys
+ * @param[in] key_lens Key lengths (or NULL for strings)
+ * @return true on success, false if this seed doesn't work
+ */
+static bool try_seed(perfect_hash* ph, build_state* state, const void* const* keys, const size_t* key_lens) {
+    for (size_t i = 0; i < ph->key_size; ++i) {
+        const size_t key_len = key_lens != NULL ? key_lens[i] : strlen(keys[i]);
+        state->hashes[i] = hash_key(keys[i], key_len, ph->seed);
+    }
+
+    if (!group_buckets(ph, state)) {
+        return false;
+    }
+
+    memset(state->taken, 0, (ph->slot_size + 63) / 64 * sizeof(uint64_t));
+
+    for (size_t i = 0; i < ph->bucket_size; ++i) {
+        if (!place_bucket(ph, state, state->bucket_order[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool perfect_hash_init(
+    perfect_hash* ph,
+    const void* const* keys,
+    const size_t* key_lens,
+    const size_t n,
+    const uint8_t fingerprint_bits
+) {
+    memset(ph, 0, sizeof(perfect_hash));
+
+    if (fingerprint_bits != 0 && fingerprint_bits != 8 && fingerprint_bits != 16) {
+        log_error("perfect hash fingerprint size must be 0, 8 or 16 bits");
+        return false;
+    }
+
+    if (n >= UINT32_MAX) {
+        log_error("too many keys for perfect hash");
+        return false;
+    }
+
+    ph->key_size = n;
+    ph->fingerprint_bits = fingerprint_bits;
+
+    if (n == 0) {
+        return true;
+    }
+
+    ph->slot_size = (size_t)ceil(n / PERFECT_HASH_LOAD_FACTOR);
+    if (ph->slot_size < n) {
+        ph->slot_size = n;
+    }
+
+    // At least 2 buckets, so there's always a dense and a sparse bucket
+    ph->bucket_size = (n + PERFECT_HASH_KEYS_PER_BUCKET - 1) / PERFECT_HASH_KEYS_PER_BUCKET;
+    if (ph->bucket_size < 2) {
+        ph->bucket_size = 2;
+    }
+    ph->dense_bucket_size = ph->bucket_size * 3 / 10;
+    if (ph->dense_bucket_size < 1) {
+        ph->dense_bucket_size = 1;
+    }
+
+    build_state state = {
+        .hashes = malloc(n * sizeof(uint64_t)),
+        .bucket_starts = malloc((ph->bucket_size + 1) * sizeof(uint32_t)),
+        .bucket_keys = malloc(n * sizeof(uint32_t)),
+        .bucket_order = malloc(ph->bucket_size * sizeof(uint32_t)),
+        .taken = malloc((ph->slot_size + 63) / 64 * sizeof(uint64_t)),
+        .bucket_slots = malloc(n * sizeof(size_t)),
+    };
+    ph->pilots = calloc(ph->bucket_size, sizeof(uint16_t));
+    ph->remap = calloc(ph->slot_size - n + 1, sizeof(uint32_t));
+
+    if (state.hashes == NULL || state.bucket_starts == NULL || state.bucket_keys == NULL ||
+        state.bucket_order == NULL || state.taken == NULL || state.bucket_slots == NULL ||
+        ph->pilots == NULL || ph->remap == NULL) {
+        log_perror("malloc() failed for perfect hash");
+        free_build_state(&state);
+        perfect_hash_destroy(ph);
+        return false;
+    }
+
+    bool placed = false;
+    for (uint32_t attempt = 1; attempt <= PERFECT_HASH_MAX_ATTEMPTS && !placed; ++attempt) {
+        ph->seed = FIRST_SEED * attempt;
+        placed = try_seed(ph, &state, keys, key_lens);
+    }
+
+    if (!placed) {
+        log_error("failed to build perfect hash (are the keys distinct?)");
+        free_build_state(&state);
+        perfect_hash_destroy(ph);
+        return false;
+    }
+
+    // Give each key that landed past n one of the free slots below n, in order
+    size_t free_slot = 0;
+    for (size_t slot = n; slot < ph->slot_size; ++slot) {
+        if (slot_taken(state.taken, slot)) {
+            while (slot_taken(state.taken, free_slot)) {
+                ++free_slot;
+            }
+            ph->remap[slot - n] = free_slot++;
+        }
+    }
+
+    if (fingerprint_bits != 0) {
+        ph->fingerprints = malloc(n * fingerprint_bits / 8);
+        if (ph->fingerprints == NULL) {
+            log_perror("malloc() failed for perfect hash fingerprints");
+            free_build_state(&state);
+            perfect_hash_destroy(ph);
+            return false;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const size_t index = index_of(ph, state.hashes[i]);
+            if (fingerprint_bits == 8) {
+                ((uint8_t*)ph->fingerprints)[index] = fingerprint_of(state.hashes[i]);
+            }
+            else {
+                ((uint16_t*)ph->fingerprints)[index] = fingerprint_of(state.hashes[i]);
+            }
+        }
+    }
+
+    free_build_state(&state);
+
+    return true;
+}
+
+/**
+ * Keys (and values) collected from a hash table by collect_entry()
+ */
+typedef struct collected_entries {
+    const void** keys;
+    size_t* key_lens;
+    void** values;
+
+    /**
+     * Number of entries collected so far
+     */
+    size_t size;
+} collected_entries;
+
+/**
+ * Collect an entry's key, key length and value
+ * {@see hash_table_iter_func}
+ */
+static void collect_entry(hash_table_entry* entry, const size_t _index, void* user_arg) {
+    collected_entries* collected = user_arg;
+
+    collected->keys[collected->size] = entry->key;
+    collected->key_lens[collected->size] = entry->key_len != 0 ? entry->key_len : strlen(entry->key);
+    collected->values[collected->size] = entry->value;
+    ++collected->size;
+}
+
+bool perfect_hash_init_from_hash_table(
+    perfect_hash* ph,
+    hash_table* ht,
+    const uint8_t fingerprint_bits,
+    void** values_out
+) {
+    const size_t n = hash_table_size(ht);
+
+    collected_entries collected = {
+        .keys = malloc((n + 1) * sizeof(void*)),
+        .key_lens = malloc((n + 1) * sizeof(size_t)),
+        .values = malloc((n + 1) * sizeof(void*)),
+    };
+
+    if (collected.keys == NULL || collected.key_lens == NULL || collected.values == NULL) {
+        log_perror("malloc() failed for perfect hash keys");
+        free(collected.keys);
+        free(collected.key_lens);
+        free(collected.values);
+        return false;
+    }
+
+    bool success = hash_table_iter(ht, collect_entry, &collected) &&
+                   perfect_hash_init(ph, collected.keys, collected.key_lens, n, fingerprint_bits);
+
+    if (success && values_out != NULL) {
+        for (size_t i = 0; i < n; ++i) {
+            values_out[perfect_hash_lookup_n(ph, collected.keys[i], collected.key_lens[i])] = collected.values[i];
+        }
+    }
+
+    free(collected.keys);
+    free(collected.key_lens);
+    free(collected.values);
+
+    return success;
+}
+
+size_t perfect_hash_lookup_n(const perfect_hash* ph, const void* key, const size_t key_len) {
+    if (ph->key_size == 0) {
+        return PERFECT_HASH_NOT_FOUND;
+    }
+
+    const uint64_t hash = hash_key(key, key_len, ph->seed);
+    const size_t index = index_of(ph, hash);
+
+    if (ph->fingerprint_bits == 8 && ((const uint8_t*)ph->fingerprints)[index] != (uint8_t)fingerprint_of(hash)) {
+        return PERFECT_HASH_NOT_FOUND;
+    }
+    if (ph->fingerprint_bits == 16 && ((const uint16_t*)ph->fingerprints)[index] != fingerprint_of(hash)) {
+        return PERFECT_HASH_NOT_FOUND;
+    }
+
+    return index;
+}
+
+size_t perfect_hash_lookup(const perfect_hash* ph, const char* key) {
+    return perfect_hash_lookup_n(ph, key, strlen(key));
+}
+
+size_t perfect_hash_memory_size(const perfect_hash* ph) {
+    if (ph->key_size == 0) {
+        return 0;
+    }
+
+    return ph->bucket_size * sizeof(uint16_t) +
+           (ph->slot_size - ph->key_size) * sizeof(uint32_t) +
+           ph->key_size * ph->fingerprint_bits / 8;
+}
+
+bool perfect_hash_destroy(perfect_hash* ph) {
+    free(ph->pilots);
+    free(ph->remap);
+    free(ph->fingerprints);
+
+    memset(ph, 0, sizeof(perfect_hash));
+
+    return true;
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hash_table.h"
+
+/**
+ * Average number of keys per bucket (each bucket stores a 16-bit pilot, so this sets the bits per key)
+ */
+#define PERFECT_HASH_KEYS_PER_BUCKET 5
+
+/**
+ * Fraction of the slots that keys are placed in while building (the rest are remapped so the function is minimal)
+ * Leaving some slots free keeps the last buckets from needing huge pilots
+ */
+#define PERFECT_HASH_LOAD_FACTOR 0.99
+
+/**
+ * Number of seeds tried before giving up on a key set (a seed only fails if a bucket runs out of pilots, or two keys
+ * have the same 64-bit hash)
+ */
+#define PERFECT_HASH_MAX_ATTEMPTS 16
+
+/**
+ * Returned by lookups of keys that were rejected by the fingerprint check
+ */
+#define PERFECT_HASH_NOT_FOUND SIZE_MAX
+
+/**
+ * A minimal perfect hash function maps each key of a fixed set of n keys to a distinct index in [0, n), so values for a
+ * read-only key set can be kept in a plain array and found with exactly one probe (no chains, empty buckets or key
+ * comparisons).
+ *
+ * This is built PTHash style: keys are hashed (murmur3, with a seed that changes if a build attempt fails) into buckets
+ * of about PERFECT_HASH_KEYS_PER_BUCKET keys, with 60% of the keys going to 30% of the buckets. Buckets are placed
+ * largest first, each searching for a 16-bit pilot that moves all of its keys to free slots. Keys are placed in slightly
+ * more slots than there are keys (PERFECT_HASH_LOAD_FACTOR), and the few that land past n are remapped to the free slots
+ * below n. That's about 3.5 bits per key in total.
+ *
+ * Keys that weren't in the set map to an arbitrary index. If fingerprints are enabled (8 or 16 bits per key), lookups
+ * compare the key's fingerprint with the one stored for its index and return PERFECT_HASH_NOT_FOUND on a mismatch,
+ * which rejects all but 1 / 2^bits of absent keys. Callers that need exact answers should still compare the key stored
+ * at the returned index.
+ *
+ * **Example**
+ * ```c
+ * const char* keys[] = {"foo", "bar", "spangle"};
+ * const char* values[] = {"one", "two", "three"};
+ *
+ * perfect_hash ph;
+ * perfect_hash_init(&ph, (const void**)keys, NULL, 3, 8); // String keys, 8-bit fingerprints
+ *
+ * const char* table[3];
+ * for (size_t i = 0; i < 3; ++i) {
+ *     table[perfect_hash_lookup(&ph, keys[i])] = values[i];
+ * }
+ *
+ * assert(strcmp(table[perfect_hash_lookup(&ph, "bar")], "two") == 0);
+ * assert(perfect_hash_lookup(&ph, "baz") == PERFECT_HASH_NOT_FOUND); // Most likely
+ *
+ * perfect_hash_destroy(&ph);
+ * ```
+ */
+typedef struct perfect_hash {
+    /**
+     * Number of keys (indexes are in [0, key_size))
+     */
+    size_t key_size;
+
+    /**
+     * Number of slots keys were placed in (at least key_size)
+     */
+    size_t slot_size;
+
+    /**
+     * Number of buckets
+     */
+    size_t bucket_size;
+
+    /**
+     * Buckets [0, dense_bucket_size) receive 60% of the keys
+     */
+    size_t dense_bucket_size;
+
+    /**
+     * Seed the keys are hashed with
+     */
+    uint32_t seed;
+
+    /**
+     * Pilot for each bucket
+     */
+    uint16_t* pilots;
+
+    /**
+     * Index for each slot in [key_size, slot_size)
+     */
+    uint32_t* remap;
+
+    /**
+     * Fingerprint size in bits (0, 8 or 16)
+     */
+    uint8_t fingerprint_bits;
+
+    /**
+     * Fingerprint for each index (uint8_t or uint16_t), or NULL if fingerprints are disabled
+     */
+    void* fingerprints;
+} perfect_hash;
+
+/**
+ * Build a minimal perfect hash function for a set of distinct keys
+ *
+ * Time complexity: O(n) expected
+ *
+ * @relates perfect_hash
+ * @param[out] ph Perfect hash
+ * @param[in] keys Keys
+ * @param[in] key_lens Key lengths in bytes (or NULL if keys are NUL-terminated strings)
+ * @param[in] n Number of keys (less than 2^32)
+ * @param[in] fingerprint_bits Fingerprint size in bits (0 to disable, 8 or 16)
+ * @return true on success, false on failure (including when keys aren't distinct)
+ */
+bool perfect_hash_init(
+    perfect_hash* ph,
+    const void* const* keys,
+    const size_t* key_lens,
+    size_t n,
+    uint8_t fingerprint_bits
+);
+
+/**
+ * Build a minimal perfect hash function for the keys of a hash table
+ *
+ * The table's keys must be NUL-terminated strings, or binary keys added with hash_table_set_n().
+ *
+ * Time complexity: O(n) expected
+ *
+ * @relates perfect_hash
+ * @param[out] ph Perfect hash
+ * @param[in] ht Hash table
+ * @param[in] fingerprint_bits Fingerprint size in bits (0 to disable, 8 or 16)
+ * @param[out] values_out Array with room for hash_table_size(ht) values, filled so that each value is at its key's index
+ *  (or NULL if not needed)
+ * @return true on success, false on failure
+ */
+bool perfect_hash_init_from_hash_table(
+    perfect_hash* ph,
+    hash_table* ht,
+    uint8_t fingerprint_bits,
+    void** values_out
+);
+
+/**
+ * Look up the index of a binary key
+ *
+ * Time complexity: O(1)
+ *
+ * @relates perfect_hash
+ * @param[in] ph Perfect hash
+ * @param[in] key Pointer to key bytes
+ * @param[in] key_len Key length in bytes
+ * @return Index in [0, n), or PERFECT_HASH_NOT_FOUND if the key was rejected by the fingerprint check (or the set is
+ *  empty)
+ */
+size_t perfect_hash_lookup_n(const perfect_hash* ph, const void* key, size_t key_len);
+
+/**
+ * Look up the index of a NUL-terminated string key
+ *
+ * Time complexity: O(1)
+ *
+ * @relates perfect_hash
+ * @param[in] ph Perfect hash
+ * @param[in] key Key
+ * @return Index in [0, n), or PERFECT_HASH_NOT_FOUND if the key was rejected by the fingerprint check (or the set is
+ *  empty)
+ */
+size_t perfect_hash_lookup(const perfect_hash* ph, const char* key);
+
+/**
+ * Get the number of bytes used by the perfect hash function (pilots, remap table and fingerprints)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates perfect_hash
+ * @param[in] ph Perfect hash
+ * @return Size in bytes
+ */
+size_t perfect_hash_memory_size(const perfect_hash* ph);
+
+/**
+ * Destroy the perfect hash function
+ *
+ * Time complexity: O(1)
+ *
+ * @relates perfect_hash
+ * @param[in,out] ph Perfect hash
+ * @return true on success, false on failure
+ */
+bool perfect_hash_destroy(perfect_hash* ph);
@@ -0,0 +1,166 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scalable_bloom_filter.h"
+#include "../utils/log.h"
+
+/**
+ * Start a new sub-filter, sized for the filter's current capacity and false positive rate
+ *
+ * @param[in,out] sbf Scalable bloom filter
+ * @return true on success, false on failure
+ */
+static bool add_filter(scalable_bloom_filter* sbf) {
+    if (sbf->filter_count == sbf->filters_size) {
+        const size_t filters_size = sbf->filters_size == 0 ? 4 : sbf->filters_size * 2;
+
+        bloom_filter* filters = realloc(sbf->filters, filters_size * sizeof(bloom_filter));
+        if (filters == NULL) {
+            log_perror("realloc() failed");
+            return false;
+        }
+
+        sbf->filters = filters;
+        sbf->filters_size = filters_size;
+    }
+
+    if (!bloom_filter_init_with_fpr(&sbf->filters[sbf->filter_count], sbf->capacity, sbf->filter_fpr)) {
+        return false;
+    }
+
+    ++sbf->filter_count;
+    sbf->count = 0;
+
+    return true;
+}
+
+bool scalable_bloom_filter_init(scalable_bloom_filter* sbf, const size_t initial_capacity, const double fpr) {
+    memset(sbf, 0, sizeof(scalable_bloom_filter));
+
+    if (initial_capacity == 0 || !(fpr > 0 && fpr < 1)) {
+        log_error("invalid scalable bloom filter size: %zu keys with a false positive rate of %f", initial_capacity, fpr);
+        return false;
+    }
+
+    sbf->initial_capacity = initial_capacity;
+    sbf->fpr = fpr;
+    sbf->capacity = initial_capacity;
+    sbf->filter_fpr = fpr * (1 - SCALABLE_BLOOM_FILTER_TIGHTENING); // Sub-filter rates sum to fpr
+
+    if (!add_filter(sbf)) {
+        free(sbf->filters);
+        sbf->filters = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Check if a hashed key is in any sub-filter
+ *
+ * @param[in] sbf Scalable bloom filter
+ * @param[in] hashes h1 and h2 from bloom_filter_hashes() (the same for every sub-filter)
+ * @return true if the key is member, false if not
+ */
+static bool check_hashes(const scalable_bloom_filter* sbf, const uint64_t hashes[2]) {
+    // Newest first, since it's the largest, and holds about half of the keys
+    for (size_t i = sbf->filter_count; i > 0; --i) {
+        if (bloom_filter_check_hashes(&sbf->filters[i - 1], hashes)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool scalable_bloom_filter_add(scalable_bloom_filter* sbf, const uint8_t* key, const size_t key_len) {
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+
+    if (check_hashes(sbf, hashes)) {
+        return true;
+    }
+
+    if (sbf->count >= sbf->capacity) {
+        const size_t capacity = sbf->capacity;
+        const double filter_fpr = sbf->filter_fpr;
+
+        sbf->capacity *= SCALABLE_BLOOM_FILTER_GROWTH;
+        sbf->filter_fpr *= SCALABLE_BLOOM_FILTER_TIGHTENING;
+
+        if (!add_filter(sbf)) {
+            sbf->capacity = capacity;
+            sbf->filter_fpr = filter_fpr;
+            return false;
+        }
+    }
+
+    bloom_filter_add_hashes(&sbf->filters[sbf->filter_count - 1], hashes);
+    ++sbf->count;
+    ++sbf->size;
+
+    return true;
+}
+
+bool scalable_bloom_filter_check(const scalable_bloom_filter* sbf, const uint8_t* key, const size_t key_len) {
+    // Every sub-filter uses the same hashes, so the key is only hashed once
+    uint64_t hashes[2];
+    bloom_filter_hashes(key, key_len, hashes);
+
+    return check_hashes(sbf, hashes);
+}
+
+size_t scalable_bloom_filter_size(const scalable_bloom_filter* sbf) {
+    return sbf->size;
+}
+
+size_t scalable_bloom_filter_bytes(const scalable_bloom_filter* sbf) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < sbf->filter_count; ++i) {
+        bytes += sbf->filters[i].bit_array->size_bits / 8;
+    }
+
+    return bytes;
+}
+
+double scalable_bloom_filter_fpr(const scalable_bloom_filter* sbf) {
+    // 1 - (1 - fpr_1)(1 - fpr_2)..., in log space so tiny rates don't round to 0
+    double log_true_negative = 0;
+    for (size_t i = 0; i < sbf->filter_count; ++i) {
+        log_true_negative += log1p(-bloom_filter_estimated_fpr(&sbf->filters[i]));
+    }
+
+    return -expm1(log_true_negative);
+}
+
+void scalable_bloom_filter_clear(scalable_bloom_filter* sbf) {
+    for (size_t i = 1; i < sbf->filter_count; ++i) {
+        bloom_filter_destroy(&sbf->filters[i]);
+    }
+
+    bloom_filter_clear(&sbf->filters[0]);
+    sbf->filter_count = 1;
+    sbf->capacity = sbf->initial_capacity;
+    sbf->count = 0;
+    sbf->filter_fpr = sbf->fpr * (1 - SCALABLE_BLOOM_FILTER_TIGHTENING);
+    sbf->size = 0;
+}
+
+bool scalable_bloom_filter_destroy(scalable_bloom_filter* sbf) {
+    bool success = true;
+    for (size_t i = 0; i < sbf->filter_count; ++i) {
+        success &= bloom_filter_destroy(&sbf->filters[i]);
+    }
+
+    free(sbf->filters);
+    sbf->filters = nullptr;
+    sbf->filter_count = 0;
+    sbf->filters_size = 0;
+    sbf->count = 0;
+    sbf->size = 0;
+
+    return success;
+}
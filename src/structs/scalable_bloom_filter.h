@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "bloom_filter.h"
+
+/**
+ * Capacity of each sub-filter, relative to the one before it
+ */
+#define SCALABLE_BLOOM_FILTER_GROWTH 2
+
+/**
+ * False positive rate of each sub-filter, relative to the one before it
+ */
+#define SCALABLE_BLOOM_FILTER_TIGHTENING 0.85
+
+/**
+ * A scalable bloom filter is a bloom filter (see bloom_filter) that grows as keys are added, so it doesn't need to know
+ * how many keys there will be up front.
+ * https://gsd.di.uminho.pt/members/cbm/ps/dbloom.pdf
+ *
+ * Keys are added to the newest of a chain of sub-filters, and a new sub-filter is started when the newest one is full.
+ * Each sub-filter has SCALABLE_BLOOM_FILTER_GROWTH times the capacity of the one before it, and a target false positive
+ * rate SCALABLE_BLOOM_FILTER_TIGHTENING times as high. The sub-filter rates add up to a geometric series, so the
+ * compound false positive rate stays below the target no matter how many keys are added:
+ *   fpr * (1 - r) * (1 + r + r^2 + ...) = fpr
+ *
+ * Checking a key looks in every sub-filter, newest (and largest) first, so a lookup costs O(log n) sub-filter checks.
+ * Sizing the first sub-filter for the expected number of keys keeps the chain short.
+ *
+ * Items can't be deleted from a scalable bloom filter.
+ *
+ * **Example**
+ * ```c
+ * scalable_bloom_filter sbf;
+ * scalable_bloom_filter_init(&sbf, 1000, 0.01); // 1% false positives, starting with room for 1000 keys
+ *
+ * for (int i = 0; i < 1000000; ++i) {
+ *     scalable_bloom_filter_add(&sbf, (uint8_t *)&i, sizeof(i)); // Grows as needed
+ * }
+ * assert(scalable_bloom_filter_fpr(&sbf) < 0.01);
+ *
+ * scalable_bloom_filter_destroy(&sbf);
+ * ```
+ */
+typedef struct scalable_bloom_filter {
+    /**
+     * Sub-filters, oldest first
+     */
+    bloom_filter* filters;
+    size_t filter_count;
+
+    /**
+     * Number of sub-filters there's room for in filters
+     */
+    size_t filters_size;
+
+    /**
+     * Number of keys the newest sub-filter was sized for, and the number added to it
+     */
+    size_t capacity;
+    size_t count;
+
+    /**
+     * Target false positive rate of the newest sub-filter
+     */
+    double filter_fpr;
+
+    /**
+     * Number of keys added to all sub-filters
+     */
+    size_t size;
+
+    /**
+     * Initial capacity and compound false positive rate the filter was initialized with
+     */
+    size_t initial_capacity;
+    double fpr;
+} scalable_bloom_filter;
+
+/**
+ * Initialize the scalable bloom filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates scalable_bloom_filter
+ * @param[out] sbf Scalable bloom filter
+ * @param[in] initial_capacity Number of keys the first sub-filter is sized for
+ * @param[in] fpr Target compound false positive rate (between 0 and 1, exclusive)
+ * @return true on success, false on failure
+ */
+bool scalable_bloom_filter_init(scalable_bloom_filter* sbf, size_t initial_capacity, double fpr);
+
+/**
+ * Add a key to the scalable bloom filter, starting a new sub-filter if the newest one is full
+ *
+ * Keys that are already members aren't added again, so duplicates don't use up capacity.
+ *
+ * Time complexity: O(log n) (amortized)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in,out] sbf Scalable bloom filter
+ * @param[in] key Key to add
+ * @param[in] key_len Length of the key
+ * @return true on success, false on failure
+ */
+bool scalable_bloom_filter_add(scalable_bloom_filter* sbf, const uint8_t* key, size_t key_len);
+
+/**
+ * Check if a key is in the scalable bloom filter
+ *
+ * False positives are possible (meaning this can indicate that a key is a member when it's not)
+ * False negatives are impossible (meaning this can't indicate that a key is not a member when it is)
+ *
+ * Time complexity: O(log n)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in] sbf Scalable bloom filter
+ * @param[in] key Key to check
+ * @param[in] key_len Length of the key
+ * @return true if the key is member (false positive possible), false if not (false negative impossible)
+ */
+bool scalable_bloom_filter_check(const scalable_bloom_filter* sbf, const uint8_t* key, size_t key_len);
+
+/**
+ * Get the number of keys in the scalable bloom filter (not counting keys that were already members when added)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in] sbf Scalable bloom filter
+ * @return Number of keys
+ */
+size_t scalable_bloom_filter_size(const scalable_bloom_filter* sbf);
+
+/**
+ * Get the size of all of the scalable bloom filter's sub-filters
+ *
+ * Time complexity: O(log n)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in] sbf Scalable bloom filter
+ * @return Size in bytes
+ */
+size_t scalable_bloom_filter_bytes(const scalable_bloom_filter* sbf);
+
+/**
+ * Estimate the scalable bloom filter's current compound false positive rate
+ *
+ * A key is a false positive if any sub-filter matches it, so this is 1 - (1 - fpr_1)(1 - fpr_2)..., using each
+ * sub-filter's bloom_filter_estimated_fpr().
+ *
+ * Time complexity: O(m)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in] sbf Scalable bloom filter
+ * @return Estimated probability that checking a key that was never added returns true
+ */
+double scalable_bloom_filter_fpr(const scalable_bloom_filter* sbf);
+
+/**
+ * Remove all keys from the scalable bloom filter, shrinking it back to its first sub-filter
+ *
+ * Time complexity: O(m)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in,out] sbf Scalable bloom filter
+ */
+void scalable_bloom_filter_clear(scalable_bloom_filter* sbf);
+
+/**
+ * Destroy the scalable bloom filter
+ *
+ * Time complexity: O(log n)
+ *
+ * @relates scalable_bloom_filter
+ * @param[in,out] sbf Scalable bloom filter
+ * @return true on success, false on failure
+ */
+bool scalable_bloom_filter_destroy(scalable_bloom_filter* sbf);
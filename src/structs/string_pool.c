@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "string_pool.h"
+#include "../utils/log.h"
+
+bool string_pool_init(string_pool* pool, const uint32_t size) {
+    memset(pool, 0, sizeof(string_pool));
+
+    return hash_table_init(&pool->table, size, NULL, NULL);
+}
+
+/**
+ * Get the bytes a string takes up in a block (including its header and NUL terminator, rounded up so the next string's
+ * header is aligned)
+ *
+ * @param[in] len Length of the string in bytes
+ * @return Stored size in bytes
+ */
+static inline size_t stored_size(const size_t len) {
+    const size_t size = sizeof(string_pool_string) + len + 1;
+    return (size + alignof(string_pool_string) - 1) & ~(alignof(string_pool_string) - 1);
+}
+
+/**
+ * Reserve space for a string, starting a new block if the current one is full
+ *
+ * @param[in,out] pool String pool
+ * @param[in] size Stored size of the string
+ * @return Space for the string, or NULL on failure
+ */
+static string_pool_string* reserve_string(string_pool* pool, const size_t size) {
+    string_pool_block* p_block = pool->blocks;
+
+    if (p_block == NULL || p_block->size - p_block->used < size) {
+        const size_t block_size = size > STRING_POOL_BLOCK_SIZE ? size : STRING_POOL_BLOCK_SIZE;
+
+        p_block = malloc(sizeof(string_pool_block) + block_size);
+        if (p_block == NULL) {
+            log_perror("string pool block allocation failed");
+            return nullptr;
+        }
+
+        p_block->used = 0;
+        p_block->size = block_size;
+        pool->bytes += block_size;
+
+        // An oversized string's block goes behind the current one, so the rest of the current one is still used
+        if (block_size > STRING_POOL_BLOCK_SIZE && pool->blocks != NULL) {
+            p_block->next = pool->blocks->next;
+            pool->blocks->next = p_block;
+        }
+        else {
+            p_block->next = pool->blocks;
+            pool->blocks = p_block;
+        }
+    }
+
+    string_pool_string* p_string = (string_pool_string *)(p_block->data + p_block->used);
+    p_block->used += size;
+
+    return p_string;
+}
+
+const char* string_pool_intern_n(string_pool* pool, const char* str, const size_t len) {
+    const char* handle = hash_table_get_n(&pool->table, str, len);
+    if (handle != NULL) {
+        return handle;
+    }
+
+    string_pool_string* p_string = reserve_string(pool, stored_size(len));
+    if (p_string == NULL) {
+        return nullptr;
+    }
+
+    p_string->hash = hash_table_hash_bytes(str, len);
+    p_string->len = len;
+    memcpy(p_string->chars, str, len);
+    p_string->chars[len] = '\0';
+
+    // The table's key is the stored copy, so it stays valid as long as the pool
+    if (!hash_table_set_n(&pool->table, p_string->chars, len, p_string->chars)) {
+        return nullptr; // Its space in the block is wasted, but only until the pool is destroyed
+    }
+
+    return p_string->chars;
+}
+
+const char* string_pool_intern(string_pool* pool, const char* str) {
+    return string_pool_intern_n(pool, str, strlen(str));
+}
+
+const char* string_pool_find(const string_pool* pool, const char* str) {
+    return hash_table_get_n(&pool->table, str, strlen(str));
+}
+
+uint32_t string_pool_key_hash(const void* key, const size_t ht_size) {
+    return string_pool_hash(key) % (ht_size - 1);
+}
+
+int string_pool_key_cmp(const void* a, const void* b) {
+    return (a > b) - (a < b);
+}
+
+size_t string_pool_size(const string_pool* pool) {
+    return hash_table_size(&pool->table);
+}
+
+bool string_pool_destroy(string_pool* pool) {
+    const bool success = hash_table_destroy(&pool->table);
+
+    string_pool_block* p_block = pool->blocks;
+    while (p_block != NULL) {
+        string_pool_block* p_next = p_block->next;
+        free(p_block);
+        p_block = p_next;
+    }
+
+    pool->blocks = nullptr;
+    pool->bytes = 0;
+
+    return success;
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hash_table.h"
+
+/**
+ * Size of each block of string storage (strings that don't fit get a block of their own)
+ */
+#define STRING_POOL_BLOCK_SIZE 65536
+
+/**
+ * Interned string, as it's stored in a block
+ * Handles point to the string's chars, which come right after this header.
+ */
+typedef struct string_pool_string {
+    /**
+     * Full hash of the string (hash_table_hash_bytes() of its chars)
+     */
+    uint32_t hash;
+
+    /**
+     * Length of the string in bytes (not counting the NUL terminator)
+     */
+    size_t len;
+
+    /**
+     * NUL terminated chars
+     */
+    char chars[];
+} string_pool_string;
+
+/**
+ * Block of string storage
+ */
+typedef struct string_pool_block {
+    struct string_pool_block* next;
+
+    /**
+     * Bytes used in data, and its size
+     */
+    size_t used;
+    size_t size;
+
+    /**
+     * Storage for strings
+     */
+    alignas(string_pool_string) char data[];
+} string_pool_block;
+
+/**
+ * A string pool interns strings: it stores one copy of each distinct string, along with its length and hash, and hands
+ * out a handle for it. Interning equal strings always gives the same handle, so handles can be compared by pointer.
+ *
+ * Handles are plain NUL terminated C strings, and stay valid (and unchanged) until the pool is destroyed. Strings are
+ * copied into large blocks of storage, so interning a new string doesn't usually call the allocator, and strings are
+ * never freed one at a time.
+ *
+ * A hash_table keyed by handles can use string_pool_key_hash() and string_pool_key_cmp(), which read the stored hash
+ * and compare pointers, instead of hashing and comparing the chars on every lookup.
+ *
+ * String pools aren't thread safe.
+ *
+ * **Example**
+ * ```c
+ * string_pool pool;
+ * string_pool_init(&pool, 1024);
+ *
+ * hash_table ht;
+ * hash_table_init(&ht, 1024, string_pool_key_cmp, string_pool_key_hash);
+ *
+ * hash_table_set(&ht, (void *)string_pool_intern(&pool, "foo"), "bar");
+ *
+ * char buf[] = "foo"; // A different copy of "foo"
+ * const char* key = string_pool_intern(&pool, buf); // Same handle as before
+ * hash_table_get(&ht, key); // "bar" (no strlen, murmur3 or strcmp)
+ *
+ * hash_table_destroy(&ht);
+ * string_pool_destroy(&pool); // Handles are invalid after this
+ * ```
+ */
+typedef struct string_pool {
+    /**
+     * String chars -> handle (binary keys, so strings don't need to be NUL terminated to be looked up)
+     */
+    hash_table table;
+
+    /**
+     * Storage blocks (newest first, which is the one new strings go in)
+     */
+    string_pool_block* blocks;
+
+    /**
+     * Total bytes of string storage allocated
+     */
+    size_t bytes;
+} string_pool;
+
+/**
+ * Initialize the string pool
+ *
+ * Time complexity: O(n)
+ *
+ * @relates string_pool
+ * @param[out] pool String pool
+ * @param[in] size Initial hash table index size (ideally about the number of distinct strings)
+ * @return true on success, false on failure
+ */
+bool string_pool_init(string_pool* pool, uint32_t size);
+
+/**
+ * Intern a NUL terminated string
+ *
+ * Time complexity: O(len)
+ *
+ * @relates string_pool
+ * @param[in,out] pool String pool
+ * @param[in] str String to intern (copied if it's not in the pool yet)
+ * @return Handle for the string (valid until the pool is destroyed), or NULL on failure
+ */
+const char* string_pool_intern(string_pool* pool, const char* str);
+
+/**
+ * Intern a string with a known length (which doesn't need to be NUL terminated, or can contain NULs)
+ * {@see string_pool_intern}
+ *
+ * Time complexity: O(len)
+ *
+ * @relates string_pool
+ * @param[in,out] pool String pool
+ * @param[in] str String to intern (copied if it's not in the pool yet)
+ * @param[in] len Length of the string in bytes
+ * @return Handle for the string (valid until the pool is destroyed), or NULL on failure
+ */
+const char* string_pool_intern_n(string_pool* pool, const char* str, size_t len);
+
+/**
+ * Get the handle for a string that's already interned, without interning it
+ *
+ * Time complexity: O(len)
+ *
+ * @relates string_pool
+ * @param[in] pool String pool
+ * @param[in] str NUL terminated string to find
+ * @return Handle for the string, or NULL if it's not in the pool
+ */
+const char* string_pool_find(const string_pool* pool, const char* str);
+
+/**
+ * Get the stored header of a handle
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] handle Handle from string_pool_intern()
+ * @return Stored string
+ */
+static inline const string_pool_string* string_pool_header(const char* handle) {
+    return (const string_pool_string *)(handle - offsetof(string_pool_string, chars));
+}
+
+/**
+ * Get the length of an interned string, without strlen()
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] handle Handle from string_pool_intern()
+ * @return Length in bytes
+ */
+static inline size_t string_pool_len(const char* handle) {
+    return string_pool_header(handle)->len;
+}
+
+/**
+ * Get the hash of an interned string, without hashing it
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] handle Handle from string_pool_intern()
+ * @return Full hash (the same as hash_table_hash_bytes() of the string's chars)
+ */
+static inline uint32_t string_pool_hash(const char* handle) {
+    return string_pool_header(handle)->hash;
+}
+
+/**
+ * Hash table key hash function for handles (reads the stored hash)
+ * {@see hash_table_key_hash_func}
+ */
+uint32_t string_pool_key_hash(const void* key, size_t ht_size);
+
+/**
+ * Hash table key comparator for handles (compares pointers)
+ * Only handles from the same pool can be compared, and they're only ordered by address.
+ * {@see value_cmp_func}
+ */
+int string_pool_key_cmp(const void* a, const void* b);
+
+/**
+ * Get the number of distinct strings in the pool
+ *
+ * Time complexity: O(1)
+ *
+ * @relates string_pool
+ * @param[in] pool String pool
+ * @return Number of strings
+ */
+size_t string_pool_size(const string_pool* pool);
+
+/**
+ * Destroy the string pool, freeing every string in it (which invalidates all of its handles)
+ *
+ * Time complexity: O(n)
+ *
+ * @relates string_pool
+ * @param[in,out] pool String pool
+ * @return true on success, false on failure
+ */
+bool string_pool_destroy(string_pool* pool);
@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tinylfu_cache.h"
+#include "../utils/log.h"
+
+bool tinylfu_cache_init(
+    tinylfu_cache* cache,
+    const size_t max_entries,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(cache, 0, sizeof(tinylfu_cache));
+
+    if (max_entries == 0 || max_entries >= UINT32_MAX) {
+        log_error("W-TinyLFU cache size must be between 1 and %u entries", UINT32_MAX - 1);
+        return false;
+    }
+
+    cache->max_entries = max_entries;
+    cache->window_max = max_entries * TINYLFU_CACHE_WINDOW_PERCENT / 100;
+    if (cache->window_max == 0) {
+        cache->window_max = 1;
+    }
+    cache->protected_max = (max_entries - cache->window_max) * TINYLFU_CACHE_PROTECTED_PERCENT / 100;
+    cache->sample_size = max_entries * TINYLFU_CACHE_SAMPLE_FACTOR;
+
+    if (!hash_table_init(&cache->table, max_entries, key_cmp, key_hash)) {
+        return false;
+    }
+
+    if (!mem_pool_init(&cache->entry_pool, sizeof(tinylfu_cache_entry), NULL)) {
+        hash_table_destroy(&cache->table);
+        return false;
+    }
+
+    if (!count_min_sketch_init(&cache->sketch, max_entries)) {
+        mem_pool_destroy(&cache->entry_pool);
+        hash_table_destroy(&cache->table);
+        return false;
+    }
+
+    // One bit per lookup in a sample keeps doorkeeper false positives low, since most lookups are repeats
+    if (!bloom_filter_init(&cache->doorkeeper, cache->sample_size)) {
+        count_min_sketch_destroy(&cache->sketch);
+        mem_pool_destroy(&cache->entry_pool);
+        hash_table_destroy(&cache->table);
+        return false;
+    }
+
+    linked_list_init(&cache->window);
+    linked_list_init(&cache->probation);
+    linked_list_init(&cache->protected);
+
+    return true;
+}
+
+void tinylfu_cache_set_evict_func(tinylfu_cache* cache, const lru_cache_evict_func evict_func, void* evict_user_arg) {
+    cache->evict_func = evict_func;
+    cache->evict_user_arg = evict_user_arg;
+}
+
+/**
+ * Get the full hash of a key
+ *
+ * @param[in] cache W-TinyLFU cache
+ * @param[in] key Key to hash
+ * @return Full hash
+ */
+static inline uint32_t key_full_hash(const tinylfu_cache* cache, const void* key) {
+    return cache->table.key_hash(key, SIZE_MAX);
+}
+
+/**
+ * Estimate the lookup frequency of a key hash
+ *
+ * @param[in] cache W-TinyLFU cache
+ * @param[in] hash Full hash of the key
+ * @return Estimated frequency
+ */
+static uint8_t hash_frequency(const tinylfu_cache* cache, const uint32_t hash) {
+    const uint8_t* key = (const uint8_t *)&hash;
+
+    return count_min_sketch_estimate(&cache->sketch, key, sizeof(hash)) +
+           bloom_filter_check(&cache->doorkeeper, key, sizeof(hash));
+}
+
+/**
+ * Count a lookup of a key hash, and age all frequencies at the end of each sample
+ *
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] hash Full hash of the key
+ */
+static void record_lookup(tinylfu_cache* cache, const uint32_t hash) {
+    const uint8_t* key = (const uint8_t *)&hash;
+
+    // The first lookup only goes into the doorkeeper, so one-off keys don't take up sketch counters
+    if (bloom_filter_check(&cache->doorkeeper, key, sizeof(hash))) {
+        count_min_sketch_increment(&cache->sketch, key, sizeof(hash));
+    }
+    else {
+        bloom_filter_add(&cache->doorkeeper, key, sizeof(hash));
+    }
+
+    if (++cache->sample_count >= cache->sample_size) {
+        count_min_sketch_halve(&cache->sketch);
+        bloom_filter_clear(&cache->doorkeeper);
+        cache->sample_count = 0;
+    }
+}
+
+/**
+ * Get the recency list of a region
+ *
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] region Region
+ * @return Recency list
+ */
+static inline linked_list* region_list(tinylfu_cache* cache, const tinylfu_cache_region region) {
+    switch (region) {
+        case TINYLFU_CACHE_REGION_WINDOW:
+            return &cache->window;
+        case TINYLFU_CACHE_REGION_PROBATION:
+            return &cache->probation;
+        default:
+            return &cache->protected;
+    }
+}
+
+/**
+ * Move an entry to the front of another region
+ *
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in,out] entry Entry to move
+ * @param[in] region Region to move the entry to
+ */
+static inline void move_entry(tinylfu_cache* cache, tinylfu_cache_entry* entry, const tinylfu_cache_region region) {
+    linked_list_unlink(region_list(cache, entry->region), &entry->node);
+    linked_list_link_head(region_list(cache, region), &entry->node);
+    entry->region = region;
+}
+
+/**
+ * Remove an entry from the table and its region, and free it
+ *
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] entry Entry to remove
+ * @param[in] evicted Call the eviction callback
+ */
+static void remove_entry(tinylfu_cache* cache, tinylfu_cache_entry* entry, const bool evicted) {
+    void* key = entry->key;
+    void* value = entry->value;
+
+    hash_table_del(&cache->table, key);
+    linked_list_unlink(region_list(cache, entry->region), &entry->node);
+    mem_pool_free(&cache->entry_pool, entry);
+
+    if (evicted && cache->evict_func != NULL) {
+        cache->evict_func(key, value, cache->evict_user_arg);
+    }
+}
+
+/**
+ * Mark an entry as used
+ * Hits on probation promote the entry to the protected segment, which demotes its least recently used entries back
+ * to probation if it's full.
+ *
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in,out] entry Entry that was used
+ */
+static void touch_entry(tinylfu_cache* cache, tinylfu_cache_entry* entry) {
+    switch (entry->region) {
+        case TINYLFU_CACHE_REGION_WINDOW:
+            linked_list_move_to_head(&cache->window, &entry->node);
+            break;
+
+        case TINYLFU_CACHE_REGION_PROBATION:
+            move_entry(cache, entry, TINYLFU_CACHE_REGION_PROTECTED);
+            while (cache->protected.size > cache->protected_max) {
+                move_entry(cache, cache->protected.tail->value, TINYLFU_CACHE_REGION_PROBATION);
+            }
+            break;
+
+        case TINYLFU_CACHE_REGION_PROTECTED:
+            linked_list_move_to_head(&cache->protected, &entry->node);
+            break;
+    }
+}
+
+/**
+ * Move the least recently used entry out of the admission window, and either admit it to the main region or evict it
+ *
+ * @param[in,out] cache W-TinyLFU cache
+ */
+static void admit_from_window(tinylfu_cache* cache) {
+    tinylfu_cache_entry* p_candidate = cache->window.tail->value;
+
+    const size_t main_size = cache->probation.size + cache->protected.size;
+    if (main_size < cache->max_entries - cache->window_max) {
+        move_entry(cache, p_candidate, TINYLFU_CACHE_REGION_PROBATION);
+        return;
+    }
+
+    // The main region is full: the victim is its least recently used entry on probation (or protected, if none are)
+    const list_node* p_victim_node = cache->probation.tail != NULL ? cache->probation.tail : cache->protected.tail;
+    if (p_victim_node == NULL) {
+        remove_entry(cache, p_candidate, true); // No main region (capacity of 1)
+        return;
+    }
+
+    tinylfu_cache_entry* p_victim = p_victim_node->value;
+
+    // Ties go to the victim, so a scan of keys with no history can't displace anything
+    if (hash_frequency(cache, p_candidate->hash) > hash_frequency(cache, p_victim->hash)) {
+        remove_entry(cache, p_victim, true);
+        move_entry(cache, p_candidate, TINYLFU_CACHE_REGION_PROBATION);
+    }
+    else {
+        remove_entry(cache, p_candidate, true);
+    }
+}
+
+bool tinylfu_cache_put(tinylfu_cache* cache, void* key, void* value) {
+    tinylfu_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    if (p_entry != NULL) {
+        // Replace existing entry
+        p_entry->value = value;
+        touch_entry(cache, p_entry);
+        return true;
+    }
+
+    p_entry = mem_pool_alloc(&cache->entry_pool);
+    if (p_entry == NULL) {
+        log_error("W-TinyLFU cache entry allocation failed");
+        return false;
+    }
+
+    p_entry->node.value = p_entry;
+    p_entry->key = key;
+    p_entry->value = value;
+    p_entry->hash = key_full_hash(cache, key);
+    p_entry->region = TINYLFU_CACHE_REGION_WINDOW;
+
+    if (!hash_table_set(&cache->table, key, p_entry)) {
+        mem_pool_free(&cache->entry_pool, p_entry);
+        return false;
+    }
+
+    linked_list_link_head(&cache->window, &p_entry->node);
+
+    if (cache->window.size > cache->window_max) {
+        admit_from_window(cache);
+    }
+
+    return true;
+}
+
+void* tinylfu_cache_get(tinylfu_cache* cache, const void* key) {
+    record_lookup(cache, key_full_hash(cache, key));
+
+    tinylfu_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
+
+    touch_entry(cache, p_entry);
+
+    return p_entry->value;
+}
+
+uint8_t tinylfu_cache_frequency(const tinylfu_cache* cache, const void* key) {
+    return hash_frequency(cache, key_full_hash(cache, key));
+}
+
+bool tinylfu_cache_del(tinylfu_cache* cache, const void* key) {
+    tinylfu_cache_entry* p_entry = hash_table_get(&cache->table, key);
+    if (p_entry == NULL) {
+        return false;
+    }
+
+    remove_entry(cache, p_entry, false);
+
+    return true;
+}
+
+size_t tinylfu_cache_size(const tinylfu_cache* cache) {
+    return cache->window.size + cache->probation.size + cache->protected.size;
+}
+
+bool tinylfu_cache_destroy(tinylfu_cache* cache) {
+    // Entries are all freed with their pool, so the lists only need to be forgotten
+    linked_list_init(&cache->window);
+    linked_list_init(&cache->probation);
+    linked_list_init(&cache->protected);
+
+    bool success = hash_table_destroy(&cache->table);
+    success = mem_pool_destroy(&cache->entry_pool) && success;
+    success = count_min_sketch_destroy(&cache->sketch) && success;
+    success = bloom_filter_destroy(&cache->doorkeeper) && success;
+
+    return success;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "bloom_filter.h"
+#include "count_min_sketch.h"
+#include "hash_table.h"
+#include "linked_list.h"
+#include "lru_cache.h"
+#include "../utils/mem_pool.h"
+#include "../utils/value.h"
+
+/**
+ * Percentage of the capacity used for the admission window (at least 1 entry)
+ */
+#define TINYLFU_CACHE_WINDOW_PERCENT 1
+
+/**
+ * Percentage of the main region used for the protected segment
+ */
+#define TINYLFU_CACHE_PROTECTED_PERCENT 80
+
+/**
+ * Number of lookups (as a multiple of the capacity) after which all frequencies are halved
+ */
+#define TINYLFU_CACHE_SAMPLE_FACTOR 10
+
+/**
+ * Region of the cache that an entry is in
+ */
+typedef enum tinylfu_cache_region {
+    /**
+     * Admission window (LRU), where every new entry starts
+     */
+    TINYLFU_CACHE_REGION_WINDOW,
+
+    /**
+     * Main region, probationary segment: entries admitted from the window, that haven't been hit since
+     */
+    TINYLFU_CACHE_REGION_PROBATION,
+
+    /**
+     * Main region, protected segment: entries that were hit while on probation
+     */
+    TINYLFU_CACHE_REGION_PROTECTED,
+} tinylfu_cache_region;
+
+/**
+ * W-TinyLFU cache entry
+ */
+typedef struct tinylfu_cache_entry {
+    /**
+     * Node in its region's recency list (value points back to this entry)
+     */
+    list_node node;
+
+    void* key;
+    void* value;
+
+    /**
+     * Full hash of the key (used for frequency estimates)
+     */
+    uint32_t hash;
+
+    tinylfu_cache_region region;
+} tinylfu_cache_entry;
+
+/**
+ * A W-TinyLFU cache is a bounded key/value cache that only keeps new entries if they're likely to be used more often
+ * than the entries they'd replace. Unlike lru_cache, a burst of one-off keys (like a full scan) can't flush out the
+ * popular entries.
+ *
+ * New entries go into a small LRU admission window, so bursts of recent keys still get hits. When an entry falls out of
+ * the window, it competes with the main region's eviction victim, and whichever has been looked up more often stays.
+ * The main region is a segmented LRU: admitted entries start on probation, and move to the protected segment if they
+ * get hit again.
+ *
+ * Lookup frequencies are estimated with a 4-bit count-min sketch, behind a bloom_filter "doorkeeper" that absorbs keys
+ * that were only seen once, so they don't take up sketch counters. Every TINYLFU_CACHE_SAMPLE_FACTOR * capacity lookups,
+ * the sketch is halved and the doorkeeper is cleared, so frequencies follow changes in popularity.
+ *
+ * Frequencies are counted by tinylfu_cache_get() (hits and misses), so keys should be looked up before they're put.
+ *
+ * Keys and values aren't copied or freed by the cache.
+ *
+ * **Example**
+ * ```c
+ * tinylfu_cache cache;
+ * tinylfu_cache_init(&cache, 1000, NULL, NULL); // At most 1000 entries, string keys
+ *
+ * if (tinylfu_cache_get(&cache, "foo") == NULL) {
+ *     tinylfu_cache_put(&cache, "foo", "one");
+ * }
+ *
+ * tinylfu_cache_destroy(&cache);
+ * ```
+ */
+typedef struct tinylfu_cache {
+    /**
+     * Key -> tinylfu_cache_entry
+     */
+    hash_table table;
+
+    /**
+     * Recency lists for each region (most recently used first)
+     */
+    linked_list window;
+    linked_list probation;
+    linked_list protected;
+
+    /**
+     * Entry pool
+     */
+    mem_pool entry_pool;
+
+    /**
+     * Lookup frequency estimates
+     */
+    count_min_sketch sketch;
+
+    /**
+     * Keys that were looked up since the last reset (keys seen once are only counted here)
+     */
+    bloom_filter doorkeeper;
+
+    /**
+     * Max number of entries
+     */
+    size_t max_entries;
+
+    /**
+     * Max number of entries in the admission window
+     */
+    size_t window_max;
+
+    /**
+     * Max number of entries in the protected segment
+     */
+    size_t protected_max;
+
+    /**
+     * Number of lookups between frequency resets
+     */
+    size_t sample_size;
+
+    /**
+     * Number of lookups since the last frequency reset
+     */
+    size_t sample_count;
+
+    /**
+     * Eviction callback (or NULL)
+     */
+    lru_cache_evict_func evict_func;
+    void* evict_user_arg;
+} tinylfu_cache;
+
+/**
+ * Initialize the W-TinyLFU cache
+ *
+ * Time complexity: O(n)
+ *
+ * @relates tinylfu_cache
+ * @param[out] cache W-TinyLFU cache
+ * @param[in] max_entries Max number of entries (must be at least 1)
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default). This is also called with ht_size set to SIZE_MAX to
+ *   get the full hash for frequency estimates.
+ * @return true on success, false on failure
+ */
+bool tinylfu_cache_init(
+    tinylfu_cache* cache,
+    size_t max_entries,
+    value_cmp_func key_cmp,
+    hash_table_key_hash_func key_hash
+);
+
+/**
+ * Set the eviction callback
+ *
+ * Time complexity: O(1)
+ *
+ * @relates tinylfu_cache
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] evict_func Called with each entry that's evicted, or that isn't admitted (or NULL)
+ * @param evict_user_arg Optional argument to pass to the eviction callback
+ */
+void tinylfu_cache_set_evict_func(tinylfu_cache* cache, lru_cache_evict_func evict_func, void* evict_user_arg);
+
+/**
+ * Insert or replace an entry in the W-TinyLFU cache
+ *
+ * New entries go into the admission window. If that pushes an older entry out of the window, either it or the main
+ * region's eviction victim is evicted (calling the eviction callback), so a put can evict the entry it inserts later on.
+ * Replacing an entry doesn't call the eviction callback for the old value.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates tinylfu_cache
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] key Pointer to key
+ * @param[in] value Pointer to value
+ * @return true on success, false on failure
+ */
+bool tinylfu_cache_put(tinylfu_cache* cache, void* key, void* value);
+
+/**
+ * Get a value from the W-TinyLFU cache, counting the lookup towards the key's frequency (even if it's not found)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates tinylfu_cache
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] key Key to get value for
+ * @return Value pointer, or NULL if not found
+ */
+void* tinylfu_cache_get(tinylfu_cache* cache, const void* key);
+
+/**
+ * Estimate how many times a key was looked up recently
+ *
+ * Time complexity: O(1)
+ *
+ * @relates tinylfu_cache
+ * @param[in] cache W-TinyLFU cache
+ * @param[in] key Key to estimate
+ * @return Estimated frequency (never less than the real count since the last reset, up to COUNT_MIN_SKETCH_MAX_COUNT + 1)
+ */
+uint8_t tinylfu_cache_frequency(const tinylfu_cache* cache, const void* key);
+
+/**
+ * Delete an entry from the W-TinyLFU cache (without calling the eviction callback)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates tinylfu_cache
+ * @param[in,out] cache W-TinyLFU cache
+ * @param[in] key Key to delete
+ * @return true on success, false if not found
+ */
+bool tinylfu_cache_del(tinylfu_cache* cache, const void* key);
+
+/**
+ * Get the number of entries in the W-TinyLFU cache
+ *
+ * Time complexity: O(1)
+ *
+ * @relates tinylfu_cache
+ * @param[in] cache W-TinyLFU cache
+ * @return Number of entries
+ */
+size_t tinylfu_cache_size(const tinylfu_cache* cache);
+
+/**
+ * Destroy the W-TinyLFU cache (without calling the eviction callback)
+ *
+ * Time complexity: O(n)
+ *
+ * @relates tinylfu_cache
+ * @param[in,out] cache W-TinyLFU cache
+ * @return true on success, false on failure
+ */
+bool tinylfu_cache_destroy(tinylfu_cache* cache);
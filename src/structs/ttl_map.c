@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ttl_map.h"
+#include "array_list.h"
+#include "../utils/log.h"
+
+/**
+ * Default clock function (CLOCK_MONOTONIC)
+ * {@see ttl_map_clock_func}
+ */
+static uint64_t monotonic_clock_ms(void* _user_arg) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+ * Compare timers by expiry time
+ * {@see value_cmp_func}
+ */
+static int timer_cmp(const void* a, const void* b) {
+    const uint64_t a_expires_at = ((const ttl_map_timer *)a)->expires_at;
+    const uint64_t b_expires_at = ((const ttl_map_timer *)b)->expires_at;
+    return (a_expires_at > b_expires_at) - (a_expires_at < b_expires_at);
+}
+
+bool ttl_map_init(
+    ttl_map* map,
+    const uint32_t size,
+    const value_cmp_func key_cmp,
+    const hash_table_key_hash_func key_hash
+) {
+    memset(map, 0, sizeof(ttl_map));
+
+    if (!hash_table_init(&map->table, size, key_cmp, key_hash)) {
+        return false;
+    }
+
+    if (!heap_init(&map->timers, MIN_HEAP, timer_cmp, size)) {
+        hash_table_destroy(&map->table);
+        return false;
+    }
+
+    if (
+        !mem_pool_init(&map->entry_pool, sizeof(ttl_map_entry), NULL) ||
+        !mem_pool_init(&map->timer_pool, sizeof(ttl_map_timer), NULL)
+    ) {
+        mem_pool_destroy(&map->entry_pool);
+        heap_destroy(&map->timers);
+        hash_table_destroy(&map->table);
+        return false;
+    }
+
+    map->clock_func = monotonic_clock_ms;
+
+    return true;
+}
+
+void ttl_map_set_clock_func(ttl_map* map, const ttl_map_clock_func clock_func, void* clock_user_arg) {
+    map->clock_func = clock_func == NULL ? monotonic_clock_ms : clock_func;
+    map->clock_user_arg = clock_user_arg;
+}
+
+void ttl_map_set_expire_func(ttl_map* map, const ttl_map_expire_func expire_func, void* expire_user_arg) {
+    map->expire_func = expire_func;
+    map->expire_user_arg = expire_user_arg;
+}
+
+/**
+ * Get the current time
+ *
+ * @param[in] map TTL map
+ * @return Current time in milliseconds
+ */
+static inline uint64_t now_ms(const ttl_map* map) {
+    return map->clock_func(map->clock_user_arg);
+}
+
+/**
+ * Check if an entry has expired
+ *
+ * @param[in] entry Entry to check
+ * @param[in] now Current time in milliseconds
+ * @return true if expired
+ */
+static inline bool is_expired(const ttl_map_entry* entry, const uint64_t now) {
+    return entry->timer != NULL && entry->expires_at <= now;
+}
+
+/**
+ * Rebuild the expiry heap without its stale timers
+ *
+ * @param[in,out] map TTL map
+ * @return true on success, false on failure
+ */
+static bool compact_timers(ttl_map* map) {
+    heap timers;
+    if (!heap_init(&timers, MIN_HEAP, timer_cmp, map->timers.size - map->stale_timers + 1)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < map->timers.size; ++i) {
+        ttl_map_timer* p_timer = array_list_get_at(map->timers.heap_array, i);
+        if (p_timer->entry != NULL && !heap_push(&timers, p_timer)) {
+            heap_destroy(&timers);
+            return false;
+        }
+    }
+
+    // Only free stale timers once nothing can fail, so the old heap stays usable until then
+    for (size_t i = 0; i < map->timers.size; ++i) {
+        ttl_map_timer* p_timer = array_list_get_at(map->timers.heap_array, i);
+        if (p_timer->entry == NULL) {
+            mem_pool_free(&map->timer_pool, p_timer);
+        }
+    }
+
+    heap_destroy(&map->timers);
+    map->timers = timers;
+    map->stale_timers = 0;
+
+    return true;
+}
+
+/**
+ * Mark an entry's timer as stale (if it has one), compacting the expiry heap if it's mostly stale timers
+ *
+ * @param[in,out] map TTL map
+ * @param[in,out] entry Entry to clear the timer of
+ */
+static void clear_timer(ttl_map* map, ttl_map_entry* entry) {
+    if (entry->timer == NULL) {
+        return;
+    }
+
+    entry->timer->entry = nullptr;
+    entry->timer = nullptr;
+    ++map->stale_timers;
+
+    if (map->stale_timers >= TTL_MAP_MIN_COMPACT_TIMERS && map->stale_timers > map->timers.size / 2) {
+        if (!compact_timers(map)) {
+            log_error("failed to compact TTL map timers");
+        }
+    }
+}
+
+/**
+ * Give an entry a new expiry time
+ *
+ * @param[in,out] map TTL map
+ * @param[in,out] entry Entry to set the timer of
+ * @param[in] ttl_ms Time to live in milliseconds from now, or 0 to never expire
+ * @return true on success, false on failure (the entry keeps its old expiry time)
+ */
+static bool set_timer(ttl_map* map, ttl_map_entry* entry, const uint64_t ttl_ms) {
+    if (ttl_ms == 0) {
+        clear_timer(map, entry);
+        return true;
+    }
+
+    ttl_map_timer* p_timer = mem_pool_alloc(&map->timer_pool);
+    if (p_timer == NULL) {
+        log_error("TTL map timer allocation failed");
+        return false;
+    }
+
+    p_timer->expires_at = now_ms(map) + ttl_ms;
+    p_timer->entry = entry;
+
+    if (!heap_push(&map->timers, p_timer)) {
+        mem_pool_free(&map->timer_pool, p_timer);
+        return false;
+    }
+
+    // Only drop the old timer once the new one is in the heap, so nothing is lost if that fails
+    clear_timer(map, entry);
+    entry->expires_at = p_timer->expires_at;
+    entry->timer = p_timer;
+
+    return true;
+}
+
+/**
+ * Remove an entry from the map, and free it
+ *
+ * @param[in,out] map TTL map
+ * @param[in] entry Entry to remove
+ * @param[in] expired Call the expiry callback
+ */
+static void remove_entry(ttl_map* map, ttl_map_entry* entry, const bool expired) {
+    void* key = entry->key;
+    void* value = entry->value;
+
+    clear_timer(map, entry);
+    hash_table_del(&map->table, key);
+    mem_pool_free(&map->entry_pool, entry);
+
+    if (expired && map->expire_func != NULL) {
+        map->expire_func(key, value, map->expire_user_arg);
+    }
+}
+
+/**
+ * Find a live entry, removing it if it has expired
+ *
+ * @param[in,out] map TTL map
+ * @param[in] key Key to find
+ * @return Entry, or NULL if not found or expired
+ */
+static ttl_map_entry* find_entry(ttl_map* map, const void* key) {
+    ttl_map_entry* p_entry = hash_table_get(&map->table, key);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
+
+    if (is_expired(p_entry, now_ms(map))) {
+        remove_entry(map, p_entry, true);
+        return nullptr;
+    }
+
+    return p_entry;
+}
+
+bool ttl_map_set(ttl_map* map, void* key, void* value, const uint64_t ttl_ms) {
+    ttl_map_entry* p_entry = hash_table_get(&map->table, key);
+    if (p_entry != NULL) {
+        // Replace existing entry (even if it expired, since it's being given a new TTL anyway). The value is only
+        // replaced once the new timer is set, so a failure leaves the entry as it was.
+        if (!set_timer(map, p_entry, ttl_ms)) {
+            return false;
+        }
+
+        p_entry->value = value;
+        return true;
+    }
+
+    p_entry = mem_pool_alloc(&map->entry_pool);
+    if (p_entry == NULL) {
+        log_error("TTL map entry allocation failed");
+        return false;
+    }
+
+    p_entry->key = key;
+    p_entry->value = value;
+    p_entry->expires_at = 0;
+    p_entry->timer = nullptr;
+
+    if (!set_timer(map, p_entry, ttl_ms)) {
+        mem_pool_free(&map->entry_pool, p_entry);
+        return false;
+    }
+
+    if (!hash_table_set(&map->table, key, p_entry)) {
+        clear_timer(map, p_entry);
+        mem_pool_free(&map->entry_pool, p_entry);
+        return false;
+    }
+
+    return true;
+}
+
+void* ttl_map_get(ttl_map* map, const void* key) {
+    const ttl_map_entry* p_entry = find_entry(map, key);
+    if (p_entry == NULL) {
+        return nullptr;
+    }
+
+    return p_entry->value;
+}
+
+bool ttl_map_expire(ttl_map* map, const void* key, const uint64_t ttl_ms) {
+    ttl_map_entry* p_entry = find_entry(map, key);
+    if (p_entry == NULL) {
+        return false;
+    }
+
+    return set_timer(map, p_entry, ttl_ms);
+}
+
+int64_t ttl_map_ttl(ttl_map* map, const void* key) {
+    const ttl_map_entry* p_entry = find_entry(map, key);
+    if (p_entry == NULL) {
+        return -1;
+    }
+
+    if (p_entry->timer == NULL) {
+        return 0;
+    }
+
+    return (int64_t)(p_entry->expires_at - now_ms(map));
+}
+
+bool ttl_map_del(ttl_map* map, const void* key) {
+    ttl_map_entry* p_entry = hash_table_get(&map->table, key);
+    if (p_entry == NULL) {
+        return false;
+    }
+
+    remove_entry(map, p_entry, false);
+
+    return true;
+}
+
+size_t ttl_map_expire_step(ttl_map* map, const size_t budget) {
+    const uint64_t now = now_ms(map);
+    size_t expired = 0;
+
+    for (size_t i = 0; i < budget && map->timers.size > 0; ++i) {
+        ttl_map_timer* p_timer = heap_peek(&map->timers);
+        if (p_timer->expires_at > now) {
+            break; // Nothing else has expired yet
+        }
+
+        heap_pop(&map->timers);
+
+        if (p_timer->entry == NULL) {
+            --map->stale_timers;
+        }
+        else {
+            p_timer->entry->timer = nullptr; // Already out of the heap
+            remove_entry(map, p_timer->entry, true);
+            ++expired;
+        }
+
+        mem_pool_free(&map->timer_pool, p_timer);
+    }
+
+    return expired;
+}
+
+size_t ttl_map_size(const ttl_map* map) {
+    return hash_table_size(&map->table);
+}
+
+bool ttl_map_destroy(ttl_map* map) {
+    // Entries and timers are all freed with their pools
+    bool success = hash_table_destroy(&map->table);
+    success = heap_destroy(&map->timers) && success;
+    success = mem_pool_destroy(&map->entry_pool) && success;
+    success = mem_pool_destroy(&map->timer_pool) && success;
+
+    map->stale_timers = 0;
+
+    return success;
+}
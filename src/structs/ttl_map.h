@@ -0,0 +1,275 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hash_table.h"
+#include "heap.h"
+#include "../utils/mem_pool.h"
+#include "../utils/value.h"
+
+/**
+ * Min number of stale timers before the expiry heap is compacted
+ */
+#define TTL_MAP_MIN_COMPACT_TIMERS 64
+
+/**
+ * Clock function
+ *
+ * @param user_arg Optional user arg
+ * @return Current time in milliseconds (only differences between times matter)
+ */
+typedef uint64_t (*ttl_map_clock_func)(void* user_arg);
+
+/**
+ * Expiry callback function, called when an expired entry is removed from the map
+ *
+ * @param[in] key Expired entry's key
+ * @param[in] value Expired entry's value
+ * @param user_arg Optional user arg
+ */
+typedef void (*ttl_map_expire_func)(void* key, void* value, void* user_arg);
+
+struct ttl_map_timer;
+
+/**
+ * TTL map entry
+ */
+typedef struct ttl_map_entry {
+    void* key;
+    void* value;
+
+    /**
+     * Time the entry expires at (in clock milliseconds)
+     */
+    uint64_t expires_at;
+
+    /**
+     * Entry's timer in the expiry heap, or NULL if the entry never expires
+     */
+    struct ttl_map_timer* timer;
+} ttl_map_entry;
+
+/**
+ * Expiry heap timer
+ */
+typedef struct ttl_map_timer {
+    /**
+     * Time the timer fires at (in clock milliseconds)
+     */
+    uint64_t expires_at;
+
+    /**
+     * Entry to expire, or NULL if the entry was deleted or given a new expiry since the timer was set (stale)
+     */
+    ttl_map_entry* entry;
+} ttl_map_timer;
+
+/**
+ * A TTL map is a key/value map where entries can expire after a time to live (TTL).
+ *
+ * Expired entries are never returned. They're removed in two ways:
+ *   - Lazily: looking up an expired entry removes it.
+ *   - Actively: ttl_map_expire_step() removes expired entries in expiry order, doing a bounded amount of work per call,
+ *     so it can be called periodically (e.g. from an event loop) without stalling.
+ *
+ * Expiry times are indexed by a min heap, so active expiry only looks at entries that have expired (or are about to be
+ * found to have expired), and its cost doesn't grow with the size of the map. Deleting an entry or changing its TTL
+ * leaves its old timer in the heap as a stale timer that's skipped when it fires. The heap is compacted when stale
+ * timers outnumber live ones, so it stays within about twice the number of expiring entries.
+ *
+ * Time comes from a clock function in milliseconds (CLOCK_MONOTONIC by default), which can be replaced for testing.
+ *
+ * Keys and values aren't copied, and are only freed by the expiry callback (if one is set).
+ *
+ * **Example**
+ * ```c
+ * ttl_map map;
+ * ttl_map_init(&map, 100, NULL, NULL); // String keys
+ *
+ * ttl_map_set(&map, "session", "token", 30000); // Expires in 30s
+ * ttl_map_set(&map, "config", "value", 0); // Never expires
+ *
+ * // Later, from an event loop:
+ * ttl_map_expire_step(&map, 100); // Remove up to 100 expired entries
+ *
+ * ttl_map_destroy(&map);
+ * ```
+ */
+typedef struct ttl_map {
+    /**
+     * Key -> ttl_map_entry
+     */
+    hash_table table;
+
+    /**
+     * Min heap of ttl_map_timer, by expiry time
+     */
+    heap timers;
+
+    /**
+     * Entry pool
+     */
+    mem_pool entry_pool;
+
+    /**
+     * Timer pool
+     */
+    mem_pool timer_pool;
+
+    /**
+     * Number of stale timers in the heap
+     */
+    size_t stale_timers;
+
+    /**
+     * Clock function
+     */
+    ttl_map_clock_func clock_func;
+    void* clock_user_arg;
+
+    /**
+     * Expiry callback (or NULL)
+     */
+    ttl_map_expire_func expire_func;
+    void* expire_user_arg;
+} ttl_map;
+
+/**
+ * Initialize the TTL map
+ *
+ * Time complexity: O(n)
+ *
+ * @relates ttl_map
+ * @param[out] map TTL map
+ * @param[in] size Initial hash table index size
+ * @param[in] key_cmp Key comparator (or NULL to use default)
+ * @param[in] key_hash Key hash function (or NULL to use default)
+ * @return true on success, false on failure
+ */
+bool ttl_map_init(ttl_map* map, uint32_t size, value_cmp_func key_cmp, hash_table_key_hash_func key_hash);
+
+/**
+ * Set the clock function
+ * This should be set before any entries are added, since existing expiry times aren't converted.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] clock_func Clock function (or NULL to use the default monotonic clock)
+ * @param clock_user_arg Optional argument to pass to the clock function
+ */
+void ttl_map_set_clock_func(ttl_map* map, ttl_map_clock_func clock_func, void* clock_user_arg);
+
+/**
+ * Set the expiry callback
+ *
+ * Time complexity: O(1)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] expire_func Called with each expired entry that's removed (or NULL)
+ * @param expire_user_arg Optional argument to pass to the expiry callback
+ */
+void ttl_map_set_expire_func(ttl_map* map, ttl_map_expire_func expire_func, void* expire_user_arg);
+
+/**
+ * Insert or replace an entry in the TTL map
+ *
+ * Replacing an entry resets its TTL, and doesn't call the expiry callback for the old value.
+ *
+ * Time complexity: O(lg n)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] key Pointer to key
+ * @param[in] value Pointer to value
+ * @param[in] ttl_ms Time to live in milliseconds, or 0 to never expire
+ * @return true on success, false on failure (an existing entry keeps its old value and TTL)
+ */
+bool ttl_map_set(ttl_map* map, void* key, void* value, uint64_t ttl_ms);
+
+/**
+ * Get a value from the TTL map
+ * If the entry has expired, it's removed (calling the expiry callback) and not returned.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] key Key to get value for
+ * @return Value pointer, or NULL if not found or expired
+ */
+void* ttl_map_get(ttl_map* map, const void* key);
+
+/**
+ * Change an entry's TTL, without changing its value
+ *
+ * Time complexity: O(lg n)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] key Key of the entry
+ * @param[in] ttl_ms New time to live in milliseconds (from now), or 0 to never expire
+ * @return true on success, false if not found (or expired) or on failure
+ */
+bool ttl_map_expire(ttl_map* map, const void* key, uint64_t ttl_ms);
+
+/**
+ * Get an entry's remaining time to live
+ *
+ * Time complexity: O(1)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] key Key of the entry
+ * @return Remaining time to live in milliseconds, 0 if the entry never expires, or -1 if not found (or expired)
+ */
+int64_t ttl_map_ttl(ttl_map* map, const void* key);
+
+/**
+ * Delete an entry from the TTL map (without calling the expiry callback)
+ *
+ * Time complexity: O(1)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] key Key to delete
+ * @return true on success, false if not found
+ */
+bool ttl_map_del(ttl_map* map, const void* key);
+
+/**
+ * Remove expired entries, in expiry order, doing a bounded amount of work (calling the expiry callback for each)
+ *
+ * Time complexity: O(budget lg n)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @param[in] budget Max number of timers to process (stale timers count towards this too)
+ * @return Number of expired entries removed
+ */
+size_t ttl_map_expire_step(ttl_map* map, size_t budget);
+
+/**
+ * Get the number of entries in the TTL map
+ * This includes expired entries that haven't been removed yet.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates ttl_map
+ * @param[in] map TTL map
+ * @return Number of entries
+ */
+size_t ttl_map_size(const ttl_map* map);
+
+/**
+ * Destroy the TTL map (without calling the expiry callback)
+ *
+ * Time complexity: O(n)
+ *
+ * @relates ttl_map
+ * @param[in,out] map TTL map
+ * @return true on success, false on failure
+ */
+bool ttl_map_destroy(ttl_map* map);
@@ -3,13 +3,34 @@
 
 #include "library.h"
 #include "tests/algos/array_test.h"
+#include "tests/algos/hash_join_test.h"
 #include "tests/algos/murmur3_test.h"
 #include "tests/structs/linked_list_test.h"
 #include "tests/structs/array_list_test.h"
 #include "tests/structs/hash_table_test.h"
+#include "tests/structs/hash_aggregate_test.h"
+#include "tests/structs/flat_hash_table_test.h"
+#include "tests/structs/hash_map_test.h"
+#include "tests/structs/concurrent_hash_table_test.h"
+#include "tests/structs/cuckoo_hash_table_test.h"
+#include "tests/structs/disk_hash_table_test.h"
+#include "tests/structs/perfect_hash_test.h"
+#include "tests/structs/lru_cache_test.h"
+#include "tests/structs/tinylfu_cache_test.h"
 #include "tests/structs/bit_array_test.h"
+#include "tests/structs/count_min_sketch_test.h"
 #include "tests/structs/bloom_filter_test.h"
+#include "tests/structs/blocked_bloom_filter_test.h"
+#include "tests/structs/counting_bloom_filter_test.h"
+#include "tests/structs/scalable_bloom_filter_test.h"
+#include "tests/structs/cuckoo_filter_test.h"
+#include "tests/structs/binary_fuse_filter_test.h"
 #include "tests/structs/heap_test.h"
+#include "tests/structs/ttl_map_test.h"
+#include "tests/structs/string_pool_test.h"
+#include "tests/utils/epoch_test.h"
+#include "tests/utils/mem_pool_test.h"
+#include "tests/utils/parallel_test.h"
 #include "tests/utils/net_utils_test.h"
 
 static int suite_setup() {
@@ -38,13 +59,34 @@ int main(int argc, char** argv) {
 
     CU_SuiteInfo suites[] = {
         {"array", suite_setup, suite_teardown, NULL, NULL, get_array_tests()},
+        {"hash_join", suite_setup, suite_teardown, NULL, NULL, get_hash_join_tests()},
         {"murmur3", suite_setup, suite_teardown, NULL, NULL, get_murmur3_tests()},
         {"linked_list", suite_setup, suite_teardown, NULL, NULL, get_linked_list_tests()},
         {"array_list", suite_setup, suite_teardown, NULL, NULL, get_array_list_tests()},
         {"hash_table", suite_setup, suite_teardown, NULL, NULL, get_hash_table_tests()},
+        {"hash_aggregate", suite_setup, suite_teardown, NULL, NULL, get_hash_aggregate_tests()},
+        {"flat_hash_table", suite_setup, suite_teardown, NULL, NULL, get_flat_hash_table_tests()},
+        {"hash_map", suite_setup, suite_teardown, NULL, NULL, get_hash_map_tests()},
+        {"concurrent_hash_table", suite_setup, suite_teardown, NULL, NULL, get_concurrent_hash_table_tests()},
+        {"cuckoo_hash_table", suite_setup, suite_teardown, NULL, NULL, get_cuckoo_hash_table_tests()},
+        {"disk_hash_table", suite_setup, suite_teardown, NULL, NULL, get_disk_hash_table_tests()},
+        {"perfect_hash", suite_setup, suite_teardown, NULL, NULL, get_perfect_hash_tests()},
+        {"lru_cache", suite_setup, suite_teardown, NULL, NULL, get_lru_cache_tests()},
+        {"tinylfu_cache", suite_setup, suite_teardown, NULL, NULL, get_tinylfu_cache_tests()},
         {"bit_array", suite_setup, suite_teardown, NULL, NULL, get_bit_array_tests()},
+        {"count_min_sketch", suite_setup, suite_teardown, NULL, NULL, get_count_min_sketch_tests()},
         {"bloom_filter", suite_setup, suite_teardown, NULL, NULL, get_bloom_filter_tests()},
+        {"blocked_bloom_filter", suite_setup, suite_teardown, NULL, NULL, get_blocked_bloom_filter_tests()},
+        {"counting_bloom_filter", suite_setup, suite_teardown, NULL, NULL, get_counting_bloom_filter_tests()},
+        {"scalable_bloom_filter", suite_setup, suite_teardown, NULL, NULL, get_scalable_bloom_filter_tests()},
+        {"cuckoo_filter", suite_setup, suite_teardown, NULL, NULL, get_cuckoo_filter_tests()},
+        {"binary_fuse_filter", suite_setup, suite_teardown, NULL, NULL, get_binary_fuse_filter_tests()},
         {"heap", suite_setup, suite_teardown, NULL, NULL, get_heap_tests()},
+        {"ttl_map", suite_setup, suite_teardown, NULL, NULL, get_ttl_map_tests()},
+        {"string_pool", suite_setup, suite_teardown, NULL, NULL, get_string_pool_tests()},
+        {"epoch", suite_setup, suite_teardown, NULL, NULL, get_epoch_tests()},
+        {"mem_pool", suite_setup, suite_teardown, NULL, NULL, get_mem_pool_tests()},
+        {"parallel", suite_setup, suite_teardown, NULL, NULL, get_parallel_tests()},
         {"net_utils", suite_setup, suite_teardown, NULL, NULL, get_net_utils_tests()},
         CU_SUITE_INFO_NULL,
     };
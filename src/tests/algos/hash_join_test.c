@@ -0,0 +1,241 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash_join_test.h"
+#include "../../algos/hash_join.h"
+#include "../../structs/hash_map.h"
+
+CU_TestInfo* get_hash_join_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_hash_join_init_and_destroy", test_hash_join_init_and_destroy},
+        {"test_hash_join_inner", test_hash_join_inner},
+        {"test_hash_join_semi_and_anti", test_hash_join_semi_and_anti},
+        {"test_hash_join_parallel", test_hash_join_parallel},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+/**
+ * Matches collected from a single threaded join
+ */
+struct test_hash_join_matches {
+    hash_join_match matches[16];
+    size_t n;
+};
+
+static void test_hash_join_collect(const hash_join_match* matches, const size_t n, size_t thread, void* user_arg) {
+    struct test_hash_join_matches* p_collected = user_arg;
+    for (size_t i = 0; i < n && p_collected->n < 16; ++i) {
+        p_collected->matches[p_collected->n++] = matches[i];
+    }
+}
+
+/**
+ * Check if a match was collected
+ */
+static bool test_hash_join_has_match(
+    const struct test_hash_join_matches* collected,
+    const size_t build_row,
+    const size_t probe_row
+) {
+    for (size_t i = 0; i < collected->n; ++i) {
+        if (collected->matches[i].build_row == build_row && collected->matches[i].probe_row == probe_row) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void test_hash_join_init_and_destroy() {
+    hash_join join;
+    CU_ASSERT_EQUAL(hash_join_init(&join, (hash_join_type)42, nullptr, nullptr), false)
+
+    CU_ASSERT_EQUAL(hash_join_init(&join, HASH_JOIN_INNER, nullptr, nullptr), true)
+
+    // Empty sides
+    char* keys[] = {"foo"};
+    CU_ASSERT_EQUAL(hash_join_run(&join, nullptr, 0, (void**)keys, 1, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 0)
+    CU_ASSERT_EQUAL(hash_join_run(&join, (void**)keys, 1, nullptr, 0, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 0)
+
+    CU_ASSERT_EQUAL(hash_join_destroy(&join), true)
+
+    // Not initialized anymore (will print an error)
+    CU_ASSERT_EQUAL(hash_join_run(&join, (void**)keys, 1, (void**)keys, 1, 1), false)
+}
+
+void test_hash_join_inner() {
+    char* customers[] = {"alice", "bob", "alice"};
+    char* orders[] = {"bob", "carol", "alice", "bob"};
+
+    struct test_hash_join_matches collected = {.n = 0};
+    hash_join join;
+    CU_ASSERT_EQUAL(hash_join_init(&join, HASH_JOIN_INNER, nullptr, nullptr), true)
+    hash_join_set_emit_func(&join, test_hash_join_collect, &collected);
+
+    CU_ASSERT_EQUAL(hash_join_run(&join, (void**)customers, 3, (void**)orders, 4, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 4)
+    CU_ASSERT_EQUAL(collected.n, 4)
+    CU_ASSERT(test_hash_join_has_match(&collected, 1, 0))
+    CU_ASSERT(test_hash_join_has_match(&collected, 1, 3))
+    CU_ASSERT(test_hash_join_has_match(&collected, 0, 2))
+    CU_ASSERT(test_hash_join_has_match(&collected, 2, 2)) // Duplicate build key
+
+    // Duplicates are emitted in build row order
+    for (size_t i = 0; i < collected.n; ++i) {
+        if (collected.matches[i].build_row == 0) {
+            CU_ASSERT(i + 1 < collected.n && collected.matches[i + 1].build_row == 2)
+        }
+    }
+
+    // Counting only
+    hash_join_set_emit_func(&join, nullptr, nullptr);
+    CU_ASSERT_EQUAL(hash_join_run(&join, (void**)orders, 4, (void**)customers, 3, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 4)
+
+    CU_ASSERT_EQUAL(hash_join_destroy(&join), true)
+}
+
+void test_hash_join_semi_and_anti() {
+    char* customers[] = {"alice", "bob", "alice"};
+    char* orders[] = {"bob", "carol", "alice", "bob"};
+
+    struct test_hash_join_matches collected = {.n = 0};
+    hash_join join;
+    CU_ASSERT_EQUAL(hash_join_init(&join, HASH_JOIN_SEMI, nullptr, nullptr), true)
+    hash_join_set_emit_func(&join, test_hash_join_collect, &collected);
+
+    // Probe rows with a match, once each (with the first matching build row)
+    CU_ASSERT_EQUAL(hash_join_run(&join, (void**)customers, 3, (void**)orders, 4, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 3)
+    CU_ASSERT_EQUAL(collected.n, 3)
+    CU_ASSERT(test_hash_join_has_match(&collected, 1, 0))
+    CU_ASSERT(test_hash_join_has_match(&collected, 0, 2))
+    CU_ASSERT(test_hash_join_has_match(&collected, 1, 3))
+    CU_ASSERT_EQUAL(hash_join_destroy(&join), true)
+
+    // Probe rows without a match
+    collected.n = 0;
+    CU_ASSERT_EQUAL(hash_join_init(&join, HASH_JOIN_ANTI, nullptr, nullptr), true)
+    hash_join_set_emit_func(&join, test_hash_join_collect, &collected);
+
+    CU_ASSERT_EQUAL(hash_join_run(&join, (void**)customers, 3, (void**)orders, 4, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 1)
+    CU_ASSERT_EQUAL(collected.n, 1)
+    CU_ASSERT(test_hash_join_has_match(&collected, SIZE_MAX, 1))
+
+    // Every probe row, when there's nothing to build
+    collected.n = 0;
+    CU_ASSERT_EQUAL(hash_join_run(&join, nullptr, 0, (void**)orders, 4, 1), true)
+    CU_ASSERT_EQUAL(join.matches, 4)
+    CU_ASSERT_EQUAL(collected.n, 4)
+
+    CU_ASSERT_EQUAL(hash_join_destroy(&join), true)
+}
+
+static int test_hash_join_cmp_u64(const void* a, const void* b) {
+    const uint64_t a_key = *(const uint64_t *)a;
+    const uint64_t b_key = *(const uint64_t *)b;
+    return (a_key > b_key) - (a_key < b_key);
+}
+
+static uint32_t test_hash_join_hash_u64(const void* key, size_t ht_size) {
+    return (uint32_t)hash_map_hash_u64(*(const uint64_t *)key);
+}
+
+/**
+ * Matches checked by a parallel join
+ */
+struct test_hash_join_check {
+    void* const* build_keys;
+    void* const* probe_keys;
+
+    /**
+     * Number of matches for each probe row (each probe row is only joined by one thread)
+     */
+    size_t* probe_matches;
+
+    /**
+     * Set if any match had different keys
+     */
+    bool mismatched;
+};
+
+static void test_hash_join_check(const hash_join_match* matches, const size_t n, size_t thread, void* user_arg) {
+    struct test_hash_join_check* p_check = user_arg;
+
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t probe_key = *(const uint64_t *)p_check->probe_keys[matches[i].probe_row];
+        if (matches[i].build_row != SIZE_MAX) {
+            const uint64_t build_key = *(const uint64_t *)p_check->build_keys[matches[i].build_row];
+            if (build_key != probe_key) {
+                __atomic_store_n(&p_check->mismatched, true, __ATOMIC_RELAXED);
+            }
+        }
+
+        ++p_check->probe_matches[matches[i].probe_row];
+    }
+}
+
+void test_hash_join_parallel() {
+    // Each build key is there twice, and half of the probe keys are in the build side
+    const size_t build_n = 50000;
+    const size_t probe_n = 100000;
+    uint64_t* build_values = malloc(build_n * sizeof(uint64_t));
+    uint64_t* probe_values = malloc(probe_n * sizeof(uint64_t));
+    void** build_keys = malloc(build_n * sizeof(void*));
+    void** probe_keys = malloc(probe_n * sizeof(void*));
+    size_t* probe_matches = malloc(probe_n * sizeof(size_t));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(build_values)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(probe_values)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(build_keys)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(probe_keys)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(probe_matches)
+
+    for (size_t i = 0; i < build_n; ++i) {
+        build_values[i] = i / 2;
+        build_keys[i] = &build_values[i];
+    }
+
+    for (size_t i = 0; i < probe_n; ++i) {
+        probe_values[i] = i % build_n;
+        probe_keys[i] = &probe_values[i];
+    }
+
+    const hash_join_type types[] = {HASH_JOIN_INNER, HASH_JOIN_SEMI, HASH_JOIN_ANTI};
+    const size_t expected_matches[] = {2, 1, 0}; // For probe keys in the build side
+    const size_t expected_misses[] = {0, 0, 1}; // For probe keys that aren't
+
+    for (size_t t = 0; t < 3; ++t) {
+        memset(probe_matches, 0, probe_n * sizeof(size_t));
+        struct test_hash_join_check check = {build_keys, probe_keys, probe_matches, false};
+
+        hash_join join;
+        CU_ASSERT_EQUAL(hash_join_init(&join, types[t], test_hash_join_cmp_u64, test_hash_join_hash_u64), true)
+        hash_join_set_emit_func(&join, test_hash_join_check, &check);
+
+        CU_ASSERT_EQUAL(hash_join_run(&join, build_keys, build_n, probe_keys, probe_n, 4), true)
+        CU_ASSERT_EQUAL(check.mismatched, false)
+        CU_ASSERT_EQUAL(join.matches, probe_n / 2 * (expected_matches[t] + expected_misses[t]))
+
+        bool all_expected = true;
+        for (size_t i = 0; i < probe_n; ++i) {
+            const bool in_build = probe_values[i] < build_n / 2;
+            all_expected &= probe_matches[i] == (in_build ? expected_matches[t] : expected_misses[t]);
+        }
+        CU_ASSERT(all_expected)
+
+        CU_ASSERT_EQUAL(hash_join_destroy(&join), true)
+    }
+
+    free(probe_matches);
+    free(probe_keys);
+    free(build_keys);
+    free(probe_values);
+    free(build_values);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_hash_join_tests();
+
+void test_hash_join_init_and_destroy();
+
+void test_hash_join_inner();
+
+void test_hash_join_semi_and_anti();
+
+void test_hash_join_parallel();
@@ -4,6 +4,7 @@
 CU_TestInfo* get_murmur3_tests() {
     static CU_TestInfo tests[] = {
         {"test_murmur3", test_murmur3},
+        {"test_murmur3_128", test_murmur3_128},
         CU_TEST_INFO_NULL,
     };
 
@@ -24,3 +25,23 @@ void test_murmur3() {
     CU_ASSERT_EQUAL(murmur3((uint8_t *)"The quick brown fox jumps over the lazy dog", 43, 0x00000000), 0x2e4ff723)
     CU_ASSERT_EQUAL(murmur3((uint8_t *)"The quick brown fox jumps over the lazy dog", 43, 0x9747b28c), 0x2fa826cd)
 }
+
+void test_murmur3_128() {
+    uint64_t hash[2];
+
+    murmur3_128((uint8_t *)"", 0, 0x00000000, hash);
+    CU_ASSERT_EQUAL(hash[0], 0x0000000000000000ULL)
+    CU_ASSERT_EQUAL(hash[1], 0x0000000000000000ULL)
+
+    murmur3_128((uint8_t *)"", 0, 0x00000001, hash);
+    CU_ASSERT_EQUAL(hash[0], 0x4610abe56eff5cb5ULL)
+    CU_ASSERT_EQUAL(hash[1], 0x51622daa78f83583ULL)
+
+    murmur3_128((uint8_t *)"hello", 5, 0x00000000, hash);
+    CU_ASSERT_EQUAL(hash[0], 0xcbd8a7b341bd9b02ULL)
+    CU_ASSERT_EQUAL(hash[1], 0x5b1e906a48ae1d19ULL)
+
+    murmur3_128((uint8_t *)"The quick brown fox jumps over the lazy dog", 43, 0x00000000, hash);
+    CU_ASSERT_EQUAL(hash[0], 0xe34bbc7bbc071b6cULL)
+    CU_ASSERT_EQUAL(hash[1], 0x7a433ca9c49a9347ULL)
+}
@@ -5,3 +5,5 @@
 CU_TestInfo* get_murmur3_tests();
 
 void test_murmur3();
+
+void test_murmur3_128();
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_fuse_filter_test.h"
+#include "../../structs/binary_fuse_filter.h"
+
+CU_TestInfo* get_binary_fuse_filter_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_binary_fuse_filter_build_and_destroy", test_binary_fuse_filter_build_and_destroy},
+        {"test_binary_fuse_filter", test_binary_fuse_filter},
+        {"test_binary_fuse_filter_duplicates", test_binary_fuse_filter_duplicates},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_binary_fuse_filter_build_and_destroy() {
+    binary_fuse_filter bff;
+
+    // Empty and tiny filters still build
+    CU_ASSERT_EQUAL(binary_fuse_filter_build(&bff, NULL, NULL, 0), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_size(&bff), 0)
+    CU_ASSERT_EQUAL(binary_fuse_filter_destroy(&bff), true)
+    CU_ASSERT_PTR_NULL(bff.fingerprints)
+
+    const uint8_t* keys[] = {(uint8_t *)"foo", (uint8_t *)"bar", (uint8_t *)"spangle"};
+    const size_t key_lens[] = {3, 3, 7};
+    CU_ASSERT_EQUAL(binary_fuse_filter_build(&bff, keys, key_lens, 1), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_size(&bff), 1)
+    CU_ASSERT_EQUAL(binary_fuse_filter_check(&bff, (uint8_t *)"foo", 3), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_destroy(&bff), true)
+
+    CU_ASSERT_EQUAL(binary_fuse_filter_build(&bff, keys, key_lens, 3), true)
+    CU_ASSERT_PTR_NOT_NULL(bff.fingerprints)
+    CU_ASSERT_EQUAL(binary_fuse_filter_size(&bff), 3)
+    CU_ASSERT_EQUAL(binary_fuse_filter_bytes(&bff), bff.array_length)
+    CU_ASSERT_EQUAL(binary_fuse_filter_check(&bff, (uint8_t *)"foo", 3), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_check(&bff, (uint8_t *)"bar", 3), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_check(&bff, (uint8_t *)"spangle", 7), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_check_hash(&bff, binary_fuse_filter_hash((uint8_t *)"foo", 3)), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_destroy(&bff), true)
+}
+
+void test_binary_fuse_filter() {
+    const size_t n = 100000;
+    uint64_t* hashes = malloc(n * sizeof(uint64_t));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(hashes)
+
+    char key[32];
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        hashes[i] = binary_fuse_filter_hash((uint8_t *)key, strlen(key));
+    }
+
+    binary_fuse_filter bff;
+    CU_ASSERT_EQUAL(binary_fuse_filter_build_hashes(&bff, hashes, n), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_size(&bff), n)
+
+    // About 9 bits per key
+    const double bits_per_key = 8.0 * (double)binary_fuse_filter_bytes(&bff) / (double)n;
+    CU_ASSERT(bits_per_key > 8.5 && bits_per_key < 10)
+
+    bool all_found = true;
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= binary_fuse_filter_check(&bff, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found) // No false negatives
+
+    // About 1 / 2^8 = 0.39%
+    size_t false_positives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        snprintf(key, sizeof(key), "other:%zu", i);
+        false_positives += binary_fuse_filter_check(&bff, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(false_positives > 250 && false_positives < 550)
+
+    CU_ASSERT_EQUAL(binary_fuse_filter_destroy(&bff), true)
+    free(hashes);
+}
+
+void test_binary_fuse_filter_duplicates() {
+    const size_t n = 10000;
+    uint64_t* hashes = malloc(n * 2 * sizeof(uint64_t));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(hashes)
+
+    // Every key twice
+    char key[32];
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        hashes[i] = binary_fuse_filter_hash((uint8_t *)key, strlen(key));
+        hashes[n + i] = hashes[i];
+    }
+
+    binary_fuse_filter bff;
+    CU_ASSERT_EQUAL(binary_fuse_filter_build_hashes(&bff, hashes, n * 2), true)
+    CU_ASSERT_EQUAL(binary_fuse_filter_size(&bff), n)
+
+    bool all_found = true;
+    for (size_t i = 0; i < n; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= binary_fuse_filter_check(&bff, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found)
+
+    CU_ASSERT_EQUAL(binary_fuse_filter_destroy(&bff), true)
+    free(hashes);
+}
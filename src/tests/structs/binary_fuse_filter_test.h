@@ -0,0 +1,11 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_binary_fuse_filter_tests();
+
+void test_binary_fuse_filter_build_and_destroy();
+
+void test_binary_fuse_filter();
+
+void test_binary_fuse_filter_duplicates();
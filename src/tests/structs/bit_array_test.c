@@ -5,6 +5,7 @@ CU_TestInfo* get_bit_array_tests() {
     static CU_TestInfo tests[] = {
         {"test_bit_array_init_and_destroy", test_bit_array_init_and_destroy},
         {"test_bit_array", test_bit_array},
+        {"test_bit_array_multiple_elems", test_bit_array_multiple_elems},
         CU_TEST_INFO_NULL,
     };
 
@@ -43,3 +44,34 @@ void test_bit_array() {
 
     CU_ASSERT_EQUAL(bit_array_destroy(&ba), true)
 }
+
+void test_bit_array_multiple_elems() {
+    bit_array ba;
+    CU_ASSERT_EQUAL(bit_array_init(&ba, 100), true)
+    CU_ASSERT_EQUAL(ba.size_bits, 128)
+
+    bit_array_set(&ba, 0);
+    bit_array_set(&ba, 33);
+    bit_array_set(&ba, 127);
+    CU_ASSERT_EQUAL(ba.bit_array[0], 1U)
+    CU_ASSERT_EQUAL(ba.bit_array[1], 1U << 1)
+    CU_ASSERT_EQUAL(ba.bit_array[2], 0U)
+    CU_ASSERT_EQUAL(ba.bit_array[3], 1U << 31)
+
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 33), true)
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 32), false)
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 128 + 33), true) // Wraps
+    CU_ASSERT_EQUAL(bit_array_test(&ba, ((uint64_t)1 << 32) + 33), true) // Wraps from beyond 32 bits
+    CU_ASSERT_EQUAL(bit_array_count(&ba), 3)
+
+    bit_array_clear(&ba, 33);
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 33), false)
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 127), true)
+
+    bit_array_clear_all(&ba);
+    CU_ASSERT_EQUAL(bit_array_count(&ba), 0)
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 0), false)
+    CU_ASSERT_EQUAL(bit_array_test(&ba, 127), false)
+
+    CU_ASSERT_EQUAL(bit_array_destroy(&ba), true)
+}
@@ -7,3 +7,5 @@ CU_TestInfo* get_bit_array_tests();
 void test_bit_array_init_and_destroy();
 
 void test_bit_array();
+
+void test_bit_array_multiple_elems();
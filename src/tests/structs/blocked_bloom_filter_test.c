@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "blocked_bloom_filter_test.h"
+#include "../../structs/blocked_bloom_filter.h"
+
+CU_TestInfo* get_blocked_bloom_filter_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_blocked_bloom_filter_init_and_destroy", test_blocked_bloom_filter_init_and_destroy},
+        {"test_blocked_bloom_filter", test_blocked_bloom_filter},
+        {"test_blocked_bloom_filter_hash", test_blocked_bloom_filter_hash},
+        {"test_blocked_bloom_filter_init_with_fpr", test_blocked_bloom_filter_init_with_fpr},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+/**
+ * Count the bits set in a blocked bloom filter
+ */
+static size_t count_bits(const blocked_bloom_filter* bf) {
+    size_t bits = 0;
+    for (size_t i = 0; i < bf->block_count; ++i) {
+        for (size_t j = 0; j < BLOCKED_BLOOM_FILTER_BLOCK_WORDS; ++j) {
+            bits += __builtin_popcountll(bf->blocks[i].words[j]);
+        }
+    }
+
+    return bits;
+}
+
+void test_blocked_bloom_filter_init_and_destroy() {
+    blocked_bloom_filter bf;
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init(&bf, 600), true)
+    CU_ASSERT_PTR_NOT_NULL(bf.blocks)
+    CU_ASSERT_EQUAL(bf.block_count, 2) // Rounded to 1024 bits
+    CU_ASSERT_EQUAL((uintptr_t)bf.blocks % 64, 0) // Cache line aligned
+    CU_ASSERT_EQUAL(blocked_bloom_filter_bytes(&bf), 128)
+    CU_ASSERT_EQUAL(count_bits(&bf), 0)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_destroy(&bf), true)
+    CU_ASSERT_EQUAL(bf.block_count, 0)
+    CU_ASSERT_PTR_NULL(bf.blocks)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init(&bf, 0), true)
+    CU_ASSERT_EQUAL(bf.block_count, 1)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_destroy(&bf), true)
+}
+
+void test_blocked_bloom_filter() {
+    blocked_bloom_filter bf;
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init(&bf, 4096), true)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"foo", 3), false)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_add(&bf, (uint8_t *)"foo", 3), true) // ["foo"]
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"foo", 3), true)
+
+    // One bit in each word of one block
+    CU_ASSERT_EQUAL(count_bits(&bf), BLOCKED_BLOOM_FILTER_BLOCK_WORDS)
+    size_t blocks_used = 0;
+    for (size_t i = 0; i < bf.block_count; ++i) {
+        bool used = false;
+        for (size_t j = 0; j < BLOCKED_BLOOM_FILTER_BLOCK_WORDS; ++j) {
+            CU_ASSERT(__builtin_popcountll(bf.blocks[i].words[j]) <= 1)
+            used |= bf.blocks[i].words[j] != 0;
+        }
+        blocks_used += used;
+    }
+    CU_ASSERT_EQUAL(blocks_used, 1)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"bar", 3), false)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_add(&bf, (uint8_t *)"bar", 3), true) // ["foo", "bar"]
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"bar", 3), true)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"foo", 3), true)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"spangle", 7), false)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_add(&bf, (uint8_t *)"spangle", 7), true) // ["foo", "bar", "spangle"]
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"spangle", 7), true)
+
+    blocked_bloom_filter_clear(&bf); // []
+    CU_ASSERT_EQUAL(count_bits(&bf), 0)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check(&bf, (uint8_t *)"foo", 3), false)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_destroy(&bf), true)
+}
+
+void test_blocked_bloom_filter_hash() {
+    blocked_bloom_filter bf;
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init(&bf, 1 << 16), true)
+
+    // Hashes that only differ in the block half, or only in the in-block half
+    const uint64_t hash = 0x9e3779b97f4a7c15ULL;
+    blocked_bloom_filter_add_hash(&bf, hash);
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check_hash(&bf, hash), true)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check_hash(&bf, hash ^ 0x8000000000000000ULL), false)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check_hash(&bf, hash ^ 0x0000000000000001ULL), false)
+
+    // Block selection covers the whole filter, including the last block
+    blocked_bloom_filter_add_hash(&bf, 0);
+    blocked_bloom_filter_add_hash(&bf, UINT64_MAX);
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check_hash(&bf, 0), true)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_check_hash(&bf, UINT64_MAX), true)
+    CU_ASSERT_NOT_EQUAL(bf.blocks[0].words[0], 0)
+    CU_ASSERT_NOT_EQUAL(bf.blocks[bf.block_count - 1].words[0], 0)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_destroy(&bf), true)
+}
+
+void test_blocked_bloom_filter_init_with_fpr() {
+    blocked_bloom_filter bf;
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init_with_fpr(&bf, 0, 0.01), false)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init_with_fpr(&bf, 10000, 0), false)
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init_with_fpr(&bf, 10000, 1), false)
+
+    CU_ASSERT_DOUBLE_EQUAL(blocked_bloom_filter_expected_fpr(0, 1), 0, 0)
+    CU_ASSERT(blocked_bloom_filter_expected_fpr(10000, 100) > blocked_bloom_filter_expected_fpr(10000, 200))
+
+    // Needs more than a standard bloom filter's 9.6 bits per key at 1%, but not much more
+    CU_ASSERT_EQUAL(blocked_bloom_filter_init_with_fpr(&bf, 10000, 0.01), true)
+    const double bits_per_key = (double)bf.block_count * BLOCKED_BLOOM_FILTER_BLOCK_BITS / 10000;
+    CU_ASSERT(bits_per_key > 9.6 && bits_per_key < 13)
+    CU_ASSERT(blocked_bloom_filter_expected_fpr(10000, bf.block_count) <= 0.01)
+    CU_ASSERT(blocked_bloom_filter_expected_fpr(10000, bf.block_count - 1) > 0.01)
+
+    char key[32];
+    bool all_found = true;
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        blocked_bloom_filter_add(&bf, (uint8_t *)key, strlen(key));
+    }
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= blocked_bloom_filter_check(&bf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found) // No false negatives
+
+    size_t false_positives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        snprintf(key, sizeof(key), "other:%zu", i);
+        false_positives += blocked_bloom_filter_check(&bf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(false_positives > 500 && false_positives < 2000)
+
+    CU_ASSERT_EQUAL(blocked_bloom_filter_destroy(&bf), true)
+}
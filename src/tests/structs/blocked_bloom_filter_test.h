@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_blocked_bloom_filter_tests();
+
+void test_blocked_bloom_filter_init_and_destroy();
+
+void test_blocked_bloom_filter();
+
+void test_blocked_bloom_filter_hash();
+
+void test_blocked_bloom_filter_init_with_fpr();
@@ -1,3 +1,6 @@
+#include <stdio.h>
+#include <string.h>
+
 #include "bloom_filter_test.h"
 #include "../../structs/bloom_filter.h"
 
@@ -5,6 +8,7 @@ CU_TestInfo* get_bloom_filter_tests() {
     static CU_TestInfo tests[] = {
         {"test_bloom_filter_init_and_destroy", test_bloom_filter_init_and_destroy},
         {"test_bloom_filter", test_bloom_filter},
+        {"test_bloom_filter_init_with_fpr", test_bloom_filter_init_with_fpr},
         CU_TEST_INFO_NULL,
     };
 
@@ -47,5 +51,47 @@ void test_bloom_filter() {
     CU_ASSERT_EQUAL(bloom_filter_check(&bf, (uint8_t *)"spangle", 7), true)
     CU_ASSERT_NOT_EQUAL(bit_array_slot, bf.bit_array->bit_array[0]) // Ensure bit array changed
 
+    bloom_filter_clear(&bf); // []
+    CU_ASSERT_EQUAL(bf.bit_array->bit_array[0], 0)
+    CU_ASSERT_EQUAL(bloom_filter_check(&bf, (uint8_t *)"foo", 3), false)
+
+    CU_ASSERT_EQUAL(bloom_filter_destroy(&bf), true)
+}
+
+void test_bloom_filter_init_with_fpr() {
+    bloom_filter bf;
+    CU_ASSERT_EQUAL(bloom_filter_init_with_fpr(&bf, 0, 0.01), false)
+    CU_ASSERT_EQUAL(bloom_filter_init_with_fpr(&bf, 1000, 0), false)
+    CU_ASSERT_EQUAL(bloom_filter_init_with_fpr(&bf, 1000, 1), false)
+
+    // m = -1000 ln(0.01) / ln(2)^2 = 9586 bits (rounded up to 9600), k = 9586 / 1000 ln(2) = 7
+    CU_ASSERT_EQUAL(bloom_filter_init_with_fpr(&bf, 1000, 0.01), true)
+    CU_ASSERT_EQUAL(bf.bit_array->size_bits, 9600)
+    CU_ASSERT_EQUAL(bf.hash_count, 7)
+    CU_ASSERT_DOUBLE_EQUAL(bloom_filter_estimated_fpr(&bf), 0, 0)
+
+    char key[32];
+    bool all_found = true;
+    for (size_t i = 0; i < 1000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        bloom_filter_add(&bf, (uint8_t *)key, strlen(key));
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= bloom_filter_check(&bf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found) // No false negatives
+
+    // About half the bits are set at the target size, which gives about the target rate
+    const double estimated_fpr = bloom_filter_estimated_fpr(&bf);
+    CU_ASSERT(estimated_fpr > 0.005 && estimated_fpr < 0.02)
+
+    size_t false_positives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        snprintf(key, sizeof(key), "other:%zu", i);
+        false_positives += bloom_filter_check(&bf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(false_positives > 500 && false_positives < 2000)
+
     CU_ASSERT_EQUAL(bloom_filter_destroy(&bf), true)
 }
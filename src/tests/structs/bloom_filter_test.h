@@ -7,3 +7,5 @@ CU_TestInfo* get_bloom_filter_tests();
 void test_bloom_filter_init_and_destroy();
 
 void test_bloom_filter();
+
+void test_bloom_filter_init_with_fpr();
@@ -0,0 +1,218 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "concurrent_hash_table_test.h"
+#include "../../structs/concurrent_hash_table.h"
+
+#define THREAD_COUNT 8
+#define KEYS_PER_THREAD 2000
+
+CU_TestInfo* get_concurrent_hash_table_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_concurrent_hash_table_init_and_destroy", test_concurrent_hash_table_init_and_destroy},
+        {"test_concurrent_hash_table_get_and_set", test_concurrent_hash_table_get_and_set},
+        {"test_concurrent_hash_table_del", test_concurrent_hash_table_del},
+        {"test_concurrent_hash_table_grow", test_concurrent_hash_table_grow},
+        {"test_concurrent_hash_table_grow_frees_old_index", test_concurrent_hash_table_grow_frees_old_index},
+        {"test_concurrent_hash_table_threads", test_concurrent_hash_table_threads},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_concurrent_hash_table_init_and_destroy() {
+    concurrent_hash_table cht;
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 10, 0, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(cht.stripe_count, CONCURRENT_HASH_TABLE_DEFAULT_STRIPES)
+    CU_ASSERT_EQUAL(atomic_load(&cht.index)->size, CONCURRENT_HASH_TABLE_DEFAULT_STRIPES) // At least one per stripe
+    CU_ASSERT_EQUAL(concurrent_hash_table_size(&cht), 0)
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), false) // Already destroyed
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 100, 3, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(cht.stripe_count, 4) // Rounded up to a power of 2
+    CU_ASSERT_EQUAL(atomic_load(&cht.index)->size, 128)
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+}
+
+void test_concurrent_hash_table_get_and_set() {
+    concurrent_hash_table cht;
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 10, 4, nullptr, nullptr), true)
+
+    CU_ASSERT_PTR_NULL(concurrent_hash_table_get(&cht, "foo"))
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_set(&cht, "foo", "one"), true)
+    CU_ASSERT_EQUAL(concurrent_hash_table_set(&cht, "bar", "two"), true)
+    CU_ASSERT_EQUAL(concurrent_hash_table_set(&cht, "foo", "three"), true) // Update
+
+    CU_ASSERT_STRING_EQUAL(concurrent_hash_table_get(&cht, "foo"), "three")
+    CU_ASSERT_STRING_EQUAL(concurrent_hash_table_get(&cht, "bar"), "two")
+    CU_ASSERT_EQUAL(concurrent_hash_table_size(&cht), 2)
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+}
+
+void test_concurrent_hash_table_del() {
+    char keys[100][16];
+    concurrent_hash_table cht;
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 1, 1, nullptr, nullptr), true) // Long chains
+
+    for (int i = 0; i < 100; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(concurrent_hash_table_set(&cht, keys[i], keys[i]), true)
+    }
+
+    // Delete from the head, middle and tail of chains
+    for (int i = 0; i < 100; i += 3) {
+        CU_ASSERT_EQUAL(concurrent_hash_table_del(&cht, keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_del(&cht, keys[0]), false) // Already deleted
+    CU_ASSERT_EQUAL(concurrent_hash_table_size(&cht), 66)
+
+    for (int i = 0; i < 100; ++i) {
+        CU_ASSERT_PTR_EQUAL(concurrent_hash_table_get(&cht, keys[i]), i % 3 == 0 ? NULL : keys[i])
+    }
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+}
+
+void test_concurrent_hash_table_grow() {
+    char keys[1000][16];
+    concurrent_hash_table cht;
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 4, 4, nullptr, nullptr), true)
+
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(concurrent_hash_table_set(&cht, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT(atomic_load(&cht.index)->size >= 512)
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_rehash(&cht, 4096), true)
+    CU_ASSERT_EQUAL(atomic_load(&cht.index)->size, 4096)
+
+    for (int i = 0; i < 1000; ++i) {
+        CU_ASSERT_PTR_EQUAL(concurrent_hash_table_get(&cht, keys[i]), keys[i])
+    }
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_size(&cht), 1000)
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+}
+
+/**
+ * Count the objects that are retired to an epoch record but not freed yet
+ *
+ * @param[in] record Epoch record
+ * @return Number of retired objects
+ */
+static size_t retired_count(const epoch_record* record) {
+    size_t count = 0;
+    for (size_t i = 0; i < EPOCH_LIMBO_LISTS; ++i) {
+        for (const epoch_entry* p_entry = record->limbo[i]; p_entry != NULL; p_entry = p_entry->next) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+void test_concurrent_hash_table_grow_frees_old_index() {
+    char (*keys)[16] = malloc(20000 * 16);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(keys)
+
+    concurrent_hash_table cht;
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 1, 4, nullptr, nullptr), true)
+
+    const epoch_record* p_record = epoch_thread_record(&cht.epoch);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_record)
+
+    for (int i = 0; i < 20000; ++i) {
+        snprintf(keys[i], 16, "key%d", i);
+        CU_ASSERT_EQUAL(concurrent_hash_table_set(&cht, keys[i], keys[i]), true)
+
+        // Nothing else is reading, so each replaced index is freed by the resize that replaced it
+        CU_ASSERT_EQUAL(retired_count(p_record), 0)
+    }
+
+    CU_ASSERT(atomic_load(&cht.index)->size >= 16384) // Grew many times
+    CU_ASSERT_PTR_NULL(cht.prev_index)
+
+    for (int i = 0; i < 20000; ++i) {
+        CU_ASSERT_PTR_EQUAL(concurrent_hash_table_get(&cht, keys[i]), keys[i])
+    }
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+    free(keys);
+}
+
+/**
+ * Worker thread state
+ */
+struct concurrent_hash_table_test_worker {
+    concurrent_hash_table* cht;
+    char (*keys)[16];
+    size_t errors;
+};
+
+static void* writer_thread(void* arg) {
+    struct concurrent_hash_table_test_worker* worker = arg;
+
+    for (int i = 0; i < KEYS_PER_THREAD; ++i) {
+        if (!concurrent_hash_table_set(worker->cht, worker->keys[i], worker->keys[i])) {
+            ++worker->errors;
+        }
+
+        // Read back while other threads insert (and trigger resizes)
+        if (concurrent_hash_table_get(worker->cht, worker->keys[i / 2]) != worker->keys[i / 2]) {
+            ++worker->errors;
+        }
+    }
+
+    // Delete every other key
+    for (int i = 0; i < KEYS_PER_THREAD; i += 2) {
+        if (!concurrent_hash_table_del(worker->cht, worker->keys[i])) {
+            ++worker->errors;
+        }
+    }
+
+    concurrent_hash_table_thread_detach(worker->cht);
+
+    return NULL;
+}
+
+void test_concurrent_hash_table_threads() {
+    char (*keys)[16] = malloc(THREAD_COUNT * KEYS_PER_THREAD * 16);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(keys)
+
+    for (int i = 0; i < THREAD_COUNT * KEYS_PER_THREAD; ++i) {
+        snprintf(keys[i], 16, "key%d", i);
+    }
+
+    concurrent_hash_table cht;
+    CU_ASSERT_EQUAL(concurrent_hash_table_init(&cht, 1, 4, nullptr, nullptr), true) // Grows many times
+
+    pthread_t threads[THREAD_COUNT];
+    struct concurrent_hash_table_test_worker workers[THREAD_COUNT];
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        workers[t].cht = &cht;
+        workers[t].keys = keys + t * KEYS_PER_THREAD;
+        workers[t].errors = 0;
+        CU_ASSERT_EQUAL_FATAL(pthread_create(&threads[t], NULL, writer_thread, &workers[t]), 0)
+    }
+
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        pthread_join(threads[t], NULL);
+        CU_ASSERT_EQUAL(workers[t].errors, 0)
+    }
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_size(&cht), THREAD_COUNT * KEYS_PER_THREAD / 2)
+    for (int i = 0; i < THREAD_COUNT * KEYS_PER_THREAD; ++i) {
+        CU_ASSERT_PTR_EQUAL(concurrent_hash_table_get(&cht, keys[i]), i % 2 == 0 ? NULL : keys[i])
+    }
+
+    CU_ASSERT_EQUAL(concurrent_hash_table_destroy(&cht), true)
+    free(keys);
+}
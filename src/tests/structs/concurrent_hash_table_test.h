@@ -0,0 +1,17 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_concurrent_hash_table_tests();
+
+void test_concurrent_hash_table_init_and_destroy();
+
+void test_concurrent_hash_table_get_and_set();
+
+void test_concurrent_hash_table_del();
+
+void test_concurrent_hash_table_grow();
+
+void test_concurrent_hash_table_grow_frees_old_index();
+
+void test_concurrent_hash_table_threads();
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "count_min_sketch_test.h"
+#include "../../structs/count_min_sketch.h"
+
+CU_TestInfo* get_count_min_sketch_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_count_min_sketch_init_and_destroy", test_count_min_sketch_init_and_destroy},
+        {"test_count_min_sketch_estimate", test_count_min_sketch_estimate},
+        {"test_count_min_sketch_saturate", test_count_min_sketch_saturate},
+        {"test_count_min_sketch_halve", test_count_min_sketch_halve},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_count_min_sketch_init_and_destroy() {
+    count_min_sketch cms;
+    CU_ASSERT_EQUAL(count_min_sketch_init(&cms, 100), true)
+    CU_ASSERT_EQUAL(cms.width, 128) // Rounded up to a power of 2
+    CU_ASSERT_EQUAL(cms.row_words, 8)
+    CU_ASSERT_PTR_NOT_NULL(cms.table)
+    CU_ASSERT_EQUAL(count_min_sketch_destroy(&cms), true)
+
+    CU_ASSERT_EQUAL(count_min_sketch_init(&cms, 1), true) // At least one word per row
+    CU_ASSERT_EQUAL(cms.width, 16)
+
+    CU_ASSERT_EQUAL(count_min_sketch_destroy(&cms), true)
+    CU_ASSERT_PTR_NULL(cms.table)
+    CU_ASSERT_EQUAL(cms.width, 0)
+}
+
+void test_count_min_sketch_estimate() {
+    char keys[1000][16];
+    count_min_sketch cms;
+    CU_ASSERT_EQUAL(count_min_sketch_init(&cms, 4000), true)
+
+    // Key i is counted i % 8 times
+    for (size_t i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+        for (size_t j = 0; j < i % 8; ++j) {
+            count_min_sketch_increment(&cms, (uint8_t *)keys[i], strlen(keys[i]));
+        }
+    }
+
+    // Never under-estimates, and is mostly exact with a sketch this wide
+    size_t exact = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        const uint8_t estimate = count_min_sketch_estimate(&cms, (uint8_t *)keys[i], strlen(keys[i]));
+        CU_ASSERT(estimate >= i % 8)
+        exact += estimate == i % 8;
+    }
+    CU_ASSERT(exact > 900)
+
+    count_min_sketch_clear(&cms);
+    CU_ASSERT_EQUAL(count_min_sketch_estimate(&cms, (uint8_t *)keys[7], strlen(keys[7])), 0)
+
+    CU_ASSERT_EQUAL(count_min_sketch_destroy(&cms), true)
+}
+
+void test_count_min_sketch_saturate() {
+    count_min_sketch cms;
+    CU_ASSERT_EQUAL(count_min_sketch_init(&cms, 16), true)
+
+    for (size_t i = 0; i < 100; ++i) {
+        count_min_sketch_increment(&cms, (uint8_t *)"foo", 3);
+    }
+
+    // Counters stop at the max instead of overflowing into their neighbors
+    CU_ASSERT_EQUAL(count_min_sketch_estimate(&cms, (uint8_t *)"foo", 3), COUNT_MIN_SKETCH_MAX_COUNT)
+    CU_ASSERT(count_min_sketch_estimate(&cms, (uint8_t *)"bar", 3) < COUNT_MIN_SKETCH_MAX_COUNT)
+
+    CU_ASSERT_EQUAL(count_min_sketch_destroy(&cms), true)
+}
+
+void test_count_min_sketch_halve() {
+    count_min_sketch cms;
+    CU_ASSERT_EQUAL(count_min_sketch_init(&cms, 1000), true)
+
+    for (size_t i = 0; i < 9; ++i) {
+        count_min_sketch_increment(&cms, (uint8_t *)"foo", 3);
+    }
+    count_min_sketch_increment(&cms, (uint8_t *)"bar", 3);
+
+    count_min_sketch_halve(&cms);
+    CU_ASSERT_EQUAL(count_min_sketch_estimate(&cms, (uint8_t *)"foo", 3), 4)
+    CU_ASSERT_EQUAL(count_min_sketch_estimate(&cms, (uint8_t *)"bar", 3), 0)
+
+    count_min_sketch_halve(&cms);
+    CU_ASSERT_EQUAL(count_min_sketch_estimate(&cms, (uint8_t *)"foo", 3), 2)
+
+    CU_ASSERT_EQUAL(count_min_sketch_destroy(&cms), true)
+}
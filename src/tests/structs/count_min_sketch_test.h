@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_count_min_sketch_tests();
+
+void test_count_min_sketch_init_and_destroy();
+
+void test_count_min_sketch_estimate();
+
+void test_count_min_sketch_saturate();
+
+void test_count_min_sketch_halve();
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "counting_bloom_filter_test.h"
+#include "../../structs/counting_bloom_filter.h"
+
+CU_TestInfo* get_counting_bloom_filter_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_counting_bloom_filter_init_and_destroy", test_counting_bloom_filter_init_and_destroy},
+        {"test_counting_bloom_filter", test_counting_bloom_filter},
+        {"test_counting_bloom_filter_saturation", test_counting_bloom_filter_saturation},
+        {"test_counting_bloom_filter_compact", test_counting_bloom_filter_compact},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_counting_bloom_filter_init_and_destroy() {
+    counting_bloom_filter cbf;
+    CU_ASSERT_EQUAL(counting_bloom_filter_init(&cbf, 9), true)
+    CU_ASSERT_PTR_NOT_NULL(cbf.counters)
+    CU_ASSERT_EQUAL(cbf.size, 32) // Rounded to 32 counters
+    CU_ASSERT_EQUAL(cbf.hash_count, 2)
+    CU_ASSERT_EQUAL(counting_bloom_filter_saturated(&cbf), 0)
+
+    CU_ASSERT_EQUAL(counting_bloom_filter_destroy(&cbf), true)
+    CU_ASSERT_EQUAL(cbf.size, 0)
+    CU_ASSERT_PTR_NULL(cbf.counters)
+
+    CU_ASSERT_EQUAL(counting_bloom_filter_init_with_fpr(&cbf, 0, 0.01), false)
+    CU_ASSERT_EQUAL(counting_bloom_filter_init_with_fpr(&cbf, 1000, 1), false)
+
+    // Same size as bloom_filter_init_with_fpr()
+    CU_ASSERT_EQUAL(counting_bloom_filter_init_with_fpr(&cbf, 1000, 0.01), true)
+    CU_ASSERT_EQUAL(cbf.size, 9600)
+    CU_ASSERT_EQUAL(cbf.hash_count, 7)
+    CU_ASSERT_EQUAL(counting_bloom_filter_destroy(&cbf), true)
+}
+
+void test_counting_bloom_filter() {
+    counting_bloom_filter cbf;
+    CU_ASSERT_EQUAL(counting_bloom_filter_init_with_fpr(&cbf, 100, 0.01), true)
+
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3), false)
+    CU_ASSERT_EQUAL(counting_bloom_filter_remove(&cbf, (uint8_t *)"foo", 3), false) // Not a member
+    CU_ASSERT_EQUAL(counting_bloom_filter_add(&cbf, (uint8_t *)"foo", 3), true) // ["foo"]
+    CU_ASSERT_EQUAL(counting_bloom_filter_add(&cbf, (uint8_t *)"bar", 3), true) // ["foo", "bar"]
+    CU_ASSERT_EQUAL(counting_bloom_filter_add(&cbf, (uint8_t *)"bar", 3), true) // ["foo", "bar", "bar"]
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3), true)
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"bar", 3), true)
+
+    CU_ASSERT_EQUAL(counting_bloom_filter_remove(&cbf, (uint8_t *)"foo", 3), true) // ["bar", "bar"]
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3), false)
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"bar", 3), true)
+
+    // Added twice, so it's a member until it's removed twice
+    CU_ASSERT_EQUAL(counting_bloom_filter_remove(&cbf, (uint8_t *)"bar", 3), true) // ["bar"]
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"bar", 3), true)
+    CU_ASSERT_EQUAL(counting_bloom_filter_remove(&cbf, (uint8_t *)"bar", 3), true) // []
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"bar", 3), false)
+
+    // Every counter is back to 0
+    bool all_zero = true;
+    for (size_t i = 0; i < cbf.size / 16; ++i) {
+        all_zero &= cbf.counters[i] == 0;
+    }
+    CU_ASSERT(all_zero)
+
+    // Churn: removing half the keys leaves no false negatives for the other half
+    char key[32];
+    for (size_t i = 0; i < 100; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        counting_bloom_filter_add(&cbf, (uint8_t *)key, strlen(key));
+    }
+    bool all_removed = true;
+    for (size_t i = 0; i < 100; i += 2) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_removed &= counting_bloom_filter_remove(&cbf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_removed)
+
+    bool all_found = true;
+    size_t removed_found = 0;
+    for (size_t i = 0; i < 100; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        if (i % 2 == 1) {
+            all_found &= counting_bloom_filter_check(&cbf, (uint8_t *)key, strlen(key));
+        }
+        else {
+            removed_found += counting_bloom_filter_check(&cbf, (uint8_t *)key, strlen(key));
+        }
+    }
+    CU_ASSERT(all_found) // No false negatives
+    CU_ASSERT(removed_found < 5) // Only false positives
+
+    counting_bloom_filter_clear(&cbf); // []
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"key:1", 5), false)
+
+    CU_ASSERT_EQUAL(counting_bloom_filter_destroy(&cbf), true)
+}
+
+void test_counting_bloom_filter_saturation() {
+    counting_bloom_filter cbf;
+    CU_ASSERT_EQUAL(counting_bloom_filter_init(&cbf, 1024), true)
+
+    for (size_t i = 0; i < COUNTING_BLOOM_FILTER_MAX_COUNT - 1; ++i) {
+        counting_bloom_filter_add(&cbf, (uint8_t *)"foo", 3);
+    }
+    CU_ASSERT_EQUAL(counting_bloom_filter_saturated(&cbf), 0)
+
+    // Both counters saturate at the 15th add, and stay there after that
+    counting_bloom_filter_add(&cbf, (uint8_t *)"foo", 3);
+    CU_ASSERT_EQUAL(counting_bloom_filter_saturated(&cbf), 2)
+    counting_bloom_filter_add(&cbf, (uint8_t *)"foo", 3);
+    CU_ASSERT_EQUAL(counting_bloom_filter_saturated(&cbf), 2)
+
+    // Saturated counters are never decremented, so the key stays a member
+    for (size_t i = 0; i < COUNTING_BLOOM_FILTER_MAX_COUNT + 1; ++i) {
+        CU_ASSERT_EQUAL(counting_bloom_filter_remove(&cbf, (uint8_t *)"foo", 3), true)
+    }
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3), true)
+
+    counting_bloom_filter_clear(&cbf);
+    CU_ASSERT_EQUAL(counting_bloom_filter_saturated(&cbf), 0)
+    CU_ASSERT_EQUAL(counting_bloom_filter_check(&cbf, (uint8_t *)"foo", 3), false)
+
+    CU_ASSERT_EQUAL(counting_bloom_filter_destroy(&cbf), true)
+}
+
+void test_counting_bloom_filter_compact() {
+    counting_bloom_filter cbf;
+    CU_ASSERT_EQUAL(counting_bloom_filter_init_with_fpr(&cbf, 1000, 0.01), true)
+
+    char key[32];
+    for (size_t i = 0; i < 1000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        counting_bloom_filter_add(&cbf, (uint8_t *)key, strlen(key));
+    }
+    for (size_t i = 0; i < 1000; i += 3) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        counting_bloom_filter_remove(&cbf, (uint8_t *)key, strlen(key));
+    }
+
+    bloom_filter bf;
+    CU_ASSERT_EQUAL(counting_bloom_filter_compact(&cbf, &bf), true)
+    CU_ASSERT_EQUAL(bf.bit_array->size_bits, cbf.size)
+    CU_ASSERT_EQUAL(bf.hash_count, cbf.hash_count)
+
+    // One bit for each counter that isn't 0
+    bool bits_match = true;
+    for (size_t i = 0; i < cbf.size; ++i) {
+        const bool counted = (cbf.counters[i / 16] >> (i % 16 * 4) & 0xf) != 0;
+        bits_match &= bit_array_test(bf.bit_array, i) == counted;
+    }
+    CU_ASSERT(bits_match)
+
+    // Both filters give the same answer for every key, whether or not it was added (or removed)
+    bool same = true;
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        same &= bloom_filter_check(&bf, (uint8_t *)key, strlen(key)) ==
+                counting_bloom_filter_check(&cbf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(same)
+
+    CU_ASSERT_EQUAL(bloom_filter_destroy(&bf), true)
+    CU_ASSERT_EQUAL(counting_bloom_filter_destroy(&cbf), true)
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_counting_bloom_filter_tests();
+
+void test_counting_bloom_filter_init_and_destroy();
+
+void test_counting_bloom_filter();
+
+void test_counting_bloom_filter_saturation();
+
+void test_counting_bloom_filter_compact();
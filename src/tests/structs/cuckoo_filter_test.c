@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "cuckoo_filter_test.h"
+#include "../../structs/cuckoo_filter.h"
+
+CU_TestInfo* get_cuckoo_filter_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_cuckoo_filter_init_and_destroy", test_cuckoo_filter_init_and_destroy},
+        {"test_cuckoo_filter", test_cuckoo_filter},
+        {"test_cuckoo_filter_full", test_cuckoo_filter_full},
+        {"test_cuckoo_filter_fpr", test_cuckoo_filter_fpr},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_cuckoo_filter_init_and_destroy() {
+    cuckoo_filter cf;
+    CU_ASSERT_EQUAL(cuckoo_filter_init(&cf, 100, 12), false) // Only 8 or 16 bits
+
+    // 100 keys at 95% load need 27 buckets
+    CU_ASSERT_EQUAL(cuckoo_filter_init(&cf, 100, 8), true)
+    CU_ASSERT_PTR_NOT_NULL(cf.buckets)
+    CU_ASSERT_EQUAL(cf.bucket_count, 27)
+    CU_ASSERT_EQUAL(cuckoo_filter_bytes(&cf), 108)
+    CU_ASSERT_EQUAL(cuckoo_filter_size(&cf), 0)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+    CU_ASSERT_PTR_NULL(cf.buckets)
+    CU_ASSERT_EQUAL(cf.bucket_count, 0)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_init_with_fpr(&cf, 0, 0.01), false)
+    CU_ASSERT_EQUAL(cuckoo_filter_init_with_fpr(&cf, 100, 1), false)
+    CU_ASSERT_EQUAL(cuckoo_filter_init_with_fpr(&cf, 100, 0.00001), false) // Needs more than 16 bits
+
+    CU_ASSERT_EQUAL(cuckoo_filter_init_with_fpr(&cf, 100, 0.05), true)
+    CU_ASSERT_EQUAL(cf.fingerprint_bits, 8)
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_init_with_fpr(&cf, 100, 0.01), true)
+    CU_ASSERT_EQUAL(cf.fingerprint_bits, 16)
+    CU_ASSERT_EQUAL(cuckoo_filter_bytes(&cf), 216)
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+}
+
+void test_cuckoo_filter() {
+    cuckoo_filter cf;
+    CU_ASSERT_EQUAL(cuckoo_filter_init(&cf, 100, 16), true)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"foo", 3), false)
+    CU_ASSERT_EQUAL(cuckoo_filter_remove(&cf, (uint8_t *)"foo", 3), false) // Not a member
+    CU_ASSERT_EQUAL(cuckoo_filter_add(&cf, (uint8_t *)"foo", 3), true) // ["foo"]
+    CU_ASSERT_EQUAL(cuckoo_filter_add(&cf, (uint8_t *)"bar", 3), true) // ["foo", "bar"]
+    CU_ASSERT_EQUAL(cuckoo_filter_add(&cf, (uint8_t *)"bar", 3), true) // ["foo", "bar", "bar"]
+    CU_ASSERT_EQUAL(cuckoo_filter_size(&cf), 3)
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"foo", 3), true)
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"bar", 3), true)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_remove(&cf, (uint8_t *)"foo", 3), true) // ["bar", "bar"]
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"foo", 3), false)
+
+    // Added twice, so it's a member until it's removed twice
+    CU_ASSERT_EQUAL(cuckoo_filter_remove(&cf, (uint8_t *)"bar", 3), true) // ["bar"]
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"bar", 3), true)
+    CU_ASSERT_EQUAL(cuckoo_filter_remove(&cf, (uint8_t *)"bar", 3), true) // []
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"bar", 3), false)
+    CU_ASSERT_EQUAL(cuckoo_filter_size(&cf), 0)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_add(&cf, (uint8_t *)"foo", 3), true) // ["foo"]
+    cuckoo_filter_clear(&cf); // []
+    CU_ASSERT_EQUAL(cuckoo_filter_size(&cf), 0)
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"foo", 3), false)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+}
+
+void test_cuckoo_filter_full() {
+    cuckoo_filter cf;
+    CU_ASSERT_EQUAL(cuckoo_filter_init(&cf, 1000, 16), true)
+    const size_t slots = cf.bucket_count * CUCKOO_FILTER_BUCKET_SLOTS;
+
+    // Fill until an add fails
+    char key[32];
+    size_t added = 0;
+    for (; added < slots * 2; ++added) {
+        snprintf(key, sizeof(key), "key:%zu", added);
+        if (!cuckoo_filter_add(&cf, (uint8_t *)key, strlen(key))) {
+            break;
+        }
+    }
+    CU_ASSERT(cf.has_victim)
+    CU_ASSERT(added > slots * 9 / 10 && added <= slots) // Over 90% full
+    CU_ASSERT_EQUAL(cuckoo_filter_size(&cf), added)
+
+    // Every key that was added is still there (including the victim)
+    bool all_found = true;
+    for (size_t i = 0; i < added; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= cuckoo_filter_check(&cf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found)
+
+    // Removing keys makes room for the victim, and then for new keys
+    for (size_t i = 0; i < 10; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        CU_ASSERT_EQUAL(cuckoo_filter_remove(&cf, (uint8_t *)key, strlen(key)), true)
+    }
+    CU_ASSERT_FALSE(cf.has_victim)
+    CU_ASSERT_EQUAL(cuckoo_filter_add(&cf, (uint8_t *)"foo", 3), true)
+    CU_ASSERT_EQUAL(cuckoo_filter_check(&cf, (uint8_t *)"foo", 3), true)
+
+    all_found = true;
+    for (size_t i = 10; i < added; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= cuckoo_filter_check(&cf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found)
+
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+}
+
+void test_cuckoo_filter_fpr() {
+    cuckoo_filter cf;
+    char key[32];
+
+    // About 8 / 2^8 = 3% at full load
+    CU_ASSERT_EQUAL(cuckoo_filter_init(&cf, 10000, 8), true)
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        cuckoo_filter_add(&cf, (uint8_t *)key, strlen(key));
+    }
+
+    size_t false_positives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        snprintf(key, sizeof(key), "other:%zu", i);
+        false_positives += cuckoo_filter_check(&cf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(false_positives > 2000 && false_positives < 4000)
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+
+    // About 8 / 2^16 = 0.012% at full load
+    CU_ASSERT_EQUAL(cuckoo_filter_init(&cf, 10000, 16), true)
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        cuckoo_filter_add(&cf, (uint8_t *)key, strlen(key));
+    }
+
+    false_positives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        snprintf(key, sizeof(key), "other:%zu", i);
+        false_positives += cuckoo_filter_check(&cf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(false_positives < 30)
+    CU_ASSERT_EQUAL(cuckoo_filter_destroy(&cf), true)
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_cuckoo_filter_tests();
+
+void test_cuckoo_filter_init_and_destroy();
+
+void test_cuckoo_filter();
+
+void test_cuckoo_filter_full();
+
+void test_cuckoo_filter_fpr();
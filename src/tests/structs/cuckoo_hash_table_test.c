@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cuckoo_hash_table_test.h"
+#include "../../structs/cuckoo_hash_table.h"
+
+CU_TestInfo* get_cuckoo_hash_table_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_cuckoo_hash_table_init_and_destroy", test_cuckoo_hash_table_init_and_destroy},
+        {"test_cuckoo_hash_table_get_and_set", test_cuckoo_hash_table_get_and_set},
+        {"test_cuckoo_hash_table_del", test_cuckoo_hash_table_del},
+        {"test_cuckoo_hash_table_grow", test_cuckoo_hash_table_grow},
+        {"test_cuckoo_hash_table_high_load", test_cuckoo_hash_table_high_load},
+        {"test_cuckoo_hash_table_custom_key", test_cuckoo_hash_table_custom_key},
+        {"test_cuckoo_hash_table_same_hash", test_cuckoo_hash_table_same_hash},
+        {"test_cuckoo_hash_table_iter", test_cuckoo_hash_table_iter},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_cuckoo_hash_table_init_and_destroy() {
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 50, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(ct.bucket_size, 32) // Rounded up to a power of 2 with room for 50 entries below the max load factor
+    CU_ASSERT_EQUAL((uintptr_t)ct.buckets % 64, 0) // Buckets are cache line aligned
+    CU_ASSERT_EQUAL(cuckoo_hash_table_size(&ct), 0)
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+    CU_ASSERT_PTR_NULL(ct.buckets)
+    CU_ASSERT_EQUAL(cuckoo_hash_table_size(&ct), 0)
+
+    // Get non-existent values (will print warnings)
+    CU_ASSERT_PTR_NULL(cuckoo_hash_table_get(&ct, "foo"))
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), false)
+}
+
+void test_cuckoo_hash_table_get_and_set() {
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "foo", "three"), true) // {"foo": "three", "bar": "two"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_size(&ct), 2)
+
+    CU_ASSERT_STRING_EQUAL(cuckoo_hash_table_get(&ct, "foo"), "three")
+    CU_ASSERT_STRING_EQUAL(cuckoo_hash_table_get(&ct, "bar"), "two")
+    CU_ASSERT_PTR_NULL(cuckoo_hash_table_get(&ct, "spangle"))
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_contains(&ct, "foo"), true)
+    CU_ASSERT_EQUAL(cuckoo_hash_table_contains(&ct, "spangle"), false)
+
+    // NULL keys mark empty slots, so they can't be stored (will print errors)
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, nullptr, "four"), false)
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
+
+void test_cuckoo_hash_table_del() {
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_del(&ct, "foo"), true) // {"bar": "two"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_del(&ct, "foo"), false) // Already deleted
+    CU_ASSERT_EQUAL(cuckoo_hash_table_size(&ct), 1)
+
+    CU_ASSERT_PTR_NULL(cuckoo_hash_table_get(&ct, "foo"))
+    CU_ASSERT_STRING_EQUAL(cuckoo_hash_table_get(&ct, "bar"), "two")
+
+    // Slot can be reused
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "foo", "three"), true) // {"foo": "three", "bar": "two"}
+    CU_ASSERT_STRING_EQUAL(cuckoo_hash_table_get(&ct, "foo"), "three")
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
+
+void test_cuckoo_hash_table_grow() {
+    static char keys[10000][16];
+
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 1, nullptr, nullptr), true)
+
+    for (int i = 0; i < 10000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL_FATAL(cuckoo_hash_table_set(&ct, keys[i], (void *)(intptr_t)i), true)
+    }
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_size(&ct), 10000)
+    CU_ASSERT(ct.bucket_size * CUCKOO_HASH_TABLE_BUCKET_SLOTS >= 10000)
+
+    for (int i = 0; i < 10000; ++i) {
+        CU_ASSERT_EQUAL((intptr_t)cuckoo_hash_table_get(&ct, keys[i]), i)
+    }
+
+    // Explicit resize keeps every entry
+    CU_ASSERT_EQUAL(cuckoo_hash_table_rehash(&ct, 100), false) // Smaller than the entry count (will print errors)
+    CU_ASSERT_EQUAL(cuckoo_hash_table_rehash(&ct, 50000), true)
+    for (int i = 0; i < 10000; ++i) {
+        CU_ASSERT_EQUAL((intptr_t)cuckoo_hash_table_get(&ct, keys[i]), i)
+    }
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
+
+void test_cuckoo_hash_table_high_load() {
+    static char keys[6000][16];
+
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 3000, nullptr, nullptr), true)
+    const size_t bucket_size = ct.bucket_size;
+
+    // Fill right up to the max load factor, which needs displacements but not growth
+    const int count = (int)(bucket_size * CUCKOO_HASH_TABLE_BUCKET_SLOTS * CUCKOO_HASH_TABLE_MAX_LOAD_FACTOR);
+    CU_ASSERT_FATAL(count <= 6000)
+    for (int i = 0; i < count; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL_FATAL(cuckoo_hash_table_set(&ct, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(ct.bucket_size, bucket_size)
+
+    for (int i = 0; i < count; ++i) {
+        CU_ASSERT_PTR_EQUAL(cuckoo_hash_table_get(&ct, keys[i]), keys[i])
+    }
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
+
+static uint32_t int_key_hash(const void* key, const size_t ht_size) {
+    return hash_table_hash_bytes(key, sizeof(int));
+}
+
+void test_cuckoo_hash_table_custom_key() {
+    int keys[100];
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 10, value_cmp_int, int_key_hash), true)
+
+    for (int i = 0; i < 100; ++i) {
+        keys[i] = i;
+        CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, &keys[i], &keys[i]), true)
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        const int* value = cuckoo_hash_table_get(&ct, &i);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+        CU_ASSERT_EQUAL(*value, i)
+    }
+
+    const int missing = 100;
+    CU_ASSERT_PTR_NULL(cuckoo_hash_table_get(&ct, &missing))
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
+
+static uint32_t same_key_hash(const void* key, const size_t ht_size) {
+    return 42;
+}
+
+void test_cuckoo_hash_table_same_hash() {
+    char keys[2 * CUCKOO_HASH_TABLE_BUCKET_SLOTS + 1][16];
+
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 100, nullptr, same_key_hash), true)
+
+    size_t inserted = 0;
+    for (size_t i = 0; i < 2 * CUCKOO_HASH_TABLE_BUCKET_SLOTS + 1; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+        inserted += cuckoo_hash_table_set(&ct, keys[i], keys[i]); // The last one fails (will print errors)
+    }
+
+    // Keys with the same hash share both buckets, so at most two buckets' worth fit
+    CU_ASSERT(inserted <= 2 * CUCKOO_HASH_TABLE_BUCKET_SLOTS)
+    CU_ASSERT(inserted >= CUCKOO_HASH_TABLE_BUCKET_SLOTS)
+    CU_ASSERT_EQUAL(cuckoo_hash_table_size(&ct), inserted)
+
+    // A failed insert leaves the table as it was
+    for (size_t i = 0; i < inserted; ++i) {
+        CU_ASSERT_PTR_EQUAL(cuckoo_hash_table_get(&ct, keys[i]), keys[i])
+    }
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
+
+static void test_cuckoo_hash_table_iter_func(hash_table_entry* entry, const size_t index, void* count) {
+    *(int *)count += strlen(entry->key) + strlen(entry->value);
+}
+
+void test_cuckoo_hash_table_iter() {
+    int count = 0;
+    cuckoo_hash_table ct;
+    CU_ASSERT_EQUAL(cuckoo_hash_table_init(&ct, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(cuckoo_hash_table_set(&ct, "spangle", "two"), true) // {"foo": "one", "spangle": "two"}
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_iter(&ct, test_cuckoo_hash_table_iter_func, &count), true)
+    CU_ASSERT_EQUAL(count, 16)
+
+    CU_ASSERT_EQUAL(cuckoo_hash_table_destroy(&ct), true)
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_cuckoo_hash_table_tests();
+
+void test_cuckoo_hash_table_init_and_destroy();
+
+void test_cuckoo_hash_table_get_and_set();
+
+void test_cuckoo_hash_table_del();
+
+void test_cuckoo_hash_table_grow();
+
+void test_cuckoo_hash_table_high_load();
+
+void test_cuckoo_hash_table_custom_key();
+
+void test_cuckoo_hash_table_same_hash();
+
+void test_cuckoo_hash_table_iter();
@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "disk_hash_table_test.h"
+#include "../../structs/disk_hash_table.h"
+
+/**
+ * File the tests write to (in the working directory)
+ */
+#define TEST_PATH "disk_hash_table_test.dht"
+
+CU_TestInfo* get_disk_hash_table_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_disk_hash_table_write_and_open", test_disk_hash_table_write_and_open},
+        {"test_disk_hash_table_binary_keys_and_values", test_disk_hash_table_binary_keys_and_values},
+        {"test_disk_hash_table_many_entries", test_disk_hash_table_many_entries},
+        {"test_disk_hash_table_empty", test_disk_hash_table_empty},
+        {"test_disk_hash_table_invalid_file", test_disk_hash_table_invalid_file},
+        {"test_disk_hash_table_file_mode", test_disk_hash_table_file_mode},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_disk_hash_table_write_and_open() {
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "foo", "one"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "bar", "two"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "spangle", ""), true)
+
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    disk_hash_table dht;
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), true)
+    CU_ASSERT_EQUAL(disk_hash_table_size(&dht), 3)
+
+    size_t value_len = 0;
+    const char* value = disk_hash_table_get(&dht, "foo", &value_len);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+    CU_ASSERT_STRING_EQUAL(value, "one") // NUL-terminated in the file
+    CU_ASSERT_EQUAL(value_len, 3)
+    CU_ASSERT_EQUAL((uintptr_t)value % 8, 0) // Values are aligned
+
+    CU_ASSERT_STRING_EQUAL(disk_hash_table_get(&dht, "bar", nullptr), "two")
+
+    value = disk_hash_table_get(&dht, "spangle", &value_len);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+    CU_ASSERT_STRING_EQUAL(value, "")
+    CU_ASSERT_EQUAL(value_len, 0)
+
+    CU_ASSERT_PTR_NULL(disk_hash_table_get(&dht, "baz", nullptr))
+    CU_ASSERT_PTR_NULL(disk_hash_table_get(&dht, "fo", nullptr))
+    CU_ASSERT_PTR_NULL(disk_hash_table_get(&dht, "fooo", nullptr))
+
+    CU_ASSERT_EQUAL(disk_hash_table_close(&dht), true)
+    CU_ASSERT_PTR_NULL(dht.data)
+
+    unlink(TEST_PATH);
+}
+
+/**
+ * Fixed-size binary value
+ */
+typedef struct test_blob {
+    uint64_t id;
+    double weight;
+} test_blob;
+
+static size_t test_blob_len(const void* value, void* user_arg) {
+    *(int *)user_arg += 1;
+    return sizeof(test_blob);
+}
+
+void test_disk_hash_table_binary_keys_and_values() {
+    const uint8_t key1[] = {0x00, 0x01, 0x02};
+    const uint8_t key2[] = {0x00, 0x01, 0x03};
+    test_blob blob1 = {.id = 1, .weight = 0.5};
+    test_blob blob2 = {.id = 2, .weight = 1.5};
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_set_n(&ht, (void *)key1, sizeof(key1), &blob1), true)
+    CU_ASSERT_EQUAL(hash_table_set_n(&ht, (void *)key2, sizeof(key2), &blob2), true)
+
+    int calls = 0;
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, test_blob_len, &calls), true)
+    CU_ASSERT_EQUAL(calls, 2)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    disk_hash_table dht;
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), true)
+
+    size_t value_len = 0;
+    const test_blob* value = disk_hash_table_get_n(&dht, key2, sizeof(key2), &value_len);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+    CU_ASSERT_EQUAL(value_len, sizeof(test_blob))
+    CU_ASSERT_EQUAL(value->id, 2)
+    CU_ASSERT_DOUBLE_EQUAL(value->weight, 1.5, 0.0)
+
+    value = disk_hash_table_get_n(&dht, key1, sizeof(key1), nullptr);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+    CU_ASSERT_EQUAL(value->id, 1)
+
+    CU_ASSERT_PTR_NULL(disk_hash_table_get_n(&dht, key1, 2, nullptr)) // Prefix of a key
+
+    CU_ASSERT_EQUAL(disk_hash_table_close(&dht), true)
+
+    unlink(TEST_PATH);
+}
+
+void test_disk_hash_table_many_entries() {
+    static char keys[5000][16];
+    static char values[5000][16];
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    for (int i = 0; i < 5000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        snprintf(values[i], sizeof(values[i]), "value%d", i * 7);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], values[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    // Rewriting replaces the file
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    for (int i = 0; i < 5000; i += 2) {
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], values[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    disk_hash_table dht;
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), true)
+    CU_ASSERT_EQUAL(disk_hash_table_size(&dht), 2500)
+
+    for (int i = 0; i < 5000; ++i) {
+        const char* value = disk_hash_table_get(&dht, keys[i], nullptr);
+        if (i % 2 == 0) {
+            CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+            CU_ASSERT_STRING_EQUAL(value, values[i])
+        }
+        else {
+            CU_ASSERT_PTR_NULL(value)
+        }
+    }
+
+    CU_ASSERT_EQUAL(disk_hash_table_close(&dht), true)
+
+    unlink(TEST_PATH);
+}
+
+void test_disk_hash_table_empty() {
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    disk_hash_table dht;
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), true)
+    CU_ASSERT_EQUAL(disk_hash_table_size(&dht), 0)
+    CU_ASSERT_PTR_NULL(disk_hash_table_get(&dht, "foo", nullptr))
+    CU_ASSERT_EQUAL(disk_hash_table_close(&dht), true)
+
+    unlink(TEST_PATH);
+}
+
+void test_disk_hash_table_invalid_file() {
+    disk_hash_table dht;
+
+    // Missing file (will print errors)
+    unlink(TEST_PATH);
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), false)
+
+    // Not a disk hash table
+    FILE* file = fopen(TEST_PATH, "wb");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(file)
+    for (int i = 0; i < 100; ++i) {
+        fputs("garbage ", file);
+    }
+    fclose(file);
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), false)
+
+    // Truncated
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "foo", "one"), true)
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+    CU_ASSERT_EQUAL(truncate(TEST_PATH, sizeof(disk_hash_table_header) + 8), 0)
+    CU_ASSERT_EQUAL(disk_hash_table_open(&dht, TEST_PATH), false)
+
+    // Not open
+    CU_ASSERT_EQUAL(disk_hash_table_close(&dht), false)
+
+    unlink(TEST_PATH);
+}
+
+void test_disk_hash_table_file_mode() {
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "foo", "one"), true)
+
+    struct stat st;
+
+    // Files get the same permissions as any other file created under the umask
+    const mode_t old_mask = umask(077);
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL_FATAL(stat(TEST_PATH, &st), 0)
+    CU_ASSERT_EQUAL(st.st_mode & 0777, 0600)
+
+    umask(022);
+    CU_ASSERT_EQUAL(disk_hash_table_write(&ht, TEST_PATH, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL_FATAL(stat(TEST_PATH, &st), 0)
+    CU_ASSERT_EQUAL(st.st_mode & 0777, 0644)
+
+    umask(old_mask);
+    unlink(TEST_PATH);
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_disk_hash_table_tests();
+
+void test_disk_hash_table_write_and_open();
+
+void test_disk_hash_table_binary_keys_and_values();
+
+void test_disk_hash_table_many_entries();
+
+void test_disk_hash_table_empty();
+
+void test_disk_hash_table_invalid_file();
+
+void test_disk_hash_table_file_mode();
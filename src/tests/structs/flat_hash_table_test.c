@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "flat_hash_table_test.h"
+#include "../../structs/flat_hash_table.h"
+
+CU_TestInfo* get_flat_hash_table_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_flat_hash_table_init_and_destroy", test_flat_hash_table_init_and_destroy},
+        {"test_flat_hash_table_get_and_set", test_flat_hash_table_get_and_set},
+        {"test_flat_hash_table_del", test_flat_hash_table_del},
+        {"test_flat_hash_table_grow", test_flat_hash_table_grow},
+        {"test_flat_hash_table_rehash", test_flat_hash_table_rehash},
+        {"test_flat_hash_table_custom_key", test_flat_hash_table_custom_key},
+        {"test_flat_hash_table_binary_keys", test_flat_hash_table_binary_keys},
+        {"test_flat_hash_table_keys_and_values", test_flat_hash_table_keys_and_values},
+        {"test_flat_hash_table_iter", test_flat_hash_table_iter},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_flat_hash_table_init_and_destroy() {
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 50, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(ft.capacity, 64) // Rounded up to a power of 2 with room for 50 entries
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 0)
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+    CU_ASSERT_PTR_NULL(ft.ctrl)
+    CU_ASSERT_PTR_NULL(ft.slots)
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 0)
+
+    // Get non-existent values (will print warnings)
+    CU_ASSERT_PTR_NULL(flat_hash_table_get(&ft, "foo"))
+}
+
+void test_flat_hash_table_get_and_set() {
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "foo"), "one")
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "two"), true) // {"foo": "two"}
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "foo"), "two")
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 1)
+    CU_ASSERT_PTR_NULL(flat_hash_table_get(&ft, "doesnt_exist"))
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "bar", "three"), true) // {"foo": "two", "bar": "three"}
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "foo"), "two")
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "bar"), "three")
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 2)
+
+    hash_table_entry* entry = flat_hash_table_get_entry(&ft, "bar");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(entry)
+    CU_ASSERT_STRING_EQUAL(entry->key, "bar")
+    CU_ASSERT_STRING_EQUAL(entry->value, "three")
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
+
+void test_flat_hash_table_del() {
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+
+    CU_ASSERT_EQUAL(flat_hash_table_del(&ft, "bar"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(flat_hash_table_del(&ft, "bar"), false)
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "foo"), "one")
+    CU_ASSERT_PTR_NULL(flat_hash_table_get(&ft, "bar"))
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 1)
+
+    // Reinsert over the tombstone
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "bar", "three"), true) // {"foo": "one", "bar": "three"}
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "bar"), "three")
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 2)
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
+
+void test_flat_hash_table_grow() {
+    const size_t count = 2000;
+    char (*keys)[16] = malloc(count * sizeof(*keys));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(keys)
+
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 0, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(ft.capacity, 16)
+
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+        CU_ASSERT_EQUAL(flat_hash_table_set(&ft, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), count)
+    CU_ASSERT(ft.capacity >= count)
+
+    bool all_found = true;
+    for (size_t i = 0; i < count; ++i) {
+        all_found &= flat_hash_table_get(&ft, keys[i]) == keys[i];
+    }
+    CU_ASSERT(all_found)
+
+    // Churn deletes and inserts so tombstones get cleared
+    const size_t capacity = ft.capacity;
+    for (int round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < count; i += 2) {
+            CU_ASSERT_EQUAL(flat_hash_table_del(&ft, keys[i]), true)
+        }
+        for (size_t i = 0; i < count; i += 2) {
+            CU_ASSERT_EQUAL(flat_hash_table_set(&ft, keys[i], keys[i]), true)
+        }
+    }
+
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), count)
+    CU_ASSERT_EQUAL(ft.capacity, capacity)
+
+    all_found = true;
+    for (size_t i = 0; i < count; ++i) {
+        all_found &= flat_hash_table_get(&ft, keys[i]) == keys[i];
+    }
+    CU_ASSERT(all_found)
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+    free(keys);
+}
+
+void test_flat_hash_table_rehash() {
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 2, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "foo"), "one")
+
+    // Rehash
+    CU_ASSERT_EQUAL(flat_hash_table_rehash(&ft, 100), true)
+    CU_ASSERT_EQUAL(ft.capacity, 128)
+    CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, "foo"), "one")
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 1)
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
+
+/**
+ * Weak hash that forces lots of h2 collisions
+ */
+static uint32_t int_key_hash(const void* key, const size_t _ht_size) {
+    return *(const int *)key % 7;
+}
+
+void test_flat_hash_table_custom_key() {
+    int keys[100];
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 10, value_cmp_int, int_key_hash), true)
+
+    for (int i = 0; i < 100; ++i) {
+        keys[i] = i;
+        CU_ASSERT_EQUAL(flat_hash_table_set(&ft, &keys[i], &keys[i]), true)
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        const int* value = flat_hash_table_get(&ft, &i);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+        CU_ASSERT_EQUAL(*value, i)
+    }
+
+    const int missing = 100;
+    CU_ASSERT_PTR_NULL(flat_hash_table_get(&ft, &missing))
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
+
+void test_flat_hash_table_binary_keys() {
+    uint8_t uuids[100][16];
+    for (int i = 0; i < 100; ++i) {
+        memset(uuids[i], 0, 16); // Mostly NUL bytes
+        uuids[i][15] = (uint8_t)i;
+    }
+
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 10, nullptr, nullptr), true)
+
+    for (int i = 0; i < 100; ++i) {
+        CU_ASSERT_EQUAL(flat_hash_table_set_n(&ft, uuids[i], 16, uuids[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 100)
+
+    uint8_t lookup[16];
+    memcpy(lookup, uuids[42], 16);
+    CU_ASSERT_PTR_EQUAL(flat_hash_table_get_n(&ft, lookup, 16), uuids[42])
+    CU_ASSERT_PTR_NULL(flat_hash_table_get_n(&ft, lookup, 15)) // Different length
+
+    const hash_table_entry* entry = flat_hash_table_get_entry_n(&ft, lookup, 16);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(entry)
+    CU_ASSERT_EQUAL(entry->key_len, 16)
+
+    CU_ASSERT_EQUAL(flat_hash_table_del_n(&ft, lookup, 16), true)
+    CU_ASSERT_EQUAL(flat_hash_table_del_n(&ft, lookup, 16), false)
+    CU_ASSERT_PTR_NULL(flat_hash_table_get_n(&ft, uuids[42], 16))
+    CU_ASSERT_PTR_EQUAL(flat_hash_table_get_n(&ft, uuids[43], 16), uuids[43])
+    CU_ASSERT_EQUAL(flat_hash_table_size(&ft), 99)
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
+
+void test_flat_hash_table_keys_and_values() {
+    char* keys[5];
+    char* values[5];
+    memset(keys, 0, sizeof(keys));
+    memset(values, 0, sizeof(values));
+
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(flat_hash_table_keys(&ft, (void *)keys), 0)
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+
+    CU_ASSERT_EQUAL(flat_hash_table_keys(&ft, (void *)keys), 2)
+    CU_ASSERT_EQUAL(flat_hash_table_values(&ft, (void *)values), 2)
+    CU_ASSERT_PTR_NULL(keys[2])
+
+    // Keys and values are returned in the same (slot) order
+    for (int i = 0; i < 2; ++i) {
+        CU_ASSERT_STRING_EQUAL(flat_hash_table_get(&ft, keys[i]), values[i])
+    }
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
+
+static void test_flat_hash_table_iter_func(hash_table_entry* entry, const size_t index, void* count) {
+    *(int *)count += strlen(entry->key) + strlen(entry->value);
+}
+
+void test_flat_hash_table_iter() {
+    int count = 0;
+    flat_hash_table ft;
+    CU_ASSERT_EQUAL(flat_hash_table_init(&ft, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(flat_hash_table_set(&ft, "spangle", "two"), true) // {"foo": "one", "spangle": "two"}
+
+    CU_ASSERT_EQUAL(flat_hash_table_iter(&ft, test_flat_hash_table_iter_func, &count), true)
+    CU_ASSERT_EQUAL(count, 16)
+
+    CU_ASSERT_EQUAL(flat_hash_table_destroy(&ft), true)
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_flat_hash_table_tests();
+
+void test_flat_hash_table_init_and_destroy();
+
+void test_flat_hash_table_get_and_set();
+
+void test_flat_hash_table_del();
+
+void test_flat_hash_table_grow();
+
+void test_flat_hash_table_rehash();
+
+void test_flat_hash_table_custom_key();
+
+void test_flat_hash_table_binary_keys();
+
+void test_flat_hash_table_keys_and_values();
+
+void test_flat_hash_table_iter();
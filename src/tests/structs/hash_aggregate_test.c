@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hash_aggregate_test.h"
+#include "../../structs/hash_aggregate.h"
+
+CU_TestInfo* get_hash_aggregate_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_hash_aggregate_init_and_destroy", test_hash_aggregate_init_and_destroy},
+        {"test_hash_aggregate_add", test_hash_aggregate_add},
+        {"test_hash_aggregate_merge", test_hash_aggregate_merge},
+        {"test_hash_aggregate_iter", test_hash_aggregate_iter},
+        {"test_hash_aggregate_add_parallel", test_hash_aggregate_add_parallel},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_hash_aggregate_init_and_destroy() {
+    hash_aggregate agg;
+    CU_ASSERT_EQUAL(hash_aggregate_init(&agg, 0, nullptr, nullptr), false)
+
+    CU_ASSERT_EQUAL(hash_aggregate_init(&agg, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&agg), 0)
+    CU_ASSERT_PTR_NULL(hash_aggregate_get(&agg, "foo"))
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&agg), true)
+}
+
+void test_hash_aggregate_add() {
+    hash_aggregate agg;
+    CU_ASSERT_EQUAL(hash_aggregate_init(&agg, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "foo", 1), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "foo", 5), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "bar", -2), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "foo", 3), true)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&agg), 2)
+
+    const hash_aggregate_state* p_foo = hash_aggregate_get(&agg, "foo");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_foo)
+    CU_ASSERT_EQUAL(p_foo->count, 3)
+    CU_ASSERT_EQUAL(p_foo->sum, 9)
+    CU_ASSERT_EQUAL(p_foo->min, 1)
+    CU_ASSERT_EQUAL(p_foo->max, 5)
+
+    const hash_aggregate_state* p_bar = hash_aggregate_get(&agg, "bar");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_bar)
+    CU_ASSERT_EQUAL(p_bar->count, 1)
+    CU_ASSERT_EQUAL(p_bar->sum, -2)
+    CU_ASSERT_EQUAL(p_bar->min, -2)
+    CU_ASSERT_EQUAL(p_bar->max, -2)
+
+    CU_ASSERT_PTR_NULL(hash_aggregate_get(&agg, "spangle"))
+
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&agg), true)
+}
+
+void test_hash_aggregate_merge() {
+    hash_aggregate a, b;
+    CU_ASSERT_EQUAL(hash_aggregate_init(&a, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_aggregate_init(&b, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(hash_aggregate_add(&a, "foo", 1), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&a, "bar", 2), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&b, "foo", 10), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&b, "baz", -3), true)
+
+    CU_ASSERT_EQUAL(hash_aggregate_merge(&a, &b), true)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&a), 3)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&b), 2) // Unchanged
+
+    const hash_aggregate_state* p_foo = hash_aggregate_get(&a, "foo");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_foo)
+    CU_ASSERT_EQUAL(p_foo->count, 2)
+    CU_ASSERT_EQUAL(p_foo->sum, 11)
+    CU_ASSERT_EQUAL(p_foo->min, 1)
+    CU_ASSERT_EQUAL(p_foo->max, 10)
+
+    const hash_aggregate_state* p_baz = hash_aggregate_get(&a, "baz");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_baz)
+    CU_ASSERT_EQUAL(p_baz->count, 1)
+    CU_ASSERT_EQUAL(p_baz->min, -3)
+
+    // Merged states are copies
+    CU_ASSERT_PTR_NOT_EQUAL(p_baz, hash_aggregate_get(&b, "baz"))
+
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&a), true)
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&b), true)
+}
+
+static void test_hash_aggregate_sum_iter(const void* key, const hash_aggregate_state* state, void* totals) {
+    ((int64_t *)totals)[0] += (int64_t)state->count;
+    ((int64_t *)totals)[1] += state->sum;
+}
+
+void test_hash_aggregate_iter() {
+    hash_aggregate agg;
+    CU_ASSERT_EQUAL(hash_aggregate_init(&agg, 10, nullptr, nullptr), true)
+
+    int64_t totals[2] = {0, 0};
+    CU_ASSERT_EQUAL(hash_aggregate_iter(&agg, test_hash_aggregate_sum_iter, totals), true)
+    CU_ASSERT_EQUAL(totals[0], 0)
+
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "foo", 1), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "bar", 2), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add(&agg, "foo", 3), true)
+
+    CU_ASSERT_EQUAL(hash_aggregate_iter(&agg, test_hash_aggregate_sum_iter, totals), true)
+    CU_ASSERT_EQUAL(totals[0], 3)
+    CU_ASSERT_EQUAL(totals[1], 6)
+
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&agg), true)
+}
+
+void test_hash_aggregate_add_parallel() {
+    const size_t rows = 100000;
+    const size_t groups = 100;
+    char (*group_keys)[16] = malloc(groups * sizeof(*group_keys));
+    void** keys = malloc(rows * sizeof(void*));
+    int64_t* values = malloc(rows * sizeof(int64_t));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(group_keys)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(keys)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(values)
+
+    for (size_t i = 0; i < groups; ++i) {
+        snprintf(group_keys[i], sizeof(group_keys[i]), "group:%zu", i);
+    }
+
+    for (size_t i = 0; i < rows; ++i) {
+        keys[i] = group_keys[i % groups];
+        values[i] = (int64_t)i;
+    }
+
+    hash_aggregate serial, parallel;
+    CU_ASSERT_EQUAL(hash_aggregate_init(&serial, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_aggregate_init(&parallel, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(hash_aggregate_add_parallel(&serial, keys, values, rows, 1), true)
+    CU_ASSERT_EQUAL(hash_aggregate_add_parallel(&parallel, keys, values, rows, 4), true)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&serial), groups)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&parallel), groups)
+
+    bool all_equal = true;
+    for (size_t i = 0; i < groups; ++i) {
+        const hash_aggregate_state* p_serial = hash_aggregate_get(&serial, group_keys[i]);
+        const hash_aggregate_state* p_parallel = hash_aggregate_get(&parallel, group_keys[i]);
+        all_equal &= p_serial != NULL && p_parallel != NULL &&
+                     p_parallel->count == rows / groups && p_serial->count == p_parallel->count &&
+                     p_serial->sum == p_parallel->sum && p_serial->min == (int64_t)i &&
+                     p_parallel->min == (int64_t)i && p_serial->max == p_parallel->max;
+    }
+    CU_ASSERT(all_equal)
+
+    // Adds to groups that are already there
+    CU_ASSERT_EQUAL(hash_aggregate_add_parallel(&parallel, keys, values, rows, 0), true)
+    CU_ASSERT_EQUAL(hash_aggregate_size(&parallel), groups)
+    CU_ASSERT_EQUAL(hash_aggregate_get(&parallel, group_keys[0])->count, rows / groups * 2)
+
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&serial), true)
+    CU_ASSERT_EQUAL(hash_aggregate_destroy(&parallel), true)
+
+    free(values);
+    free(keys);
+    free(group_keys);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_hash_aggregate_tests();
+
+void test_hash_aggregate_init_and_destroy();
+
+void test_hash_aggregate_add();
+
+void test_hash_aggregate_merge();
+
+void test_hash_aggregate_iter();
+
+void test_hash_aggregate_add_parallel();
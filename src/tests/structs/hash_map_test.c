@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "hash_map_test.h"
+#include "../../structs/hash_map.h"
+
+LUPRA_HASHMAP_DECLARE(test_counter_map, uint64_t, uint32_t, hash_map_hash_u64, hash_map_eq_u64)
+
+/**
+ * Fixed-size struct key
+ */
+typedef struct test_point {
+    int32_t x;
+    int32_t y;
+} test_point;
+
+static inline uint64_t test_point_hash(const test_point p) {
+    return hash_map_hash_u64((uint64_t)(uint32_t)p.x << 32 | (uint32_t)p.y);
+}
+
+static inline bool test_point_eq(const test_point a, const test_point b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+LUPRA_HASHMAP_DECLARE(test_point_map, test_point, const char*, test_point_hash, test_point_eq)
+
+/**
+ * Hash that sends every key to the same slot, so all entries share one probe run
+ */
+#define TEST_COLLIDING_HASH(key) ((uint64_t)0)
+
+LUPRA_HASHMAP_DECLARE(test_colliding_map, uint32_t, uint32_t, TEST_COLLIDING_HASH, hash_map_eq_u32)
+
+CU_TestInfo* get_hash_map_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_hash_map_init_and_destroy", test_hash_map_init_and_destroy},
+        {"test_hash_map_get_and_set", test_hash_map_get_and_set},
+        {"test_hash_map_del", test_hash_map_del},
+        {"test_hash_map_grow", test_hash_map_grow},
+        {"test_hash_map_struct_key", test_hash_map_struct_key},
+        {"test_hash_map_next", test_hash_map_next},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_hash_map_init_and_destroy() {
+    test_counter_map map;
+    CU_ASSERT_EQUAL(test_counter_map_init(&map, 100), true)
+    CU_ASSERT_EQUAL(map.capacity, 256) // Rounded up to a power of 2 that's at most 3/4 full
+    CU_ASSERT_EQUAL(test_counter_map_size(&map), 0)
+
+    test_counter_map_destroy(&map);
+    CU_ASSERT_PTR_NULL(map.keys)
+    CU_ASSERT_EQUAL(map.capacity, 0)
+}
+
+void test_hash_map_get_and_set() {
+    test_counter_map map;
+    CU_ASSERT_EQUAL(test_counter_map_init(&map, 10), true)
+
+    CU_ASSERT_PTR_NULL(test_counter_map_get(&map, 42))
+
+    CU_ASSERT_EQUAL(test_counter_map_set(&map, 42, 1), true)
+    CU_ASSERT_EQUAL(test_counter_map_set(&map, 0, 7), true) // Zero is a valid key
+    CU_ASSERT_EQUAL(test_counter_map_size(&map), 2)
+
+    uint32_t* count = test_counter_map_get(&map, 42);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(count)
+    CU_ASSERT_EQUAL(*count, 1)
+
+    // Update in place through the returned pointer
+    ++*count;
+    CU_ASSERT_EQUAL(*test_counter_map_get(&map, 42), 2)
+
+    // Update with set
+    CU_ASSERT_EQUAL(test_counter_map_set(&map, 42, 10), true)
+    CU_ASSERT_EQUAL(*test_counter_map_get(&map, 42), 10)
+    CU_ASSERT_EQUAL(*test_counter_map_get(&map, 0), 7)
+    CU_ASSERT_EQUAL(test_counter_map_size(&map), 2)
+
+    test_counter_map_destroy(&map);
+}
+
+void test_hash_map_del() {
+    test_colliding_map map;
+    CU_ASSERT_EQUAL(test_colliding_map_init(&map, 16), true)
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        CU_ASSERT_EQUAL(test_colliding_map_set(&map, i, i * 10), true)
+    }
+
+    // Deleting from the middle of a probe run shifts later entries back so they stay reachable
+    CU_ASSERT_EQUAL(test_colliding_map_del(&map, 5), true)
+    CU_ASSERT_EQUAL(test_colliding_map_del(&map, 5), false)
+    CU_ASSERT_EQUAL(test_colliding_map_del(&map, 0), true)
+    CU_ASSERT_EQUAL(test_colliding_map_del(&map, 100), false)
+    CU_ASSERT_EQUAL(test_colliding_map_size(&map), 14)
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t* value = test_colliding_map_get(&map, i);
+        if (i == 0 || i == 5) {
+            CU_ASSERT_PTR_NULL(value)
+        }
+        else {
+            CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+            CU_ASSERT_EQUAL(*value, i * 10)
+        }
+    }
+
+    test_colliding_map_destroy(&map);
+}
+
+void test_hash_map_grow() {
+    test_counter_map map;
+    CU_ASSERT_EQUAL(test_counter_map_init(&map, 0), true)
+    CU_ASSERT_EQUAL(map.capacity, HASH_MAP_MIN_CAPACITY)
+
+    for (uint64_t i = 0; i < 10000; ++i) {
+        CU_ASSERT_EQUAL(test_counter_map_set(&map, i * 7919, (uint32_t)i), true)
+    }
+
+    CU_ASSERT_EQUAL(test_counter_map_size(&map), 10000)
+    CU_ASSERT(map.size <= map.capacity - map.capacity / 4)
+
+    for (uint64_t i = 0; i < 10000; i += 2) {
+        CU_ASSERT_EQUAL(test_counter_map_del(&map, i * 7919), true)
+    }
+
+    for (uint64_t i = 0; i < 10000; ++i) {
+        const uint32_t* value = test_counter_map_get(&map, i * 7919);
+        if (i % 2 == 0) {
+            CU_ASSERT_PTR_NULL(value)
+        }
+        else {
+            CU_ASSERT_PTR_NOT_NULL_FATAL(value)
+            CU_ASSERT_EQUAL(*value, i)
+        }
+    }
+
+    test_counter_map_destroy(&map);
+}
+
+void test_hash_map_struct_key() {
+    test_point_map map;
+    CU_ASSERT_EQUAL(test_point_map_init(&map, 4), true)
+
+    CU_ASSERT_EQUAL(test_point_map_set(&map, (test_point){1, 2}, "a"), true)
+    CU_ASSERT_EQUAL(test_point_map_set(&map, (test_point){2, 1}, "b"), true)
+    CU_ASSERT_EQUAL(test_point_map_set(&map, (test_point){-1, -2}, "c"), true)
+
+    CU_ASSERT_STRING_EQUAL(*test_point_map_get(&map, (test_point){1, 2}), "a")
+    CU_ASSERT_STRING_EQUAL(*test_point_map_get(&map, (test_point){2, 1}), "b")
+    CU_ASSERT_STRING_EQUAL(*test_point_map_get(&map, (test_point){-1, -2}), "c")
+    CU_ASSERT_PTR_NULL(test_point_map_get(&map, (test_point){1, 1}))
+
+    test_point_map_destroy(&map);
+}
+
+void test_hash_map_next() {
+    test_counter_map map;
+    CU_ASSERT_EQUAL(test_counter_map_init(&map, 10), true)
+
+    for (uint64_t i = 1; i <= 100; ++i) {
+        CU_ASSERT_EQUAL(test_counter_map_set(&map, i, (uint32_t)(i * 2)), true)
+    }
+
+    size_t pos = 0;
+    size_t count = 0;
+    uint64_t key_sum = 0;
+    uint64_t key;
+    uint32_t value;
+    while (test_counter_map_next(&map, &pos, &key, &value)) {
+        CU_ASSERT_EQUAL(value, key * 2)
+        key_sum += key;
+        ++count;
+    }
+
+    CU_ASSERT_EQUAL(count, 100)
+    CU_ASSERT_EQUAL(key_sum, 5050)
+
+    test_counter_map_destroy(&map);
+}
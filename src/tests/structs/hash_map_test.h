@@ -0,0 +1,17 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_hash_map_tests();
+
+void test_hash_map_init_and_destroy();
+
+void test_hash_map_get_and_set();
+
+void test_hash_map_del();
+
+void test_hash_map_grow();
+
+void test_hash_map_struct_key();
+
+void test_hash_map_next();
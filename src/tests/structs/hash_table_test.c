@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "hash_table_test.h"
@@ -7,6 +8,16 @@ CU_TestInfo* get_hash_table_tests() {
     static CU_TestInfo tests[] = {
         {"test_hash_table_init_and_destroy", test_hash_table_init_and_destroy},
         {"test_hash_table_rehash", test_hash_table_rehash},
+        {"test_hash_table_auto_grow", test_hash_table_auto_grow},
+        {"test_hash_table_incremental_rehash", test_hash_table_incremental_rehash},
+        {"test_hash_table_auto_shrink", test_hash_table_auto_shrink},
+        {"test_hash_table_set_load_factors", test_hash_table_set_load_factors},
+        {"test_hash_table_custom_allocator", test_hash_table_custom_allocator},
+        {"test_hash_table_cached_hash", test_hash_table_cached_hash},
+        {"test_hash_table_binary_keys", test_hash_table_binary_keys},
+        {"test_hash_table_get_and_set_many", test_hash_table_get_and_set_many},
+        {"test_hash_table_scan", test_hash_table_scan},
+        {"test_hash_table_scan_during_resize", test_hash_table_scan_during_resize},
         {"test_hash_table_get_and_set", test_hash_table_get_and_set},
         {"test_hash_table_set_entry", test_hash_table_set_entry},
         {"test_hash_table_del", test_hash_table_del},
@@ -15,6 +26,11 @@ CU_TestInfo* get_hash_table_tests() {
         {"test_hash_table_has_no_duplicates", test_hash_table_has_no_duplicates},
         {"test_hash_table_iter", test_hash_table_iter},
         {"test_hash_table_size", test_hash_table_size},
+        {"test_hash_table_stats", test_hash_table_stats},
+        {"test_hash_table_counters", test_hash_table_counters},
+        {"test_hash_table_bulk_load", test_hash_table_bulk_load},
+        {"test_hash_table_bulk_load_duplicates", test_hash_table_bulk_load_duplicates},
+        {"test_hash_table_get_or_insert", test_hash_table_get_or_insert},
         CU_TEST_INFO_NULL,
     };
 
@@ -52,6 +68,443 @@ void test_hash_table_rehash() {
     CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
 }
 
+void test_hash_table_auto_grow() {
+    char keys[1000][16];
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 4, nullptr, nullptr), true)
+
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 1000)
+
+    // Index doubled as entries were added (possibly with the last migration still in progress)
+    const size_t index_size = hash_table_is_rehashing(&ht) ? ht.rehash_index_size : ht.index_size;
+    CU_ASSERT(index_size >= 1000)
+
+    bool all_found = true;
+    for (int i = 0; i < 1000; ++i) {
+        all_found &= hash_table_get(&ht, keys[i]) == keys[i];
+    }
+    CU_ASSERT(all_found)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_incremental_rehash() {
+    char keys[9][16];
+    void* found_keys[9];
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 8, nullptr, nullptr), true)
+
+    for (int i = 0; i < 9; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    // The 9th entry went over the max load factor of 1.0 and started (but didn't finish) a rehash
+    CU_ASSERT_EQUAL(hash_table_is_rehashing(&ht), true)
+    CU_ASSERT_EQUAL(ht.index_size, 8)
+    CU_ASSERT_EQUAL(ht.rehash_index_size, 16)
+
+    // Entries are reachable in either index
+    bool all_found = true;
+    for (int i = 0; i < 9; ++i) {
+        all_found &= hash_table_get(&ht, keys[i]) == keys[i];
+    }
+    CU_ASSERT(all_found)
+    CU_ASSERT_EQUAL(hash_table_keys(&ht, found_keys), 9)
+
+    // Updates and deletes work on entries that haven't been migrated yet
+    CU_ASSERT_EQUAL(hash_table_set(&ht, keys[0], "updated"), true)
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, keys[0]), "updated")
+    CU_ASSERT_EQUAL(hash_table_del(&ht, keys[1]), true)
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, keys[1]))
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 8)
+
+    // Finish the migration
+    CU_ASSERT_EQUAL(hash_table_rehash_step(&ht, 100), true)
+    CU_ASSERT_EQUAL(hash_table_is_rehashing(&ht), false)
+    CU_ASSERT_EQUAL(ht.index_size, 16)
+    CU_ASSERT_PTR_NULL(ht.rehash_index)
+
+    all_found = true;
+    for (int i = 2; i < 9; ++i) {
+        all_found &= hash_table_get(&ht, keys[i]) == keys[i];
+    }
+    CU_ASSERT(all_found)
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, keys[0]), "updated")
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_auto_shrink() {
+    char keys[100][16];
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 4, nullptr, nullptr), true)
+
+    for (int i = 0; i < 100; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+    CU_ASSERT_EQUAL(hash_table_rehash_step(&ht, 1000), true)
+    CU_ASSERT_EQUAL(ht.index_size, 128)
+
+    for (int i = 0; i < 90; ++i) {
+        CU_ASSERT_EQUAL(hash_table_del(&ht, keys[i]), true)
+    }
+    CU_ASSERT_EQUAL(hash_table_rehash_step(&ht, 1000), true)
+    CU_ASSERT(ht.index_size < 128)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 10)
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, keys[99]), keys[99])
+
+    // Shrinks, but never below the initial size
+    for (int i = 90; i < 100; ++i) {
+        CU_ASSERT_EQUAL(hash_table_del(&ht, keys[i]), true)
+    }
+    CU_ASSERT_EQUAL(hash_table_rehash_step(&ht, 1000), true)
+    CU_ASSERT_EQUAL(ht.index_size, 4)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 0)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_set_load_factors() {
+    char keys[100][16];
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 4, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_set_load_factors(&ht, 0.5f, 0.5f), false) // min must be <= max / 2
+    CU_ASSERT_EQUAL(hash_table_set_load_factors(&ht, 0, 0), true) // Never resize
+
+    for (int i = 0; i < 100; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_is_rehashing(&ht), false)
+    CU_ASSERT_EQUAL(ht.index_size, 4)
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, keys[50]), keys[50])
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+/**
+ * Allocator that counts allocations
+ */
+struct hash_table_allocator_ctx {
+    size_t allocs;
+    size_t frees;
+};
+
+static void* hash_table_test_alloc(const size_t size, void* ctx) {
+    ++((struct hash_table_allocator_ctx *)ctx)->allocs;
+    return malloc(size);
+}
+
+static void hash_table_test_free(void* ptr, const size_t _size, void* ctx) {
+    ++((struct hash_table_allocator_ctx *)ctx)->frees;
+    free(ptr);
+}
+
+void test_hash_table_custom_allocator() {
+    char keys[1000][16];
+    struct hash_table_allocator_ctx ctx = {0, 0};
+    const mem_allocator allocator = {hash_table_test_alloc, hash_table_test_free, &ctx};
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init_with_allocator(&ht, 2048, nullptr, nullptr, &allocator), true)
+
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    for (int i = 0; i < 1000; i += 2) {
+        CU_ASSERT_EQUAL(hash_table_del(&ht, keys[i]), true)
+    }
+
+    for (int i = 0; i < 1000; i += 2) {
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, keys[500]), keys[500])
+
+    // Slabs double in size, so 3000 allocations only need a handful of slabs per pool
+    CU_ASSERT(ctx.allocs > 0)
+    CU_ASSERT(ctx.allocs < 20)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+    CU_ASSERT_EQUAL(ctx.frees, ctx.allocs)
+}
+
+static size_t cached_hash_cmp_calls = 0;
+static size_t cached_hash_hash_calls = 0;
+
+static int cached_hash_cmp(const void* a, const void* b) {
+    ++cached_hash_cmp_calls;
+    return value_cmp_string(a, b);
+}
+
+static uint32_t cached_hash_hash(const void* key, const size_t ht_size) {
+    ++cached_hash_hash_calls;
+    return hash_table_key_hash_string(key, ht_size);
+}
+
+void test_hash_table_cached_hash() {
+    char keys[100][16];
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 3, cached_hash_cmp, cached_hash_hash), true) // Long chains
+    CU_ASSERT_EQUAL(hash_table_set_load_factors(&ht, 0, 0), true)
+
+    for (int i = 0; i < 100; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    hash_table_entry* entry = hash_table_get_entry(&ht, keys[42]);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(entry)
+    CU_ASSERT_EQUAL(entry->hash, hash_table_key_hash_string(keys[42], SIZE_MAX))
+
+    // Only the matching entry's key is compared, even though it shares a chain with ~50 others
+    cached_hash_cmp_calls = 0;
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, keys[42]), keys[42])
+    CU_ASSERT_EQUAL(cached_hash_cmp_calls, 1)
+
+    cached_hash_cmp_calls = 0;
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, "missing"))
+    CU_ASSERT_EQUAL(cached_hash_cmp_calls, 0)
+
+    // Rehashing reuses the stored hashes
+    cached_hash_hash_calls = 0;
+    CU_ASSERT_EQUAL(hash_table_rehash(&ht, 200), true)
+    CU_ASSERT_EQUAL(cached_hash_hash_calls, 0)
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, keys[99]), keys[99])
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+/**
+ * Packed binary key (contains NUL bytes)
+ */
+typedef struct binary_key_tuple {
+    uint32_t src_addr;
+    uint32_t dst_addr;
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint8_t protocol;
+    uint8_t _pad[3];
+} binary_key_tuple;
+
+void test_hash_table_binary_keys() {
+    binary_key_tuple keys[200];
+    memset(keys, 0, sizeof(keys));
+    for (int i = 0; i < 200; ++i) {
+        keys[i].src_addr = 0x0a000001;
+        keys[i].dst_addr = 0x0a000002;
+        keys[i].src_port = (uint16_t)i;
+        keys[i].dst_port = 443;
+        keys[i].protocol = 6;
+    }
+
+    hash_table t;
+    CU_ASSERT_EQUAL(hash_table_init(&t, 10, nullptr, nullptr), true)
+
+    for (int i = 0; i < 200; ++i) {
+        CU_ASSERT_EQUAL(hash_table_set_n(&t, &keys[i], sizeof(binary_key_tuple), &keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_size(&t), 200)
+
+    // Lookups compare key bytes, not pointers
+    binary_key_tuple lookup = keys[150];
+    CU_ASSERT_PTR_EQUAL(hash_table_get_n(&t, &lookup, sizeof(lookup)), &keys[150])
+
+    const hash_table_entry* entry = hash_table_get_entry_n(&t, &lookup, sizeof(lookup));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(entry)
+    CU_ASSERT_EQUAL(entry->key_len, sizeof(binary_key_tuple))
+
+    // Same prefix but a different length is a different key
+    CU_ASSERT_PTR_NULL(hash_table_get_n(&t, &lookup, sizeof(lookup) - 1))
+
+    lookup.dst_port = 80;
+    CU_ASSERT_PTR_NULL(hash_table_get_n(&t, &lookup, sizeof(lookup)))
+
+    // Keys can contain NUL bytes
+    const uint8_t with_nul_a[] = {'a', 0, 'b'};
+    const uint8_t with_nul_b[] = {'a', 0, 'c'};
+    CU_ASSERT_EQUAL(hash_table_set_n(&t, (void *)with_nul_a, sizeof(with_nul_a), "a0b"), true)
+    CU_ASSERT_EQUAL(hash_table_set_n(&t, (void *)with_nul_b, sizeof(with_nul_b), "a0c"), true)
+    CU_ASSERT_STRING_EQUAL(hash_table_get_n(&t, with_nul_a, sizeof(with_nul_a)), "a0b")
+    CU_ASSERT_STRING_EQUAL(hash_table_get_n(&t, with_nul_b, sizeof(with_nul_b)), "a0c")
+
+    // Update existing key
+    CU_ASSERT_EQUAL(hash_table_set_n(&t, (void *)with_nul_a, sizeof(with_nul_a), "updated"), true)
+    CU_ASSERT_STRING_EQUAL(hash_table_get_n(&t, with_nul_a, sizeof(with_nul_a)), "updated")
+    CU_ASSERT_EQUAL(hash_table_size(&t), 202)
+
+    for (int i = 0; i < 200; i += 2) {
+        CU_ASSERT_EQUAL(hash_table_del_n(&t, &keys[i], sizeof(binary_key_tuple)), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_del_n(&t, &keys[0], sizeof(binary_key_tuple)), false) // Already deleted
+    CU_ASSERT_EQUAL(hash_table_size(&t), 102)
+
+    for (int i = 0; i < 200; ++i) {
+        CU_ASSERT_PTR_EQUAL(hash_table_get_n(&t, &keys[i], sizeof(binary_key_tuple)), i % 2 == 0 ? NULL : &keys[i])
+    }
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&t), true)
+}
+
+void test_hash_table_get_and_set_many() {
+    char keys[300][16];
+    void* key_ptrs[300];
+    void* values[300];
+    void* values_out[300];
+
+    for (int i = 0; i < 300; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        key_ptrs[i] = keys[i];
+        values[i] = keys[(i + 1) % 300];
+    }
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 4, nullptr, nullptr), true)
+
+    // Not a multiple of the group size, and grows (rehashes) part way through
+    CU_ASSERT_EQUAL(hash_table_set_many(&ht, key_ptrs, values, 201), true)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 201)
+
+    // Duplicate keys in a batch: the last value wins, like sequential sets
+    void* dup_keys[] = {keys[0], keys[1], keys[0]};
+    void* dup_values[] = {"first", "second", "third"};
+    CU_ASSERT_EQUAL(hash_table_set_many(&ht, dup_keys, dup_values, 3), true)
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, keys[0]), "third")
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, keys[1]), "second")
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 201)
+
+    // Lookups include misses (keys 201+) and match hash_table_get()
+    CU_ASSERT_EQUAL(hash_table_get_many(&ht, key_ptrs, 300, values_out), 201)
+    for (int i = 0; i < 300; ++i) {
+        CU_ASSERT_PTR_EQUAL(values_out[i], hash_table_get(&ht, keys[i]))
+    }
+
+    // Same results while an incremental rehash is in progress
+    CU_ASSERT_EQUAL(hash_table_set_many(&ht, key_ptrs + 201, values + 201, 99), true)
+    CU_ASSERT_EQUAL(hash_table_is_rehashing(&ht), true)
+    CU_ASSERT_EQUAL(hash_table_get_many(&ht, key_ptrs, 300, values_out), 300)
+    for (int i = 2; i < 300; ++i) {
+        CU_ASSERT_PTR_EQUAL(values_out[i], values[i])
+    }
+
+    CU_ASSERT_EQUAL(hash_table_get_many(&ht, key_ptrs, 0, values_out), 0)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_scan() {
+    char keys[500][16];
+    uint8_t seen[500];
+    hash_table_entry* entries[7];
+    memset(seen, 0, sizeof(seen));
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 16, nullptr, nullptr), true)
+
+    // Empty table
+    uint64_t cursor = 0;
+    CU_ASSERT_EQUAL(hash_table_scan(&ht, &cursor, 7, entries), 0)
+    CU_ASSERT_EQUAL(cursor, 0)
+
+    for (int i = 0; i < 500; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], (void *)(intptr_t)i), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_scan(&ht, &cursor, 0, entries), -1) // Invalid batch size
+
+    size_t calls = 0;
+    do {
+        const size_t count = hash_table_scan(&ht, &cursor, 7, entries);
+        CU_ASSERT_FATAL(count <= 7)
+        for (size_t i = 0; i < count; ++i) {
+            ++seen[(intptr_t)entries[i]->value];
+        }
+        ++calls;
+    }
+    while (cursor != 0);
+
+    CU_ASSERT(calls >= 500 / 7)
+    for (int i = 0; i < 500; ++i) {
+        CU_ASSERT_EQUAL(seen[i], 1)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_scan_during_resize() {
+    char keys[2000][16];
+    uint8_t seen[2000];
+    hash_table_entry* entries[10];
+    memset(seen, 0, sizeof(seen));
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 8, nullptr, nullptr), true)
+
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], (void *)(intptr_t)i), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_rehash(&ht, 1000), true)
+
+    // Grow, shrink and rehash between calls: every key that's there for the whole scan is returned exactly once
+    uint64_t cursor = 0;
+    size_t calls = 0;
+    size_t rehashing_calls = 0;
+    int next_key = 1000;
+    do {
+        const size_t count = hash_table_scan(&ht, &cursor, 10, entries);
+        CU_ASSERT_FATAL(count <= 10)
+        for (size_t i = 0; i < count; ++i) {
+            ++seen[(intptr_t)entries[i]->value];
+        }
+
+        rehashing_calls += hash_table_is_rehashing(&ht);
+
+        ++calls;
+        if (calls == 10) {
+            CU_ASSERT_EQUAL(hash_table_rehash(&ht, 37), true) // Shrink (uneven bucket ranges)
+        }
+        else if (calls == 40) {
+            CU_ASSERT_EQUAL(hash_table_rehash(&ht, 64), true)
+        }
+        else if (calls > 10 && next_key < 2000) {
+            // Insert keys as the scan goes (the index is overloaded, so this keeps incremental rehashes going)
+            for (int j = 0; j < 10 && next_key < 2000; ++j, ++next_key) {
+                snprintf(keys[next_key], sizeof(keys[next_key]), "key%d", next_key);
+                CU_ASSERT_EQUAL(hash_table_set(&ht, keys[next_key], (void *)(intptr_t)next_key), true)
+            }
+        }
+    }
+    while (cursor != 0);
+
+    CU_ASSERT(rehashing_calls > 0)
+
+    for (int i = 0; i < 1000; ++i) {
+        CU_ASSERT_EQUAL(seen[i], 1)
+    }
+
+    // Keys added during the scan are returned at most once
+    for (int i = 1000; i < 2000; ++i) {
+        CU_ASSERT(seen[i] <= 1)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
 void test_hash_table_get_and_set() {
     hash_table ht;
     CU_ASSERT_EQUAL(hash_table_init(&ht, 50, nullptr, nullptr), true)
@@ -119,8 +572,8 @@ void test_hash_table_keys() {
 
     CU_ASSERT_EQUAL(hash_table_keys(&ht, (void *)keys), 3)
     CU_ASSERT_STRING_EQUAL(keys[0], "bar")
-    CU_ASSERT_STRING_EQUAL(keys[1], "spangle")
-    CU_ASSERT_STRING_EQUAL(keys[2], "foo")
+    CU_ASSERT_STRING_EQUAL(keys[1], "foo")
+    CU_ASSERT_STRING_EQUAL(keys[2], "spangle")
     CU_ASSERT_PTR_NULL(keys[3])
 
     CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
@@ -141,8 +594,8 @@ void test_hash_table_values() {
 
     CU_ASSERT_EQUAL(hash_table_values(&ht, (void *)values), 3)
     CU_ASSERT_STRING_EQUAL(values[0], "two")
-    CU_ASSERT_STRING_EQUAL(values[1], "three")
-    CU_ASSERT_STRING_EQUAL(values[2], "one")
+    CU_ASSERT_STRING_EQUAL(values[1], "one")
+    CU_ASSERT_STRING_EQUAL(values[2], "three")
     CU_ASSERT_PTR_NULL(values[3])
 
     CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
@@ -199,3 +652,259 @@ void test_hash_table_size() {
     CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
     CU_ASSERT_EQUAL(hash_table_size(&ht), 0)
 }
+
+static uint32_t stats_key_hash(const void* key, const size_t ht_size) {
+    return *(const char *)key == 'a' ? 0 : hash_table_key_hash_string(key, ht_size); // Keys starting with 'a' collide
+}
+
+void test_hash_table_stats() {
+    char keys[20][16];
+    hash_table_stats_snapshot stats;
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 64, nullptr, stats_key_hash), true)
+
+    CU_ASSERT_EQUAL(hash_table_stats(&ht, &stats), true)
+    CU_ASSERT_EQUAL(stats.entry_size, 0)
+    CU_ASSERT_EQUAL(stats.index_size, 64)
+    CU_ASSERT_EQUAL(stats.used_buckets, 0)
+    CU_ASSERT_EQUAL(stats.max_chain, 0)
+    CU_ASSERT_EQUAL(stats.chain_histogram[0], 64)
+
+    // 10 keys in one chain, and 10 spread out
+    for (size_t i = 0; i < 20; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "%c%zu", i < 10 ? 'a' : 'b', i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], keys[i]), true)
+    }
+
+    CU_ASSERT_EQUAL(hash_table_stats(&ht, &stats), true)
+    CU_ASSERT_EQUAL(stats.entry_size, 20)
+    CU_ASSERT_DOUBLE_EQUAL(stats.load_factor, 20.0 / 64.0, 0.0001)
+    CU_ASSERT(stats.max_chain >= 10)
+    CU_ASSERT(stats.chain_histogram[10] + stats.chain_histogram[11] >= 1)
+
+    size_t buckets = 0;
+    size_t entries = 0;
+    for (size_t i = 0; i < HASH_TABLE_STATS_HISTOGRAM_SIZE; ++i) {
+        buckets += stats.chain_histogram[i];
+        entries += i * stats.chain_histogram[i];
+    }
+    CU_ASSERT_EQUAL(buckets, 64)
+    CU_ASSERT_EQUAL(entries, 20)
+    CU_ASSERT_EQUAL(buckets - stats.chain_histogram[0], stats.used_buckets)
+
+#ifdef LUPRA_HASH_TABLE_STATS
+    CU_ASSERT_EQUAL(stats.counters_enabled, true)
+#else
+    CU_ASSERT_EQUAL(stats.counters_enabled, false)
+    CU_ASSERT_EQUAL(stats.counters.lookups, 0)
+#endif
+
+    // Both indexes are counted during a rehash
+    ht.max_load_factor = 0.25f;
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "c", "c"), true) // Starts a rehash
+    CU_ASSERT_EQUAL(hash_table_is_rehashing(&ht), true)
+    CU_ASSERT_EQUAL(hash_table_stats(&ht, &stats), true)
+    CU_ASSERT_EQUAL(stats.rehash_index_size, 128)
+
+    buckets = 0;
+    for (size_t i = 0; i < HASH_TABLE_STATS_HISTOGRAM_SIZE; ++i) {
+        buckets += stats.chain_histogram[i];
+    }
+    CU_ASSERT_EQUAL(buckets, 64 + 128)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_counters() {
+    hash_table_stats_snapshot stats;
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "foo", "one"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "bar", "two"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "foo", "three"), true)
+    CU_ASSERT_PTR_NOT_NULL(hash_table_get(&ht, "foo"))
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, "spangle"))
+    CU_ASSERT_EQUAL(hash_table_del(&ht, "bar"), true)
+    CU_ASSERT_EQUAL(hash_table_stats(&ht, &stats), true)
+
+#ifdef LUPRA_HASH_TABLE_STATS
+    CU_ASSERT_EQUAL(stats.counters.lookups, 6)
+    CU_ASSERT_EQUAL(stats.counters.hits, 3) // Replacing foo, getting foo, deleting bar
+    CU_ASSERT_EQUAL(stats.counters.misses, 3) // Setting foo and bar, getting spangle
+    CU_ASSERT(stats.counters.key_cmps >= 3)
+    CU_ASSERT(stats.counters.probes >= stats.counters.key_cmps)
+    CU_ASSERT(stats.counters.allocations >= 5) // Index, 2 entries, 2 nodes (plus their bucket lists)
+    CU_ASSERT_EQUAL(stats.counters.rehashes, 0)
+
+    hash_table_reset_counters(&ht);
+    CU_ASSERT_EQUAL(hash_table_stats(&ht, &stats), true)
+    CU_ASSERT_EQUAL(stats.counters.lookups, 0)
+
+    CU_ASSERT_EQUAL(hash_table_rehash(&ht, 100), true)
+    CU_ASSERT_EQUAL(hash_table_stats(&ht, &stats), true)
+    CU_ASSERT_EQUAL(stats.counters.rehashes, 1)
+#else
+    // Counting is compiled out
+    CU_ASSERT_EQUAL(stats.counters_enabled, false)
+    CU_ASSERT_EQUAL(stats.counters.lookups, 0)
+    hash_table_reset_counters(&ht);
+#endif
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_hash_table_bulk_load() {
+    const size_t count = 100000; // Several partitions
+    char (*keys)[16] = malloc(count * sizeof(*keys));
+    void** key_ptrs = malloc(count * sizeof(void*));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(keys)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(key_ptrs)
+
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key:%zu", i);
+        key_ptrs[i] = keys[i];
+    }
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_bulk_load(&ht, key_ptrs, key_ptrs, 0, 4), true)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 0)
+
+    CU_ASSERT_EQUAL(hash_table_bulk_load(&ht, key_ptrs, key_ptrs, count, 4), true)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), count)
+    CU_ASSERT(ht.index_size >= count) // Sized up front for the default max load factor
+    CU_ASSERT_EQUAL(hash_table_is_rehashing(&ht), false)
+
+    bool all_found = true;
+    for (size_t i = 0; i < count; ++i) {
+        all_found &= hash_table_get(&ht, keys[i]) == keys[i];
+    }
+    CU_ASSERT(all_found)
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, "key:-1"))
+
+    // Loaded entries behave like any other
+    CU_ASSERT_EQUAL(hash_table_del(&ht, "key:0"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "key:1", "one"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "spangle", "two"), true)
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, "key:0"))
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, "key:1"), "one")
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, "spangle"), "two")
+    CU_ASSERT_EQUAL(hash_table_size(&ht), count)
+
+    // Non-empty tables fall back to hash_table_set_many()
+    void* extra_keys[] = {"key:1", "foo"};
+    void* extra_values[] = {"three", "four"};
+    CU_ASSERT_EQUAL(hash_table_bulk_load(&ht, extra_keys, extra_values, 2, 4), true)
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, "key:1"), "three")
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, "foo"), "four")
+    CU_ASSERT_EQUAL(hash_table_size(&ht), count + 1)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    // Single threaded, into a table that was emptied by deletes
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "foo", "one"), true)
+    CU_ASSERT_EQUAL(hash_table_del(&ht, "foo"), true)
+    CU_ASSERT_EQUAL(hash_table_bulk_load(&ht, key_ptrs, key_ptrs, 1000, 1), true)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 1000)
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, keys[999]), keys[999])
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, keys[1000]))
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    free(key_ptrs);
+    free(keys);
+}
+
+void test_hash_table_bulk_load_duplicates() {
+    const size_t count = 50000;
+    char (*keys)[16] = malloc(count * sizeof(*keys));
+    void** key_ptrs = malloc(count * sizeof(void*));
+    void** values = malloc(count * sizeof(void*));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(keys)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(key_ptrs)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(values)
+
+    // Every key appears 5 times, and the last value wins
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key:%zu", i % (count / 5));
+        key_ptrs[i] = keys[i];
+        values[i] = (void *)(i + 1);
+    }
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(hash_table_bulk_load(&ht, key_ptrs, values, count, 0), true)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), count / 5)
+
+    bool last_wins = true;
+    for (size_t i = count - count / 5; i < count; ++i) {
+        last_wins &= hash_table_get(&ht, keys[i]) == values[i];
+    }
+    CU_ASSERT(last_wins)
+
+    // Unused entries went back to the pool
+    void* p_entry = ht.entry_pool.free_list;
+    CU_ASSERT_PTR_NOT_NULL(p_entry)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, "spangle", "one"), true)
+    CU_ASSERT_PTR_EQUAL(hash_table_get_entry(&ht, "spangle"), p_entry)
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+
+    free(values);
+    free(key_ptrs);
+    free(keys);
+}
+
+void test_hash_table_get_or_insert() {
+    bool inserted;
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 2, nullptr, nullptr), true)
+
+    void** p_slot = hash_table_get_or_insert(&ht, "foo", &inserted);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_slot)
+    CU_ASSERT_EQUAL(inserted, true)
+    CU_ASSERT_PTR_NULL(*p_slot) // New entries start out NULL
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 1)
+    *p_slot = "one";
+
+    CU_ASSERT_PTR_EQUAL(hash_table_get_or_insert(&ht, "foo", &inserted), p_slot)
+    CU_ASSERT_EQUAL(inserted, false)
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, "foo"), "one")
+
+    // Slots stay valid while the index grows
+    char keys[100][16];
+    for (size_t i = 0; i < 100; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key:%zu", i);
+        void** p_count = hash_table_get_or_insert(&ht, keys[i], &inserted);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(p_count)
+        *p_count = (void *)((uintptr_t)*p_count + 1);
+    }
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 101)
+    CU_ASSERT_STRING_EQUAL(*p_slot, "one")
+    CU_ASSERT_PTR_EQUAL(hash_table_get(&ht, "key:42"), (void *)1)
+
+    // Binary keys
+    const uint64_t id = 1234;
+    p_slot = hash_table_get_or_insert_n(&ht, (void *)&id, sizeof(id), &inserted);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_slot)
+    CU_ASSERT_EQUAL(inserted, true)
+    *p_slot = "two";
+    CU_ASSERT_PTR_EQUAL(hash_table_get_or_insert_n(&ht, (void *)&id, sizeof(id), &inserted), p_slot)
+    CU_ASSERT_EQUAL(inserted, false)
+    CU_ASSERT_STRING_EQUAL(hash_table_get_n(&ht, &id, sizeof(id)), "two")
+
+    // Precomputed hashes
+    const uint32_t hash = hash_table_key_hash_string("bar", SIZE_MAX);
+    CU_ASSERT_PTR_NULL(hash_table_get_with_hash(&ht, "bar", hash))
+    p_slot = hash_table_get_or_insert_with_hash(&ht, "bar", hash, &inserted);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_slot)
+    CU_ASSERT_EQUAL(inserted, true)
+    *p_slot = "three";
+    CU_ASSERT_PTR_EQUAL(hash_table_get_or_insert_with_hash(&ht, "bar", hash, &inserted), p_slot)
+    CU_ASSERT_EQUAL(inserted, false)
+    CU_ASSERT_STRING_EQUAL(hash_table_get_with_hash(&ht, "bar", hash), "three")
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, "bar"), "three")
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
@@ -8,6 +8,26 @@ void test_hash_table_init_and_destroy();
 
 void test_hash_table_rehash();
 
+void test_hash_table_auto_grow();
+
+void test_hash_table_incremental_rehash();
+
+void test_hash_table_auto_shrink();
+
+void test_hash_table_set_load_factors();
+
+void test_hash_table_custom_allocator();
+
+void test_hash_table_cached_hash();
+
+void test_hash_table_binary_keys();
+
+void test_hash_table_get_and_set_many();
+
+void test_hash_table_scan();
+
+void test_hash_table_scan_during_resize();
+
 void test_hash_table_get_and_set();
 
 void test_hash_table_set_entry();
@@ -23,3 +43,13 @@ void test_hash_table_has_no_duplicates();
 void test_hash_table_iter();
 
 void test_hash_table_size();
+
+void test_hash_table_stats();
+
+void test_hash_table_counters();
+
+void test_hash_table_bulk_load();
+
+void test_hash_table_bulk_load_duplicates();
+
+void test_hash_table_get_or_insert();
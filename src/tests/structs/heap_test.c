@@ -1,3 +1,5 @@
+#include <stdlib.h>
+
 #include "heap_test.h"
 #include "../../structs/heap.h"
 #include "../../structs/array_list.h"
@@ -10,6 +12,7 @@ CU_TestInfo* get_heap_tests() {
         {"test_heap_init_and_destroy", test_heap_init_and_destroy},
         {"test_min_heap", test_min_heap},
         {"test_max_heap", test_max_heap},
+        {"test_heap_interleaved", test_heap_interleaved},
         CU_TEST_INFO_NULL,
     };
 
@@ -115,3 +118,33 @@ void test_max_heap() {
 
     CU_ASSERT_EQUAL(heap_destroy(&max_heap), true)
 }
+
+void test_heap_interleaved() {
+    static int random_values[1000];
+    heap min_heap;
+    CU_ASSERT_EQUAL(heap_init(&min_heap, MIN_HEAP, value_cmp_int, 16), true)
+
+    // Popping leaves old values past the end of the heap array, which pushes and pops after it must ignore
+    int last_popped = -1;
+    size_t pushed = 0;
+    for (size_t round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < 100; ++i) {
+            random_values[pushed] = last_popped + 1 + rand() % 1000; // Never less than what was already popped
+            CU_ASSERT_EQUAL(heap_push(&min_heap, &random_values[pushed++]), true)
+        }
+
+        for (size_t i = 0; i < 70; ++i) {
+            const int popped = *(int *)heap_pop(&min_heap);
+            CU_ASSERT(popped >= last_popped)
+            last_popped = popped;
+        }
+    }
+
+    while (min_heap.size > 0) {
+        const int popped = *(int *)heap_pop(&min_heap);
+        CU_ASSERT(popped >= last_popped)
+        last_popped = popped;
+    }
+
+    CU_ASSERT_EQUAL(heap_destroy(&min_heap), true)
+}
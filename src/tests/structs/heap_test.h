@@ -9,3 +9,5 @@ void test_heap_init_and_destroy();
 void test_min_heap();
 
 void test_max_heap();
+
+void test_heap_interleaved();
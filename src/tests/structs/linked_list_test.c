@@ -5,6 +5,8 @@ CU_TestInfo* get_linked_list_tests() {
     static CU_TestInfo tests[] = {
         {"test_linked_list_init_and_destroy", test_linked_list_init_and_destroy},
         {"test_linked_list", test_linked_list},
+        {"test_linked_list_pop_head", test_linked_list_pop_head},
+        {"test_linked_list_intrusive_nodes", test_linked_list_intrusive_nodes},
         {"test_linked_list_forward_iter", test_linked_list_forward_iter},
         {"test_linked_list_backward_iter", test_linked_list_backward_iter},
         CU_TEST_INFO_NULL,
@@ -64,6 +66,77 @@ void test_linked_list() {
     CU_ASSERT_EQUAL(linked_list_destroy(&lst), true)
 }
 
+void test_linked_list_pop_head() {
+    linked_list lst;
+    CU_ASSERT_EQUAL(linked_list_init(&lst), true)
+
+    CU_ASSERT_EQUAL(linked_list_push_tail(&lst, "foo"), true) // ["foo"]
+    CU_ASSERT_EQUAL(linked_list_push_tail(&lst, "bar"), true) // ["foo", "bar"]
+
+    CU_ASSERT_STRING_EQUAL(linked_list_pop_head(&lst), "foo") // ["bar"]
+    CU_ASSERT_EQUAL(lst.size, 1)
+    CU_ASSERT_PTR_NULL(lst.head->prev)
+    CU_ASSERT_PTR_EQUAL(lst.head, lst.tail)
+
+    CU_ASSERT_STRING_EQUAL(linked_list_pop_head(&lst), "bar") // []
+    CU_ASSERT_EQUAL(lst.size, 0)
+    CU_ASSERT_PTR_NULL(lst.head)
+    CU_ASSERT_PTR_NULL(lst.tail)
+
+    CU_ASSERT_PTR_NULL(linked_list_pop_head(&lst))
+
+    // Still usable after being emptied
+    CU_ASSERT_EQUAL(linked_list_push_tail(&lst, "spangle"), true) // ["spangle"]
+    CU_ASSERT_STRING_EQUAL(linked_list_head(&lst), "spangle")
+    CU_ASSERT_STRING_EQUAL(linked_list_tail(&lst), "spangle")
+
+    CU_ASSERT_EQUAL(linked_list_destroy(&lst), true)
+}
+
+void test_linked_list_intrusive_nodes() {
+    list_node nodes[3] = {
+        {.value = "foo"},
+        {.value = "bar"},
+        {.value = "spangle"},
+    };
+
+    linked_list lst;
+    CU_ASSERT_EQUAL(linked_list_init(&lst), true)
+
+    linked_list_link_tail(&lst, &nodes[0]); // ["foo"]
+    linked_list_link_tail(&lst, &nodes[1]); // ["foo", "bar"]
+    linked_list_link_head(&lst, &nodes[2]); // ["spangle", "foo", "bar"]
+    CU_ASSERT_EQUAL(lst.size, 3)
+    CU_ASSERT_PTR_EQUAL(lst.head, &nodes[2])
+    CU_ASSERT_PTR_EQUAL(lst.tail, &nodes[1])
+
+    linked_list_move_to_head(&lst, &nodes[1]); // ["bar", "spangle", "foo"]
+    CU_ASSERT_PTR_EQUAL(lst.head, &nodes[1])
+    CU_ASSERT_PTR_EQUAL(lst.tail, &nodes[0])
+    CU_ASSERT_PTR_EQUAL(nodes[1].next, &nodes[2])
+    CU_ASSERT_PTR_EQUAL(nodes[0].prev, &nodes[2])
+
+    linked_list_move_to_head(&lst, &nodes[1]); // Already at head
+    CU_ASSERT_PTR_EQUAL(lst.head, &nodes[1])
+    CU_ASSERT_EQUAL(lst.size, 3)
+
+    linked_list_unlink(&lst, &nodes[2]); // ["bar", "foo"]
+    CU_ASSERT_EQUAL(lst.size, 2)
+    CU_ASSERT_PTR_EQUAL(nodes[1].next, &nodes[0])
+    CU_ASSERT_PTR_EQUAL(nodes[0].prev, &nodes[1])
+    CU_ASSERT_PTR_NULL(nodes[2].next)
+    CU_ASSERT_PTR_NULL(nodes[2].prev)
+
+    linked_list_unlink(&lst, &nodes[0]); // ["bar"]
+    linked_list_unlink(&lst, &nodes[1]); // []
+    CU_ASSERT_EQUAL(lst.size, 0)
+    CU_ASSERT_PTR_NULL(lst.head)
+    CU_ASSERT_PTR_NULL(lst.tail)
+
+    // Nothing left for destroy to free
+    CU_ASSERT_EQUAL(linked_list_destroy(&lst), true)
+}
+
 static void test_list_iter_func(const list_node* item, size_t index, void* result) {
     strcat(result, "(");
     strcat(result, item->value);
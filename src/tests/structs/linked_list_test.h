@@ -8,6 +8,10 @@ void test_linked_list_init_and_destroy();
 
 void test_linked_list();
 
+void test_linked_list_pop_head();
+
+void test_linked_list_intrusive_nodes();
+
 void test_linked_list_forward_iter();
 
 void test_linked_list_backward_iter();
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lru_cache_test.h"
+#include "../../structs/lru_cache.h"
+
+CU_TestInfo* get_lru_cache_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_lru_cache_init_and_destroy", test_lru_cache_init_and_destroy},
+        {"test_lru_cache_get_and_put", test_lru_cache_get_and_put},
+        {"test_lru_cache_evict_order", test_lru_cache_evict_order},
+        {"test_lru_cache_max_bytes", test_lru_cache_max_bytes},
+        {"test_lru_cache_evict_func", test_lru_cache_evict_func},
+        {"test_lru_cache_clock", test_lru_cache_clock},
+        {"test_lru_cache_del_and_peek", test_lru_cache_del_and_peek},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_lru_cache_init_and_destroy() {
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 10, 0, LRU_CACHE_POLICY_LRU, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 0)
+    CU_ASSERT_EQUAL(lru_cache_byte_size(&cache), 0)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "foo", "one", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "bar", "two", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 2)
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 0)
+}
+
+void test_lru_cache_get_and_put() {
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 10, 0, LRU_CACHE_POLICY_LRU, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "foo", "one", 0), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "bar", "two", 0), true) // {"foo": "one", "bar": "two"}
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "foo", "three", 0), true) // {"foo": "three", "bar": "two"}
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 2)
+
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "foo"), "three")
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "bar"), "two")
+    CU_ASSERT_PTR_NULL(lru_cache_get(&cache, "spangle"))
+
+    // Most recently used first
+    CU_ASSERT_STRING_EQUAL(((lru_cache_entry *)cache.list.head->value)->key, "bar")
+    CU_ASSERT_STRING_EQUAL(((lru_cache_entry *)cache.list.tail->value)->key, "foo")
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+}
+
+void test_lru_cache_evict_order() {
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 3, 0, LRU_CACHE_POLICY_LRU, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "a", "1", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "b", "2", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "3", 0), true)
+
+    CU_ASSERT_PTR_NOT_NULL(lru_cache_get(&cache, "a")) // Order: a, c, b
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "d", "4", 0), true) // Evicts b
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 3)
+    CU_ASSERT_PTR_NULL(lru_cache_get(&cache, "b"))
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "5", 0), true) // Replacing also counts as a use. Order: c, d, a
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "e", "6", 0), true) // Evicts a
+    CU_ASSERT_PTR_NULL(lru_cache_get(&cache, "a"))
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "c"), "5")
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "d"), "4")
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "e"), "6")
+
+    // Evict everything by hand
+    CU_ASSERT_EQUAL(lru_cache_evict(&cache), true)
+    CU_ASSERT_EQUAL(lru_cache_evict(&cache), true)
+    CU_ASSERT_EQUAL(lru_cache_evict(&cache), true)
+    CU_ASSERT_EQUAL(lru_cache_evict(&cache), false)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 0)
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+}
+
+void test_lru_cache_max_bytes() {
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 0, 100, LRU_CACHE_POLICY_LRU, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "a", "1", 40), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "b", "2", 40), true)
+    CU_ASSERT_EQUAL(lru_cache_byte_size(&cache), 80)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "3", 70), true) // Evicts a and b
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 1)
+    CU_ASSERT_EQUAL(lru_cache_byte_size(&cache), 70)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "4", 20), true) // Replacing changes the size
+    CU_ASSERT_EQUAL(lru_cache_byte_size(&cache), 20)
+
+    // Larger than the whole cache (will print errors)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "d", "5", 101), false)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 1)
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+}
+
+typedef struct evicted_keys {
+    char keys[8];
+    size_t size;
+} evicted_keys;
+
+static void test_lru_cache_evict_callback(void* key, void* value, void* user_arg) {
+    evicted_keys* evicted = user_arg;
+    evicted->keys[evicted->size++] = *(char *)key;
+}
+
+void test_lru_cache_evict_func() {
+    evicted_keys evicted = {0};
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 2, 0, LRU_CACHE_POLICY_LRU, nullptr, nullptr), true)
+    lru_cache_set_evict_func(&cache, test_lru_cache_evict_callback, &evicted);
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "a", "1", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "b", "2", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "b", "3", 0), true) // Replacing doesn't evict
+    CU_ASSERT_EQUAL(evicted.size, 0)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "4", 0), true) // Evicts a
+    CU_ASSERT_EQUAL(evicted.size, 1)
+    CU_ASSERT_EQUAL(evicted.keys[0], 'a')
+
+    CU_ASSERT_EQUAL(lru_cache_del(&cache, "b"), true) // Deleting doesn't call the callback
+    CU_ASSERT_EQUAL(evicted.size, 1)
+
+    CU_ASSERT_EQUAL(lru_cache_evict(&cache), true) // Evicts c
+    CU_ASSERT_EQUAL(evicted.size, 2)
+    CU_ASSERT_EQUAL(evicted.keys[1], 'c')
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+}
+
+void test_lru_cache_clock() {
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 3, 0, LRU_CACHE_POLICY_CLOCK, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "a", "1", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "b", "2", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "3", 0), true)
+
+    // Hits only set the referenced bit, so the list order doesn't change
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "a"), "1")
+    CU_ASSERT_STRING_EQUAL(((lru_cache_entry *)cache.list.tail->value)->key, "a")
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "d", "4", 0), true) // a gets a second chance, so b is evicted
+    CU_ASSERT_PTR_NULL(lru_cache_peek(&cache, "b"))
+    CU_ASSERT_PTR_NOT_NULL(lru_cache_peek(&cache, "a"))
+
+    // When every entry was referenced, the oldest one is evicted after a full pass
+    CU_ASSERT_PTR_NOT_NULL(lru_cache_get(&cache, "a"))
+    CU_ASSERT_PTR_NOT_NULL(lru_cache_get(&cache, "c"))
+    CU_ASSERT_PTR_NOT_NULL(lru_cache_get(&cache, "d"))
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "e", "5", 0), true) // Evicts c
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 3)
+    CU_ASSERT_PTR_NULL(lru_cache_peek(&cache, "c"))
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+}
+
+void test_lru_cache_del_and_peek() {
+    lru_cache cache;
+    CU_ASSERT_EQUAL(lru_cache_init(&cache, 2, 0, LRU_CACHE_POLICY_LRU, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "a", "1", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "b", "2", 0), true)
+
+    // Peeking doesn't count as a use, so a is still evicted first
+    CU_ASSERT_STRING_EQUAL(lru_cache_peek(&cache, "a"), "1")
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "c", "3", 0), true)
+    CU_ASSERT_PTR_NULL(lru_cache_peek(&cache, "a"))
+
+    CU_ASSERT_EQUAL(lru_cache_del(&cache, "b"), true)
+    CU_ASSERT_EQUAL(lru_cache_del(&cache, "b"), false)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 1)
+    CU_ASSERT_PTR_NULL(lru_cache_peek(&cache, "b"))
+
+    // Deleted entries are reused
+    CU_ASSERT_EQUAL(lru_cache_put(&cache, "d", "4", 0), true)
+    CU_ASSERT_EQUAL(lru_cache_size(&cache), 2)
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "c"), "3")
+    CU_ASSERT_STRING_EQUAL(lru_cache_get(&cache, "d"), "4")
+
+    CU_ASSERT_EQUAL(lru_cache_destroy(&cache), true)
+}
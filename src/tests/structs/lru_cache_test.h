@@ -0,0 +1,19 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_lru_cache_tests();
+
+void test_lru_cache_init_and_destroy();
+
+void test_lru_cache_get_and_put();
+
+void test_lru_cache_evict_order();
+
+void test_lru_cache_max_bytes();
+
+void test_lru_cache_evict_func();
+
+void test_lru_cache_clock();
+
+void test_lru_cache_del_and_peek();
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "perfect_hash_test.h"
+#include "../../structs/perfect_hash.h"
+
+/**
+ * Number of keys used by the larger tests
+ */
+#define TEST_KEY_COUNT 100000
+
+CU_TestInfo* get_perfect_hash_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_perfect_hash_init_and_destroy", test_perfect_hash_init_and_destroy},
+        {"test_perfect_hash_many_keys", test_perfect_hash_many_keys},
+        {"test_perfect_hash_binary_keys", test_perfect_hash_binary_keys},
+        {"test_perfect_hash_fingerprints", test_perfect_hash_fingerprints},
+        {"test_perfect_hash_from_hash_table", test_perfect_hash_from_hash_table},
+        {"test_perfect_hash_invalid_keys", test_perfect_hash_invalid_keys},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_perfect_hash_init_and_destroy() {
+    const char* keys[] = {"foo", "bar", "spangle"};
+
+    perfect_hash ph;
+    CU_ASSERT_EQUAL(perfect_hash_init(&ph, (const void **)keys, nullptr, 3, 0), true)
+    CU_ASSERT_EQUAL(ph.key_size, 3)
+
+    // Every key gets its own index in [0, 3)
+    bool seen[3] = {false};
+    for (int i = 0; i < 3; ++i) {
+        const size_t index = perfect_hash_lookup(&ph, keys[i]);
+        CU_ASSERT_FATAL(index < 3)
+        CU_ASSERT_EQUAL(seen[index], false)
+        seen[index] = true;
+    }
+
+    CU_ASSERT_EQUAL(perfect_hash_destroy(&ph), true)
+    CU_ASSERT_PTR_NULL(ph.pilots)
+    CU_ASSERT_EQUAL(ph.key_size, 0)
+
+    // Empty set
+    CU_ASSERT_EQUAL(perfect_hash_init(&ph, nullptr, nullptr, 0, 8), true)
+    CU_ASSERT_EQUAL(perfect_hash_lookup(&ph, "foo"), PERFECT_HASH_NOT_FOUND)
+    CU_ASSERT_EQUAL(perfect_hash_memory_size(&ph), 0)
+    CU_ASSERT_EQUAL(perfect_hash_destroy(&ph), true)
+}
+
+void test_perfect_hash_many_keys() {
+    static char key_buf[TEST_KEY_COUNT][16];
+    static const char* keys[TEST_KEY_COUNT];
+    static bool seen[TEST_KEY_COUNT];
+
+    for (int i = 0; i < TEST_KEY_COUNT; ++i) {
+        snprintf(key_buf[i], sizeof(key_buf[i]), "key%d", i);
+        keys[i] = key_buf[i];
+    }
+
+    perfect_hash ph;
+    CU_ASSERT_EQUAL_FATAL(perfect_hash_init(&ph, (const void **)keys, nullptr, TEST_KEY_COUNT, 0), true)
+
+    memset(seen, 0, sizeof(seen));
+    size_t collisions = 0;
+    for (int i = 0; i < TEST_KEY_COUNT; ++i) {
+        const size_t index = perfect_hash_lookup(&ph, keys[i]);
+        CU_ASSERT_FATAL(index < TEST_KEY_COUNT)
+        collisions += seen[index];
+        seen[index] = true;
+    }
+    CU_ASSERT_EQUAL(collisions, 0)
+
+    // About 3.5 bits per key
+    const double bits_per_key = perfect_hash_memory_size(&ph) * 8.0 / TEST_KEY_COUNT;
+    CU_ASSERT(bits_per_key >= 2.0)
+    CU_ASSERT(bits_per_key <= 4.0)
+
+    CU_ASSERT_EQUAL(perfect_hash_destroy(&ph), true)
+}
+
+void test_perfect_hash_binary_keys() {
+    static uint64_t key_values[1000];
+    static const void* keys[1000];
+    static size_t key_lens[1000];
+    bool seen[1000] = {false};
+
+    for (int i = 0; i < 1000; ++i) {
+        key_values[i] = (uint64_t)i << 40; // Only differs in a few high bytes
+        keys[i] = &key_values[i];
+        key_lens[i] = sizeof(uint64_t);
+    }
+
+    perfect_hash ph;
+    CU_ASSERT_EQUAL_FATAL(perfect_hash_init(&ph, keys, key_lens, 1000, 0), true)
+
+    for (int i = 0; i < 1000; ++i) {
+        const size_t index = perfect_hash_lookup_n(&ph, &key_values[i], sizeof(uint64_t));
+        CU_ASSERT_FATAL(index < 1000)
+        CU_ASSERT_EQUAL(seen[index], false)
+        seen[index] = true;
+    }
+
+    CU_ASSERT_EQUAL(perfect_hash_destroy(&ph), true)
+}
+
+void test_perfect_hash_fingerprints() {
+    static char key_buf[TEST_KEY_COUNT][16];
+    static const char* keys[TEST_KEY_COUNT];
+
+    for (int i = 0; i < TEST_KEY_COUNT; ++i) {
+        snprintf(key_buf[i], sizeof(key_buf[i]), "key%d", i);
+        keys[i] = key_buf[i];
+    }
+
+    for (uint8_t bits = 8; bits <= 16; bits += 8) {
+        perfect_hash ph;
+        CU_ASSERT_EQUAL_FATAL(perfect_hash_init(&ph, (const void **)keys, nullptr, TEST_KEY_COUNT, bits), true)
+
+        // Keys in the set always pass the check
+        for (int i = 0; i < TEST_KEY_COUNT; ++i) {
+            CU_ASSERT_NOT_EQUAL(perfect_hash_lookup(&ph, keys[i]), PERFECT_HASH_NOT_FOUND)
+        }
+
+        // About 1 / 2^bits of absent keys get through
+        char absent[24];
+        size_t false_positives = 0;
+        for (int i = 0; i < TEST_KEY_COUNT; ++i) {
+            snprintf(absent, sizeof(absent), "absent%d", i);
+            false_positives += perfect_hash_lookup(&ph, absent) != PERFECT_HASH_NOT_FOUND;
+        }
+
+        const double expected = (double)TEST_KEY_COUNT / (1 << bits);
+        CU_ASSERT(false_positives <= expected * 2 + 5)
+
+        CU_ASSERT_EQUAL(perfect_hash_memory_size(&ph) >= TEST_KEY_COUNT * bits / 8, true)
+        CU_ASSERT_EQUAL(perfect_hash_destroy(&ph), true)
+    }
+}
+
+void test_perfect_hash_from_hash_table() {
+    static char keys[1000][16];
+    static char values[1000][24];
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, nullptr, nullptr), true)
+    for (int i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%d", i);
+        snprintf(values[i], sizeof(values[i]), "value%d", i);
+        CU_ASSERT_EQUAL(hash_table_set(&ht, keys[i], values[i]), true)
+    }
+
+    perfect_hash ph;
+    void* table[1000] = {nullptr};
+    CU_ASSERT_EQUAL_FATAL(perfect_hash_init_from_hash_table(&ph, &ht, 16, table), true)
+    CU_ASSERT_EQUAL(ph.key_size, 1000)
+
+    // Values are laid out by index, so a lookup is one probe into the array
+    for (int i = 0; i < 1000; ++i) {
+        const size_t index = perfect_hash_lookup(&ph, keys[i]);
+        CU_ASSERT_FATAL(index < 1000)
+        CU_ASSERT_STRING_EQUAL(table[index], values[i])
+    }
+
+    CU_ASSERT_EQUAL(perfect_hash_destroy(&ph), true)
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+}
+
+void test_perfect_hash_invalid_keys() {
+    perfect_hash ph;
+
+    // Duplicate keys can't be given distinct indexes (will print errors)
+    const char* duplicate_keys[] = {"foo", "bar", "foo"};
+    CU_ASSERT_EQUAL(perfect_hash_init(&ph, (const void **)duplicate_keys, nullptr, 3, 0), false)
+    CU_ASSERT_PTR_NULL(ph.pilots)
+
+    // Unsupported fingerprint size
+    const char* keys[] = {"foo", "bar"};
+    CU_ASSERT_EQUAL(perfect_hash_init(&ph, (const void **)keys, nullptr, 2, 4), false)
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_perfect_hash_tests();
+
+void test_perfect_hash_init_and_destroy();
+
+void test_perfect_hash_many_keys();
+
+void test_perfect_hash_binary_keys();
+
+void test_perfect_hash_fingerprints();
+
+void test_perfect_hash_from_hash_table();
+
+void test_perfect_hash_invalid_keys();
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "scalable_bloom_filter_test.h"
+#include "../../structs/scalable_bloom_filter.h"
+
+CU_TestInfo* get_scalable_bloom_filter_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_scalable_bloom_filter_init_and_destroy", test_scalable_bloom_filter_init_and_destroy},
+        {"test_scalable_bloom_filter", test_scalable_bloom_filter},
+        {"test_scalable_bloom_filter_growth", test_scalable_bloom_filter_growth},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_scalable_bloom_filter_init_and_destroy() {
+    scalable_bloom_filter sbf;
+    CU_ASSERT_EQUAL(scalable_bloom_filter_init(&sbf, 0, 0.01), false)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_init(&sbf, 100, 0), false)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_init(&sbf, 100, 1), false)
+
+    CU_ASSERT_EQUAL(scalable_bloom_filter_init(&sbf, 100, 0.01), true)
+    CU_ASSERT_PTR_NOT_NULL(sbf.filters)
+    CU_ASSERT_EQUAL(sbf.filter_count, 1)
+    CU_ASSERT_EQUAL(sbf.capacity, 100)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_size(&sbf), 0)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_bytes(&sbf), sbf.filters[0].bit_array->size_bits / 8)
+    CU_ASSERT_DOUBLE_EQUAL(scalable_bloom_filter_fpr(&sbf), 0, 0)
+
+    CU_ASSERT_EQUAL(scalable_bloom_filter_destroy(&sbf), true)
+    CU_ASSERT_PTR_NULL(sbf.filters)
+    CU_ASSERT_EQUAL(sbf.filter_count, 0)
+}
+
+void test_scalable_bloom_filter() {
+    scalable_bloom_filter sbf;
+    CU_ASSERT_EQUAL(scalable_bloom_filter_init(&sbf, 100, 0.01), true)
+
+    CU_ASSERT_EQUAL(scalable_bloom_filter_check(&sbf, (uint8_t *)"foo", 3), false)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_add(&sbf, (uint8_t *)"foo", 3), true) // ["foo"]
+    CU_ASSERT_EQUAL(scalable_bloom_filter_check(&sbf, (uint8_t *)"foo", 3), true)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_size(&sbf), 1)
+
+    // Duplicates aren't counted
+    CU_ASSERT_EQUAL(scalable_bloom_filter_add(&sbf, (uint8_t *)"foo", 3), true) // ["foo"]
+    CU_ASSERT_EQUAL(scalable_bloom_filter_size(&sbf), 1)
+
+    CU_ASSERT_EQUAL(scalable_bloom_filter_check(&sbf, (uint8_t *)"bar", 3), false)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_add(&sbf, (uint8_t *)"bar", 3), true) // ["foo", "bar"]
+    CU_ASSERT_EQUAL(scalable_bloom_filter_check(&sbf, (uint8_t *)"bar", 3), true)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_size(&sbf), 2)
+    CU_ASSERT(scalable_bloom_filter_fpr(&sbf) > 0)
+
+    CU_ASSERT_EQUAL(scalable_bloom_filter_destroy(&sbf), true)
+}
+
+void test_scalable_bloom_filter_growth() {
+    scalable_bloom_filter sbf;
+    CU_ASSERT_EQUAL(scalable_bloom_filter_init(&sbf, 100, 0.01), true)
+    const size_t first_bytes = scalable_bloom_filter_bytes(&sbf);
+
+    // 100 x 10 times as many keys as the first sub-filter is sized for
+    char key[32];
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        CU_ASSERT_EQUAL(scalable_bloom_filter_add(&sbf, (uint8_t *)key, strlen(key)), true)
+    }
+
+    // Capacities of 100, 200, 400, ..., 6400 hold 12700 keys
+    CU_ASSERT_EQUAL(sbf.filter_count, 7)
+    CU_ASSERT_EQUAL(sbf.capacity, 6400)
+    CU_ASSERT(scalable_bloom_filter_size(&sbf) > 9900 && scalable_bloom_filter_size(&sbf) <= 10000)
+    CU_ASSERT(scalable_bloom_filter_bytes(&sbf) > first_bytes * 100)
+
+    bool all_found = true;
+    for (size_t i = 0; i < 10000; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_found &= scalable_bloom_filter_check(&sbf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(all_found) // No false negatives
+
+    // Compound rate stays under the target, even though the filter holds 100x its initial capacity
+    const double fpr = scalable_bloom_filter_fpr(&sbf);
+    CU_ASSERT(fpr > 0.001 && fpr < 0.01)
+
+    size_t false_positives = 0;
+    for (size_t i = 0; i < 100000; ++i) {
+        snprintf(key, sizeof(key), "other:%zu", i);
+        false_positives += scalable_bloom_filter_check(&sbf, (uint8_t *)key, strlen(key));
+    }
+    CU_ASSERT(false_positives > 100 && false_positives < 1000)
+
+    scalable_bloom_filter_clear(&sbf); // []
+    CU_ASSERT_EQUAL(sbf.filter_count, 1)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_size(&sbf), 0)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_bytes(&sbf), first_bytes)
+    CU_ASSERT_EQUAL(scalable_bloom_filter_check(&sbf, (uint8_t *)"key:1", 5), false)
+
+    CU_ASSERT_EQUAL(scalable_bloom_filter_destroy(&sbf), true)
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_scalable_bloom_filter_tests();
+
+void test_scalable_bloom_filter_init_and_destroy();
+
+void test_scalable_bloom_filter();
+
+void test_scalable_bloom_filter_growth();
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "string_pool_test.h"
+#include "../../structs/string_pool.h"
+
+CU_TestInfo* get_string_pool_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_string_pool_init_and_destroy", test_string_pool_init_and_destroy},
+        {"test_string_pool_intern", test_string_pool_intern},
+        {"test_string_pool_many_strings", test_string_pool_many_strings},
+        {"test_string_pool_hash_table_keys", test_string_pool_hash_table_keys},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_string_pool_init_and_destroy() {
+    string_pool pool;
+    CU_ASSERT_EQUAL(string_pool_init(&pool, 0), false)
+
+    CU_ASSERT_EQUAL(string_pool_init(&pool, 10), true)
+    CU_ASSERT_EQUAL(string_pool_size(&pool), 0)
+    CU_ASSERT_PTR_NULL(string_pool_find(&pool, "foo"))
+    CU_ASSERT_EQUAL(string_pool_destroy(&pool), true)
+}
+
+void test_string_pool_intern() {
+    string_pool pool;
+    CU_ASSERT_EQUAL(string_pool_init(&pool, 10), true)
+
+    char foo[] = "foo";
+    const char* p_foo = string_pool_intern(&pool, foo);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_foo)
+    CU_ASSERT_PTR_NOT_EQUAL(p_foo, foo) // Copied
+    CU_ASSERT_STRING_EQUAL(p_foo, "foo")
+    CU_ASSERT_EQUAL(string_pool_len(p_foo), 3)
+    CU_ASSERT_EQUAL(string_pool_hash(p_foo), hash_table_key_hash_string("foo", SIZE_MAX))
+
+    // Equal strings get the same handle
+    CU_ASSERT_PTR_EQUAL(string_pool_intern(&pool, "foo"), p_foo)
+    CU_ASSERT_PTR_EQUAL(string_pool_intern_n(&pool, "foobar", 3), p_foo)
+    CU_ASSERT_PTR_EQUAL(string_pool_find(&pool, "foo"), p_foo)
+    foo[0] = 'g'; // Handles don't change with the original
+    CU_ASSERT_STRING_EQUAL(p_foo, "foo")
+
+    const char* p_bar = string_pool_intern(&pool, "bar");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_bar)
+    CU_ASSERT_PTR_NOT_EQUAL(p_bar, p_foo)
+    CU_ASSERT_EQUAL(string_pool_size(&pool), 2)
+    CU_ASSERT_PTR_NULL(string_pool_find(&pool, "baz"))
+
+    // Empty strings and embedded NULs
+    const char* p_empty = string_pool_intern(&pool, "");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_empty)
+    CU_ASSERT_EQUAL(string_pool_len(p_empty), 0)
+    CU_ASSERT_PTR_EQUAL(string_pool_intern_n(&pool, "", 0), p_empty)
+
+    const char* p_nul = string_pool_intern_n(&pool, "foo\0bar", 7);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_nul)
+    CU_ASSERT_PTR_NOT_EQUAL(p_nul, p_foo)
+    CU_ASSERT_EQUAL(string_pool_len(p_nul), 7)
+    CU_ASSERT_EQUAL(memcmp(p_nul, "foo\0bar", 8), 0) // NUL terminated too
+    CU_ASSERT_EQUAL(string_pool_size(&pool), 4)
+
+    CU_ASSERT_EQUAL(string_pool_destroy(&pool), true)
+}
+
+void test_string_pool_many_strings() {
+    string_pool pool;
+    CU_ASSERT_EQUAL(string_pool_init(&pool, 10), true)
+
+    // Enough strings to fill several blocks
+    const size_t count = 20000;
+    const char** handles = malloc(count * sizeof(char*));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(handles)
+
+    char key[32];
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        handles[i] = string_pool_intern(&pool, key);
+    }
+    CU_ASSERT(pool.bytes > STRING_POOL_BLOCK_SIZE)
+
+    // A string bigger than a block
+    char* big = malloc(STRING_POOL_BLOCK_SIZE * 2);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(big)
+    memset(big, 'x', STRING_POOL_BLOCK_SIZE * 2 - 1);
+    big[STRING_POOL_BLOCK_SIZE * 2 - 1] = '\0';
+    const char* p_big = string_pool_intern(&pool, big);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_big)
+    CU_ASSERT_EQUAL(string_pool_len(p_big), STRING_POOL_BLOCK_SIZE * 2 - 1)
+    CU_ASSERT_PTR_EQUAL(string_pool_intern(&pool, big), p_big)
+    free(big);
+
+    // Handles stay valid and unique as the pool grows
+    const char* p_after = string_pool_intern(&pool, "after");
+    CU_ASSERT_PTR_NOT_NULL(p_after)
+    CU_ASSERT_EQUAL(string_pool_size(&pool), count + 2)
+
+    bool all_same = true;
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(key, sizeof(key), "key:%zu", i);
+        all_same &= handles[i] != NULL && strcmp(handles[i], key) == 0 &&
+                    string_pool_intern(&pool, key) == handles[i] &&
+                    string_pool_len(handles[i]) == strlen(key);
+    }
+    CU_ASSERT(all_same)
+
+    free(handles);
+    CU_ASSERT_EQUAL(string_pool_destroy(&pool), true)
+}
+
+void test_string_pool_hash_table_keys() {
+    string_pool pool;
+    CU_ASSERT_EQUAL(string_pool_init(&pool, 10), true)
+
+    hash_table ht;
+    CU_ASSERT_EQUAL(hash_table_init(&ht, 10, string_pool_key_cmp, string_pool_key_hash), true)
+
+    CU_ASSERT_EQUAL(hash_table_set(&ht, (void *)string_pool_intern(&pool, "foo"), "one"), true)
+    CU_ASSERT_EQUAL(hash_table_set(&ht, (void *)string_pool_intern(&pool, "bar"), "two"), true)
+
+    // Looked up by handle, from a different copy of the string
+    char foo[] = "foo";
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, string_pool_intern(&pool, foo)), "one")
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, string_pool_intern(&pool, "bar")), "two")
+    CU_ASSERT_PTR_NULL(hash_table_get(&ht, string_pool_intern(&pool, "baz")))
+
+    // Replacing goes through the same handle
+    CU_ASSERT_EQUAL(hash_table_set(&ht, (void *)string_pool_intern(&pool, foo), "three"), true)
+    CU_ASSERT_EQUAL(hash_table_size(&ht), 2)
+    CU_ASSERT_STRING_EQUAL(hash_table_get(&ht, string_pool_find(&pool, "foo")), "three")
+
+    CU_ASSERT_EQUAL(hash_table_destroy(&ht), true)
+    CU_ASSERT_EQUAL(string_pool_destroy(&pool), true)
+}
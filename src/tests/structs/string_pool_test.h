@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_string_pool_tests();
+
+void test_string_pool_init_and_destroy();
+
+void test_string_pool_intern();
+
+void test_string_pool_many_strings();
+
+void test_string_pool_hash_table_keys();
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tinylfu_cache_test.h"
+#include "../../structs/tinylfu_cache.h"
+
+CU_TestInfo* get_tinylfu_cache_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_tinylfu_cache_init_and_destroy", test_tinylfu_cache_init_and_destroy},
+        {"test_tinylfu_cache_get_and_put", test_tinylfu_cache_get_and_put},
+        {"test_tinylfu_cache_frequency", test_tinylfu_cache_frequency},
+        {"test_tinylfu_cache_admission", test_tinylfu_cache_admission},
+        {"test_tinylfu_cache_scan_resistance", test_tinylfu_cache_scan_resistance},
+        {"test_tinylfu_cache_evict_func", test_tinylfu_cache_evict_func},
+        {"test_tinylfu_cache_del", test_tinylfu_cache_del},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_tinylfu_cache_init_and_destroy() {
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 1000, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(cache.window_max, 10)
+    CU_ASSERT_EQUAL(cache.protected_max, 792)
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 0)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "foo", "one"), true)
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 1)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 0)
+
+    // The window always has room for at least one entry
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(cache.window_max, 1)
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+
+    // Invalid size (will print errors)
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 0, nullptr, nullptr), false)
+}
+
+void test_tinylfu_cache_get_and_put() {
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "foo", "one"), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "bar", "two"), true) // {"foo": "one", "bar": "two"}
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "foo", "three"), true) // {"foo": "three", "bar": "two"}
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 2)
+
+    CU_ASSERT_STRING_EQUAL(tinylfu_cache_get(&cache, "foo"), "three")
+    CU_ASSERT_STRING_EQUAL(tinylfu_cache_get(&cache, "bar"), "two")
+    CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, "spangle"))
+
+    // "foo" was pushed out of the window by "bar" and admitted on probation, then promoted when it was replaced
+    const tinylfu_cache_entry* p_entry = hash_table_get(&cache.table, "foo");
+    CU_ASSERT_EQUAL(p_entry->region, TINYLFU_CACHE_REGION_PROTECTED)
+    p_entry = hash_table_get(&cache.table, "bar");
+    CU_ASSERT_EQUAL(p_entry->region, TINYLFU_CACHE_REGION_WINDOW)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+}
+
+void test_tinylfu_cache_frequency() {
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 100, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_frequency(&cache, "foo"), 0)
+
+    // Lookups count, even if they miss
+    CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, "foo"))
+    CU_ASSERT_EQUAL(tinylfu_cache_frequency(&cache, "foo"), 1) // Only in the doorkeeper so far
+    CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, "foo"))
+    CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, "foo"))
+    CU_ASSERT_EQUAL(tinylfu_cache_frequency(&cache, "foo"), 3)
+
+    // Frequencies are aged at the end of each sample
+    for (size_t i = cache.sample_count; i < cache.sample_size - 1; ++i) {
+        tinylfu_cache_get(&cache, "bar");
+    }
+    CU_ASSERT_EQUAL(tinylfu_cache_frequency(&cache, "foo"), 3)
+    tinylfu_cache_get(&cache, "bar");
+    CU_ASSERT_EQUAL(cache.sample_count, 0)
+    CU_ASSERT_EQUAL(tinylfu_cache_frequency(&cache, "foo"), 1) // The sketch was halved, and the doorkeeper was cleared
+    CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, "foo"))
+    CU_ASSERT_EQUAL(tinylfu_cache_frequency(&cache, "foo"), 2)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+}
+
+void test_tinylfu_cache_admission() {
+    char keys[200][16];
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 100, nullptr, nullptr), true)
+
+    // Fill the cache with keys that were each looked up twice
+    for (size_t i = 0; i < 100; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "hot%zu", i);
+        CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, keys[i]))
+        CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, keys[i]))
+        CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, keys[i], keys[i]), true)
+    }
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 100)
+
+    // A key that's looked up more often than the victim is admitted
+    snprintf(keys[100], sizeof(keys[100]), "hotter");
+    for (size_t i = 0; i < 5; ++i) {
+        tinylfu_cache_get(&cache, keys[100]);
+    }
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, keys[100], keys[100]), true)
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 100)
+
+    snprintf(keys[101], sizeof(keys[101]), "cold");
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, keys[101], keys[101]), true) // Pushes "hotter" out of the window
+    CU_ASSERT_PTR_NOT_NULL(hash_table_get(&cache.table, keys[100]))
+    CU_ASSERT_EQUAL(((tinylfu_cache_entry *)hash_table_get(&cache.table, keys[100]))->region, TINYLFU_CACHE_REGION_PROBATION)
+
+    // A key that's looked up less often than the victim isn't
+    snprintf(keys[102], sizeof(keys[102]), "colder");
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, keys[102], keys[102]), true) // Pushes "cold" out of the window
+    CU_ASSERT_PTR_NULL(hash_table_get(&cache.table, keys[101]))
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 100)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+}
+
+void test_tinylfu_cache_scan_resistance() {
+    char hot_keys[50][16];
+    char scan_keys[500][16];
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 100, nullptr, nullptr), true)
+
+    for (size_t round = 0; round < 4; ++round) {
+        for (size_t i = 0; i < 50; ++i) {
+            snprintf(hot_keys[i], sizeof(hot_keys[i]), "hot%zu", i);
+            if (tinylfu_cache_get(&cache, hot_keys[i]) == NULL) {
+                CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, hot_keys[i], hot_keys[i]), true)
+            }
+        }
+    }
+
+    // A scan over many more keys than fit in the cache, each looked up once
+    for (size_t i = 0; i < 500; ++i) {
+        snprintf(scan_keys[i], sizeof(scan_keys[i]), "scan%zu", i);
+        if (tinylfu_cache_get(&cache, scan_keys[i]) == NULL) {
+            CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, scan_keys[i], scan_keys[i]), true)
+        }
+    }
+
+    // The hot keys survive (an LRU cache would have none of them left)
+    size_t hits = 0;
+    for (size_t i = 0; i < 50; ++i) {
+        hits += tinylfu_cache_get(&cache, hot_keys[i]) != NULL;
+    }
+    CU_ASSERT(hits >= 45)
+    CU_ASSERT(tinylfu_cache_size(&cache) <= 100)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+}
+
+typedef struct evicted_keys {
+    size_t size;
+    void* last_key;
+} evicted_keys;
+
+static void test_tinylfu_cache_evict_callback(void* key, void* value, void* user_arg) {
+    evicted_keys* evicted = user_arg;
+    evicted->size++;
+    evicted->last_key = key;
+}
+
+void test_tinylfu_cache_evict_func() {
+    char keys[20][16];
+    evicted_keys evicted = {0};
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 10, nullptr, nullptr), true)
+    tinylfu_cache_set_evict_func(&cache, test_tinylfu_cache_evict_callback, &evicted);
+
+    for (size_t i = 0; i < 20; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+        CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, keys[i], keys[i]), true)
+    }
+
+    // None of the keys were looked up, so once the cache is full each one that leaves the window is rejected
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 10)
+    CU_ASSERT_EQUAL(evicted.size, 10)
+    CU_ASSERT_PTR_EQUAL(evicted.last_key, keys[18])
+
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, keys[19], "replaced"), true) // Replacing doesn't evict
+    CU_ASSERT_EQUAL(evicted.size, 10)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+}
+
+void test_tinylfu_cache_del() {
+    tinylfu_cache cache;
+    CU_ASSERT_EQUAL(tinylfu_cache_init(&cache, 10, nullptr, nullptr), true)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "foo", "one"), true)
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "bar", "two"), true)
+
+    CU_ASSERT_EQUAL(tinylfu_cache_del(&cache, "foo"), true) // On probation
+    CU_ASSERT_EQUAL(tinylfu_cache_del(&cache, "bar"), true) // In the window
+    CU_ASSERT_EQUAL(tinylfu_cache_del(&cache, "bar"), false)
+    CU_ASSERT_EQUAL(tinylfu_cache_size(&cache), 0)
+    CU_ASSERT_PTR_NULL(tinylfu_cache_get(&cache, "foo"))
+
+    CU_ASSERT_EQUAL(tinylfu_cache_put(&cache, "foo", "three"), true)
+    CU_ASSERT_STRING_EQUAL(tinylfu_cache_get(&cache, "foo"), "three")
+
+    CU_ASSERT_EQUAL(tinylfu_cache_destroy(&cache), true)
+}
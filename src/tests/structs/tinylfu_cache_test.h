@@ -0,0 +1,19 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_tinylfu_cache_tests();
+
+void test_tinylfu_cache_init_and_destroy();
+
+void test_tinylfu_cache_get_and_put();
+
+void test_tinylfu_cache_frequency();
+
+void test_tinylfu_cache_admission();
+
+void test_tinylfu_cache_scan_resistance();
+
+void test_tinylfu_cache_evict_func();
+
+void test_tinylfu_cache_del();
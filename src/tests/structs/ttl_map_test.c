@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ttl_map_test.h"
+#include "../../structs/ttl_map.h"
+
+CU_TestInfo* get_ttl_map_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_ttl_map_init_and_destroy", test_ttl_map_init_and_destroy},
+        {"test_ttl_map_get_and_set", test_ttl_map_get_and_set},
+        {"test_ttl_map_lazy_expiry", test_ttl_map_lazy_expiry},
+        {"test_ttl_map_expire_step", test_ttl_map_expire_step},
+        {"test_ttl_map_expire_and_ttl", test_ttl_map_expire_and_ttl},
+        {"test_ttl_map_stale_timers", test_ttl_map_stale_timers},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+static uint64_t test_ttl_map_clock(void* now) {
+    return *(uint64_t *)now;
+}
+
+static void test_ttl_map_expire_callback(void* key, void* value, void* count) {
+    ++*(size_t *)count;
+}
+
+void test_ttl_map_init_and_destroy() {
+    ttl_map map;
+    CU_ASSERT_EQUAL(ttl_map_init(&map, 10, nullptr, nullptr), true)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 0)
+
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "one", 1000), true)
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "bar", "two", 0), true)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 2)
+    CU_ASSERT_EQUAL(map.timers.size, 1) // Entries that never expire don't need a timer
+
+    CU_ASSERT_EQUAL(ttl_map_destroy(&map), true)
+}
+
+void test_ttl_map_get_and_set() {
+    uint64_t now = 1000;
+    ttl_map map;
+    CU_ASSERT_EQUAL(ttl_map_init(&map, 10, nullptr, nullptr), true)
+    ttl_map_set_clock_func(&map, test_ttl_map_clock, &now);
+
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "one", 100), true) // {"foo": "one"}
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "bar", "two", 0), true) // {"foo": "one", "bar": "two"}
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "three", 100), true) // {"foo": "three", "bar": "two"}
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 2)
+
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "foo"), "three")
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "bar"), "two")
+    CU_ASSERT_PTR_NULL(ttl_map_get(&map, "spangle"))
+
+    CU_ASSERT_EQUAL(ttl_map_del(&map, "foo"), true)
+    CU_ASSERT_EQUAL(ttl_map_del(&map, "foo"), false)
+    CU_ASSERT_PTR_NULL(ttl_map_get(&map, "foo"))
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 1)
+
+    CU_ASSERT_EQUAL(ttl_map_destroy(&map), true)
+}
+
+void test_ttl_map_lazy_expiry() {
+    uint64_t now = 1000;
+    size_t expired = 0;
+    ttl_map map;
+    CU_ASSERT_EQUAL(ttl_map_init(&map, 10, nullptr, nullptr), true)
+    ttl_map_set_clock_func(&map, test_ttl_map_clock, &now);
+    ttl_map_set_expire_func(&map, test_ttl_map_expire_callback, &expired);
+
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "one", 100), true)
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "bar", "two", 0), true)
+
+    now = 1099;
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "foo"), "one")
+
+    now = 1100;
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 2) // Not removed until it's looked up
+    CU_ASSERT_PTR_NULL(ttl_map_get(&map, "foo"))
+    CU_ASSERT_EQUAL(expired, 1)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 1)
+
+    now = 1000000;
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "bar"), "two") // Never expires
+    CU_ASSERT_EQUAL(expired, 1)
+
+    // Setting an expired entry gives it a new TTL
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "three", 10), true)
+    now += 10;
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "four", 10), true)
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "foo"), "four")
+    CU_ASSERT_EQUAL(expired, 1)
+
+    CU_ASSERT_EQUAL(ttl_map_destroy(&map), true)
+}
+
+void test_ttl_map_expire_step() {
+    char keys[100][16];
+    uint64_t now = 0;
+    size_t expired = 0;
+    ttl_map map;
+    CU_ASSERT_EQUAL(ttl_map_init(&map, 100, nullptr, nullptr), true)
+    ttl_map_set_clock_func(&map, test_ttl_map_clock, &now);
+    ttl_map_set_expire_func(&map, test_ttl_map_expire_callback, &expired);
+
+    // Key i expires at (i + 1) * 10, inserted in a scrambled order
+    for (size_t i = 0; i < 100; ++i) {
+        const size_t key = (i * 37) % 100;
+        snprintf(keys[key], sizeof(keys[key]), "key%zu", key);
+        CU_ASSERT_EQUAL(ttl_map_set(&map, keys[key], keys[key], (key + 1) * 10), true)
+    }
+
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 100), 0) // Nothing has expired yet
+
+    // Half have expired, but only as many as the budget allows are removed per step
+    now = 500;
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 20), 20)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 80)
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 20), 20)
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 20), 10)
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 20), 0)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 50)
+    CU_ASSERT_EQUAL(expired, 50)
+
+    // Expired in order, so the ones left are the ones that expire last
+    CU_ASSERT_PTR_NULL(ttl_map_get(&map, keys[48]))
+    CU_ASSERT_PTR_NOT_NULL(ttl_map_get(&map, keys[50]))
+
+    now = 1000;
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 1000), 50)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 0)
+    CU_ASSERT_EQUAL(map.timers.size, 0)
+
+    CU_ASSERT_EQUAL(ttl_map_destroy(&map), true)
+}
+
+void test_ttl_map_expire_and_ttl() {
+    uint64_t now = 1000;
+    size_t expired = 0;
+    ttl_map map;
+    CU_ASSERT_EQUAL(ttl_map_init(&map, 10, nullptr, nullptr), true)
+    ttl_map_set_clock_func(&map, test_ttl_map_clock, &now);
+    ttl_map_set_expire_func(&map, test_ttl_map_expire_callback, &expired);
+
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "foo", "one", 100), true)
+    CU_ASSERT_EQUAL(ttl_map_set(&map, "bar", "two", 0), true)
+    CU_ASSERT_EQUAL(ttl_map_ttl(&map, "foo"), 100)
+    CU_ASSERT_EQUAL(ttl_map_ttl(&map, "bar"), 0)
+    CU_ASSERT_EQUAL(ttl_map_ttl(&map, "spangle"), -1)
+
+    // Extend foo, and give bar a TTL
+    now = 1050;
+    CU_ASSERT_EQUAL(ttl_map_expire(&map, "foo", 200), true)
+    CU_ASSERT_EQUAL(ttl_map_expire(&map, "bar", 10), true)
+    CU_ASSERT_EQUAL(ttl_map_expire(&map, "spangle", 10), false)
+    CU_ASSERT_EQUAL(ttl_map_ttl(&map, "foo"), 200)
+    CU_ASSERT_EQUAL(ttl_map_ttl(&map, "bar"), 10)
+
+    // foo's old timer fires, but it's stale
+    now = 1100;
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 10), 1) // bar
+    CU_ASSERT_EQUAL(expired, 1)
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "foo"), "one")
+    CU_ASSERT_EQUAL(map.stale_timers, 0)
+
+    // Remove foo's TTL
+    CU_ASSERT_EQUAL(ttl_map_expire(&map, "foo", 0), true)
+    now = 100000;
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 10), 0)
+    CU_ASSERT_STRING_EQUAL(ttl_map_get(&map, "foo"), "one")
+
+    CU_ASSERT_EQUAL(ttl_map_destroy(&map), true)
+}
+
+void test_ttl_map_stale_timers() {
+    char keys[1000][16];
+    uint64_t now = 0;
+    ttl_map map;
+    CU_ASSERT_EQUAL(ttl_map_init(&map, 1000, nullptr, nullptr), true)
+    ttl_map_set_clock_func(&map, test_ttl_map_clock, &now);
+
+    for (size_t i = 0; i < 1000; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key%zu", i);
+        CU_ASSERT_EQUAL(ttl_map_set(&map, keys[i], keys[i], 1000), true)
+    }
+
+    // Refreshing TTLs leaves stale timers behind, but the heap is compacted before they outnumber the live ones
+    for (size_t round = 0; round < 10; ++round) {
+        ++now;
+        for (size_t i = 0; i < 1000; ++i) {
+            CU_ASSERT_EQUAL(ttl_map_expire(&map, keys[i], 1000), true)
+        }
+        CU_ASSERT(map.timers.size <= 2000)
+        CU_ASSERT(map.stale_timers <= map.timers.size / 2)
+    }
+
+    // Deleting most of the entries compacts the heap down too
+    for (size_t i = 0; i < 900; ++i) {
+        CU_ASSERT_EQUAL(ttl_map_del(&map, keys[i]), true)
+    }
+    CU_ASSERT(map.timers.size <= 200)
+
+    now += 1000;
+    CU_ASSERT_EQUAL(ttl_map_expire_step(&map, 1000), 100)
+    CU_ASSERT_EQUAL(ttl_map_size(&map), 0)
+    CU_ASSERT_EQUAL(map.timers.size, 0)
+    CU_ASSERT_EQUAL(map.stale_timers, 0)
+
+    CU_ASSERT_EQUAL(ttl_map_destroy(&map), true)
+}
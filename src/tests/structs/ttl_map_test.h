@@ -0,0 +1,17 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_ttl_map_tests();
+
+void test_ttl_map_init_and_destroy();
+
+void test_ttl_map_get_and_set();
+
+void test_ttl_map_lazy_expiry();
+
+void test_ttl_map_expire_step();
+
+void test_ttl_map_expire_and_ttl();
+
+void test_ttl_map_stale_timers();
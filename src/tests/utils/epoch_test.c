@@ -0,0 +1,175 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "epoch_test.h"
+#include "../../utils/epoch.h"
+
+/**
+ * Retired test object
+ */
+typedef struct epoch_test_object {
+    epoch_entry retire;
+    size_t* freed_count;
+} epoch_test_object;
+
+static void free_test_object(epoch_entry* entry) {
+    epoch_test_object* p_object = (epoch_test_object*)entry;
+    ++*p_object->freed_count;
+    free(p_object);
+}
+
+static epoch_test_object* make_test_object(size_t* freed_count) {
+    epoch_test_object* p_object = malloc(sizeof(epoch_test_object));
+    p_object->retire.free_func = free_test_object;
+    p_object->freed_count = freed_count;
+    return p_object;
+}
+
+CU_TestInfo* get_epoch_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_epoch_init_and_destroy", test_epoch_init_and_destroy},
+        {"test_epoch_retire_and_collect", test_epoch_retire_and_collect},
+        {"test_epoch_reader_blocks_free", test_epoch_reader_blocks_free},
+        {"test_epoch_thread_detach", test_epoch_thread_detach},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_epoch_init_and_destroy() {
+    size_t freed_count = 0;
+    epoch_domain domain;
+    CU_ASSERT_EQUAL(epoch_domain_init(&domain), true)
+
+    epoch_record* record = epoch_thread_record(&domain);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(record)
+    CU_ASSERT_PTR_EQUAL(epoch_thread_record(&domain), record) // Same record for the same thread
+
+    epoch_retire(&domain, record, &make_test_object(&freed_count)->retire);
+    CU_ASSERT_EQUAL(freed_count, 0)
+
+    // Destroying frees everything that's still retired
+    CU_ASSERT_EQUAL(epoch_domain_destroy(&domain), true)
+    CU_ASSERT_EQUAL(freed_count, 1)
+
+    // A new domain (even at the same address) gets a new record
+    CU_ASSERT_EQUAL(epoch_domain_init(&domain), true)
+    CU_ASSERT_PTR_NOT_NULL(epoch_thread_record(&domain))
+    CU_ASSERT_EQUAL(epoch_domain_destroy(&domain), true)
+}
+
+void test_epoch_retire_and_collect() {
+    size_t freed_count = 0;
+    epoch_domain domain;
+    CU_ASSERT_EQUAL(epoch_domain_init(&domain), true)
+
+    epoch_record* record = epoch_thread_record(&domain);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(record)
+
+    epoch_enter(&domain, record);
+    epoch_retire(&domain, record, &make_test_object(&freed_count)->retire);
+    epoch_exit(record);
+
+    // Freed once the epoch has advanced twice
+    epoch_collect(&domain, record);
+    CU_ASSERT_EQUAL(freed_count, 0)
+    epoch_collect(&domain, record);
+    CU_ASSERT_EQUAL(freed_count, 1)
+
+    // Retiring enough objects collects automatically
+    for (size_t i = 0; i < EPOCH_COLLECT_INTERVAL * 4; ++i) {
+        epoch_retire(&domain, record, &make_test_object(&freed_count)->retire);
+    }
+
+    CU_ASSERT(freed_count > 1)
+
+    CU_ASSERT_EQUAL(epoch_domain_destroy(&domain), true)
+    CU_ASSERT_EQUAL(freed_count, EPOCH_COLLECT_INTERVAL * 4 + 1)
+}
+
+/**
+ * Reader thread state
+ */
+struct epoch_test_reader {
+    epoch_domain* domain;
+    _Atomic int stage;
+};
+
+static void* reader_thread(void* arg) {
+    struct epoch_test_reader* reader = arg;
+    epoch_record* record = epoch_thread_record(reader->domain);
+
+    epoch_enter(reader->domain, record);
+    atomic_store(&reader->stage, 1);
+
+    // Stay in the critical section until the main thread is done checking
+    while (atomic_load(&reader->stage) != 2) {
+    }
+
+    epoch_exit(record);
+    epoch_thread_detach(reader->domain);
+
+    return NULL;
+}
+
+void test_epoch_reader_blocks_free() {
+    size_t freed_count = 0;
+    epoch_domain domain;
+    CU_ASSERT_EQUAL(epoch_domain_init(&domain), true)
+
+    struct epoch_test_reader reader = {.domain = &domain};
+    atomic_init(&reader.stage, 0);
+
+    pthread_t thread;
+    CU_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, reader_thread, &reader), 0)
+    while (atomic_load(&reader.stage) != 1) {
+    }
+
+    epoch_record* record = epoch_thread_record(&domain);
+    epoch_retire(&domain, record, &make_test_object(&freed_count)->retire);
+
+    // The reader entered before the object was retired, so it can't be freed yet
+    for (int i = 0; i < 10; ++i) {
+        epoch_collect(&domain, record);
+    }
+    CU_ASSERT_EQUAL(freed_count, 0)
+
+    atomic_store(&reader.stage, 2);
+    pthread_join(thread, NULL);
+
+    for (int i = 0; i < 3; ++i) {
+        epoch_collect(&domain, record);
+    }
+    CU_ASSERT_EQUAL(freed_count, 1)
+
+    CU_ASSERT_EQUAL(epoch_domain_destroy(&domain), true)
+}
+
+static void* detach_thread(void* arg) {
+    epoch_domain* domain = arg;
+    epoch_thread_record(domain);
+    epoch_thread_detach(domain);
+
+    return NULL;
+}
+
+void test_epoch_thread_detach() {
+    epoch_domain domain;
+    CU_ASSERT_EQUAL(epoch_domain_init(&domain), true)
+
+    // Threads that detach leave their records to be reused
+    for (int i = 0; i < 5; ++i) {
+        pthread_t thread;
+        CU_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, detach_thread, &domain), 0)
+        pthread_join(thread, NULL);
+    }
+
+    size_t record_count = 0;
+    for (const epoch_record* p_record = atomic_load(&domain.records); p_record != NULL; p_record = p_record->next) {
+        ++record_count;
+    }
+    CU_ASSERT_EQUAL(record_count, 1)
+
+    CU_ASSERT_EQUAL(epoch_domain_destroy(&domain), true)
+}
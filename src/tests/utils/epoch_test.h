@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_epoch_tests();
+
+void test_epoch_init_and_destroy();
+
+void test_epoch_retire_and_collect();
+
+void test_epoch_reader_blocks_free();
+
+void test_epoch_thread_detach();
@@ -0,0 +1,137 @@
+#include <stdlib.h>
+
+#include "mem_pool_test.h"
+#include "../../utils/mem_pool.h"
+
+CU_TestInfo* get_mem_pool_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_mem_pool_init_and_destroy", test_mem_pool_init_and_destroy},
+        {"test_mem_pool_alloc_and_free", test_mem_pool_alloc_and_free},
+        {"test_mem_pool_custom_allocator", test_mem_pool_custom_allocator},
+        {"test_mem_pool_alloc_many", test_mem_pool_alloc_many},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_mem_pool_init_and_destroy() {
+    mem_pool pool;
+    CU_ASSERT_EQUAL(mem_pool_init(&pool, 0, nullptr), false)
+
+    CU_ASSERT_EQUAL(mem_pool_init(&pool, 1, nullptr), true)
+    CU_ASSERT_EQUAL(pool.object_size, sizeof(void*)) // Must fit a free list pointer
+    CU_ASSERT_PTR_NULL(pool.slabs) // Nothing allocated yet
+
+    CU_ASSERT_EQUAL(mem_pool_init(&pool, 20, nullptr), true)
+    CU_ASSERT_EQUAL(pool.object_size, 24) // Pointer aligned
+    CU_ASSERT_PTR_NOT_NULL(mem_pool_alloc(&pool))
+    CU_ASSERT_PTR_NOT_NULL(pool.slabs)
+
+    CU_ASSERT_EQUAL(mem_pool_destroy(&pool), true)
+    CU_ASSERT_PTR_NULL(pool.slabs)
+    CU_ASSERT_PTR_NULL(pool.free_list)
+}
+
+void test_mem_pool_alloc_and_free() {
+    void* objects[100];
+    mem_pool pool;
+    CU_ASSERT_EQUAL(mem_pool_init(&pool, sizeof(int), nullptr), true)
+
+    // Objects don't overlap
+    for (int i = 0; i < 100; ++i) {
+        objects[i] = mem_pool_alloc(&pool);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(objects[i])
+        *(int *)objects[i] = i;
+    }
+
+    bool intact = true;
+    for (int i = 0; i < 100; ++i) {
+        intact &= *(int *)objects[i] == i;
+    }
+    CU_ASSERT(intact)
+
+    // Freed objects are reused (most recently freed first)
+    mem_pool_free(&pool, objects[10]);
+    mem_pool_free(&pool, objects[20]);
+    CU_ASSERT_PTR_EQUAL(mem_pool_alloc(&pool), objects[20])
+    CU_ASSERT_PTR_EQUAL(mem_pool_alloc(&pool), objects[10])
+
+    CU_ASSERT_EQUAL(mem_pool_destroy(&pool), true)
+}
+
+/**
+ * Allocator that counts allocations
+ */
+struct counting_allocator_ctx {
+    size_t allocs;
+    size_t frees;
+};
+
+static void* counting_alloc(const size_t size, void* ctx) {
+    ++((struct counting_allocator_ctx *)ctx)->allocs;
+    return malloc(size);
+}
+
+static void counting_free(void* ptr, const size_t _size, void* ctx) {
+    ++((struct counting_allocator_ctx *)ctx)->frees;
+    free(ptr);
+}
+
+void test_mem_pool_custom_allocator() {
+    struct counting_allocator_ctx ctx = {0, 0};
+    const mem_allocator allocator = {counting_alloc, counting_free, &ctx};
+
+    mem_pool pool;
+    CU_ASSERT_EQUAL(mem_pool_init(&pool, sizeof(int), &allocator), true)
+    CU_ASSERT_EQUAL(ctx.allocs, 0)
+
+    // First slab holds MEM_POOL_MIN_SLAB_OBJECTS, then slabs double
+    for (int i = 0; i < MEM_POOL_MIN_SLAB_OBJECTS; ++i) {
+        CU_ASSERT_PTR_NOT_NULL(mem_pool_alloc(&pool))
+    }
+    CU_ASSERT_EQUAL(ctx.allocs, 1)
+
+    for (int i = 0; i < MEM_POOL_MIN_SLAB_OBJECTS * 2; ++i) {
+        CU_ASSERT_PTR_NOT_NULL(mem_pool_alloc(&pool))
+    }
+    CU_ASSERT_EQUAL(ctx.allocs, 2)
+
+    CU_ASSERT_EQUAL(mem_pool_destroy(&pool), true)
+    CU_ASSERT_EQUAL(ctx.frees, 2)
+}
+
+void test_mem_pool_alloc_many() {
+    struct counting_allocator_ctx ctx = {0, 0};
+    const mem_allocator allocator = {counting_alloc, counting_free, &ctx};
+
+    mem_pool pool;
+    CU_ASSERT_EQUAL(mem_pool_init(&pool, sizeof(int), &allocator), true)
+    CU_ASSERT_PTR_NULL(mem_pool_alloc_many(&pool, 0))
+
+    void* p_first = mem_pool_alloc(&pool);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_first)
+
+    // A block is one allocation, whatever its size
+    char* p_block = mem_pool_alloc_many(&pool, 1000);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(p_block)
+    CU_ASSERT_EQUAL(ctx.allocs, 2)
+
+    for (int i = 0; i < 1000; ++i) {
+        *(int *)(p_block + i * pool.object_size) = i;
+    }
+
+    // The slab that was in use keeps handing out objects
+    char* p_next = mem_pool_alloc(&pool);
+    CU_ASSERT_PTR_EQUAL(p_next, (char *)p_first + pool.object_size)
+    CU_ASSERT_EQUAL(ctx.allocs, 2)
+
+    // Block objects can be freed individually
+    mem_pool_free(&pool, p_block + 10 * pool.object_size);
+    CU_ASSERT_PTR_EQUAL(mem_pool_alloc(&pool), p_block + 10 * pool.object_size)
+
+    CU_ASSERT_EQUAL(*(int *)(p_block + 999 * pool.object_size), 999)
+
+    CU_ASSERT_EQUAL(mem_pool_destroy(&pool), true)
+    CU_ASSERT_EQUAL(ctx.frees, 2)
+}
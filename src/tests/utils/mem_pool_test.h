@@ -0,0 +1,13 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_mem_pool_tests();
+
+void test_mem_pool_init_and_destroy();
+
+void test_mem_pool_alloc_and_free();
+
+void test_mem_pool_custom_allocator();
+
+void test_mem_pool_alloc_many();
@@ -0,0 +1,43 @@
+#include "parallel_test.h"
+#include "../../utils/parallel.h"
+
+CU_TestInfo* get_parallel_tests() {
+    static CU_TestInfo tests[] = {
+        {"test_parallel_threads", test_parallel_threads},
+        {"test_parallel_run", test_parallel_run},
+        CU_TEST_INFO_NULL,
+    };
+
+    return tests;
+}
+
+void test_parallel_threads() {
+    CU_ASSERT_EQUAL(parallel_threads(1), 1)
+    CU_ASSERT_EQUAL(parallel_threads(8), 8)
+    CU_ASSERT_EQUAL(parallel_threads(PARALLEL_MAX_THREADS + 1), PARALLEL_MAX_THREADS)
+
+    // One per online CPU
+    const size_t cpus = parallel_threads(0);
+    CU_ASSERT(cpus >= 1 && cpus <= PARALLEL_MAX_THREADS)
+}
+
+static void test_parallel_count(void* arg, const size_t thread) {
+    __atomic_fetch_add(&((size_t *)arg)[thread], 1, __ATOMIC_RELAXED);
+}
+
+void test_parallel_run() {
+    size_t calls[16] = {0};
+    parallel_run(16, test_parallel_count, calls);
+
+    // Every thread number runs exactly once
+    bool all_once = true;
+    for (size_t i = 0; i < 16; ++i) {
+        all_once &= calls[i] == 1;
+    }
+    CU_ASSERT(all_once)
+
+    // On the calling thread only
+    parallel_run(1, test_parallel_count, calls);
+    CU_ASSERT_EQUAL(calls[0], 2)
+    CU_ASSERT_EQUAL(calls[1], 1)
+}
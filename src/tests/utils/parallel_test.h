@@ -0,0 +1,9 @@
+#pragma once
+
+#include <CUnit/Basic.h>
+
+CU_TestInfo* get_parallel_tests();
+
+void test_parallel_threads();
+
+void test_parallel_run();
@@ -0,0 +1,241 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "epoch.h"
+#include "log.h"
+
+/**
+ * Thread-local link from a domain to the calling thread's record in it
+ */
+typedef struct epoch_thread_link {
+    uint64_t domain_id;
+    epoch_record* record;
+    struct epoch_thread_link* next;
+} epoch_thread_link;
+
+/**
+ * Calling thread's records
+ */
+static _Thread_local epoch_thread_link* thread_links = nullptr;
+
+/**
+ * Frees thread_links when a thread exits
+ */
+static pthread_key_t thread_links_key;
+static pthread_once_t thread_links_key_once = PTHREAD_ONCE_INIT;
+
+static _Atomic uint64_t next_domain_id = 1;
+
+/**
+ * Free a thread's links to its records (the records themselves belong to their domains)
+ *
+ * @param[in] links Thread's links
+ */
+static void free_thread_links(void* links) {
+    epoch_thread_link* p_link = links;
+    while (p_link != NULL) {
+        epoch_thread_link* p_next = p_link->next;
+        free(p_link);
+        p_link = p_next;
+    }
+}
+
+static void create_thread_links_key() {
+    pthread_key_create(&thread_links_key, free_thread_links);
+}
+
+/**
+ * Free every object in a retired object list
+ *
+ * @param[in] entry First entry in the list
+ */
+static void free_entries(epoch_entry* entry) {
+    while (entry != NULL) {
+        epoch_entry* p_next = entry->next;
+        entry->free_func(entry);
+        entry = p_next;
+    }
+}
+
+bool epoch_domain_init(epoch_domain* domain) {
+    atomic_init(&domain->epoch, 1);
+    atomic_init(&domain->records, nullptr);
+    domain->id = atomic_fetch_add(&next_domain_id, 1);
+
+    return true;
+}
+
+bool epoch_domain_destroy(epoch_domain* domain) {
+    epoch_record* p_record = atomic_load(&domain->records);
+    while (p_record != NULL) {
+        epoch_record* p_next = p_record->next;
+
+        for (size_t i = 0; i < EPOCH_LIMBO_LISTS; ++i) {
+            free_entries(p_record->limbo[i]);
+        }
+
+        free(p_record);
+        p_record = p_next;
+    }
+
+    atomic_store(&domain->records, nullptr);
+
+    // Threads may still have links to this domain, but IDs are never reused so they'll never match again
+    domain->id = 0;
+
+    return true;
+}
+
+/**
+ * Claim an unused record in the domain, or add a new one
+ *
+ * @param[in,out] domain Epoch domain
+ * @return Record, or NULL on failure
+ */
+static epoch_record* claim_record(epoch_domain* domain) {
+    for (epoch_record* p_record = atomic_load(&domain->records); p_record != NULL; p_record = p_record->next) {
+        bool expected = false;
+        if (!atomic_load_explicit(&p_record->in_use, memory_order_relaxed) &&
+            atomic_compare_exchange_strong(&p_record->in_use, &expected, true)) {
+            return p_record;
+        }
+    }
+
+    epoch_record* p_record = calloc(1, sizeof(epoch_record));
+    if (p_record == NULL) {
+        log_perror("calloc() failed for epoch record");
+        return nullptr;
+    }
+
+    atomic_init(&p_record->state, 0);
+    atomic_init(&p_record->in_use, true);
+
+    // Records are never removed until the domain is destroyed, so a plain push is safe
+    epoch_record* p_head = atomic_load(&domain->records);
+    do {
+        p_record->next = p_head;
+    }
+    while (!atomic_compare_exchange_weak(&domain->records, &p_head, p_record));
+
+    return p_record;
+}
+
+epoch_record* epoch_thread_record(epoch_domain* domain) {
+    for (const epoch_thread_link* p_link = thread_links; p_link != NULL; p_link = p_link->next) {
+        if (p_link->domain_id == domain->id) {
+            return p_link->record;
+        }
+    }
+
+    pthread_once(&thread_links_key_once, create_thread_links_key);
+
+    epoch_thread_link* p_link = malloc(sizeof(epoch_thread_link));
+    if (p_link == NULL) {
+        log_perror("malloc() failed for epoch thread link");
+        return nullptr;
+    }
+
+    p_link->record = claim_record(domain);
+    if (p_link->record == NULL) {
+        free(p_link);
+        return nullptr;
+    }
+
+    p_link->domain_id = domain->id;
+    p_link->next = thread_links;
+    thread_links = p_link;
+    pthread_setspecific(thread_links_key, thread_links);
+
+    return p_link->record;
+}
+
+void epoch_thread_detach(epoch_domain* domain) {
+    epoch_thread_link** pp_link = &thread_links;
+    while (*pp_link != NULL) {
+        epoch_thread_link* p_link = *pp_link;
+        if (p_link->domain_id == domain->id) {
+            *pp_link = p_link->next;
+            pthread_setspecific(thread_links_key, thread_links);
+
+            // Retired objects stay with the record, and are freed by whichever thread claims it next
+            atomic_store(&p_link->record->state, 0);
+            atomic_store(&p_link->record->in_use, false);
+            free(p_link);
+            return;
+        }
+
+        pp_link = &p_link->next;
+    }
+}
+
+void epoch_enter(epoch_domain* domain, epoch_record* record) {
+    const uint64_t epoch = atomic_load(&domain->epoch);
+
+    atomic_store(&record->state, epoch << 1 | 1);
+
+    // The store must be visible to writers before any shared object is read
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void epoch_exit(epoch_record* record) {
+    atomic_store_explicit(&record->state, 0, memory_order_release);
+}
+
+/**
+ * Try to advance the global epoch
+ * This only succeeds if every thread that's inside a critical section has observed the current epoch
+ *
+ * @param[in,out] domain Epoch domain
+ * @return Global epoch after the attempt
+ */
+static uint64_t try_advance(epoch_domain* domain) {
+    // Pairs with the fence in epoch_enter(), so unlinks before this are ordered before the record states are read
+    atomic_thread_fence(memory_order_seq_cst);
+
+    uint64_t epoch = atomic_load(&domain->epoch);
+
+    for (const epoch_record* p_record = atomic_load(&domain->records); p_record != NULL; p_record = p_record->next) {
+        const uint64_t state = atomic_load(&p_record->state);
+        if ((state & 1) != 0 && state >> 1 != epoch) {
+            // A reader is still in an older epoch
+            return epoch;
+        }
+    }
+
+    atomic_compare_exchange_strong(&domain->epoch, &epoch, epoch + 1);
+
+    return atomic_load(&domain->epoch);
+}
+
+void epoch_collect(epoch_domain* domain, epoch_record* record) {
+    const uint64_t epoch = try_advance(domain);
+
+    for (size_t i = 0; i < EPOCH_LIMBO_LISTS; ++i) {
+        if (record->limbo[i] != NULL && record->limbo_epoch[i] + 2 <= epoch) {
+            free_entries(record->limbo[i]);
+            record->limbo[i] = nullptr;
+        }
+    }
+
+    record->retired_since_collect = 0;
+}
+
+void epoch_retire(epoch_domain* domain, epoch_record* record, epoch_entry* entry) {
+    const uint64_t epoch = atomic_load(&domain->epoch);
+    const size_t list = epoch % EPOCH_LIMBO_LISTS;
+
+    if (record->limbo[list] != NULL && record->limbo_epoch[list] != epoch) {
+        // Objects from epoch - 3 (or earlier) are already safe to free
+        free_entries(record->limbo[list]);
+        record->limbo[list] = nullptr;
+    }
+
+    entry->next = record->limbo[list];
+    record->limbo[list] = entry;
+    record->limbo_epoch[list] = epoch;
+
+    if (++record->retired_since_collect >= EPOCH_COLLECT_INTERVAL) {
+        epoch_collect(domain, record);
+    }
+}
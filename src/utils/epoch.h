@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Number of objects a thread retires between attempts to advance the epoch and free its retired objects
+ */
+#define EPOCH_COLLECT_INTERVAL 64
+
+/**
+ * Header for an object that's retired to an epoch domain
+ * Embed this as the first member of the object so the entry pointer is also the object pointer
+ */
+typedef struct epoch_entry {
+    struct epoch_entry* next;
+
+    /**
+     * Called once no thread can still be reading the object
+     *
+     * @param[in] entry Retired entry
+     */
+    void (*free_func)(struct epoch_entry* entry);
+} epoch_entry;
+
+/**
+ * Number of retired object lists each record keeps (objects retired in epoch e go to list e % EPOCH_LIMBO_LISTS)
+ */
+#define EPOCH_LIMBO_LISTS 3
+
+/**
+ * Per-thread epoch state
+ * Only the thread that currently owns a record touches its retired object lists
+ */
+typedef struct epoch_record {
+    /**
+     * Epoch observed when the owning thread entered its critical section (shifted left by 1), with the low bit set
+     * while it's inside. 0 when the thread isn't reading.
+     */
+    _Atomic uint64_t state;
+
+    /**
+     * Set while a thread owns this record
+     */
+    _Atomic bool in_use;
+
+    /**
+     * Next record in the domain
+     */
+    struct epoch_record* next;
+
+    /**
+     * Retired objects, by epoch
+     */
+    epoch_entry* limbo[EPOCH_LIMBO_LISTS];
+
+    /**
+     * Epoch that each limbo list's objects were retired in
+     */
+    uint64_t limbo_epoch[EPOCH_LIMBO_LISTS];
+
+    /**
+     * Number of objects retired since the last collection
+     */
+    size_t retired_since_collect;
+} epoch_record;
+
+/**
+ * An epoch domain provides epoch-based memory reclamation: a way for lock-free readers to safely use shared objects that
+ * writers may unlink and free at any time.
+ *
+ * Readers wrap every access in epoch_enter() and epoch_exit(). Writers unlink an object so no new reader can find it,
+ * then epoch_retire() it instead of freeing it. The global epoch can only advance once every thread that's inside a
+ * critical section has observed the current epoch, so an object retired in epoch e is freed once the global epoch
+ * reaches e + 2, when no reader that could have seen it is left.
+ *
+ * Each thread gets its own record per domain (see epoch_thread_record()), which is found through thread-local storage.
+ * Records are kept (and reused by new threads) until the domain is destroyed.
+ *
+ * **Example**
+ * ```c
+ * epoch_domain domain;
+ * epoch_domain_init(&domain);
+ *
+ * // Reader thread
+ * epoch_record* rec = epoch_thread_record(&domain);
+ * epoch_enter(&domain, rec);
+ * node* p = atomic_load(&head); // Safe to use p until epoch_exit()
+ * epoch_exit(rec);
+ *
+ * // Writer thread
+ * epoch_record* rec = epoch_thread_record(&domain);
+ * epoch_enter(&domain, rec);
+ * node* old = atomic_exchange(&head, new_node);
+ * epoch_retire(&domain, rec, &old->epoch_entry); // Freed once no reader can still see it
+ * epoch_exit(rec);
+ *
+ * epoch_domain_destroy(&domain); // Frees everything still retired
+ * ```
+ */
+typedef struct epoch_domain {
+    /**
+     * Global epoch
+     */
+    _Atomic uint64_t epoch;
+
+    /**
+     * All records (only ever pushed to until the domain is destroyed)
+     */
+    _Atomic(epoch_record*) records;
+
+    /**
+     * Unique ID of this domain (used to match thread-local records, so they're never confused with records of a
+     * destroyed domain at the same address)
+     */
+    uint64_t id;
+} epoch_domain;
+
+/**
+ * Initialize the epoch domain
+ *
+ * Time complexity: O(1)
+ *
+ * @relates epoch_domain
+ * @param[out] domain Epoch domain
+ * @return true on success, false on failure
+ */
+bool epoch_domain_init(epoch_domain* domain);
+
+/**
+ * Destroy the epoch domain, freeing all retired objects and records
+ *
+ * No other thread may be using the domain.
+ *
+ * Time complexity: O(n)
+ *
+ * @relates epoch_domain
+ * @param[in,out] domain Epoch domain
+ * @return true on success, false on failure
+ */
+bool epoch_domain_destroy(epoch_domain* domain);
+
+/**
+ * Get the calling thread's record for the epoch domain (claiming one the first time a thread uses the domain)
+ *
+ * Time complexity: O(1) (O(threads) the first time)
+ *
+ * @relates epoch_domain
+ * @param[in,out] domain Epoch domain
+ * @return Record, or NULL on failure
+ */
+epoch_record* epoch_thread_record(epoch_domain* domain);
+
+/**
+ * Release the calling thread's record for the epoch domain, so another thread can reuse it
+ *
+ * Threads that are about to exit should call this for each domain they used, or their records (and any objects they
+ * retired) are kept until the domain is destroyed.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates epoch_domain
+ * @param[in,out] domain Epoch domain
+ */
+void epoch_thread_detach(epoch_domain* domain);
+
+/**
+ * Enter a read-side critical section
+ * Shared objects read until epoch_exit() won't be freed
+ *
+ * Time complexity: O(1)
+ *
+ * @relates epoch_domain
+ * @param[in,out] domain Epoch domain
+ * @param[in,out] record Calling thread's record
+ */
+void epoch_enter(epoch_domain* domain, epoch_record* record);
+
+/**
+ * Exit a read-side critical section
+ *
+ * Time complexity: O(1)
+ *
+ * @relates epoch_domain
+ * @param[in,out] record Calling thread's record
+ */
+void epoch_exit(epoch_record* record);
+
+/**
+ * Retire an unlinked object, to be freed once no thread can still be reading it
+ *
+ * Every EPOCH_COLLECT_INTERVAL retires, this tries to advance the global epoch and frees the thread's objects that
+ * became safe to free.
+ *
+ * Time complexity: O(1) amortized
+ *
+ * @relates epoch_domain
+ * @param[in,out] domain Epoch domain
+ * @param[in,out] record Calling thread's record
+ * @param[in] entry Entry embedded in the object (with free_func set)
+ */
+void epoch_retire(epoch_domain* domain, epoch_record* record, epoch_entry* entry);
+
+/**
+ * Try to advance the global epoch, then free the calling thread's retired objects that are safe to free
+ *
+ * Time complexity: O(threads + freed objects)
+ *
+ * @relates epoch_domain
+ * @param[in,out] domain Epoch domain
+ * @param[in,out] record Calling thread's record
+ */
+void epoch_collect(epoch_domain* domain, epoch_record* record);
@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdalign.h>
+#include <stdint.h>
+
+#include "mem_pool.h"
+#include "log.h"
+
+/**
+ * Header at the start of every slab
+ * Padded so the objects after it are aligned like malloc() results
+ */
+typedef struct mem_pool_slab {
+    alignas(max_align_t) struct mem_pool_slab* next;
+    size_t size;
+} mem_pool_slab;
+
+static void* default_alloc(const size_t size, void* _ctx) {
+    return malloc(size);
+}
+
+static void default_free(void* ptr, const size_t _size, void* _ctx) {
+    free(ptr);
+}
+
+bool mem_pool_init(mem_pool* pool, const size_t object_size, const mem_allocator* allocator) {
+    memset(pool, 0, sizeof(mem_pool));
+
+    if (object_size == 0) {
+        log_error("memory pool object size must be greater than 0");
+        return false;
+    }
+
+    // Objects must be able to hold a free list pointer, and stay pointer aligned
+    const size_t align = sizeof(void*);
+    size_t size = object_size < sizeof(void*) ? sizeof(void*) : object_size;
+    size = (size + align - 1) / align * align;
+
+    pool->object_size = size;
+    pool->next_slab_objects = MEM_POOL_MIN_SLAB_OBJECTS;
+
+    if (allocator != NULL) {
+        pool->allocator = *allocator;
+    }
+    else {
+        pool->allocator.alloc = default_alloc;
+        pool->allocator.free = default_free;
+        pool->allocator.ctx = nullptr;
+    }
+
+    return true;
+}
+
+/**
+ * Allocate a new slab to carve objects from
+ *
+ * @param[in,out] pool Memory pool
+ * @return true on success, false on failure
+ */
+static bool add_slab(mem_pool* pool) {
+    const size_t size = sizeof(mem_pool_slab) + pool->next_slab_objects * pool->object_size;
+
+    mem_pool_slab* p_slab = pool->allocator.alloc(size, pool->allocator.ctx);
+    if (p_slab == NULL) {
+        log_perror("memory pool slab allocation failed");
+        return false;
+    }
+
+    p_slab->next = pool->slabs;
+    p_slab->size = size;
+    pool->slabs = p_slab;
+
+    pool->slab_next = (char *)(p_slab + 1);
+    pool->slab_left = pool->next_slab_objects;
+
+    if (pool->next_slab_objects < MEM_POOL_MAX_SLAB_OBJECTS) {
+        pool->next_slab_objects *= 2;
+    }
+
+    return true;
+}
+
+void* mem_pool_alloc(mem_pool* pool) {
+    if (pool->free_list != NULL) {
+        void* object = pool->free_list;
+        pool->free_list = *(void **)object;
+        return object;
+    }
+
+    if (pool->slab_left == 0 && !add_slab(pool)) {
+        return nullptr;
+    }
+
+    void* object = pool->slab_next;
+    pool->slab_next += pool->object_size;
+    --pool->slab_left;
+
+    return object;
+}
+
+void* mem_pool_alloc_many(mem_pool* pool, const size_t count) {
+    if (count == 0 || count > (SIZE_MAX - sizeof(mem_pool_slab)) / pool->object_size) {
+        log_error("invalid memory pool block size: %zu objects", count);
+        return nullptr;
+    }
+
+    const size_t size = sizeof(mem_pool_slab) + count * pool->object_size;
+
+    mem_pool_slab* p_slab = pool->allocator.alloc(size, pool->allocator.ctx);
+    if (p_slab == NULL) {
+        log_perror("memory pool block allocation failed");
+        return nullptr;
+    }
+
+    // Only the slab list needs to know about the block, so the newest slab keeps handing out objects
+    p_slab->next = pool->slabs;
+    p_slab->size = size;
+    pool->slabs = p_slab;
+
+    return p_slab + 1;
+}
+
+void mem_pool_free(mem_pool* pool, void* object) {
+    *(void **)object = pool->free_list;
+    pool->free_list = object;
+}
+
+bool mem_pool_destroy(mem_pool* pool) {
+    mem_pool_slab* p_slab = pool->slabs;
+    while (p_slab != NULL) {
+        mem_pool_slab* p_next = p_slab->next;
+        pool->allocator.free(p_slab, p_slab->size, pool->allocator.ctx);
+        p_slab = p_next;
+    }
+
+    pool->slabs = nullptr;
+    pool->free_list = nullptr;
+    pool->slab_next = nullptr;
+    pool->slab_left = 0;
+    pool->next_slab_objects = MEM_POOL_MIN_SLAB_OBJECTS;
+
+    return true;
+}
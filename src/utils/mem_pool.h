@@ -0,0 +1,163 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Memory allocator hooks
+ *
+ * Structures that accept an allocator use it for their bulk (slab) allocations. Passing NULL anywhere an allocator is
+ * accepted uses malloc() and free().
+ */
+typedef struct mem_allocator {
+    /**
+     * Allocate memory
+     *
+     * @param[in] size Number of bytes to allocate
+     * @param ctx Allocator context
+     * @return Allocated memory or NULL on failure
+     */
+    void* (*alloc)(size_t size, void* ctx);
+
+    /**
+     * Free memory returned by alloc
+     *
+     * @param[in] ptr Memory to free
+     * @param[in] size Number of bytes that were allocated
+     * @param ctx Allocator context
+     */
+    void (*free)(void* ptr, size_t size, void* ctx);
+
+    /**
+     * Allocator context (passed to alloc and free)
+     */
+    void* ctx;
+} mem_allocator;
+
+/**
+ * Number of objects in a memory pool's first slab (each following slab doubles in size)
+ */
+#define MEM_POOL_MIN_SLAB_OBJECTS 16
+
+/**
+ * Max number of objects in a single memory pool slab
+ */
+#define MEM_POOL_MAX_SLAB_OBJECTS 65536
+
+/**
+ * A memory pool hands out fixed-size objects that are carved out of larger slabs, and keeps freed objects on a free
+ * list so they can be reused.
+ *
+ * Memory pools are useful when a structure allocates and frees lots of small objects of the same size (like list
+ * nodes): allocating an object is usually just popping the free list, and all objects can be released at once by
+ * destroying the pool instead of freeing them individually.
+ *
+ * **Example**
+ * ```c
+ * mem_pool pool;
+ * mem_pool_init(&pool, sizeof(list_node), NULL); // Use malloc() for slabs
+ *
+ * list_node* node = mem_pool_alloc(&pool);
+ * mem_pool_free(&pool, node); // Return node to the free list
+ *
+ * mem_pool_destroy(&pool); // Free all slabs
+ * ```
+ */
+typedef struct mem_pool {
+    /**
+     * Size of each object (rounded up to keep objects aligned)
+     */
+    size_t object_size;
+
+    /**
+     * Number of objects in the next slab
+     */
+    size_t next_slab_objects;
+
+    /**
+     * Freed objects (linked through their first word)
+     */
+    void* free_list;
+
+    /**
+     * Allocated slabs (linked through their headers)
+     */
+    void* slabs;
+
+    /**
+     * Next never-used object in the newest slab
+     */
+    char* slab_next;
+
+    /**
+     * Number of never-used objects left in the newest slab
+     */
+    size_t slab_left;
+
+    /**
+     * Allocator used for slabs
+     */
+    mem_allocator allocator;
+} mem_pool;
+
+/**
+ * Initialize the memory pool
+ *
+ * No memory is allocated until the first object is allocated.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates mem_pool
+ * @param[out] pool Memory pool
+ * @param[in] object_size Size of each object
+ * @param[in] allocator Allocator used for slabs (copied), or NULL to use malloc()
+ * @return true on success, false on failure
+ */
+bool mem_pool_init(mem_pool* pool, size_t object_size, const mem_allocator* allocator);
+
+/**
+ * Allocate an object from the memory pool
+ *
+ * Time complexity: O(1)
+ *
+ * @relates mem_pool
+ * @param[in,out] pool Memory pool
+ * @return Uninitialized object, or NULL on failure
+ */
+void* mem_pool_alloc(mem_pool* pool);
+
+/**
+ * Allocate a contiguous block of objects from the memory pool
+ *
+ * The block gets a slab of its own, so it's a single allocator call however many objects it holds. Its objects can be
+ * returned to the pool one at a time with mem_pool_free() (like any other object), and are freed with the pool.
+ *
+ * Time complexity: O(1)
+ *
+ * @relates mem_pool
+ * @param[in,out] pool Memory pool
+ * @param[in] count Number of objects (must be at least 1)
+ * @return Uninitialized array of count objects (each object_size bytes apart), or NULL on failure
+ */
+void* mem_pool_alloc_many(mem_pool* pool, size_t count);
+
+/**
+ * Return an object to the memory pool
+ *
+ * Time complexity: O(1)
+ *
+ * @relates mem_pool
+ * @param[in,out] pool Memory pool
+ * @param[in] object Object that was allocated from this pool
+ */
+void mem_pool_free(mem_pool* pool, void* object);
+
+/**
+ * Destroy the memory pool, freeing every object allocated from it
+ *
+ * Time complexity: O(slabs)
+ *
+ * @relates mem_pool
+ * @param[in,out] pool Memory pool
+ * @return true on success, false on failure
+ */
+bool mem_pool_destroy(mem_pool* pool);
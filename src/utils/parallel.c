@@ -0,0 +1,60 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+/**
+ * Worker thread arg
+ */
+struct parallel_worker {
+    parallel_func func;
+    void* arg;
+    size_t thread;
+    pthread_t handle;
+    bool started;
+};
+
+/**
+ * Worker thread entry point: run the task for the worker's thread number
+ */
+static void* parallel_worker_thread(void* arg) {
+    const struct parallel_worker* p_worker = arg;
+    p_worker->func(p_worker->arg, p_worker->thread);
+    return nullptr;
+}
+
+size_t parallel_threads(const size_t threads) {
+    size_t count = threads;
+    if (count == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        count = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    return count > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : count;
+}
+
+void parallel_run(size_t threads, const parallel_func func, void* arg) {
+    struct parallel_worker workers[PARALLEL_MAX_THREADS];
+
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+
+    for (size_t t = 1; t < threads; ++t) {
+        workers[t].func = func;
+        workers[t].arg = arg;
+        workers[t].thread = t;
+        workers[t].started = pthread_create(&workers[t].handle, NULL, parallel_worker_thread, &workers[t]) == 0;
+    }
+
+    func(arg, 0);
+
+    for (size_t t = 1; t < threads; ++t) {
+        if (workers[t].started) {
+            pthread_join(workers[t].handle, NULL);
+        }
+        else {
+            func(arg, t);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Max number of threads parallel_run() starts
+ */
+#define PARALLEL_MAX_THREADS 256
+
+/**
+ * Parallel task function, run once for each thread number
+ *
+ * @param arg Task argument
+ * @param[in] thread Thread number (0 to threads - 1)
+ */
+typedef void (*parallel_func)(void* arg, size_t thread);
+
+/**
+ * Resolve a requested thread count
+ *
+ * Time complexity: O(1)
+ *
+ * @param[in] threads Requested number of threads (or 0 for one per online CPU)
+ * @return Number of threads to use (between 1 and PARALLEL_MAX_THREADS)
+ */
+size_t parallel_threads(size_t threads);
+
+/**
+ * Run a task on several threads, and wait for all of them to finish
+ *
+ * The calling thread runs thread number 0 itself. Thread numbers whose thread fails to start are also run on the
+ * calling thread (after its own), so func is always called exactly once for every thread number, and this can't fail.
+ *
+ * Time complexity: O(threads) (plus the cost of the task)
+ *
+ * @param[in] threads Number of threads (at most PARALLEL_MAX_THREADS)
+ * @param[in] func Task function
+ * @param arg Argument to pass to the task function
+ */
+void parallel_run(size_t threads, parallel_func func, void* arg);